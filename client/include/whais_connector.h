@@ -281,6 +281,74 @@ CONNECTOR_SHL uint_t
 WFetchProcedure(const WH_CONNECTION   hnd,
                 const char** const    outpName);
 
+/* Fetch a part of the server's statistics report.
+ *
+ * The report describes as text the latencies of the served commands and
+ * procedures, with the counters of the procedures' sync statements and of
+ * the databases' tables. It is gathered by the server when it is asked
+ * from its start, so to get all of it one should call this repeatedly,
+ * advancing the offset with the length of the received parts, until
+ * the report's size is reached.
+ *
+ * This function will fail if it's not called with a connection handler that
+ * was successfully authenticated with the the administrator account. Only
+ * the administrator of the global context database gets the statistics of
+ * all the databases.
+ *
+ * @hnd                 The connection handle.
+ * @fromOffset          The offset in the report of the requested part.
+ * @outpText            In case of success, it will point to the requested
+ *                      part, as a null terminated string.
+ * @outReportSize       In case of success, it will hold the size of the whole
+ *                      report. It should be set to NULL if it is not needed.
+ *
+ * @return              WCS_OK in case of success, other way it will return
+ *                      the error's case corresponding code.
+ *
+ * NOTE: The caller does not have the ownership of the memory pointed to
+ *       by outpText. It should make a copy of its content prior calling any
+ *       other API using the same connection handle.
+ */
+CONNECTOR_SHL uint_t
+WFetchServerStats(const WH_CONNECTION   hnd,
+                  const uint_t          fromOffset,
+                  const char** const    outpText,
+                  uint_t* const         outReportSize);
+
+/* Get a part of the profile of a procedure.
+ *
+ * The profile is the text describing where the calls of the procedure have
+ * spent their time, measured while the profiling was enabled for its
+ * database. It is sent in parts like the server statistics, so one should
+ * call this repeatedly with the offset advanced with the received parts'
+ * lengths until the profile's size is reached.
+ *
+ * This function will fail if it's not called with a connection handler that
+ * was successfully authenticated with the the administrator account.
+ *
+ * @hnd                 The connection handle.
+ * @procedure           The procedure's name. When it is NULL or empty the
+ *                      profiles of all the called procedures are sent.
+ * @fromOffset          The offset in the profile of the requested part.
+ * @outpText            In case of success, it will point to the requested
+ *                      part, as a null terminated string.
+ * @outProfileSize      In case of success, it will hold the size of the whole
+ *                      profile. It should be set to NULL if it is not needed.
+ *
+ * @return              WCS_OK in case of success, other way it will return
+ *                      the error's case corresponding code.
+ *
+ * NOTE: The caller does not have the ownership of the memory pointed to
+ *       by outpText. It should make a copy of its content prior calling any
+ *       other API using the same connection handle.
+ */
+CONNECTOR_SHL uint_t
+WFetchProcProfile(const WH_CONNECTION   hnd,
+                  const char* const     procedure,
+                  const uint_t          fromOffset,
+                  const char** const    outpText,
+                  uint_t* const         outProfileSize);
+
 /* Get the parameters count of a procedure.
  *
  * This function will fail if it's not called with a connection handler that
@@ -602,6 +670,26 @@ CONNECTOR_SHL uint_t
 WExecuteProcedure(const WH_CONNECTION   hnd,
                   const char* const     procedure);
 
+/* Get the id of a procedure, to be called later with
+ * 'WExecuteResolvedProcedure()'.
+ *
+ * The id stays valid as long as the connection is open. Calling a procedure
+ * by its id spares the server of looking up its name on every call.
+ */
+CONNECTOR_SHL uint_t
+WResolveProcedure(const WH_CONNECTION   hnd,
+                  const char* const     procedure,
+                  uint_t* const         outProcId);
+
+/* Execute remotely a procedure resolved already.
+ *
+ * The same as 'WExecuteProcedure()', except the procedure is specified by
+ * the id returned by 'WResolveProcedure()'.
+ */
+CONNECTOR_SHL uint_t
+WExecuteResolvedProcedure(const WH_CONNECTION   hnd,
+                          const uint_t          procId);
+
 #ifdef __cplusplus
 }
 #endif
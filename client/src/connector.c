@@ -960,6 +960,126 @@ list_procedure_fetch_err:
 }
 
 
+uint_t
+WFetchServerStats(const WH_CONNECTION   hnd,
+                  const uint_t          fromOffset,
+                  const char** const    outpText,
+                  uint_t* const         outReportSize)
+{
+  struct INTERNAL_HANDLER* const hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  uint_t   cs   = WCS_OK;
+  uint16_t type = CMD_INVALID_RSP;
+
+  if ((hnd == NULL) || (outpText == NULL))
+    return WCS_INVALID_ARGS;
+
+  else if (hnd_->userId != 0)
+    return WCS_OP_NOTPERMITED;
+
+  else if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  set_data_size(hnd_, sizeof(uint32_t));
+  store_le_int32(fromOffset, data(hnd_));
+
+  if ((cs = send_command(hnd_, CMD_SERVER_STATS)) != WCS_OK)
+    goto exit_server_stats;
+
+  if ((cs = recieve_answer(hnd_, &type)) != WCS_OK)
+    goto exit_server_stats;
+
+  if (type != CMD_SERVER_STATS_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto exit_server_stats;
+  }
+
+  if ((cs = load_le_int32(data(hnd_))) != WCS_OK)
+    goto exit_server_stats;
+
+  if ((data_size(hnd_) <= 3 * sizeof(uint32_t))
+      || (load_le_int32(data(hnd_) + 2 * sizeof(uint32_t)) != fromOffset)
+      || (data(hnd_)[data_size(hnd_) - 1] != 0))
+  {
+    cs = WCS_INVALID_FRAME;
+    goto exit_server_stats;
+  }
+
+  if (outReportSize != NULL)
+    *outReportSize = load_le_int32(data(hnd_) + sizeof(uint32_t));
+
+  *outpText = (const char*)(data(hnd_) + 3 * sizeof(uint32_t));
+
+exit_server_stats:
+  return cs;
+}
+
+
+uint_t
+WFetchProcProfile(const WH_CONNECTION   hnd,
+                  const char* const     procedure,
+                  const uint_t          fromOffset,
+                  const char** const    outpText,
+                  uint_t* const         outProfileSize)
+{
+  struct INTERNAL_HANDLER* const hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  const char* const name    = (procedure != NULL) ? procedure : "";
+  const uint_t      nameLen = strlen(name) + 1;
+
+  uint_t   cs   = WCS_OK;
+  uint16_t type = CMD_INVALID_RSP;
+
+  if ((hnd == NULL) || (outpText == NULL))
+    return WCS_INVALID_ARGS;
+
+  else if (hnd_->userId != 0)
+    return WCS_OP_NOTPERMITED;
+
+  else if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  else if (sizeof(uint32_t) + nameLen > max_data_size(hnd_))
+    return WCS_LARGE_ARGS;
+
+  set_data_size(hnd_, sizeof(uint32_t) + nameLen);
+  store_le_int32(fromOffset, data(hnd_));
+  memcpy(data(hnd_) + sizeof(uint32_t), name, nameLen);
+
+  if ((cs = send_command(hnd_, CMD_PROC_PROFILE)) != WCS_OK)
+    goto exit_proc_profile;
+
+  if ((cs = recieve_answer(hnd_, &type)) != WCS_OK)
+    goto exit_proc_profile;
+
+  if (type != CMD_PROC_PROFILE_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto exit_proc_profile;
+  }
+
+  if ((cs = load_le_int32(data(hnd_))) != WCS_OK)
+    goto exit_proc_profile;
+
+  if ((data_size(hnd_) <= 3 * sizeof(uint32_t))
+      || (load_le_int32(data(hnd_) + 2 * sizeof(uint32_t)) != fromOffset)
+      || (data(hnd_)[data_size(hnd_) - 1] != 0))
+  {
+    cs = WCS_INVALID_FRAME;
+    goto exit_proc_profile;
+  }
+
+  if (outProfileSize != NULL)
+    *outProfileSize = load_le_int32(data(hnd_) + sizeof(uint32_t));
+
+  *outpText = (const char*)(data(hnd_) + 3 * sizeof(uint32_t));
+
+exit_proc_profile:
+  return cs;
+}
+
+
 /* Internal function used to retrieve type information about a value.
  * If the global name is NULL then it refers to the value from the connection
  * stack top. For a table value, the hint field specifies what fields should
@@ -3390,3 +3510,98 @@ WExecuteProcedure(const WH_CONNECTION   hnd,
 execute_proc_err:
   return cs;
 }
+
+uint_t
+WResolveProcedure(const WH_CONNECTION   hnd,
+                  const char* const     procedure,
+                  uint_t* const         outProcId)
+{
+  struct INTERNAL_HANDLER* hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  uint_t   cs   = WCS_OK;
+  uint16_t type = 0;
+
+  if (hnd_ == NULL
+      || procedure == NULL
+      || outProcId == NULL
+      || strlen( procedure) == 0)
+  {
+    return WCS_INVALID_ARGS;
+  }
+
+  if (hnd_->buildingCmd == CMD_UPDATE_STACK)
+  {
+    cs = WFlush(hnd);
+    if (cs != WCS_OK)
+      return cs;
+  }
+
+  if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  set_data_size(hnd, strlen(procedure) + 1);
+  strcpy((char*)data( hnd), procedure);
+
+  if ((cs = send_command(hnd, CMD_RESOLVE_PROC)) != WCS_OK)
+    goto resolve_proc_err;
+
+  if ((cs = recieve_answer(hnd, &type)) != WCS_OK)
+    goto resolve_proc_err;
+
+  else if (type != CMD_RESOLVE_PROC_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto resolve_proc_err;
+  }
+
+  if ((cs = load_le_int32(data( hnd_))) == WCS_OK)
+    *outProcId = load_le_int32(data( hnd_) + sizeof(uint32_t));
+
+resolve_proc_err:
+  return cs;
+}
+
+uint_t
+WExecuteResolvedProcedure(const WH_CONNECTION   hnd,
+                          const uint_t          procId)
+{
+  struct INTERNAL_HANDLER* hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  uint_t   cs   = WCS_OK;
+  uint16_t type = 0;
+
+  if (hnd_ == NULL)
+    return WCS_INCOMPLETE_CMD;
+
+  if (hnd_->buildingCmd == CMD_UPDATE_STACK)
+  {
+    cs = WFlush(hnd);
+    if (cs != WCS_OK)
+      return cs;
+  }
+
+  if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  /* An empty procedure name, followed by its id. */
+  set_data_size(hnd, 1 + sizeof(uint32_t));
+  data( hnd)[0] = 0;
+  store_le_int32(procId, data( hnd) + 1);
+
+  if ((cs = send_command(hnd, CMD_EXEC_PROC)) != WCS_OK)
+    goto execute_resolved_proc_err;
+
+  if ((cs = recieve_answer(hnd, &type)) != WCS_OK)
+    goto execute_resolved_proc_err;
+
+  else if (type != CMD_EXEC_PROC_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto execute_resolved_proc_err;
+  }
+  else
+    cs = load_le_int32(data( hnd_));
+
+execute_resolved_proc_err:
+  return cs;
+}
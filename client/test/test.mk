@@ -44,6 +44,10 @@ UNIT_EXES+=c_test_stack_update_text
 c_test_stack_update_text_SRC=test/test_stack_update_text.cpp
 c_test_stack_update_text_LIB=client/wslconnector custom/wslcustom custom/wslcppmemalloc utils/wslutils 
 
+UNIT_EXES+=c_test_server_stats
+c_test_server_stats_SRC=test/test_server_stats.cpp
+c_test_server_stats_LIB=client/wslconnector custom/wslcustom custom/wslcppmemalloc utils/wslutils 
+
 #Disable this momentarly as it taske too long to link for some targets
 #ifeq ($(findstring gcc_ppc,$(ARCH)),)
 #ifeq ($(findstring _vc_x86,$(ARCH)),)
@@ -445,6 +445,42 @@ test_procedures_list_error:
   return false;
 }
 
+static bool
+test_resolved_calls(WH_CONNECTION hnd)
+{
+  const char* procName = "uint32_return_proc_no_args_This_is_a_long_variable_name_suffix_coz_I_need_to_trigger_an_odd_behavior_001_good";
+  uint_t procId, otherId;
+
+  cout << "Testing the calls of resolved procedures ... ";
+
+  if ((WResolveProcedure(hnd, procName, &procId) != WCS_OK)
+      || (WResolveProcedure(hnd, procName, &otherId) != WCS_OK)
+      || (procId != otherId))
+    {
+      goto test_resolved_calls_fail;
+    }
+  else if ((WExecuteResolvedProcedure(hnd, procId) != WCS_OK)
+           || (WExecuteResolvedProcedure(hnd, procId) != WCS_OK)
+           || (WExecuteProcedure(hnd, procName) != WCS_OK)
+           || (WPopValues(hnd, 3) != WCS_OK))
+    {
+      goto test_resolved_calls_fail;
+    }
+  else if ((WResolveProcedure(hnd, "no_such_procedure", &otherId) != WCS_PROC_NOTFOUND)
+           || (WResolveProcedure(hnd, procName, nullptr) != WCS_INVALID_ARGS)
+           || (WExecuteResolvedProcedure(hnd, 0x7FFFFFF0) != WCS_PROC_NOTFOUND))
+    {
+      goto test_resolved_calls_fail;
+    }
+
+  cout << "OK\n";
+  return true;
+
+test_resolved_calls_fail:
+  cout << "FAIL\n";
+  return false;
+}
+
 static bool
 test_for_errors(WH_CONNECTION hnd)
 {
@@ -523,6 +559,7 @@ main(int argc, const char** argv)
   success = success && test_proc_one_field_tab_ret(hnd);
   success = success && test_proc_two_field_tab_ret(hnd);
   success = success && test_proc_complete_field_tab_ret(hnd);
+  success = success && test_resolved_calls(hnd);
 
   WClose(hnd);
 
@@ -0,0 +1,219 @@
+/*
+ * test_server_stats.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+
+#include "test_client_common.h"
+
+using namespace std;
+
+
+static const char procName[] = "uint32_return_proc_no_args_This_is_a_long_variable_name_suffix_coz_I_need_to_trigger_an_odd_behavior_001_good";
+static const uint_t CALLS_COUNT = 10;
+
+
+static bool
+fetch_report(WH_CONNECTION hnd, string& outReport)
+{
+  const char* text = nullptr;
+  uint_t reportSize = 0;
+
+  outReport.clear();
+  do
+    {
+      if ((WFetchServerStats(hnd, outReport.size(), &text, &reportSize) != WCS_OK)
+          || (strlen(text) == 0))
+        {
+          return false;
+        }
+
+      outReport += text;
+    }
+  while (outReport.size() < reportSize);
+
+  return outReport.size() == reportSize;
+}
+
+
+static bool
+test_procedure_stats(WH_CONNECTION hnd)
+{
+  string report;
+  size_t linePos;
+
+  cout << "Testing the procedures statistics ... ";
+
+  for (uint_t i = 0; i < CALLS_COUNT; ++i)
+    {
+      if (WExecuteProcedure(hnd, procName) != WCS_OK)
+        goto test_procedure_stats_fail;
+    }
+
+  if ((WPopValues(hnd, CALLS_COUNT) != WCS_OK)
+      || (WFlush(hnd) != WCS_OK)
+      || ! fetch_report(hnd, report))
+    {
+      goto test_procedure_stats_fail;
+    }
+
+  //Only the administrator of the global context sees the other databases.
+  if ((report.find("Database 'test_list_db'") == string::npos)
+      || (report.find("Database 'administrator'") != string::npos)
+      || (report.find("exec_proc") == string::npos))
+    {
+      goto test_procedure_stats_fail;
+    }
+
+  //Other tests may have called it before, so its count is at least ours.
+  linePos = report.find(procName);
+  if ((linePos == string::npos)
+      || (strtoul(report.c_str() + linePos + strlen(procName), nullptr, 10) < CALLS_COUNT))
+    {
+      goto test_procedure_stats_fail;
+    }
+
+  cout << "OK\n";
+  return true;
+
+test_procedure_stats_fail:
+  cout << "FAIL\n";
+  return false;
+}
+
+
+static bool
+fetch_profile(WH_CONNECTION hnd, const char* const procedure, string& outProfile)
+{
+  const char* text = nullptr;
+  uint_t profileSize = 0;
+
+  outProfile.clear();
+  do
+    {
+      if ((WFetchProcProfile(hnd, procedure, outProfile.size(), &text, &profileSize) != WCS_OK)
+          || (strlen(text) == 0))
+        {
+          return false;
+        }
+
+      outProfile += text;
+    }
+  while (outProfile.size() < profileSize);
+
+  return outProfile.size() == profileSize;
+}
+
+
+static bool
+test_procedure_profile(WH_CONNECTION hnd)
+{
+  const char* text = nullptr;
+  const string header = string("procedure ") + procName + "\ncalls ";
+  string profile;
+
+  cout << "Testing the procedures profile ... ";
+
+  //Its database profiles the procedures, so it has seen our calls too.
+  if ( ! fetch_profile(hnd, procName, profile)
+      || (profile.compare(0, header.size(), header) != 0)
+      || (strtoul(profile.c_str() + header.size(), nullptr, 10) < CALLS_COUNT)
+      || (profile.find("\npc ") == string::npos))
+    {
+      goto test_procedure_profile_fail;
+    }
+
+  //All the called procedures are sent when none is named.
+  if ( ! fetch_profile(hnd, nullptr, profile)
+      || (profile.find(header) == string::npos))
+    {
+      goto test_procedure_profile_fail;
+    }
+
+  if (WFetchProcProfile(hnd, "no_such_procedure", 0, &text, nullptr) != WCS_PROC_NOTFOUND)
+    goto test_procedure_profile_fail;
+
+  cout << "OK\n";
+  return true;
+
+test_procedure_profile_fail:
+  cout << "FAIL\n";
+  return false;
+}
+
+
+static bool
+test_for_errors(WH_CONNECTION hnd)
+{
+  const char* text = nullptr;
+  uint_t reportSize = 0;
+
+  cout << "Testing against error conditions ... ";
+
+  if ((WFetchServerStats(nullptr, 0, &text, &reportSize) != WCS_INVALID_ARGS)
+      || (WFetchServerStats(hnd, 0, nullptr, &reportSize) != WCS_INVALID_ARGS))
+    {
+      goto test_for_errors_fail;
+    }
+  else if ((WFetchServerStats(hnd, 0, &text, &reportSize) != WCS_OK)
+           || (WFetchServerStats(hnd, reportSize + 1, &text, nullptr) != WCS_INVALID_ARGS))
+    {
+      goto test_for_errors_fail;
+    }
+
+  cout << "OK\n";
+  return true;
+
+test_for_errors_fail:
+  cout << "FAIL\n";
+  return false;
+}
+
+
+const char*
+DefaultDatabaseName()
+{
+  return "test_list_db";
+}
+
+const uint_t
+DefaultUserId()
+{
+  return 0;
+}
+
+const char*
+DefaultUserPassword()
+{
+  return "root_test_password";
+}
+
+int
+main(int argc, const char** argv)
+{
+  WH_CONNECTION       hnd = nullptr;
+
+  bool success = tc_settup_connection(argc, argv, &hnd);
+
+  success = success && test_for_errors(hnd);
+  success = success && test_procedure_stats(hnd);
+  success = success && test_procedure_profile(hnd);
+
+  WClose(hnd);
+
+  if (!success)
+    {
+      cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+
+  cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <cstdio>
 
@@ -625,6 +626,156 @@ cmd_greet_exit:
 }
 
 
+static const char statsShowDesc[]    = "Show the database server's statistics.";
+static const char statsShowDescExt[] =
+  "Show the latencies of the commands and procedures served so far, along\n"
+  "with the usage of the procedures' sync statements and of the tables'\n"
+  "caches, indexes, files and locks. The statistics of all databases are\n"
+  "shown only to the administrator of the global context.\n"
+  "Usage:\n"
+  "  stats";
+
+
+static bool
+cmdStats(const string& cmdLine, ENTRY_CMD_CONTEXT context)
+{
+  const char*   text       = nullptr;
+  uint_t        reportSize = 0;
+  uint_t        offset     = 0;
+  WH_CONNECTION conHdl     = nullptr;
+  uint32_t      cs         = WConnect(GetRemoteHostName().c_str(),
+                                       GetConnectionPort().c_str(),
+                                       GetWorkingDB().c_str(),
+                                       GetUserPassword().c_str(),
+                                       GetUserId(),
+                                       DEFAULT_FRAME_SIZE,
+                                       &conHdl);
+  if (cs != WCS_OK)
+    goto cmd_stats_exit;
+
+  do
+  {
+    cs = WFetchServerStats(conHdl, offset, &text, &reportSize);
+    if (cs != WCS_OK)
+      break;
+
+    cout << text;
+    offset += strlen(text);
+  }
+  while (offset < reportSize);
+
+  cout << endl;
+
+cmd_stats_exit:
+  WClose(conHdl);
+
+  if (cs != WCS_OK)
+    {
+      cout << wcmd_translate_status(cs) << endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+static const char profileShowDesc[]    = "Show the profile of the procedures' calls.";
+static const char profileShowDescExt[] =
+  "Show where the calls of a procedure have spent their time, measured while\n"
+  "the 'profile_procedures' option of its database is set. If no name is\n"
+  "provided all the called procedures are shown. The profile could be saved\n"
+  "into a file, for the objects dumper to show it along the procedures' code.\n"
+  "Usage:\n"
+  "  profile [procedure_name] [-o file_name]";
+
+
+static bool
+cmdProfile(const string& cmdLine, ENTRY_CMD_CONTEXT context)
+{
+  size_t        linePos     = 0;
+  string        token       = CmdLineNextToken(cmdLine, linePos);
+  string        procedure;
+  string        fileName;
+  string        profile;
+  const char*   text        = nullptr;
+  uint_t        profileSize = 0;
+  WH_CONNECTION conHdl      = nullptr;
+  uint32_t      cs          = WCS_OK;
+
+  assert(token == "profile");
+
+  while (linePos <= cmdLine.length())
+    {
+      token = CmdLineNextToken(cmdLine, linePos);
+      if (token.length() == 0)
+        break;
+
+      else if (token == "-o")
+        {
+          fileName = CmdLineNextToken(cmdLine, linePos);
+          if (fileName.length() == 0)
+            {
+              cout << "The output file name is missing.\n";
+              return false;
+            }
+        }
+      else if (procedure.length() == 0)
+        procedure = token;
+
+      else
+        {
+          cout << "Unexpected argument '" << token << "'.\n";
+          return false;
+        }
+    }
+
+  cs = WConnect(GetRemoteHostName().c_str(),
+                GetConnectionPort().c_str(),
+                GetWorkingDB().c_str(),
+                GetUserPassword().c_str(),
+                GetUserId(),
+                DEFAULT_FRAME_SIZE,
+                &conHdl);
+  if (cs != WCS_OK)
+    goto cmd_profile_exit;
+
+  do
+  {
+    cs = WFetchProcProfile(conHdl, procedure.c_str(), profile.length(), &text, &profileSize);
+    if (cs != WCS_OK)
+      break;
+
+    profile += text;
+  }
+  while (profile.length() < profileSize);
+
+cmd_profile_exit:
+  WClose(conHdl);
+
+  if (cs != WCS_OK)
+    {
+      cout << wcmd_translate_status(cs) << endl;
+      return false;
+    }
+
+  if (fileName.length() == 0)
+    {
+      cout << profile << endl;
+      return true;
+    }
+
+  ofstream out(fileName.c_str());
+  out << profile;
+  if ( ! out.good())
+    {
+      cout << "Failed to write the profile to '" << fileName << "'.\n";
+      return false;
+    }
+
+  return true;
+}
+
+
 
 static const char execShowDesc[]    = "Execute a procedure. ";
 static const char execShowDescExt[] =
@@ -716,6 +867,22 @@ AddOnlineTableCommands()
 
   RegisterCommand(entry);
 
+  entry.mShowStatus   = true;
+  entry.mName         = "stats";
+  entry.mDesc         = statsShowDesc;
+  entry.mExtendedDesc = statsShowDescExt;
+  entry.mCmd          = cmdStats;
+
+  RegisterCommand(entry);
+
+  entry.mShowStatus   = true;
+  entry.mName         = "profile";
+  entry.mDesc         = profileShowDesc;
+  entry.mExtendedDesc = profileShowDescExt;
+  entry.mCmd          = cmdProfile;
+
+  RegisterCommand(entry);
+
   entry.mShowStatus   = true;
   entry.mName         = "exec";
   entry.mDesc         = execShowDesc;
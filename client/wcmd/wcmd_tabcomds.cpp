@@ -119,10 +119,13 @@ static const char tableAddIndDesc[]    = "Index the specified field tables.";
 static const char tableAddIndDescExt[] =
   "Index the values of the specified table fields for faster searching.\n"
   "Currently it does not support to index array nor text field types.\n"
+  "With '--hash' the values are hashed instead of being kept in order, and\n"
+  "the index helps only the searches of single values.\n"
   "Usage:\n"
-  "  index table_name field_name [second_field_name ...]\n"
+  "  index [--hash] table_name field_name [second_field_name ...]\n"
   "Example:\n"
-  "  index mytab password_hash";
+  "  index mytab password_hash\n"
+  "  index --hash mytab user_id";
 
 static const char tableRmIndDesc[]    = "Remove the index associated with some"
                                         " table fields.";
@@ -309,15 +312,18 @@ print_field_desc(const DBSFieldDescriptor& desc,
 static void
 print_field_desc(const DBSFieldDescriptor& desc,
                   const uint_t              longestField,
-                  const bool                indexed)
+                  const INDEX_KIND          indexKind)
 {
   cout << left << setw(longestField) << desc.name << setw(0) << " : ";
 
   print_field_desc(desc, cout);
 
-  if (indexed)
+  if (indexKind == INDEX_BTREE)
     cout << " (indexed)";
 
+  else if (indexKind == INDEX_HASH)
+    cout << " (hash indexed)";
+
   cout << endl;
 }
 
@@ -476,7 +482,7 @@ cmdTableAdd(const string& cmdLine, ENTRY_CMD_CONTEXT context)
       if (level >= VL_INFO)
         {
           cout << " ... ";
-          print_field_desc(desc, 0, false);
+          print_field_desc(desc, 0, INDEX_NONE);
         }
 
       assert(fields.size() == fieldsNames.size());
@@ -726,7 +732,7 @@ cmdTablePrint(const string& cmdLine, ENTRY_CMD_CONTEXT context)
               {
                 DBSFieldDescriptor desc = table.DescribeField(index);
 
-                print_field_desc(desc, longestField, table.IsIndexed(index));
+                print_field_desc(desc, longestField, table.IndexKind(index));
               }
 
             dbs.ReleaseTable(table);
@@ -772,6 +778,7 @@ cmdTableAddIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
   string               token   = CmdLineNextToken(cmdLine, linePos);
   const  VERBOSE_LEVEL level   = GetVerbosityLevel();
   ITable*              table   = nullptr;
+  INDEX_KIND           kind    = INDEX_BTREE;
   bool                 result  = true;
 
   assert(token == "index");
@@ -782,6 +789,15 @@ cmdTableAddIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
   try
   {
     token = CmdLineNextToken(cmdLine, linePos);
+    if (token == "--hash")
+      {
+        if (linePos >= cmdLine.length())
+          goto invalid_args;
+
+        kind  = INDEX_HASH;
+        token = CmdLineNextToken(cmdLine, linePos);
+      }
+
     table = &dbs.RetrievePersistentTable(token.c_str());
   }
   catch(const Exception& e)
@@ -812,12 +828,12 @@ cmdTableAddIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
               {
                 CreateIndexCallbackContext context;
 
-                table->CreateIndex(field, create_index_call_back, &context);
+                table->CreateIndex(field, create_index_call_back, &context, kind);
 
                 cout << endl;
               }
             else
-              table->CreateIndex(field, nullptr, nullptr);
+              table->CreateIndex(field, nullptr, nullptr, kind);
           }
       }
       catch(const Exception& e)
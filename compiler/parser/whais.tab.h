@@ -0,0 +1,137 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_COMPILER_PARSER_WHAIS_TAB_H_INCLUDED
+# define YY_YY_COMPILER_PARSER_WHAIS_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    ARRAY = 258,                   /* ARRAY  */
+    BOOL = 259,                    /* BOOL  */
+    BREAK = 260,                   /* BREAK  */
+    CHAR = 261,                    /* CHAR  */
+    CONTINUE = 262,                /* CONTINUE  */
+    DATE = 263,                    /* DATE  */
+    DATETIME = 264,                /* DATETIME  */
+    DO = 265,                      /* DO  */
+    ELSE = 266,                    /* ELSE  */
+    END = 267,                     /* END  */
+    ENDPROC = 268,                 /* ENDPROC  */
+    ENDSYNC = 269,                 /* ENDSYNC  */
+    EXTERN = 270,                  /* EXTERN  */
+    FIELD = 271,                   /* FIELD  */
+    FOR = 272,                     /* FOR  */
+    HIRESTIME = 273,               /* HIRESTIME  */
+    IF = 274,                      /* IF  */
+    INT8 = 275,                    /* INT8  */
+    INT16 = 276,                   /* INT16  */
+    INT32 = 277,                   /* INT32  */
+    INT64 = 278,                   /* INT64  */
+    PROCEDURE = 279,               /* PROCEDURE  */
+    REAL = 280,                    /* REAL  */
+    RETURN = 281,                  /* RETURN  */
+    RICHREAL = 282,                /* RICHREAL  */
+    SYNC = 283,                    /* SYNC  */
+    TABLE = 284,                   /* TABLE  */
+    TEXT = 285,                    /* TEXT  */
+    UINT8 = 286,                   /* UINT8  */
+    UINT16 = 287,                  /* UINT16  */
+    UINT32 = 288,                  /* UINT32  */
+    UINT64 = 289,                  /* UINT64  */
+    UNDEFINED = 290,               /* UNDEFINED  */
+    UNTIL = 291,                   /* UNTIL  */
+    VAR = 292,                     /* VAR  */
+    WHILE = 293,                   /* WHILE  */
+    WHAIS_NULL = 294,              /* WHAIS_NULL  */
+    W_FALSE = 295,                 /* W_FALSE  */
+    W_TRUE = 296,                  /* W_TRUE  */
+    IDENTIFIER = 297,              /* IDENTIFIER  */
+    WHAIS_INTEGER = 298,           /* WHAIS_INTEGER  */
+    WHAIS_REAL = 299,              /* WHAIS_REAL  */
+    WHAIS_TEXT = 300,              /* WHAIS_TEXT  */
+    WHAIS_CHAR = 301,              /* WHAIS_CHAR  */
+    WHAIS_TIME = 302,              /* WHAIS_TIME  */
+    SADD = 303,                    /* SADD  */
+    SSUB = 304,                    /* SSUB  */
+    SMUL = 305,                    /* SMUL  */
+    SDIV = 306,                    /* SDIV  */
+    SMOD = 307,                    /* SMOD  */
+    SAND = 308,                    /* SAND  */
+    SXOR = 309,                    /* SXOR  */
+    SOR = 310,                     /* SOR  */
+    EQ = 311,                      /* EQ  */
+    NE = 312,                      /* NE  */
+    AND = 313,                     /* AND  */
+    OR = 314,                      /* OR  */
+    XOR = 315,                     /* XOR  */
+    LE = 316,                      /* LE  */
+    GE = 317,                      /* GE  */
+    NOT = 318,                     /* NOT  */
+    UMINUS = 319,                  /* UMINUS  */
+    FSELECT = 320                  /* FSELECT  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+typedef int YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yyparse (struct ParserState *state);
+
+
+#endif /* !YY_YY_COMPILER_PARSER_WHAIS_TAB_H_INCLUDED  */
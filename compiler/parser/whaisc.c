@@ -158,7 +158,8 @@ wh_unit_procedure(const WH_COMPILED_UNIT        hnd,
   outDescription->nameLength  = stmt->spec.proc.nameLength;
   outDescription->paramsCount = wh_array_count(&(stmt->spec.proc.paramsList)) - 1;
   outDescription->localsCount = stmt->localsUsed;
-  outDescription->syncsCount  = stmt->spec.proc.syncTracker;
+  /* The tracker counts both the begin and the end of every statement. */
+  outDescription->syncsCount  = stmt->spec.proc.syncTracker / 2;
   outDescription->codeSize    = wh_ostream_size(&(stmt->spec.proc.code));
   outDescription->code        = wh_ostream_data(&(stmt->spec.proc.code));
 
@@ -49,6 +49,7 @@ CmdLineParser::CmdLineParser(int argc, char ** argv)
   : mArgCount(argc),
     mArgs(argv),
     mSourceFile(nullptr),
+    mProfileFile(nullptr),
     mOutStream(&cout),
     mShowHelp(false),
     mShowLogo(false),
@@ -100,6 +101,17 @@ CmdLineParser::Parse()
       else
         mOutStream = new ofstream(mArgs[index++]);
     }
+    else if (areStrsEqual(mArgs[index], "-p"))
+    {
+      if (mProfileFile != nullptr)
+        throw CmdLineException(_EXTRA(0), "The profile file '-p' is specified multiple times.");
+
+      if ((++index >= mArgCount) || (mArgs[index][0] == '-'))
+        throw CmdLineException(_EXTRA(0), "Missing parameter for argument '-p'.");
+
+      else
+        mProfileFile = mArgs[index++];
+    }
     else if ((mArgs[index][0] != '-') && (mArgs[index][0] != '\\'))
     {
       if ((void *) mSourceFile != nullptr)
@@ -148,6 +160,7 @@ CmdLineParser::DisplayUsage() const
     "Options:\n"
     "-h, --help      Display this help.\n"
     "-o file         Use 'file' as the output file.\n"
+    "-p file         Show the procedures' profile saved in 'file' along their code.\n"
     "-v, --version   Display the program's version.\n"
     "-l, --license   Display the license information.\n";
 }
@@ -44,6 +44,7 @@ public:
 
   auto SourceFile() const { return mSourceFile; }
   auto& OutStream() const { return *mOutStream; }
+  auto ProfileFile() const { return mProfileFile; }
 
 private:
   void Parse();
@@ -54,6 +55,7 @@ private:
   int            mArgCount;
   char**         mArgs;
   const char    *mSourceFile;
+  const char    *mProfileFile;
   std::ostream  *mOutStream;
   bool           mShowHelp;
   bool           mShowLogo;
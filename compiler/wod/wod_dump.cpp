@@ -23,7 +23,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
 #include <assert.h>
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <string.h>
 
 #include "utils/endianness.h"
@@ -41,6 +43,71 @@ namespace wod {
 static const uint_t HEADER_FIELD_LENGTH     = 32;
 static const uint_t HEADER_SEPARATOR_LENGTH = 80;
 
+void
+wod_load_profiles(const char* const fileName, PROC_PROFILES& outProfiles)
+{
+  ifstream input(fileName);
+  if ( ! input.is_open())
+    throw DumpException(_EXTRA(0), "Cannot open the profile file '%s'.", fileName);
+
+  ProcProfile* profile = nullptr;
+  uint_t lineNo = 0;
+  string line;
+
+  while (getline(input, line))
+  {
+    istringstream entry(line);
+    string key;
+
+    ++lineNo;
+    if ( ! (entry >> key))
+      continue;
+
+    bool valid = true;
+    if (key == "procedure")
+    {
+      string name;
+
+      valid = _SC(bool, entry >> name);
+      profile = &outProfiles[name];
+      *profile = ProcProfile();
+    }
+    else if ((key == "calls") && (profile != nullptr))
+    {
+      string inclusive, exclusive, native, tables;
+
+      valid = (entry >> profile->mCallsCount
+                     >> inclusive >> profile->mInclusiveTime
+                     >> exclusive >> profile->mExclusiveTime
+                     >> native >> profile->mNativeTime
+                     >> tables >> profile->mTablesTime)
+              && (inclusive == "inclusive")
+              && (exclusive == "exclusive")
+              && (native == "native")
+              && (tables == "tables");
+    }
+    else if ((key == "pc") && (profile != nullptr))
+    {
+      uint_t offset;
+      uint64_t hits, usecs;
+
+      valid = _SC(bool, entry >> offset >> hits >> usecs);
+      profile->mInstructions[offset] = make_pair(hits, usecs);
+    }
+    else
+      valid = false;
+
+    if ( ! valid)
+    {
+      throw DumpException(_EXTRA(0),
+                          "The profile file '%s' has an invalid entry at line %u.",
+                          fileName,
+                          lineNo);
+    }
+  }
+}
+
+
 void
 wod_dump_header(File& obj, ostream& output)
 {
@@ -400,16 +467,32 @@ wod_dump_globals_tables(WIFunctionalUnit& obj, ostream& output)
 
 
 static void
-wod_dump_code(const uint8_t  *code,
-              const uint_t    codeSize,
-              ostream&        output,
-              const char*     prefix)
+wod_dump_code(const uint8_t           *code,
+              const uint_t             codeSize,
+              ostream&                 output,
+              const char*              prefix,
+              const ProcProfile* const profile)
 {
   static char conv[] = "0123456789ABCDEF";
   uint_t currPos = 0;
 
   while (currPos < codeSize)
   {
+    //The instruction's hits and time (in microseconds) lead its line.
+    if (profile != nullptr)
+    {
+      const auto it = profile->mInstructions.find(currPos);
+
+      output << dec << right << setfill(' ');
+      if (it != profile->mInstructions.end())
+        output << setw(10) << it->second.first << setw(10) << it->second.second << ' ';
+
+      else
+        output << setw(21) << ' ';
+
+      output << hex << left;
+    }
+
     if (prefix != nullptr)
     {
       output << prefix << "+";
@@ -450,7 +533,10 @@ wod_dump_code(const uint8_t  *code,
 
 
 void
-wod_dump_procs(WIFunctionalUnit& obj, ostream& output, bool_t showCode)
+wod_dump_procs(WIFunctionalUnit&            obj,
+               ostream&                     output,
+               bool_t                       showCode,
+               const PROC_PROFILES* const   profiles)
 {
 
   output << endl << endl << setw(HEADER_SEPARATOR_LENGTH) << setfill('*')
@@ -490,14 +576,36 @@ wod_dump_procs(WIFunctionalUnit& obj, ostream& output, bool_t showCode)
       output << endl;
     }
 
+    const ProcProfile* profile = nullptr;
+    if (profiles != nullptr)
+    {
+      const auto it = profiles->find(obj.RetriveProcName(proc));
+      if (it != profiles->end())
+        profile = &it->second;
+    }
+
+    if (profile != nullptr)
+    {
+      output << endl << dec
+             << "Profile: " << profile->mCallsCount << " calls, "
+             << profile->mInclusiveTime << "us inclusive, "
+             << profile->mExclusiveTime << "us exclusive, "
+             << profile->mNativeTime << "us native, "
+             << profile->mTablesTime << "us tables" << hex << endl;
+    }
+
     if (!externalProc)
     {
       output << endl << "Code:" << endl;
 
+      if (profile != nullptr)
+        output << right << setfill(' ') << setw(10) << "hits" << setw(10) << "time" << left << endl;
+
       wod_dump_code(obj.RetriveProcCodeArea(proc),
                     obj.ProcCodeAreaSize(proc),
                     output,
-                    obj.RetriveProcName(proc));
+                    obj.RetriveProcName(proc),
+                    profile);
     }
     output << endl << endl;
   }
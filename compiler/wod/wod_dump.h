@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define WOD_DUMP_H_
 
 #include <iostream>
+#include <map>
+#include <string>
 
 #include "whais.h"
 #include "compiler/wopcodes.h"
@@ -78,6 +80,25 @@ typedef uint_t(*FDECODE_OPCODE) (const uint8_t  *args,
 extern FDECODE_OPCODE   wod_decode_table[];
 extern const char*      wod_str_table[];
 
+//A procedure's profile, as it was saved from the server.
+struct ProcProfile
+{
+  uint64_t mCallsCount;
+  uint64_t mInclusiveTime;
+  uint64_t mExclusiveTime;
+  uint64_t mNativeTime;
+  uint64_t mTablesTime;
+
+  //The hits and the time of the executed instructions, by their offsets.
+  std::map<uint_t, std::pair<uint64_t, uint64_t>> mInstructions;
+};
+
+typedef std::map<std::string, ProcProfile> PROC_PROFILES;
+
+
+void
+wod_load_profiles(const char* const fileName, PROC_PROFILES& outProfiles);
+
 void
 wod_dump_header(File& obj, std::ostream& output);
 
@@ -88,9 +109,10 @@ void
 wod_dump_globals_tables(WIFunctionalUnit& unit, std::ostream& output);
 
 void
-wod_dump_procs(WIFunctionalUnit&   unit,
-               std::ostream&       output,
-               bool_t              showCode);
+wod_dump_procs(WIFunctionalUnit&             unit,
+               std::ostream&                 output,
+               bool_t                        showCode,
+               const PROC_PROFILES* const    profiles = nullptr);
 
 
 } //namespace wod
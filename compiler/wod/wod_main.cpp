@@ -55,7 +55,15 @@ main(int argc, char **argv)
 
     wod_dump_const_area(inUnit, cmdLine.OutStream());
     wod_dump_globals_tables(inUnit, cmdLine.OutStream());
-    wod_dump_procs(inUnit, cmdLine.OutStream(), false);
+    if (cmdLine.ProfileFile() != nullptr)
+    {
+      PROC_PROFILES profiles;
+
+      wod_load_profiles(cmdLine.ProfileFile(), profiles);
+      wod_dump_procs(inUnit, cmdLine.OutStream(), false, &profiles);
+    }
+    else
+      wod_dump_procs(inUnit, cmdLine.OutStream(), false);
 
   }
   catch (FunctionalUnitException& e)
@@ -93,6 +93,44 @@ File::Write(const uint8_t* pBuffer, uint_t size)
 }
 
 
+void
+File::Read(const uint64_t offset, uint8_t* pBuffer, uint_t size) const
+{
+  if ( !whf_pread(mHandle, offset, pBuffer, size))
+    throw FileException(_EXTRA(whf_last_error()), "Failed to read file(%d) content.", mHandle);
+}
+
+
+void
+File::Write(const uint64_t offset, const uint8_t* pBuffer, uint_t size)
+{
+  if ( !whf_pwrite(mHandle, offset, pBuffer, size))
+    throw FileException(_EXTRA(whf_last_error()), "Failed to update file(%d).", mHandle);
+
+  if ((mFileSize != UNKNOWN_SIZE) && (mFileSize < offset + size))
+    mFileSize = offset + size;
+}
+
+
+void
+File::Write(const uint64_t offset, const WIOVec* vecs, uint_t vecsCount)
+{
+  if ( !whf_pwritev(mHandle, offset, vecs, vecsCount))
+    throw FileException(_EXTRA(whf_last_error()), "Failed to update file(%d).", mHandle);
+
+  if (mFileSize != UNKNOWN_SIZE)
+  {
+    uint64_t endOffset = offset;
+
+    while (vecsCount-- > 0)
+      endOffset += vecs++->size;
+
+    if (mFileSize < endOffset)
+      mFileSize = endOffset;
+  }
+}
+
+
 void
 File::Seek(const int64_t where, const int whence)
 {
@@ -161,6 +199,13 @@ File::Close()
 }
 
 
+uint8_t*
+File::Map(const uint64_t offset, const uint64_t size)
+{
+  return _RC(uint8_t*, whf_map(mHandle, offset, size));
+}
+
+
 File&
 File::operator= (File&& src)
 {
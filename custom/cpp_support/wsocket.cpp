@@ -159,6 +159,22 @@ Socket::Read(uint8_t* const buffer, const uint_t maxCount)
 }
 
 
+uint_t
+Socket::ReadPending(uint8_t* const buffer, const uint_t maxCount)
+{
+  if (mSocket == INVALID_SOCKET)
+    throw SocketException(_EXTRA(WOP_UNKNOW), "Invalid socket used to read.");
+
+  uint_t result = maxCount;
+  const uint32_t e = whs_read_nowait(mSocket, buffer, &result);
+
+  if (e != WOP_OK)
+    throw SocketException(_EXTRA(e), "Failed to read from socket(%d).", mSocket);
+
+  return result;
+}
+
+
 void
 Socket::Write(const uint8_t* const buffer, const uint_t count)
 {
@@ -172,6 +188,14 @@ Socket::Write(const uint8_t* const buffer, const uint_t count)
 }
 
 
+void
+Socket::Shutdown()
+{
+  if (mSocket != INVALID_SOCKET)
+    whs_shutdown(mSocket);
+}
+
+
 void
 Socket::Close()
 {
@@ -182,5 +206,62 @@ Socket::Close()
   mSocket = INVALID_SOCKET;
 }
 
+
+
+SocketPoller::SocketPoller()
+{
+  const uint32_t e = whs_poller_create(&mPoller);
+
+  if (e != WOP_OK)
+    throw SocketException(_EXTRA(e), "Failed to create a sockets poller.");
+}
+
+
+SocketPoller::~SocketPoller()
+{
+  whs_poller_close(mPoller);
+}
+
+
+void
+SocketPoller::Add(const Socket& socket, const uint_t events, void* const data)
+{
+  const uint32_t e = whs_poller_add(mPoller, socket.mSocket, events, data);
+
+  if (e != WOP_OK)
+    throw SocketException(_EXTRA(e), "Failed to poll socket(%d).", socket.mSocket);
+}
+
+
+void
+SocketPoller::Rearm(const Socket& socket, const uint_t events, void* const data)
+{
+  const uint32_t e = whs_poller_rearm(mPoller, socket.mSocket, events, data);
+
+  if (e != WOP_OK)
+    throw SocketException(_EXTRA(e), "Failed to poll again socket(%d).", socket.mSocket);
+}
+
+
+void
+SocketPoller::Remove(const Socket& socket)
+{
+  if (socket.mSocket != INVALID_SOCKET)
+    whs_poller_remove(mPoller, socket.mSocket);
+}
+
+
+void*
+SocketPoller::Wait(const uint_t timeoutMsec)
+{
+  void* result = nullptr;
+  const uint32_t e = whs_poller_wait(mPoller, timeoutMsec, &result);
+
+  if (e != WOP_OK)
+    throw SocketException(_EXTRA(e), "Failed to wait for sockets events.");
+
+  return result;
+}
+
 } //namespace whais
 
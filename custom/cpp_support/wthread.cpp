@@ -99,6 +99,230 @@ Lock::unlock()
 
 
 
+RWLock::RWLock()
+{
+  const uint_t result = wh_rwlock_init(&mLock);
+
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to initialize a reader/writer lock.");
+  }
+}
+
+
+RWLock::~RWLock()
+{
+  const uint_t result = wh_rwlock_destroy(&mLock);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+RWLock::lock()
+{
+  const uint_t result = wh_rwlock_acquire(&mLock, FALSE);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to acquire a reader/writer lock.");
+  }
+}
+
+
+bool
+RWLock::try_lock()
+{
+  bool_t acquired;
+
+  const uint_t result = wh_rwlock_try_acquire(&mLock, FALSE, &acquired);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to try to acquire a reader/writer lock.");
+  }
+
+  return acquired != FALSE;
+}
+
+
+void
+RWLock::unlock()
+{
+  const uint_t result = wh_rwlock_release(&mLock, FALSE);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+RWLock::lock_shared()
+{
+  const uint_t result = wh_rwlock_acquire(&mLock, TRUE);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to acquire a shared lock.");
+  }
+}
+
+
+bool
+RWLock::try_lock_shared()
+{
+  bool_t acquired;
+
+  const uint_t result = wh_rwlock_try_acquire(&mLock, TRUE, &acquired);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to try to acquire a shared lock.");
+  }
+
+  return acquired != FALSE;
+}
+
+
+void
+RWLock::unlock_shared()
+{
+  const uint_t result = wh_rwlock_release(&mLock, TRUE);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+
+
+MeteredLock::MeteredLock()
+  : mWaits(0),
+    mWaitTime(0)
+{
+}
+
+
+void
+MeteredLock::lock()
+{
+  if (try_lock())
+    return;
+
+  const WTICKS waitStart = wh_usec_ticks();
+
+  Lock::lock();
+
+  wh_atomic_fetch_inc64(&mWaits);
+  wh_atomic_fetch_add64(&mWaitTime, wh_usec_ticks() - waitStart);
+}
+
+
+
+
+MeteredRWLock::MeteredRWLock()
+  : mWaits(0),
+    mWaitTime(0)
+{
+}
+
+
+void
+MeteredRWLock::lock()
+{
+  if (try_lock())
+    return;
+
+  const WTICKS waitStart = wh_usec_ticks();
+
+  RWLock::lock();
+
+  wh_atomic_fetch_inc64(&mWaits);
+  wh_atomic_fetch_add64(&mWaitTime, wh_usec_ticks() - waitStart);
+}
+
+
+void
+MeteredRWLock::lock_shared()
+{
+  if (try_lock_shared())
+    return;
+
+  const WTICKS waitStart = wh_usec_ticks();
+
+  RWLock::lock_shared();
+
+  wh_atomic_fetch_inc64(&mWaits);
+  wh_atomic_fetch_add64(&mWaitTime, wh_usec_ticks() - waitStart);
+}
+
+
+
+
+Condition::Condition()
+{
+  const uint_t result = wh_cond_init(&mCond);
+
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to initialize a condition variable.");
+  }
+}
+
+
+Condition::~Condition()
+{
+  const uint_t result = wh_cond_destroy(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+Condition::wait(Lock& lock)
+{
+  const uint_t result = wh_cond_wait(&mCond, &lock.mLock);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to wait on a condition variable.");
+  }
+}
+
+
+void
+Condition::notify_one()
+{
+  const uint_t result = wh_cond_signal(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+Condition::notify_all()
+{
+  const uint_t result = wh_cond_broadcast(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+
+
 SpinLock::SpinLock()
   : mLock(0)
 {
@@ -27,6 +27,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <unistd.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <limits.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -177,6 +180,139 @@ whf_write(WH_FILE hnd, const uint8_t* srcBuffer, uint_t size)
 }
 
 
+bool_t
+whf_pread(WH_FILE hnd, uint64_t offset, uint8_t* dstBuffer, uint_t size)
+{
+  bool_t result      = TRUE;
+  uint_t actualCount = 0;
+
+  while (actualCount < size)
+    {
+      const ssize_t count = pread64(hnd,
+                                    dstBuffer + actualCount,
+                                    size - actualCount,
+                                    offset + actualCount);
+      if (count < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          /* the errno is already set for this */
+          result = FALSE;
+
+          break;
+        }
+      else if (count == 0)
+        {
+          /* Same as whf_read(), reading past the end of file is an error. */
+          errno  = ENODATA;
+          result = FALSE;
+
+          break;
+        }
+      actualCount += count;
+    }
+
+  assert((result == TRUE) || (actualCount < size));
+  assert((result == FALSE) || (size == actualCount));
+
+  return result;
+}
+
+
+bool_t
+whf_pwrite(WH_FILE hnd, uint64_t offset, const uint8_t* srcBuffer, uint_t size)
+{
+  bool_t result      = TRUE;
+  uint_t actualCount = 0;
+
+  while (actualCount < size)
+    {
+      const ssize_t count = pwrite64(hnd,
+                                     srcBuffer + actualCount,
+                                     size - actualCount,
+                                     offset + actualCount);
+      if (count < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          /* the errno is already set for this */
+          result = FALSE;
+          break;
+        }
+      actualCount += count;
+    }
+
+  assert((result == TRUE) || (actualCount < size));
+  assert((result == FALSE) || (size == actualCount));
+
+  return result;
+}
+
+
+bool_t
+whf_pwritev(WH_FILE hnd, uint64_t offset, const WIOVec* vecs, uint_t vecsCount)
+{
+  struct iovec iov[64];
+  uint_t       skip = 0; /* Bytes of the first buffer already written. */
+
+  while (TRUE)
+    {
+      uint_t  count = 0;
+      ssize_t written;
+
+      while ((vecsCount > 0) && (vecs->size == skip))
+        {
+          ++vecs, --vecsCount;
+          skip = 0;
+        }
+
+      if (vecsCount == 0)
+        break;
+
+      while ((count < vecsCount) && (count < sizeof iov / sizeof iov[0]))
+        {
+          iov[count].iov_base = (void*)(vecs[count].buffer + (count ? 0 : skip));
+          iov[count].iov_len  = vecs[count].size - (count ? 0 : skip);
+
+          ++count;
+        }
+
+      written = pwritev64(hnd, iov, count, offset);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          /* the errno is already set for this */
+          return FALSE;
+        }
+
+      /* The write may have been a short one. */
+      offset += written;
+      while (written > 0)
+        {
+          const uint_t left = vecs->size - skip;
+
+          if ((size_t)written < left)
+            {
+              skip   += written;
+              written = 0;
+            }
+          else
+            {
+              written -= left;
+              skip     = 0;
+              ++vecs, --vecsCount;
+            }
+        }
+    }
+
+  return TRUE;
+}
+
+
 bool_t
 whf_tell(WH_FILE hnd, uint64_t* const outPosition)
 {
@@ -223,6 +359,34 @@ whf_close(WH_FILE hnd)
 }
 
 
+void*
+whf_map(WH_FILE hnd, uint64_t offset, uint64_t size)
+{
+  void* const result = mmap64(NULL,
+                              size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED,
+                              hnd,
+                              offset);
+
+  return (result == MAP_FAILED) ? NULL : result;
+}
+
+
+bool_t
+whf_sync_map(void* address, uint64_t size)
+{
+  return msync(address, size, MS_SYNC) == 0;
+}
+
+
+bool_t
+whf_unmap(void* address, uint64_t size)
+{
+  return munmap(address, size) == 0;
+}
+
+
 uint32_t
 whf_last_error()
 {
@@ -262,10 +426,13 @@ whf_remove(const char* const file)
 }
 
 
-void
+bool_t
 whf_move_file(const char* existingFile, const char* newFile )
 {
-  rename(existingFile, newFile);
+  if (rename(existingFile, newFile) == 0)
+    return TRUE;
+
+  return FALSE;
 }
 
 const char
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netdb.h>
 #include <netinet/tcp.h>
 #include <unistd.h>
@@ -240,6 +241,44 @@ whs_read(const WH_SOCKET     sd,
 }
 
 
+uint32_t
+whs_read_nowait(const WH_SOCKET    sd,
+                uint8_t*           dstBuffer,
+                uint_t* const      inoutCount)
+{
+  if (*inoutCount == 0)
+    return EINVAL;
+
+  ssize_t chunk;
+  do
+    chunk = recv(sd, dstBuffer, *inoutCount, MSG_DONTWAIT);
+  while ((chunk < 0) && (errno == EINTR));
+
+  if (chunk < 0)
+    {
+      if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        return errno;
+
+      chunk = 0;
+    }
+  else if (chunk == 0)
+    return ECONNRESET;
+
+  assert(chunk <= *inoutCount);
+
+  *inoutCount = chunk;
+
+  return WOP_OK;
+}
+
+
+void
+whs_shutdown(const WH_SOCKET sd)
+{
+  shutdown(sd, SHUT_RDWR);
+}
+
+
 void
 whs_close(const WH_SOCKET sd)
 {
@@ -253,3 +292,106 @@ whs_clean()
 {
 }
 
+
+static uint32_t
+poller_ctl(const WH_POLLER    poller,
+           const int          operation,
+           const WH_SOCKET    sd,
+           const uint_t       events,
+           void* const        data)
+{
+  struct epoll_event ev = {0, };
+
+  ev.events = EPOLLONESHOT;
+  if (events & WH_POLL_READ)
+    ev.events |= EPOLLIN | EPOLLRDHUP;
+
+  if (events & WH_POLL_WRITE)
+    ev.events |= EPOLLOUT;
+
+  ev.data.ptr = data;
+
+  if (epoll_ctl(poller, operation, sd, &ev) < 0)
+    return errno;
+
+  return WOP_OK;
+}
+
+
+uint32_t
+whs_poller_create(WH_POLLER* const outPoller)
+{
+  const int poller = epoll_create1(EPOLL_CLOEXEC);
+
+  if (poller < 0)
+    return errno;
+
+  *outPoller = poller;
+
+  return WOP_OK;
+}
+
+
+uint32_t
+whs_poller_add(const WH_POLLER     poller,
+               const WH_SOCKET     sd,
+               const uint_t        events,
+               void* const         data)
+{
+  return poller_ctl(poller, EPOLL_CTL_ADD, sd, events, data);
+}
+
+
+uint32_t
+whs_poller_rearm(const WH_POLLER   poller,
+                 const WH_SOCKET   sd,
+                 const uint_t      events,
+                 void* const       data)
+{
+  return poller_ctl(poller, EPOLL_CTL_MOD, sd, events, data);
+}
+
+
+uint32_t
+whs_poller_remove(const WH_POLLER  poller,
+                  const WH_SOCKET  sd)
+{
+  struct epoll_event ev = {0, };
+
+  if (epoll_ctl(poller, EPOLL_CTL_DEL, sd, &ev) < 0)
+    return errno;
+
+  return WOP_OK;
+}
+
+
+uint32_t
+whs_poller_wait(const WH_POLLER    poller,
+                const uint_t       timeoutMsec,
+                void** const       outData)
+{
+  struct epoll_event ev;
+  int result;
+
+  *outData = NULL;
+
+  do
+    result = epoll_wait(poller, &ev, 1, timeoutMsec);
+  while ((result < 0) && (errno == EINTR));
+
+  if (result < 0)
+    return errno;
+
+  else if (result > 0)
+    *outData = ev.data.ptr;
+
+  return WOP_OK;
+}
+
+
+void
+whs_poller_close(const WH_POLLER poller)
+{
+  close(poller);
+}
+
@@ -134,6 +134,162 @@ wh_lock_release(WH_LOCK* const lock)
 }
 
 
+uint_t
+wh_rwlock_init(WH_RWLOCK* const lock)
+{
+  uint_t result;
+
+  do
+    result = pthread_rwlock_init(lock, NULL);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_rwlock_destroy(WH_RWLOCK* const lock)
+{
+  uint_t result;
+
+  do
+    result = pthread_rwlock_destroy(lock);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_rwlock_acquire(WH_RWLOCK* const lock, const bool_t shared)
+{
+  uint_t result;
+
+  do
+    result = shared ? pthread_rwlock_rdlock(lock) : pthread_rwlock_wrlock(lock);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_rwlock_try_acquire(WH_RWLOCK* const lock,
+                       const bool_t     shared,
+                       bool_t* const    outAcquired)
+{
+  int result;
+
+  do
+    result = shared ? pthread_rwlock_tryrdlock(lock) : pthread_rwlock_trywrlock(lock);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    {
+      *outAcquired = TRUE;
+      return WOP_OK;
+    }
+  else if (result == EBUSY)
+    {
+      *outAcquired = FALSE;
+      return WOP_OK;
+    }
+
+  return result;
+}
+
+
+uint_t
+wh_rwlock_release(WH_RWLOCK* const lock, const bool_t shared)
+{
+  uint_t result;
+
+  (void)shared;
+
+  do
+    result = pthread_rwlock_unlock(lock);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_init(WH_COND* const cond)
+{
+  uint_t result;
+
+  do
+    result = pthread_cond_init(cond, NULL);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_destroy(WH_COND* const cond)
+{
+  const uint_t result = pthread_cond_destroy(cond);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock)
+{
+  const uint_t result = pthread_cond_wait(cond, lock);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_signal(WH_COND* const cond)
+{
+  const uint_t result = pthread_cond_signal(cond);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_broadcast(WH_COND* const cond)
+{
+  const uint_t result = pthread_cond_broadcast(cond);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
 uint_t
 wh_thread_create(WH_THREAD*  const             outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -173,6 +329,15 @@ wh_sleep(const uint_t millisecs)
 }
 
 
+uint_t
+wh_cpus_count()
+{
+  const long result = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return (result > 0) ? result : 1;
+}
+
+
 #ifdef __GNUC__
 
 int16_t
@@ -211,6 +376,12 @@ wh_atomic_fetch_dec64(volatile int64_t* const value)
   return __sync_fetch_and_sub(value, (int64_t)1);
 }
 
+int64_t
+wh_atomic_fetch_add64(volatile int64_t* const value, const int64_t delta)
+{
+  return __sync_fetch_and_add(value, delta);
+}
+
 
 #if defined(ARCH_PPC)
 /* These functions are required by GCC compiler for PPC target processor as
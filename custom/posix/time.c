@@ -61,3 +61,14 @@ wh_msec_ticks()
   return((WTICKS)tv.tv_sec * 1000ul) + (WTICKS)(tv.tv_usec / 1000);
 }
 
+
+
+WTICKS
+wh_usec_ticks()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return((WTICKS)ts.tv_sec * 1000000ul) + (WTICKS)(ts.tv_nsec / 1000);
+}
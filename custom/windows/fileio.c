@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 
 #include "whais.h"
 #include "whais_fileio.h"
@@ -186,6 +187,98 @@ whf_write(WH_FILE hnd, const uint8_t* srcBuffer, uint_t size)
   return result;
 }
 
+bool_t
+whf_pread(WH_FILE hnd, uint64_t offset, uint8_t* dstBuffer, uint_t size)
+{
+  bool_t result       = TRUE;
+  uint_t actual_count = 0;
+
+  while (actual_count < size)
+    {
+      DWORD      count;
+      OVERLAPPED ov;
+
+      memset(&ov, 0, sizeof ov);
+      ov.Offset     = (DWORD)((offset + actual_count) & 0xFFFFFFFF);
+      ov.OffsetHigh = (DWORD)((offset + actual_count) >> 32);
+
+      if ( ! ReadFile(hnd,
+                       dstBuffer + actual_count,
+                       size - actual_count,
+                       &count,
+                       &ov))
+        {
+          result = FALSE;
+
+          break;
+        }
+      else if (count == 0)
+        {
+          SetLastError(ERROR_HANDLE_EOF);
+          result = FALSE;
+
+          break;
+        }
+      actual_count += count;
+    }
+
+  assert((result == TRUE) || (actual_count < size));
+  assert((result == FALSE) || (size == actual_count));
+
+  return result;
+}
+
+bool_t
+whf_pwrite(WH_FILE hnd, uint64_t offset, const uint8_t* srcBuffer, uint_t size)
+{
+  bool_t result      = TRUE;
+  uint_t actualCount = 0;
+
+  while (actualCount < size)
+    {
+      DWORD      count;
+      OVERLAPPED ov;
+
+      memset(&ov, 0, sizeof ov);
+      ov.Offset     = (DWORD)((offset + actualCount) & 0xFFFFFFFF);
+      ov.OffsetHigh = (DWORD)((offset + actualCount) >> 32);
+
+      if ( ! WriteFile(hnd,
+                        srcBuffer + actualCount,
+                        size - actualCount,
+                        &count,
+                        &ov))
+        {
+          result = FALSE;
+
+          break;
+        }
+      actualCount += count;
+    }
+
+  assert((result == TRUE) || (actualCount < size));
+  assert((result == FALSE) || (size == actualCount));
+
+  return result;
+}
+
+bool_t
+whf_pwritev(WH_FILE hnd, uint64_t offset, const WIOVec* vecs, uint_t vecsCount)
+{
+  /* There is no gathering write for regular handles, so write the
+     buffers one by one. */
+  while (vecsCount-- > 0)
+    {
+      if ( ! whf_pwrite(hnd, offset, vecs->buffer, vecs->size))
+        return FALSE;
+
+      offset += vecs->size;
+      ++vecs;
+    }
+
+  return TRUE;
+}
+
 bool_t
 whf_tell(WH_FILE hnd, uint64_t* const outPosition)
 {
@@ -235,6 +328,39 @@ whf_close(WH_FILE hnd)
   return CloseHandle(hnd);
 }
 
+void*
+whf_map(WH_FILE hnd, uint64_t offset, uint64_t size)
+{
+  void*        result;
+  const HANDLE mapping = CreateFileMapping(hnd, NULL, PAGE_READWRITE, 0, 0, NULL);
+
+  if (mapping == NULL)
+    return NULL;
+
+  /* A view cannot go beyond the end of the file, so this fails if the file
+     is not big enough. The view keeps the mapping object alive. */
+  result = MapViewOfFile(mapping,
+                         FILE_MAP_WRITE,
+                         (DWORD)(offset >> 32),
+                         (DWORD)(offset & 0xFFFFFFFF),
+                         (SIZE_T)size);
+  CloseHandle(mapping);
+
+  return result;
+}
+
+bool_t
+whf_sync_map(void* address, uint64_t size)
+{
+  return FlushViewOfFile(address, (SIZE_T)size);
+}
+
+bool_t
+whf_unmap(void* address, uint64_t size)
+{
+  return UnmapViewOfFile(address);
+}
+
 uint32_t
 whf_last_error()
 {
@@ -261,10 +387,10 @@ whf_remove(const char* const file)
 }
 
 
-void
+bool_t
 whf_move_file(const char* existingFile, const char* newFile )
 {
-  MoveFile(existingFile, newFile);
+  return MoveFile(existingFile, newFile);
 }
 
 
@@ -266,6 +266,58 @@ whs_read(const WH_SOCKET           sd,
   return WOP_OK;
 }
 
+uint32_t
+whs_read_nowait(const WH_SOCKET           sd,
+                uint8_t*                  dstBuffer,
+                uint_t* const             inoutCount)
+{
+  const struct timeval noWait = {0, 0};
+  fd_set readSet;
+
+  if (*inoutCount == 0)
+    return WSAEINVAL;
+
+  FD_ZERO(&readSet);
+  FD_SET(sd, &readSet);
+
+  const int ready = select(0, &readSet, NULL, NULL, &noWait);
+  if (ready < 0)
+    return WSAGetLastError();
+
+  else if (ready == 0)
+    {
+      *inoutCount = 0;
+      return WOP_OK;
+    }
+
+  const int chunk = recv(sd, dstBuffer, *inoutCount, 0);
+  if (chunk < 0)
+    {
+      const uint32_t status = WSAGetLastError();
+      if (status != WSAEWOULDBLOCK)
+        return status;
+
+      *inoutCount = 0;
+    }
+  else if (chunk == 0)
+    return WSAECONNRESET;
+
+  else
+    {
+      assert((uint_t)chunk <= *inoutCount);
+
+      *inoutCount = chunk;
+    }
+
+  return WOP_OK;
+}
+
+void
+whs_shutdown(const WH_SOCKET sd)
+{
+  shutdown(sd, SD_BOTH);
+}
+
 void
 whs_close(const WH_SOCKET sd)
 {
@@ -279,3 +331,281 @@ whs_clean()
   WSACleanup();
 }
 
+
+
+/* There is no one shot readiness notification for sockets on this platform
+ * (other than completion ports which would require overlapped I/O all over),
+ * so the poller keeps its own list of armed sockets and polls them in short
+ * slices, allowing other threads to add or rearm sockets in the meantime. */
+#define POLLER_SLICE_MS    10
+
+struct WHPoller
+{
+  CRITICAL_SECTION  lock;
+  WSAPOLLFD*        fds;
+  void**            data;
+  uint_t            count;
+  uint_t            capacity;
+};
+
+
+static uint_t
+poller_find(const WH_POLLER poller, const WH_SOCKET sd)
+{
+  uint_t i;
+
+  for (i = 0; i < poller->count; ++i)
+    {
+      if (poller->fds[i].fd == sd)
+        break;
+    }
+
+  return i;
+}
+
+
+static SHORT
+poller_events(const uint_t events)
+{
+  SHORT result = 0;
+
+  if (events & WH_POLL_READ)
+    result |= POLLRDNORM;
+
+  if (events & WH_POLL_WRITE)
+    result |= POLLWRNORM;
+
+  return result;
+}
+
+
+uint32_t
+whs_poller_create(WH_POLLER* const outPoller)
+{
+  WH_POLLER poller = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof *poller);
+
+  if (poller == NULL)
+    return ERROR_NOT_ENOUGH_MEMORY;
+
+  InitializeCriticalSection(&poller->lock);
+  *outPoller = poller;
+
+  return WOP_OK;
+}
+
+
+uint32_t
+whs_poller_add(const WH_POLLER     poller,
+               const WH_SOCKET     sd,
+               const uint_t        events,
+               void* const         data)
+{
+  uint32_t status = WOP_OK;
+
+  EnterCriticalSection(&poller->lock);
+
+  if (poller->count == poller->capacity)
+    {
+      const uint_t capacity = (poller->capacity == 0) ? 64 : 2 * poller->capacity;
+      WSAPOLLFD* fds;
+      void**     dataEntries;
+
+      if (poller->capacity == 0)
+        {
+          fds = HeapAlloc(GetProcessHeap(), 0, capacity * sizeof fds[0]);
+          dataEntries = HeapAlloc(GetProcessHeap(), 0, capacity * sizeof dataEntries[0]);
+        }
+      else
+        {
+          fds = HeapReAlloc(GetProcessHeap(), 0, poller->fds, capacity * sizeof fds[0]);
+          if (fds != NULL)
+            poller->fds = fds;
+
+          dataEntries = HeapReAlloc(GetProcessHeap(),
+                                    0,
+                                    poller->data,
+                                    capacity * sizeof dataEntries[0]);
+          if (dataEntries != NULL)
+            poller->data = dataEntries;
+        }
+
+      if ((fds == NULL) || (dataEntries == NULL))
+        status = ERROR_NOT_ENOUGH_MEMORY;
+
+      else
+        {
+          poller->fds      = fds;
+          poller->data     = dataEntries;
+          poller->capacity = capacity;
+        }
+    }
+
+  if (status == WOP_OK)
+    {
+      poller->fds[poller->count].fd      = sd;
+      poller->fds[poller->count].events  = poller_events(events);
+      poller->fds[poller->count].revents = 0;
+      poller->data[poller->count]        = data;
+
+      ++poller->count;
+    }
+
+  LeaveCriticalSection(&poller->lock);
+
+  return status;
+}
+
+
+uint32_t
+whs_poller_rearm(const WH_POLLER   poller,
+                 const WH_SOCKET   sd,
+                 const uint_t      events,
+                 void* const       data)
+{
+  uint32_t status = WOP_OK;
+  uint_t   i;
+
+  EnterCriticalSection(&poller->lock);
+
+  i = poller_find(poller, sd);
+  if (i < poller->count)
+    {
+      poller->fds[i].events = poller_events(events);
+      poller->data[i]       = data;
+    }
+  else
+    status = WSAENOTSOCK;
+
+  LeaveCriticalSection(&poller->lock);
+
+  return status;
+}
+
+
+uint32_t
+whs_poller_remove(const WH_POLLER  poller,
+                  const WH_SOCKET  sd)
+{
+  uint32_t status = WOP_OK;
+  uint_t   i;
+
+  EnterCriticalSection(&poller->lock);
+
+  i = poller_find(poller, sd);
+  if (i < poller->count)
+    {
+      --poller->count;
+
+      poller->fds[i]  = poller->fds[poller->count];
+      poller->data[i] = poller->data[poller->count];
+    }
+  else
+    status = WSAENOTSOCK;
+
+  LeaveCriticalSection(&poller->lock);
+
+  return status;
+}
+
+
+uint32_t
+whs_poller_wait(const WH_POLLER    poller,
+                const uint_t       timeoutMsec,
+                void** const       outData)
+{
+  const DWORD startTick = GetTickCount();
+  WSAPOLLFD*  armed     = NULL;
+  uint_t      armedSize = 0;
+  uint32_t    status    = WOP_OK;
+
+  *outData = NULL;
+
+  while (TRUE)
+    {
+      const DWORD elapsed = GetTickCount() - startTick;
+      uint_t      armedCount = 0, i;
+      int         result;
+
+      if (elapsed >= timeoutMsec)
+        break;
+
+      EnterCriticalSection(&poller->lock);
+
+      if (armedSize < poller->count)
+        {
+          if (armed != NULL)
+            HeapFree(GetProcessHeap(), 0, armed);
+
+          armedSize = poller->capacity;
+          armed = HeapAlloc(GetProcessHeap(), 0, armedSize * sizeof armed[0]);
+          if (armed == NULL)
+            {
+              LeaveCriticalSection(&poller->lock);
+              return ERROR_NOT_ENOUGH_MEMORY;
+            }
+        }
+
+      for (i = 0; i < poller->count; ++i)
+        {
+          if (poller->fds[i].events != 0)
+            armed[armedCount++] = poller->fds[i];
+        }
+
+      LeaveCriticalSection(&poller->lock);
+
+      if (armedCount == 0)
+        {
+          Sleep(POLLER_SLICE_MS);
+          continue;
+        }
+
+      result = WSAPoll(armed, armedCount, POLLER_SLICE_MS);
+      if (result < 0)
+        {
+          status = WSAGetLastError();
+          break;
+        }
+      else if (result == 0)
+        continue;
+
+      /* Claim the first ready socket that was not taken by other waiter. */
+      EnterCriticalSection(&poller->lock);
+      for (i = 0; (i < armedCount) && (*outData == NULL); ++i)
+        {
+          uint_t entry;
+
+          if (armed[i].revents == 0)
+            continue;
+
+          entry = poller_find(poller, armed[i].fd);
+          if ((entry < poller->count) && (poller->fds[entry].events != 0))
+            {
+              poller->fds[entry].events = 0;
+              *outData = poller->data[entry];
+            }
+        }
+      LeaveCriticalSection(&poller->lock);
+
+      if (*outData != NULL)
+        break;
+    }
+
+  if (armed != NULL)
+    HeapFree(GetProcessHeap(), 0, armed);
+
+  return status;
+}
+
+
+void
+whs_poller_close(const WH_POLLER poller)
+{
+  if (poller->fds != NULL)
+    HeapFree(GetProcessHeap(), 0, poller->fds);
+
+  if (poller->data != NULL)
+    HeapFree(GetProcessHeap(), 0, poller->data);
+
+  DeleteCriticalSection(&poller->lock);
+  HeapFree(GetProcessHeap(), 0, poller);
+}
@@ -74,6 +74,107 @@ wh_lock_release(WH_LOCK* const lock)
 }
 
 
+uint_t
+wh_rwlock_init(WH_RWLOCK* const lock)
+{
+  InitializeSRWLock(lock);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_rwlock_destroy(WH_RWLOCK* const lock)
+{
+  return WOP_OK;
+}
+
+
+uint_t
+wh_rwlock_acquire(WH_RWLOCK* const lock, const bool_t shared)
+{
+  if (shared)
+    AcquireSRWLockShared(lock);
+
+  else
+    AcquireSRWLockExclusive(lock);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_rwlock_try_acquire(WH_RWLOCK* const lock,
+                       const bool_t     shared,
+                       bool_t* const    outAcquired)
+{
+  if (shared)
+    *outAcquired = (TryAcquireSRWLockShared(lock) != 0);
+
+  else
+    *outAcquired = (TryAcquireSRWLockExclusive(lock) != 0);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_rwlock_release(WH_RWLOCK* const lock, const bool_t shared)
+{
+  if (shared)
+    ReleaseSRWLockShared(lock);
+
+  else
+    ReleaseSRWLockExclusive(lock);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_init(WH_COND* const cond)
+{
+  InitializeConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_destroy(WH_COND* const cond)
+{
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock)
+{
+  if (SleepConditionVariableCS(cond, lock, INFINITE))
+    return WOP_OK;
+
+  return GetLastError();
+}
+
+
+uint_t
+wh_cond_signal(WH_COND* const cond)
+{
+  WakeConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_broadcast(WH_COND* const cond)
+{
+  WakeAllConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
 uint_t
 wh_thread_create(WH_THREAD* const              outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -124,6 +225,17 @@ wh_sleep(const uint_t millisecs)
 }
 
 
+uint_t
+wh_cpus_count()
+{
+  SYSTEM_INFO info;
+
+  GetSystemInfo(&info);
+
+  return (info.dwNumberOfProcessors > 0) ? info.dwNumberOfProcessors : 1;
+}
+
+
 int16_t
 wh_atomic_fetch_inc16(volatile int16_t* const value)
 {
@@ -159,3 +271,9 @@ wh_atomic_fetch_dec64(volatile int64_t* const value)
 {
   return InterlockedDecrement64(value) + 1;
 }
+
+int64_t
+wh_atomic_fetch_add64(volatile int64_t* const value, const int64_t delta)
+{
+  return InterlockedExchangeAdd64(value, delta);
+}
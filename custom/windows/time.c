@@ -70,5 +70,21 @@ wh_msec_ticks()
 }
 
 
+WTICKS
+wh_usec_ticks()
+{
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER        counter;
+
+  if (frequency.QuadPart == 0)
+    QueryPerformanceFrequency(&frequency);
+
+  QueryPerformanceCounter(&counter);
+
+  return(counter.QuadPart / frequency.QuadPart) * 1000000ull
+         + (counter.QuadPart % frequency.QuadPart) * 1000000ull / frequency.QuadPart;
+}
+
+
 
 
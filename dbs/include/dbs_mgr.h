@@ -51,6 +51,36 @@ static const uint32_t DEFAULT_TABLE_CACHE_BLK_COUNT     = 1024u;
 static const uint32_t DEFAULT_VLSTORE_CACHE_BLK_SIZE    = 16384u;       //16KB
 static const uint32_t DEFAULT_VLSTORE_CACHE_BLK_COUNT   = 1024u;
 static const uint32_t DEFAULT_VLVALUE_CACHE_SIZE        = 512u;
+static const uint64_t DEFAULT_BUFFER_POOL_SIZE          = 0;            //No global limit
+static const uint32_t DEFAULT_INDEX_FILL_FACTOR         = 60;           //Percents
+static const uint64_t DEFAULT_WAL_CHECKPOINT_SIZE       = 67108864ul;   //64MB
+static const uint32_t DEFAULT_WRITE_BACK_INTERVAL       = 100u;         //Milliseconds
+
+
+/* How a persistent table keeps its rows in the blocks of its rows file. */
+enum TABLE_LAYOUT
+{
+  TABLE_ROWS_LAYOUT,      //The fields of a row are kept together.
+  TABLE_PAX_LAYOUT        //A block keeps the values of each field together.
+};
+
+
+/* Counters gathered since a persistent table was opened. The lock waits
+   count only the acquires that could not be granted right away. */
+struct DBSTableStats
+{
+  uint64_t      mCacheHits;
+  uint64_t      mCacheMisses;
+  uint64_t      mCacheEvictions;
+  uint64_t      mNodesRetrieved;
+  uint64_t      mNodesLoaded;
+  uint64_t      mBytesRead;
+  uint64_t      mBytesWritten;
+  uint64_t      mRowsLockWaits;
+  uint64_t      mRowsLockWaitTime;        //Microseconds
+  uint64_t      mIndexesLockWaits;
+  uint64_t      mIndexesLockWaitTime;     //Microseconds
+};
 
 
 class DBS_SHL IDBSHandler
@@ -63,7 +93,8 @@ public:
   virtual ITable& RetrievePersistentTable(const char* const name) = 0;
   virtual void AddTable(const char* const   name,
                         const FIELD_INDEX   fieldsCount,
-                        DBSFieldDescriptor* const inoutFields) = 0;
+                        DBSFieldDescriptor* const inoutFields,
+                        const TABLE_LAYOUT  layout = TABLE_ROWS_LAYOUT) = 0;
   virtual void DeleteTable(const char* const name) = 0;
   virtual void SyncAllTablesContent() = 0;
   virtual void SyncTableContent(const TABLE_INDEX index) = 0;
@@ -74,8 +105,21 @@ public:
   virtual void ReleaseTable(ITable&) = 0;
   virtual const char* TableName(const TABLE_INDEX index) = 0;
 
+  /* Returns false when the table is not in use, as nothing is gathered then. */
+  virtual bool TableStatistics(const TABLE_INDEX index, DBSTableStats& outStats) = 0;
+
 };
 
+/* When the write-ahead log is disabled, the tables are written in place and
+   a database that was not closed properly has to be repaired. */
+enum WAL_SYNC_POLICY
+{
+  WAL_DISABLED,
+  WAL_SYNC_COMMIT,        //The log is synced before a table commit returns.
+  WAL_SYNC_PERIODIC       //The log is synced only when all tables are synced.
+};
+
+
 struct DBSSettings
 {
   DBSSettings()
@@ -86,18 +130,28 @@ struct DBSSettings
       mTableCacheBlkCount(DEFAULT_TABLE_CACHE_BLK_COUNT),
       mVLStoreCacheBlkSize(DEFAULT_VLSTORE_CACHE_BLK_SIZE),
       mVLStoreCacheBlkCount(DEFAULT_VLSTORE_CACHE_BLK_COUNT),
-      mVLValueCacheSize(DEFAULT_VLVALUE_CACHE_SIZE)
+      mVLValueCacheSize(DEFAULT_VLVALUE_CACHE_SIZE),
+      mBufferPoolSize(DEFAULT_BUFFER_POOL_SIZE),
+      mIndexFillFactor(DEFAULT_INDEX_FILL_FACTOR),
+      mWalSyncPolicy(WAL_SYNC_COMMIT),
+      mWalCheckpointSize(DEFAULT_WAL_CHECKPOINT_SIZE),
+      mWriteBackInterval(DEFAULT_WRITE_BACK_INTERVAL)
   {
   }
 
-  std::string   mWorkDir;
-  std::string   mTempDir;
-  uint64_t      mMaxFileSize;
-  uint32_t      mTableCacheBlkSize;
-  uint32_t      mTableCacheBlkCount;
-  uint32_t      mVLStoreCacheBlkSize;
-  uint32_t      mVLStoreCacheBlkCount;
-  uint32_t      mVLValueCacheSize;
+  std::string     mWorkDir;
+  std::string     mTempDir;
+  uint64_t        mMaxFileSize;
+  uint32_t        mTableCacheBlkSize;
+  uint32_t        mTableCacheBlkCount;
+  uint32_t        mVLStoreCacheBlkSize;
+  uint32_t        mVLStoreCacheBlkCount;
+  uint32_t        mVLValueCacheSize;
+  uint64_t        mBufferPoolSize;
+  uint32_t        mIndexFillFactor;
+  WAL_SYNC_POLICY mWalSyncPolicy;
+  uint64_t        mWalCheckpointSize;
+  uint32_t        mWriteBackInterval;
 };
 
 
@@ -129,7 +183,8 @@ DBSRepairDatabase(const char* const            name,
 
 DBS_SHL IDBSHandler&
 DBSRetrieveDatabase(const char* const name,
-                    const char*       path = nullptr);
+                    const char*       path = nullptr,
+                    const bool        mapTablesRows = false);
 
 DBS_SHL void
 DBSReleaseDatabase(IDBSHandler& hnd);
@@ -0,0 +1,118 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef DBS_ROWSSET_H_
+#define DBS_ROWSSET_H_
+
+#include <vector>
+
+#include "whais.h"
+
+#include "dbs_types.h"
+#include "dbs_values.h"
+
+
+namespace whais {
+
+
+/* A set of rows kept as a compressed bitmap. The rows are split in chunks
+   by their upper 16 bits. A chunk with few rows keeps them as a sorted list
+   of their lower 16 bits; otherwise it keeps a bitmap of all its 64K rows.
+   The sets are combined chunk by chunk, so no operation walks the rows
+   that are not in the sets. */
+class DBS_SHL RowsSet
+{
+public:
+  RowsSet() = default;
+  explicit RowsSet(const DArray& rows);
+
+  bool IsEmpty() const { return mChunks.empty(); }
+  uint64_t Count() const;
+  bool Contains(const ROW_INDEX row) const;
+
+  void Add(const ROW_INDEX row);
+  void AddRange(ROW_INDEX from, const ROW_INDEX to);
+
+  RowsSet& Unite(const RowsSet& second);
+  RowsSet& Intersect(const RowsSet& second);
+  RowsSet& Subtract(const RowsSet& second);
+
+  DArray ToArray() const;
+
+  template<class VISITOR> void ForEach(VISITOR visitor) const
+  {
+    for (const auto& chunk : mChunks)
+    {
+      const ROW_INDEX base = _SC(ROW_INDEX, chunk.mKey) << 16;
+
+      if (chunk.mBits.empty())
+      {
+        for (const auto low : chunk.mRows)
+          visitor(base | low);
+
+        continue;
+      }
+
+      for (uint_t w = 0; w < BITMAP_WORDS; ++w)
+      {
+        for (uint64_t word = chunk.mBits[w]; word != 0; word &= word - 1)
+          visitor(base | (w * 64 + CountBits((word & (~word + 1)) - 1)));
+      }
+    }
+  }
+
+  //A chunk keeps its rows in a list up to this count.
+  static const uint_t MAX_LIST_ROWS = 4096;
+  static const uint_t BITMAP_WORDS  = 65536 / 64;
+
+  static uint_t CountBits(uint64_t word)
+  {
+    word -= (word >> 1) & 0x5555555555555555ull;
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+    return (word * 0x0101010101010101ull) >> 56;
+  }
+
+private:
+  struct Chunk
+  {
+    uint16_t                mKey;
+    uint32_t                mCount;
+    std::vector<uint16_t>   mRows;
+    std::vector<uint64_t>   mBits;
+  };
+
+  Chunk* FindChunk(const uint16_t key, const bool create);
+  const Chunk* FindChunk(const uint16_t key) const;
+
+#pragma warning(disable: 4251)
+  std::vector<Chunk> mChunks;
+#pragma warning(default: 4251)
+};
+
+
+} //namespace whais
+
+#endif /* DBS_ROWSSET_H_ */
@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "dbs_types.h"
 #include "dbs_values.h"
+#include "dbs_rowsset.h"
 
 
 namespace whais {
@@ -42,6 +43,14 @@ struct CreateIndexCallbackContext
 
 class IDBSHandler;
 
+/* How the values of a field are indexed. */
+enum INDEX_KIND
+{
+  INDEX_NONE,             //The field is not indexed.
+  INDEX_BTREE,            //Sorted, to search for ranges of values.
+  INDEX_HASH              //Hashed, to search only for single values.
+};
+
 typedef void CREATE_INDEX_CALLBACK_FUNC(CreateIndexCallbackContext* cbContext);
 
 class DBS_SHL ITable
@@ -64,9 +73,11 @@ public:
 
   virtual void CreateIndex(const FIELD_INDEX                   field,
                            CREATE_INDEX_CALLBACK_FUNC* const   cbFunc,
-                           CreateIndexCallbackContext* const   cbContext) = 0;
+                           CreateIndexCallbackContext* const   cbContext,
+                           const INDEX_KIND                    kind = INDEX_BTREE) = 0;
   virtual void RemoveIndex(const FIELD_INDEX field) = 0;
   virtual bool IsIndexed(const FIELD_INDEX field) const = 0;
+  virtual INDEX_KIND IndexKind(const FIELD_INDEX field) const = 0;
 
   virtual void Set(const ROW_INDEX     row,
                    const FIELD_INDEX   field,
@@ -293,6 +304,82 @@ public:
                            const ROW_INDEX     toRow,
                            const FIELD_INDEX   field) = 0;
 
+  virtual RowsSet MatchRowsSet(const DBool&        min,
+                               const DBool&        max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DChar&        min,
+                               const DChar&        max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DDate&        min,
+                               const DDate&        max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DDateTime&    min,
+                               const DDateTime&    max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DHiresTime&   min,
+                               const DHiresTime&   max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DUInt8&       min,
+                               const DUInt8&       max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DUInt16&      min,
+                               const DUInt16&      max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DUInt32&      min,
+                               const DUInt32&      max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DUInt64&      min,
+                               const DUInt64&      max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DInt8&        min,
+                               const DInt8&        max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DInt16&       min,
+                               const DInt16&       max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DInt32&       min,
+                               const DInt32&       max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DInt64&       min,
+                               const DInt64&       max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DReal&        min,
+                               const DReal&        max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+  virtual RowsSet MatchRowsSet(const DRichReal&    min,
+                               const DRichReal&    max,
+                               const ROW_INDEX     fromRow,
+                               const ROW_INDEX     toRow,
+                               const FIELD_INDEX   field) = 0;
+
   virtual void Flush() = 0;
   virtual void LockTable() = 0;
   virtual void UnlockTable() = 0;
@@ -22,7 +22,13 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include "ps_blockcache.h"
+#include "ps_writeback.h"
 #include "dbs_exception.h"
 
 
@@ -36,7 +42,23 @@ BlockCache::BlockCache()
     mItemSize(0),
     mBlockSize(0),
     mMaxCachedBlocks(0),
-    mCachedBlocks()
+    mMaxProtectedBlocks(0),
+    mSkipFlush(false),
+    mCachedBlocks(),
+    mProbationList(),
+    mProtectedList(),
+    mLastBlock(nullptr),
+    mNextSequentialItem(~_SC(uint64_t, 0)),
+    mSequentialMisses(0),
+    mSync(),
+    mHits(0),
+    mMisses(0),
+    mEvictions(0),
+    mDirtyEvictions(0),
+    mWrittenBack(0),
+    mPrefetched(0),
+    mPrefetchHits(0),
+    mMappedBlocks(0)
 {
 }
 
@@ -45,15 +67,16 @@ BlockCache::~BlockCache()
   if (mItemSize == 0)
     return ; //This has not been initialized. So nothing to do here!
 
-  map<uint64_t, BlockEntry>::iterator it = mCachedBlocks.begin();
-  while (it != mCachedBlocks.end())
-    {
-      assert(it->second.IsInUse() == false);
-      assert(mSkipFlush || it->second.IsDirty() == false);
+  BufferPool::Instance().Unregister(*this);
 
-      delete [] it->second.Data();
-      ++it;
-    }
+  for (auto& block : mCachedBlocks)
+  {
+    assert(block.second.IsInUse() == false);
+    assert(mSkipFlush || block.second.IsDirty() == false);
+
+    if ( ! block.second.IsMapped())
+      delete [] block.second.Data();
+  }
 }
 
 void
@@ -88,6 +111,11 @@ BlockCache::Init(IBlocksManager&   blocksMgr,
     mBlockSize -= mBlockSize % mItemSize;
 
   assert(mBlockSize > 0);
+
+  BufferPool::Instance().Register(*this);
+
+  UpdateBudget();
+  mCachedBlocks.reserve(mMaxCachedBlocks + 1);
 }
 
 void
@@ -98,8 +126,151 @@ BlockCache::Flush()
   if (mSkipFlush)
     return;
 
+  LockGuard<RWLock> _l(mSync);
+
+  //Write the blocks in the order they are found in the storage.
+  vector<BlockEntry*> dirtyBlocks;
   for (auto& block : mCachedBlocks)
-    FlushItem(block.first);
+  {
+    if (block.second.IsDirty())
+      dirtyBlocks.push_back(&block.second);
+  }
+
+  sort(dirtyBlocks.begin(),
+       dirtyBlocks.end(),
+       [](const BlockEntry* a, const BlockEntry* b) { return a->BaseItem() < b->BaseItem(); });
+
+  //Adjacent blocks are written together.
+  const uint_t itemsPerBlock = mBlockSize / mItemSize;
+  vector<BlockEntry*> run;
+
+  for (size_t first = 0; first < dirtyBlocks.size(); first += run.size())
+  {
+    run.clear();
+    do
+      run.push_back(dirtyBlocks[first + run.size()]);
+    while ((first + run.size() < dirtyBlocks.size())
+           && (dirtyBlocks[first + run.size()]->BaseItem()
+               == dirtyBlocks[first]->BaseItem() + run.size() * itemsPerBlock));
+
+    StoreRun(run, itemsPerBlock);
+  }
+}
+
+uint_t
+BlockCache::WriteBack(const bool urgent)
+{
+  assert(mItemSize != 0);
+
+  if (mSkipFlush)
+    return 0;
+
+  const uint_t itemsPerBlock = mBlockSize / mItemSize;
+  vector<BlockEntry*> dirtyBlocks;
+
+  {
+    /* Blocks are evicted only while the cache is held exclusively, so the
+       picked ones just need to be marked as used to stay around. */
+    SharedLockGuard<RWLock> _l(mSync);
+
+    size_t dirtyCount = 0;
+    for (auto& block : mCachedBlocks)
+    {
+      if (block.second.IsDirty())
+        ++dirtyCount;
+    }
+
+    const size_t highWatermark = max<size_t>((mMaxCachedBlocks * DIRTY_HIGH_WATERMARK_PERCENT) / 100,
+                                             1);
+    const size_t lowWatermark = (mMaxCachedBlocks * DIRTY_LOW_WATERMARK_PERCENT) / 100;
+
+    if ((dirtyCount == 0) || ((dirtyCount < highWatermark) && ! urgent))
+      return 0;
+
+    const size_t toWrite = (dirtyCount >= highWatermark) ? dirtyCount - lowWatermark : 0;
+
+    BlockList* const lists[] = { &mProbationList, &mProtectedList };
+    for (auto list : lists)
+    {
+      const bool writeAll = urgent && (list == &mProbationList);
+
+      BlockEntry* block = list->Tail();
+      while ((block != nullptr) && (writeAll || (dirtyBlocks.size() < toWrite)))
+      {
+        if (block->IsDirty())
+        {
+          block->RegisterUser();
+          dirtyBlocks.push_back(block);
+        }
+        block = list->Prev(*block);
+      }
+    }
+  }
+
+  sort(dirtyBlocks.begin(),
+       dirtyBlocks.end(),
+       [](const BlockEntry* a, const BlockEntry* b) { return a->BaseItem() < b->BaseItem(); });
+
+  uint_t written = 0;
+  size_t next = 0;
+  vector<BlockEntry*> run;
+
+  try
+  {
+    while (next < dirtyBlocks.size())
+    {
+      //Adjacent blocks are written together, as long as none is in use.
+      while (next < dirtyBlocks.size())
+      {
+        BlockEntry* const block = dirtyBlocks[next];
+
+        if (( ! run.empty()) && (block->BaseItem() != run.back()->BaseItem() + itemsPerBlock))
+          break;
+
+        ++next;
+        if ( ! block->Latch().try_lock_shared())
+        {
+          block->ReleaseUser();
+          break;
+        }
+        run.push_back(block);
+      }
+
+      if (run.empty())
+        continue;
+
+      StoreRun(run, itemsPerBlock);
+      written += run.size();
+
+      for (auto block : run)
+      {
+        block->Latch().unlock_shared();
+        block->ReleaseUser();
+      }
+      run.clear();
+    }
+  }
+  catch (...)
+  {
+    for (auto block : run)
+    {
+      block->Latch().unlock_shared();
+      block->ReleaseUser();
+    }
+
+    while (next < dirtyBlocks.size())
+      dirtyBlocks[next++]->ReleaseUser();
+
+    throw;
+  }
+
+  if (written > 0)
+  {
+    LockGuard<RWLock> _l(mSync);
+    mWrittenBack += written;
+  }
+
+  return written;
 }
 
 StoredItem
@@ -108,44 +279,144 @@ BlockCache::RetriveItem(const uint64_t item)
   const uint_t   itemsPerBlock = mBlockSize / mItemSize;
   const uint64_t baseBlockItem = (item / itemsPerBlock) * itemsPerBlock;
 
+  {
+    /* Most hits leave the lists as they are, so they are served while the
+       cache is held shared. The block only records it was used again. */
+    SharedLockGuard<RWLock> _l(mSync);
+
+    auto it = mCachedBlocks.find(baseBlockItem);
+    if ((it != mCachedBlocks.end())
+        && (it->second.IsProtected() || (mLastBlock == &it->second)))
+    {
+      mHits.fetch_add(1, std::memory_order_relaxed);
+      it->second.MarkHit();
+
+      return StoredItem(it->second, (item % itemsPerBlock) * mItemSize);
+    }
+  }
+
+  LockGuard<RWLock> _l(mSync);
+
   auto it = mCachedBlocks.find(baseBlockItem);
 
   /* Check if the item is in cache. */
   if (it != mCachedBlocks.end())
+  {
+    mHits.fetch_add(1, std::memory_order_relaxed);
+
+    if (it->second.IsPrefetched())
+    {
+      //The scan reached it, and is not likely to come back to it.
+      it->second.MarkPrefetched(false);
+      ++mPrefetchHits;
+
+      mProbationList.Remove(it->second);
+      mProbationList.PushBack(it->second);
+      mNextSequentialItem = baseBlockItem + itemsPerBlock;
+    }
+
+    /* Consecutive accesses to the same block (e.g. walking its items one
+       by one) count as a single reference. */
+    else if (mLastBlock != &it->second)
+      TouchBlock(it->second);
+
+    mLastBlock = &it->second;
+
     return StoredItem(it->second, (item % itemsPerBlock) * mItemSize);
+  }
+
+  ++mMisses;
+
+  UpdateBudget();
 
-  /* Make sure you have room to cache the new item. */
-  if (mCachedBlocks.size() >= mMaxCachedBlocks)
+  mSequentialMisses = (baseBlockItem == mNextSequentialItem) ? mSequentialMisses + 1 : 0;
+  mNextSequentialItem = baseBlockItem + itemsPerBlock;
+
+  uint8_t* const mapped = mManager->MapItems(baseBlockItem, itemsPerBlock);
+  if (mapped != nullptr)
   {
-    it = mCachedBlocks.begin();
-    while (it != mCachedBlocks.end())
-    {
-      if (it->second.IsInUse())
-        continue;
+    //The block lives in the manager's memory, nothing to charge to the pool.
+    if (mCachedBlocks.size() >= mMaxCachedBlocks)
+      EvictBlocks(itemsPerBlock, mMaxCachedBlocks);
 
-      uint8_t* const data_ = it->second.Data();
+    it = mCachedBlocks.emplace(piecewise_construct,
+                               forward_as_tuple(baseBlockItem),
+                               forward_as_tuple(baseBlockItem, mapped, true)).first;
 
-      if (it->second.IsDirty())
-        mManager->StoreItems(it->first, itemsPerBlock, data_);
+    ++mMappedBlocks;
+    mProbationList.PushFront(it->second);
+    mLastBlock = &it->second;
 
-      delete[] data_;
+    return StoredItem(it->second, (item % itemsPerBlock) * mItemSize);
+  }
 
-      mCachedBlocks.erase(it++);
+  const bool scanning = (mSequentialMisses >= SEQUENTIAL_MISSES_TRIGGER);
 
-      if (mCachedBlocks.size() < mMaxCachedBlocks)
-        break;
+  //Read ahead the next blocks, up to the first one already cached.
+  uint_t blocksCount = 1;
+  if (scanning)
+  {
+    const uint_t readAhead = MIN(READ_AHEAD_BLOCKS, mMaxCachedBlocks / 4);
+
+    while ((blocksCount <= readAhead)
+           && (mCachedBlocks.find(baseBlockItem + blocksCount * itemsPerBlock)
+               == mCachedBlocks.end()))
+    {
+      ++blocksCount;
     }
   }
 
-  unique_ptr<uint8_t> block(new uint8_t[mBlockSize]);
-  uint8_t* const data_ = block.get();
+  vector<unique_ptr<uint8_t[]>> buffers(blocksCount);
+  vector<uint8_t*> blocks(blocksCount);
 
-  mCachedBlocks.insert(pair<uint64_t, BlockEntry>(baseBlockItem, BlockEntry(data_)));
-  block.release();
+  for (uint_t b = 0; b < blocksCount; ++b)
+  {
+    buffers[b].reset(new uint8_t[mBlockSize]);
+    blocks[b] = buffers[b].get();
+  }
+
+  if (blocksCount == 1)
+    mManager->RetrieveItems(baseBlockItem, itemsPerBlock, blocks[0]);
 
-  mManager->RetrieveItems(baseBlockItem, itemsPerBlock, data_);
+  else
+  {
+    blocksCount = mManager->RetrieveBlocks(baseBlockItem, itemsPerBlock, blocks.data(), blocksCount);
+    assert((0 < blocksCount) && (blocksCount <= blocks.size()));
+  }
 
-  return StoredItem(mCachedBlocks.find(baseBlockItem)->second, (item % itemsPerBlock) * mItemSize);
+  //The requested block goes in last, so making room does not evict it.
+  for (uint_t b = blocksCount; b-- > 0; )
+  {
+    /* Make sure you have room to cache the new item. */
+    if ( ! BufferPool::Instance().Reserve(*this, mBlockSize))
+      EvictBlocks(itemsPerBlock, min<size_t>(mCachedBlocks.size(), mMaxCachedBlocks));
+
+    else if (mCachedBlocks.size() >= mMaxCachedBlocks)
+      EvictBlocks(itemsPerBlock, mMaxCachedBlocks);
+
+    const uint64_t blockItem = baseBlockItem + b * itemsPerBlock;
+
+    it = mCachedBlocks.emplace(piecewise_construct,
+                               forward_as_tuple(blockItem),
+                               forward_as_tuple(blockItem, blocks[b])).first;
+    buffers[b].release();
+
+    if (b > 0)
+    {
+      it->second.MarkPrefetched(true);
+      mProbationList.PushFront(it->second);
+      ++mPrefetched;
+    }
+    else if (scanning)
+      mProbationList.PushBack(it->second);
+
+    else
+      mProbationList.PushFront(it->second);
+  }
+
+  mLastBlock = &it->second;
+
+  return StoredItem(it->second, (item % itemsPerBlock) * mItemSize);
 }
 
 void
@@ -154,6 +425,16 @@ BlockCache::FlushItem(const uint64_t item)
   const uint_t itemsPerBlock   = mBlockSize / mItemSize;
   const uint64_t baseBlockItem = (item / itemsPerBlock) * itemsPerBlock;
 
+  LockGuard<RWLock> _l(mSync);
+
+  FlushBlock(baseBlockItem);
+}
+
+void
+BlockCache::FlushBlock(const uint64_t baseBlockItem)
+{
+  const uint_t itemsPerBlock = mBlockSize / mItemSize;
+
   auto it = mCachedBlocks.find(baseBlockItem);
   if (it == mCachedBlocks.end())
     return;
@@ -171,6 +452,8 @@ BlockCache::RefreshItem(const uint64_t item)
   const uint_t   itemsPerBlock = mBlockSize / mItemSize;
   const uint64_t baseBlockItem = (item / itemsPerBlock) * itemsPerBlock;
 
+  LockGuard<RWLock> _l(mSync);
+
   auto it = mCachedBlocks.find(baseBlockItem);
 
   if (it == mCachedBlocks.end())
@@ -181,6 +464,216 @@ BlockCache::RefreshItem(const uint64_t item)
   mManager->RetrieveItems(baseBlockItem, itemsPerBlock, it->second.Data());
 }
 
+void
+BlockCache::StoreRun(const vector<BlockEntry*>& run, const uint_t itemsPerBlock)
+{
+  assert(run.size() > 0);
+
+  if (run.size() == 1)
+    mManager->StoreItems(run[0]->BaseItem(), itemsPerBlock, run[0]->Data());
+
+  else
+  {
+    vector<const uint8_t*> blocks;
+    blocks.reserve(run.size());
+
+    for (auto block : run)
+      blocks.push_back(block->Data());
+
+    mManager->StoreBlocks(run[0]->BaseItem(), itemsPerBlock, blocks.data(), blocks.size());
+  }
+
+  for (auto block : run)
+    block->MarkClean();
+}
+
+BlockCacheStats
+BlockCache::Statistics() const
+{
+  BlockCacheStats result;
+
+  LockGuard<RWLock> _l(mSync);
+
+  result.mHits            = mHits.load(std::memory_order_relaxed);
+  result.mMisses          = mMisses;
+  result.mEvictions       = mEvictions;
+  result.mDirtyEvictions  = mDirtyEvictions;
+  result.mWrittenBack     = mWrittenBack;
+  result.mPrefetched      = mPrefetched;
+  result.mPrefetchHits    = mPrefetchHits;
+  result.mMappedBlocks    = mMappedBlocks;
+  result.mCachedBlocks    = mCachedBlocks.size();
+  result.mProtectedBlocks = mProtectedList.Count();
+
+  return result;
+}
+
+void
+BlockCache::UpdateBudget()
+{
+  BufferPool& pool = BufferPool::Instance();
+
+  /* With a global limit in place, the cache is entitled to its share of
+     the pool, which shrinks as more caches are opened. */
+  if (pool.IsLimited())
+    mMaxCachedBlocks = max<uint64_t>(pool.FairShare() / mBlockSize, 1);
+
+  mMaxProtectedBlocks = (mMaxCachedBlocks * PROTECTED_SEGMENT_PERCENT) / 100;
+}
+
+void
+BlockCache::TouchBlock(BlockEntry& entry)
+{
+  if (entry.IsProtected())
+  {
+    mProtectedList.Remove(entry);
+    mProtectedList.PushFront(entry);
+
+    return;
+  }
+
+  //A second hit proves the block is not part of a one time scan.
+  mProbationList.Remove(entry);
+  entry.MarkProtected(true);
+  mProtectedList.PushFront(entry);
+
+  uint_t secondChances = mProtectedList.Count();
+  while (mProtectedList.Count() > mMaxProtectedBlocks)
+  {
+    BlockEntry* const demoted = mProtectedList.Tail();
+
+    mProtectedList.Remove(*demoted);
+    if (demoted->ClearHits() && (secondChances > 0))
+    {
+      --secondChances;
+      mProtectedList.PushFront(*demoted);
+      continue;
+    }
+
+    demoted->MarkProtected(false);
+    mProbationList.PushFront(*demoted);
+  }
+}
+
+void
+BlockCache::DiscardBlock(BlockEntry& entry, const uint_t itemsPerBlock)
+{
+  assert(entry.IsInUse() == false);
+
+  if (entry.IsProtected())
+    mProtectedList.Remove(entry);
+
+  else
+    mProbationList.Remove(entry);
+
+  uint8_t* const data_ = entry.Data();
+
+  if (entry.IsDirty())
+  {
+    mManager->StoreItems(entry.BaseItem(), itemsPerBlock, data_);
+    ++mDirtyEvictions;
+
+    //The write back thread did not keep up, let it know.
+    WriteBackFlusher::Instance().Wake();
+  }
+
+  ++mEvictions;
+  if (mLastBlock == &entry)
+    mLastBlock = nullptr;
+
+  if (entry.IsMapped())
+  {
+    --mMappedBlocks;
+    mCachedBlocks.erase(entry.BaseItem());
+
+    return;
+  }
+
+  mCachedBlocks.erase(entry.BaseItem());
+
+  delete [] data_;
+}
+
+void
+BlockCache::EvictBlocks(const uint_t itemsPerBlock, const size_t maxBlocks)
+{
+  BlockList* const lists[] = { &mProbationList, &mProtectedList };
+
+  /* With the dirty blocks written in the background, look first for clean
+     victims, so the request is not held by a write. The blocks read ahead
+     and not used yet are not good victims either. */
+  const bool skipDirtyFirst = WriteBackFlusher::Instance().IsRunning();
+
+  uint64_t discarded = 0;
+  for (uint_t pass = skipDirtyFirst ? 0 : 1; pass < 2; ++pass)
+  {
+    for (auto list : lists)
+    {
+      BlockEntry* victim = list->Tail();
+      while ((victim != nullptr) && (mCachedBlocks.size() >= maxBlocks))
+      {
+        BlockEntry* const prev = list->Prev(*victim);
+
+        //Blocks still referenced by someone are skipped, not waited for.
+        if ( ! (victim->IsInUse()
+                || ((pass == 0) && (victim->IsDirty() || victim->IsPrefetched()))))
+        {
+          discarded += victim->IsMapped() ? 0 : mBlockSize;
+          DiscardBlock(*victim, itemsPerBlock);
+        }
+
+        victim = prev;
+      }
+
+      if (mCachedBlocks.size() < maxBlocks)
+        break;
+    }
+
+    if (mCachedBlocks.size() < maxBlocks)
+      break;
+  }
+
+  if (discarded > 0)
+    BufferPool::Instance().Release(*this, discarded);
+
+  /* If every cached block is in use at this moment, let the cache grow beyond
+     its limit rather than blocking; it will shrink back on later misses. */
+}
+
+uint64_t
+BlockCache::ReclaimBuffers(const uint64_t size)
+{
+  LockGuard<RWLock> _l(mSync, true);
+
+  if ( ! _l.try_lock())
+    return 0;
+
+  const uint_t itemsPerBlock = mBlockSize / mItemSize;
+  BlockList* const lists[] = { &mProbationList, &mProtectedList };
+
+  uint64_t released = 0;
+  for (auto list : lists)
+  {
+    BlockEntry* victim = list->Tail();
+    while ((victim != nullptr) && (released < size))
+    {
+      BlockEntry* const prev = list->Prev(*victim);
+
+      /* Dirty blocks are left alone, as writing them back now would race
+         with the owner's use of the underlying storage. */
+      if ( ! (victim->IsInUse() || victim->IsDirty() || victim->IsMapped()))
+      {
+        DiscardBlock(*victim, itemsPerBlock);
+        released += mBlockSize;
+      }
+
+      victim = prev;
+    }
+  }
+
+  return released;
+}
+
 
 } //namespace pastra
 } //namespace whais
@@ -25,13 +25,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PS_BLOCKCACHE_H_
 #define PS_BLOCKCACHE_H_
 
-#include <map>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 #include <assert.h>
 #include <string.h>
 
 #include "whais.h"
 #include "utils/wthread.h"
 
+#include "ps_bufferpool.h"
+
 
 namespace whais {
 namespace pastra  {
@@ -44,25 +48,95 @@ public:
 
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) = 0;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) = 0;
+
+  /* Store a run of adjacent blocks. Managers able to write them with a
+     single request should override this. */
+  virtual void StoreBlocks(uint64_t               firstItem,
+                           const uint_t           itemsPerBlock,
+                           const uint8_t* const*  blocks,
+                           const uint_t           blocksCount)
+  {
+    for (uint_t b = 0; b < blocksCount; ++b, firstItem += itemsPerBlock)
+      StoreItems(firstItem, itemsPerBlock, blocks[b]);
+  }
+
+  /* Retrieve a run of adjacent blocks, used to read ahead during scans.
+     Only the blocks that hold items should be retrieved, the first one
+     always does. Returns the count of the retrieved blocks. Managers that
+     cannot tell where their items end retrieve just the first block. */
+  virtual uint_t RetrieveBlocks(uint64_t               firstItem,
+                                const uint_t           itemsPerBlock,
+                                uint8_t* const*        blocks,
+                                const uint_t           blocksCount)
+  {
+    RetrieveItems(firstItem, itemsPerBlock, blocks[0]);
+    return 1;
+  }
+
+  /* Address of the items if they could be used in place, without copying
+     them in a cache buffer. The memory must stay valid while the manager
+     exists, and storing from it must be handled by the manager. */
+  virtual uint8_t* MapItems(uint64_t firstItem, uint_t itemsCount) { return nullptr; }
 };
 
 
 class BlockEntry
 {
 public:
-  explicit BlockEntry(uint8_t* const data)
-    : mData(data),
+  BlockEntry(const uint64_t baseItem, uint8_t* const data, const bool mapped = false)
+    : mBaseItem(baseItem),
+      mData(data),
+      mPrev(nullptr),
+      mNext(nullptr),
       mReferenceCount(0),
-      mFlags(0)
+      mFlags(mapped ? BLOCK_ENTRY_MAPPED : 0),
+      mRecentHits(0)
   {
     assert(data != nullptr);
   }
 
   bool IsDirty() const { return (mFlags & BLOCK_ENTRY_DIRTY) != 0; }
   bool IsInUse() const { return mReferenceCount > 0; }
-  void MarkDirty() { mFlags |= BLOCK_ENTRY_DIRTY; }
+  bool IsProtected() const { return (mFlags & BLOCK_ENTRY_PROTECTED) != 0; }
+  bool IsMapped() const { return (mFlags & BLOCK_ENTRY_MAPPED) != 0; }
+  bool IsPrefetched() const { return (mFlags & BLOCK_ENTRY_PREFETCHED) != 0; }
+  /* The updates of a mapped block land straight into its storage, so
+     there is never anything left to write back for it. */
+  void MarkDirty()
+  {
+    if ( ! IsMapped())
+      mFlags |= BLOCK_ENTRY_DIRTY;
+  }
   void MarkClean() { mFlags &= ~BLOCK_ENTRY_DIRTY; }
+  void MarkPrefetched(const bool prefetched)
+  {
+    if (prefetched)
+      mFlags |= BLOCK_ENTRY_PREFETCHED;
+
+    else
+      mFlags &= ~BLOCK_ENTRY_PREFETCHED;
+  }
+  void MarkProtected(const bool protect)
+  {
+    if (protect)
+      mFlags |= BLOCK_ENTRY_PROTECTED;
+
+    else
+      mFlags &= ~BLOCK_ENTRY_PROTECTED;
+  }
+  uint64_t BaseItem() const { return mBaseItem; }
   uint8_t* Data() { return mData; }
+  RWLock& Latch() { return mLatch; }
+
+  /* Hits served without reordering the block in its list. They give the
+     block a second chance when it reaches the tail of the list. */
+  void MarkHit() { wh_atomic_fetch_inc32(&mRecentHits); }
+  bool ClearHits()
+  {
+    const bool result = mRecentHits > 0;
+    mRecentHits = 0;
+    return result;
+  }
 
   void RegisterUser() { wh_atomic_fetch_inc32(_RC(int32_t*, &mReferenceCount)); }
   void ReleaseUser()
@@ -72,11 +146,110 @@ public:
   }
 
 private:
+  friend class BlockList;
+
+  const uint64_t   mBaseItem;
   uint8_t* const   mData;
+  BlockEntry*      mPrev;
+  BlockEntry*      mNext;
   uint32_t         mReferenceCount;
   uint32_t         mFlags;
+  int32_t          mRecentHits;
+  RWLock           mLatch;
+
+  static const uint32_t BLOCK_ENTRY_DIRTY      = 0x00000001;
+  static const uint32_t BLOCK_ENTRY_PROTECTED  = 0x00000002;
+  static const uint32_t BLOCK_ENTRY_MAPPED     = 0x00000004;
+  static const uint32_t BLOCK_ENTRY_PREFETCHED = 0x00000008;
+};
+
+
+/* Intrusive double linked list of cached blocks. The head holds the most
+   recently used block and the tail the least recently used one. */
+class BlockList
+{
+public:
+  BlockList()
+    : mHead(nullptr),
+      mTail(nullptr),
+      mCount(0)
+  {
+  }
+
+  BlockEntry* Head() const { return mHead; }
+  BlockEntry* Tail() const { return mTail; }
+  BlockEntry* Prev(const BlockEntry& entry) const { return entry.mPrev; }
+  uint_t Count() const { return mCount; }
+
+  void PushFront(BlockEntry& entry)
+  {
+    assert((entry.mPrev == nullptr) && (entry.mNext == nullptr));
+
+    entry.mNext = mHead;
+    if (mHead != nullptr)
+      mHead->mPrev = &entry;
+
+    else
+      mTail = &entry;
+
+    mHead = &entry;
+    ++mCount;
+  }
+
+  void PushBack(BlockEntry& entry)
+  {
+    assert((entry.mPrev == nullptr) && (entry.mNext == nullptr));
+
+    entry.mPrev = mTail;
+    if (mTail != nullptr)
+      mTail->mNext = &entry;
+
+    else
+      mHead = &entry;
+
+    mTail = &entry;
+    ++mCount;
+  }
+
+  void Remove(BlockEntry& entry)
+  {
+    assert(mCount > 0);
+
+    if (entry.mPrev != nullptr)
+      entry.mPrev->mNext = entry.mNext;
+
+    else
+      mHead = entry.mNext;
+
+    if (entry.mNext != nullptr)
+      entry.mNext->mPrev = entry.mPrev;
+
+    else
+      mTail = entry.mPrev;
+
+    entry.mPrev = entry.mNext = nullptr;
+    --mCount;
+  }
+
+private:
+  BlockEntry*   mHead;
+  BlockEntry*   mTail;
+  uint_t        mCount;
+};
+
 
-  static const uint32_t BLOCK_ENTRY_DIRTY = 0x00000001;
+struct BlockCacheStats
+{
+  uint64_t mHits;
+  uint64_t mMisses;
+  uint64_t mEvictions;
+  uint64_t mDirtyEvictions;
+  uint64_t mWrittenBack;
+  uint64_t mPrefetched;
+  uint64_t mPrefetchHits;
+  uint_t   mCachedBlocks;
+  uint_t   mProtectedBlocks;
+  uint_t   mMappedBlocks;
 };
 
 
@@ -121,6 +294,21 @@ public:
 
   const uint8_t* GetDataForRead() const { return mBlockEntry->Data() + mItemOffset; }
 
+  /* For the users that spread the content of an item over its block. */
+  uint8_t* GetBlockForUpdate() const
+  {
+    mBlockEntry->MarkDirty();
+    return mBlockEntry->Data();
+  }
+
+  const uint8_t* GetBlockForRead() const { return mBlockEntry->Data(); }
+  uint_t ItemOffset() const { return mItemOffset; }
+
+  /* Guards the content of the item's block against concurrent updates.
+     The cache itself does not take it; it is up to the users to hold it
+     shared for reading or exclusive for updating the items. */
+  RWLock& Latch() const { return mBlockEntry->Latch(); }
+
 protected:
 
   BlockEntry* const   mBlockEntry;
@@ -128,11 +316,20 @@ protected:
 };
 
 
-class BlockCache
+/* Caches blocks of items using a segmented LRU replacement policy. Newly
+   loaded blocks enter a probation segment and are promoted to the protected
+   segment only when they are accessed again, so a one time scan over a large
+   range of items cannot push out the blocks that are used often. The memory
+   of the cached blocks is accounted in the process wide buffer pool; when
+   that is limited, the cache's blocks budget follows its fair share of it.
+   When the misses follow each other block after block, the next blocks are
+   read ahead with the missed one. The blocks of such a scan are moved at the
+   tail of the probation segment once used, to be the first evicted. */
+class BlockCache : public IBufferPoolClient
 {
 public:
   BlockCache();
-  ~BlockCache();
+  virtual ~BlockCache() override;
 
   void Init(IBlocksManager&   blocksMgr,
             const uint_t      itemSize,
@@ -145,14 +342,67 @@ public:
   void RefreshItem(const uint64_t item);
   StoredItem RetriveItem(const uint64_t item);
 
+  /* Write some of the dirty blocks without taking them out of the cache,
+     starting with the ones that are next to be evicted. Nothing is written
+     until the dirty blocks reach the high watermark, then they are written
+     down to the low watermark. When it's urgent, the dirty blocks of the
+     probation segment are written regardless. The blocks latched by someone
+     else are skipped. The caller has to make sure the items are not updated
+     without holding their block's latch. Returns the count of the blocks
+     written. */
+  uint_t WriteBack(const bool urgent);
+
+  BlockCacheStats Statistics() const;
+
+  /* The items of a block follow each other in its data, starting with the
+     one whose index is a multiple of this count. */
+  uint_t ItemsPerBlock() const { return mBlockSize / mItemSize; }
+
+  virtual uint64_t ReclaimBuffers(const uint64_t size) override;
+
+  /* Percentage of the cache's blocks budget allowed in the protected segment. */
+  static const uint_t PROTECTED_SEGMENT_PERCENT = 80;
+
+  /* Watermarks of the dirty blocks, as percentages of the blocks budget. */
+  static const uint_t DIRTY_HIGH_WATERMARK_PERCENT = 25;
+  static const uint_t DIRTY_LOW_WATERMARK_PERCENT  = 10;
+
+  /* Consecutive misses of adjacent blocks that start the read ahead, and
+     how many blocks are read ahead (at most a quarter of the cache). */
+  static const uint_t SEQUENTIAL_MISSES_TRIGGER = 2;
+  static const uint_t READ_AHEAD_BLOCKS         = 8;
+
 private:
+  void FlushBlock(const uint64_t baseBlockItem);
+  void EvictBlocks(const uint_t itemsPerBlock, const size_t maxBlocks);
+  void StoreRun(const std::vector<BlockEntry*>& run, const uint_t itemsPerBlock);
+  void DiscardBlock(BlockEntry& entry, const uint_t itemsPerBlock);
+  void TouchBlock(BlockEntry& entry);
+  void UpdateBudget();
+
   IBlocksManager  *mManager;
   uint_t           mItemSize;
   uint_t           mBlockSize;
   uint_t           mMaxCachedBlocks;
+  uint_t           mMaxProtectedBlocks;
   bool             mSkipFlush;
 
-  std::map<uint64_t, BlockEntry> mCachedBlocks;
+  std::unordered_map<uint64_t, BlockEntry> mCachedBlocks;
+  BlockList                                mProbationList;
+  BlockList                                mProtectedList;
+  BlockEntry*                              mLastBlock;
+  uint64_t                                 mNextSequentialItem;
+  uint_t                                   mSequentialMisses;
+  mutable RWLock                           mSync;
+
+  std::atomic<uint64_t> mHits;
+  uint64_t              mMisses;
+  uint64_t              mEvictions;
+  uint64_t              mDirtyEvictions;
+  uint64_t              mWrittenBack;
+  uint64_t              mPrefetched;
+  uint64_t              mPrefetchHits;
+  uint_t                mMappedBlocks;
 };
 
 
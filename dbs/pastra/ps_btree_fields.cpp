@@ -48,6 +48,9 @@ FieldIndexNodeManager::FieldIndexNodeManager(unique_ptr<IDataContainer>&   conta
     InitContainer();
 
   InitFromContainer();
+
+  //Have the root allocated before the tree is shared between sessions.
+  RootNodeId();
 }
 
 FieldIndexNodeManager::~FieldIndexNodeManager()
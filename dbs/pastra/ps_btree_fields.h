@@ -27,8 +27,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <assert.h>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include "whais.h"
+#include "dbs/dbs_rowsset.h"
 #include "ps_btree_index.h"
 #include "ps_container.h"
 #include "ps_serializer.h"
@@ -100,6 +103,10 @@ public:
                        KEY_INDEX toPos,
                        const ROW_INDEX fromRow,
                        const ROW_INDEX toRow, DArray& output) const = 0;
+  virtual void GetRows(KEY_INDEX fromPos,
+                       KEY_INDEX toPos,
+                       const ROW_INDEX fromRow,
+                       const ROW_INDEX toRow, RowsSet& output) const = 0;
 };
 
 
@@ -399,6 +406,29 @@ public:
                        const ROW_INDEX fromRow,
                        const ROW_INDEX toRow,
                        DArray& output) const
+  {
+    VisitRows(fromPos,
+              toPos,
+              fromRow,
+              toRow,
+              [&output](const ROW_INDEX row) { output.Add(DROW_INDEX(row)); });
+  }
+
+  virtual void GetRows(KEY_INDEX fromPos,
+                       KEY_INDEX toPos,
+                       const ROW_INDEX fromRow,
+                       const ROW_INDEX toRow,
+                       RowsSet& output) const
+  {
+    VisitRows(fromPos, toPos, fromRow, toRow, [&output](const ROW_INDEX row) { output.Add(row); });
+  }
+
+private:
+  template<class VISITOR> void VisitRows(KEY_INDEX fromPos,
+                                         KEY_INDEX toPos,
+                                         const ROW_INDEX fromRow,
+                                         const ROW_INDEX toRow,
+                                         VISITOR visitor) const
   {
     assert(fromPos >= toPos);
     assert(fromPos < KeysCount());
@@ -410,20 +440,9 @@ public:
 
     while (fromPos >= toPos)
     {
-      const auto row = Serializer::LoadRow(rows + fromPos);
+      const ROW_INDEX row = Serializer::LoadRow(rows + fromPos);
       if (fromRow <= row && row <= toRow)
-      {
-        if (sizeof(ROW_INDEX) == 8)
-          output.Add(DUInt64(Serializer::LoadRow(rows + fromPos)));
-
-        else if (sizeof(ROW_INDEX) == 4)
-          output.Add(DUInt32(Serializer::LoadRow(rows + fromPos)));
-
-        else
-        {
-          assert(false);
-        }
-      }
+        visitor(row);
 
       if (fromPos == 0)
         break;
@@ -432,7 +451,6 @@ public:
     }
   }
 
-private:
   const T_BTreeKey<DBS_T> GetKey(const KEY_INDEX keyIndex) const
   {
     assert(keyIndex < KeysCount());
@@ -522,6 +540,11 @@ public:
 
   void MarkForRemoval();
   uint64_t IndexRawSize() const;
+  const IDataContainer& Container() const { return *mContainer; }
+
+  template<class DBS_T, class KEYS_SOURCE>
+  void BulkLoad(KEYS_SOURCE& keys, const uint64_t keysCount, const uint_t fillFactor);
+
   virtual uint64_t NodeRawSize() const override;
   virtual NODE_INDEX AllocateNode(const NODE_INDEX parent, const KEY_INDEX  parentKey) override;
   virtual void FreeNode(const NODE_INDEX nodeId) override;
@@ -539,6 +562,15 @@ protected:
 
   IBTreeNode* NodeFactory(const NODE_INDEX nodeId);
 
+  template<class DBS_T> using LevelEntries = std::vector<std::pair<T_BTreeKey<DBS_T>, NODE_INDEX>>;
+
+  template<class DBS_T, class KEYS_SOURCE>
+  void BulkLoadLevel(KEYS_SOURCE&          keys,
+                     const uint64_t        keysCount,
+                     const bool            leaves,
+                     const uint_t          fillFactor,
+                     LevelEntries<DBS_T>&  outParentEntries);
+
   const uint_t                      mNodeSize;
   const uint_t                      mMaxCachedMem;
   NODE_INDEX                        mRootNode;
@@ -548,6 +580,107 @@ protected:
 };
 
 
+/* Build the index bottom up from its keys, supplied in descending order.
+   The nodes of each level are packed up to 'fillFactor' percents of their
+   capacity and are written one after the other at the container's end.
+   The index should hold no keys yet. */
+template<class DBS_T, class KEYS_SOURCE> void
+FieldIndexNodeManager::BulkLoad(KEYS_SOURCE&      keys,
+                                const uint64_t    keysCount,
+                                const uint_t      fillFactor)
+{
+  const NODE_INDEX emptyRoot = RootNodeId();
+  const T_BTreeKey<DBS_T> sentinel = _SC(const T_BTreeKey<DBS_T>&,
+                                         RetrieveNode(emptyRoot)->SentinelKey());
+
+  assert(RetrieveNode(emptyRoot)->IsLeaf());
+  assert(RetrieveNode(emptyRoot)->KeysCount() == 1);
+
+  //The leaves hold the sentinel key too, the parents get it from them.
+  bool sentinelSent = false;
+  auto leafKeys = [&keys, &sentinel, &sentinelSent] () -> std::pair<T_BTreeKey<DBS_T>, NODE_INDEX>
+  {
+    if (sentinelSent)
+      return std::make_pair(keys(), NIL_NODE);
+
+    sentinelSent = true;
+    return std::make_pair(sentinel, NIL_NODE);
+  };
+
+  LevelEntries<DBS_T> entries;
+  BulkLoadLevel(leafKeys, keysCount + 1, true, fillFactor, entries);
+
+  while (entries.size() > 1)
+  {
+    LevelEntries<DBS_T> parentEntries;
+
+    auto child = entries.cbegin();
+    auto childKeys = [&child] () { return *child++; };
+
+    BulkLoadLevel(childKeys, entries.size(), false, fillFactor, parentEntries);
+    entries.swap(parentEntries);
+  }
+
+  RootNodeId(entries[0].second);
+  FreeNode(emptyRoot);
+}
+
+
+template<class DBS_T, class KEYS_SOURCE> void
+FieldIndexNodeManager::BulkLoadLevel(KEYS_SOURCE&           keys,
+                                     const uint64_t         keysCount,
+                                     const bool             leaves,
+                                     const uint_t           fillFactor,
+                                     LevelEntries<DBS_T>&   outParentEntries)
+{
+  assert(mContainer->Size() % NodeRawSize() == 0);
+
+  const NODE_INDEX firstNode = mContainer->Size() / NodeRawSize();
+
+  std::unique_ptr<IBTreeNode> node(NodeFactory(firstNode));
+  node->Leaf(leaves);
+
+  /* Stay between the limits that would get the nodes joined or split
+     right on the next update. */
+  const uint_t keysPerNode = node->KeysPerNode();
+  const uint_t nodeKeys = MAX(MIN(keysPerNode * fillFactor / 100, 2 * keysPerNode / 3 - 2),
+                              keysPerNode / 3);
+
+  const uint64_t nodesCount = (keysCount + nodeKeys - 1) / nodeKeys;
+
+  outParentEntries.reserve(nodesCount);
+  for (uint64_t n = 0; n < nodesCount; ++n)
+  {
+    const NODE_INDEX nodeId = firstNode + n;
+
+    node.reset(NodeFactory(nodeId));
+    node->Leaf(leaves);
+    node->MarkAsUsed();
+    node->KeysCount(0);
+    node->Next((n == 0) ? NIL_NODE : nodeId - 1);
+    node->Prev((n + 1 == nodesCount) ? NIL_NODE : nodeId + 1);
+
+    const uint64_t count = keysCount / nodesCount + ((n < keysCount % nodesCount) ? 1 : 0);
+    for (uint64_t k = 0; k < count; ++k)
+    {
+      const auto entry = keys();
+
+      //Keys come in descending order, so they are always appended.
+      const KEY_INDEX keyIndex = node->InsertKey(entry.first);
+      assert(keyIndex == k);
+
+      if ( ! leaves)
+        node->SetNodeOfKey(keyIndex, entry.second);
+
+      if (k == 0)
+        outParentEntries.emplace_back(entry.first, nodeId);
+    }
+
+    mContainer->Write(nodeId * NodeRawSize(), NodeRawSize(), node->RawData());
+  }
+}
+
+
 } //namespace pastra
 } //namespace whais
 
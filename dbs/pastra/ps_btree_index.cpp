@@ -38,7 +38,8 @@ IBTreeNode::IBTreeNode(IBTreeNodeManager& nodesManager, const NODE_INDEX nodeId)
   : mNodesMgr(nodesManager),
     mRawNodeSize(nodesManager.NodeRawSize()),
     mNodeBuffer(unique_array_make(uint8_t, mRawNodeSize)),
-    mHeader(_RC(NodeHeader*, mNodeBuffer.get()))
+    mHeader(_RC(NodeHeader*, mNodeBuffer.get())),
+    mLatch()
 {
   assert(nodeId != NIL_NODE);
 
@@ -159,12 +160,18 @@ IBTreeNode::Release()
 
 IBTreeNodeManager::IBTreeNodeManager()
   : mSync(),
-    mNodesKeeper()
+    mTreeLatch(),
+    mNodesKeeper(),
+    mNodesRetrieved(0),
+    mNodesLoaded(0)
 {
+  BufferPool::Instance().Register(*this);
 }
 
 IBTreeNodeManager::~IBTreeNodeManager()
 {
+  BufferPool::Instance().Unregister(*this);
+
 #ifndef NDEBUG
   for (auto& node : mNodesKeeper)
   {
@@ -254,6 +261,15 @@ IBTreeNodeManager::Join(const NODE_INDEX parentId, const NODE_INDEX nodeId)
 }
 
 
+void
+IBTreeNodeManager::NodesStatistics(uint64_t* const outRetrieved, uint64_t* const outLoaded)
+{
+  LockGuard<Lock> syncHolder(mSync);
+
+  *outRetrieved = mNodesRetrieved;
+  *outLoaded = mNodesLoaded;
+}
+
 std::shared_ptr<IBTreeNode>
 IBTreeNodeManager::RetrieveNode(const NODE_INDEX nodeId)
 {
@@ -262,19 +278,30 @@ IBTreeNodeManager::RetrieveNode(const NODE_INDEX nodeId)
   LockGuard<Lock> syncHolder(mSync);
   auto it = mNodesKeeper.find(nodeId);
 
+  BufferPool& pool = BufferPool::Instance();
+  bool overBudget = false;
+
+  ++mNodesRetrieved;
   if (it == mNodesKeeper.end())
   {
+    ++mNodesLoaded;
+
     pair<NODE_INDEX, CachedData> cachedNode(nodeId, CachedData(LoadNode(nodeId)));
     mNodesKeeper.insert(cachedNode);
 
     it = mNodesKeeper.find(nodeId);
 
     assert(it != mNodesKeeper.end());
+
+    overBudget = ! pool.Reserve(*this, it->second.mNode->RawSize());
   }
 
+  /* When the pool is limited it's the one to tell when to trim the cache. */
   shared_ptr<IBTreeNode> result = it->second.mNode;
-  if (mNodesKeeper.size() > MaxCachedNodes())
+  if (overBudget || ( ! pool.IsLimited() && (mNodesKeeper.size() > MaxCachedNodes())))
   {
+    uint64_t released = 0;
+
     it = mNodesKeeper.begin();
     while (it != mNodesKeeper.end())
     {
@@ -283,11 +310,15 @@ IBTreeNodeManager::RetrieveNode(const NODE_INDEX nodeId)
       if ( ! it->second.IsUsed() && it->first != RootNodeId())
       {
         SaveNode(it->second.mNode.get());
+        released += it->second.mNode->RawSize();
         mNodesKeeper.erase(it++);
       }
       else
         ++it;
     }
+
+    if (released > 0)
+      pool.Release(*this, released);
   }
 
   assert(mNodesKeeper.find(nodeId)->second.IsUsed());
@@ -323,43 +354,116 @@ IBTreeNodeManager::FlushNodes()
 }
 
 
+uint64_t
+IBTreeNodeManager::ReclaimBuffers(const uint64_t size)
+{
+  LockGuard<Lock> syncHolder(mSync, true);
+
+  if ( ! syncHolder.try_lock())
+    return 0;
+
+  uint64_t released = 0;
+
+  auto it = mNodesKeeper.begin();
+  while ((it != mNodesKeeper.end()) && (released < size))
+  {
+    //Only clean nodes could be dropped without touching the storage.
+    if ( ! (it->second.IsUsed() || it->second.mNode->IsDirty()))
+    {
+      released += it->second.mNode->RawSize();
+      mNodesKeeper.erase(it++);
+    }
+    else
+      ++it;
+  }
+
+  return released;
+}
+
+
 BTree::BTree(IBTreeNodeManager& nodesManager)
   : mNodesManager(nodesManager)
 {
 }
 
 
+static void
+latch_node(IBTreeNode& node)
+{
+  //Only the leaves are changed without holding the whole tree.
+  if (node.IsLeaf())
+    node.Latch().lock();
+
+  else
+    node.Latch().lock_shared();
+}
+
+
+static void
+unlatch_node(IBTreeNode& node)
+{
+  if (node.IsLeaf())
+    node.Latch().unlock();
+
+  else
+    node.Latch().unlock_shared();
+}
+
+
 bool
-BTree::FindBiggerOrEqual(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex)
+BTree::FindBiggerOrEqual(const IBTreeKey&  key,
+                         NODE_INDEX*       outNode,
+                         KEY_INDEX*        outKeyIndex,
+                         const bool        threadSafe)
 {
+  SharedLockGuard<RWLock> treeHolder(mNodesManager.TreeLatch(), ! threadSafe);
+
   *outNode = mNodesManager.RootNodeId();
 
   auto node = mNodesManager.RetrieveNode(*outNode);
-  do
+  node->Latch().lock_shared();
+  try
   {
-    const bool found = node->FindBiggerOrEqual(key, outKeyIndex);
+    do
+    {
+      const bool found = node->FindBiggerOrEqual(key, outKeyIndex);
 
-    (void) found;
-    assert(found != false);
+      (void) found;
+      assert(found != false);
 
-    if (node->IsLeaf())
-      break;
+      if (node->IsLeaf())
+        break;
 
-    *outNode = node->NodeIdOfKey(*outKeyIndex);
-    node = mNodesManager.RetrieveNode(*outNode);
-  } while (true);
+      *outNode = node->NodeIdOfKey(*outKeyIndex);
 
-  if (*outKeyIndex == 0
-      && node->CompareKey(node->SentinelKey(), 0) == 0)
+      auto child = mNodesManager.RetrieveNode(*outNode);
+      child->Latch().lock_shared();
+      node->Latch().unlock_shared();
+      node = child;
+    } while (true);
+  }
+  catch (...)
   {
-    return false;
+    node->Latch().unlock_shared();
+    throw;
   }
-  return true;
+
+  const bool result = (*outKeyIndex != 0)
+                      || (node->CompareKey(node->SentinelKey(), 0) != 0);
+
+  node->Latch().unlock_shared();
+
+  return result;
 }
 
 
 void BTree::InsertKey(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex)
 {
+  if (TryInsertLeafKey(key, outNode, outKeyIndex))
+    return;
+
+  LockGuard<RWLock> treeHolder(mNodesManager.TreeLatch());
+
   bool tryAgain = false;
   do
   {
@@ -375,6 +479,11 @@ void BTree::InsertKey(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outK
 void
 BTree::RemoveKey(const IBTreeKey& key)
 {
+  if (TryRemoveLeafKey(key))
+    return;
+
+  LockGuard<RWLock> treeHolder(mNodesManager.TreeLatch());
+
   auto node = mNodesManager.RetrieveNode(mNodesManager.RootNodeId());
 
   RecursiveDeleteNodeKey(*node, key);
@@ -390,6 +499,124 @@ BTree::RemoveKey(const IBTreeKey& key)
 }
 
 
+bool
+BTree::TryInsertLeafKey(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex)
+{
+  SharedLockGuard<RWLock> treeHolder(mNodesManager.TreeLatch());
+
+  *outNode = mNodesManager.RootNodeId();
+
+  auto node = mNodesManager.RetrieveNode(*outNode);
+  latch_node(*node);
+  try
+  {
+    while (true)
+    {
+      //Splitting a node changes its parent too, so let it for the slow path.
+      if (node->NeedsSpliting())
+      {
+        unlatch_node(*node);
+        return false;
+      }
+
+      if (node->FindBiggerOrEqual(key, outKeyIndex) == false)
+      {
+        //The sentinel shall be the biggest.
+        assert(false);
+      }
+
+      if (node->IsLeaf())
+        break;
+
+      *outNode = node->NodeIdOfKey(*outKeyIndex);
+
+      auto child = mNodesManager.RetrieveNode(*outNode);
+      latch_node(*child);
+      unlatch_node(*node);
+      node = child;
+    }
+
+    if (node->CompareKey(key, *outKeyIndex) == 0)
+      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+
+    *outKeyIndex += 1;
+
+    assert(*outKeyIndex < node->KeysPerNode() - 1);
+
+    node->InsertKey(key);
+  }
+  catch (...)
+  {
+    unlatch_node(*node);
+    throw;
+  }
+
+  unlatch_node(*node);
+
+  return true;
+}
+
+
+bool
+BTree::TryRemoveLeafKey(const IBTreeKey& key)
+{
+  SharedLockGuard<RWLock> treeHolder(mNodesManager.TreeLatch());
+
+  const NODE_INDEX rootId = mNodesManager.RootNodeId();
+
+  auto node = mNodesManager.RetrieveNode(rootId);
+  latch_node(*node);
+  try
+  {
+    KEY_INDEX keyIndex = ~0;
+    while (true)
+    {
+      if (node->FindBiggerOrEqual(key, &keyIndex) == false)
+      {
+        assert(false);
+      }
+
+      if (node->IsLeaf())
+        break;
+
+      auto child = mNodesManager.RetrieveNode(node->NodeIdOfKey(keyIndex));
+      latch_node(*child);
+
+      if (child->NeedsJoining())
+      {
+        unlatch_node(*child);
+        unlatch_node(*node);
+        return false;
+      }
+
+      unlatch_node(*node);
+      node = child;
+    }
+
+    if (node->CompareKey(key, keyIndex) == 0)
+    {
+      //The first key of a node is also kept by its parent.
+      if ((keyIndex == 0) && (node->NodeId() != rootId))
+      {
+        unlatch_node(*node);
+        return false;
+      }
+
+      node->RemoveKey(keyIndex);
+    }
+  }
+  catch (...)
+  {
+    unlatch_node(*node);
+    throw;
+  }
+
+  unlatch_node(*node);
+
+  return true;
+}
+
+
 bool
 BTree::RecursiveInsertNodeKey(const NODE_INDEX   parentId,
                               const NODE_INDEX   nodeId,
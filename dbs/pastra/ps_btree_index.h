@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "whais.h"
 #include "utils/wthread.h"
 #include "ps_serializer.h"
+#include "ps_bufferpool.h"
 
 
 namespace whais {
@@ -70,6 +71,7 @@ public:
   const uint8_t* DataForRead() const { return _RC(const uint8_t*, mHeader + 1); }
   uint8_t* DataForWrite() { MarkDirty(); return _RC(uint8_t*, mHeader + 1); }
   uint8_t* RawData() const { return mNodeBuffer.get(); }
+  uint_t RawSize() const { return mRawNodeSize; }
 
   void MarkDirty() { mHeader->mDirty = 1; }
   void MarkClean() { mHeader->mDirty = 0; }
@@ -114,6 +116,8 @@ public:
   bool FindBiggerOrEqual(const IBTreeKey& key, KEY_INDEX* const outIndex) const;
   void Release();
 
+  RWLock& Latch() { return mLatch; }
+
 protected:
   struct NodeHeader
   {
@@ -135,14 +139,15 @@ protected:
 private:
   std::unique_ptr<uint8_t[]> mNodeBuffer;
   NodeHeader* const          mHeader;
+  RWLock                     mLatch;
 };
 
 
-class IBTreeNodeManager
+class IBTreeNodeManager : public IBufferPoolClient
 {
 public:
   IBTreeNodeManager();
-  virtual ~IBTreeNodeManager();
+  virtual ~IBTreeNodeManager() override;
 
   void Split(NODE_INDEX parentId, const NODE_INDEX nodeId);
   void Join(const NODE_INDEX parentId, const NODE_INDEX nodeId);
@@ -159,6 +164,13 @@ public:
   virtual NODE_INDEX RootNodeId() = 0;
   virtual void RootNodeId(const NODE_INDEX nodeId) = 0;
 
+  virtual uint64_t ReclaimBuffers(const uint64_t size) override;
+
+  RWLock& TreeLatch() { return mTreeLatch; }
+
+  //How many nodes were asked for, and how many of them had to be loaded.
+  void NodesStatistics(uint64_t* const outRetrieved, uint64_t* const outLoaded);
+
 protected:
   struct CachedData
   {
@@ -181,20 +193,34 @@ protected:
 
 
   Lock                               mSync;
+  RWLock                             mTreeLatch;
   std::map<NODE_INDEX, CachedData>   mNodesKeeper;
+  uint64_t                           mNodesRetrieved;
+  uint64_t                           mNodesLoaded;
 };
 
 
+/* Lookups and the updates that stay within one leaf hold the tree latch
+   shared and couple the node latches on their way down (a node is released
+   only after its child was latched). Updates that have to split or join
+   nodes, or change a parent's key, retry with the tree latch held exclusive
+   and don't bother with the node latches. */
 class BTree
 {
 public:
   BTree(IBTreeNodeManager& nodesManager);
 
-  bool FindBiggerOrEqual(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex);
+  bool FindBiggerOrEqual(const IBTreeKey&  key,
+                         NODE_INDEX*       outNode,
+                         KEY_INDEX*        outKeyIndex,
+                         const bool        threadSafe = true);
   void InsertKey(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex);
   void RemoveKey(const IBTreeKey& key);
 
 private:
+  bool TryInsertLeafKey(const IBTreeKey& key, NODE_INDEX* outNode, KEY_INDEX* outKeyIndex);
+  bool TryRemoveLeafKey(const IBTreeKey& key);
+
   bool RecursiveInsertNodeKey(const NODE_INDEX    parentId,
                                const NODE_INDEX   nodeId,
                                const IBTreeKey&   key,
@@ -0,0 +1,166 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+
+#include "ps_bufferpool.h"
+
+
+using namespace std;
+
+namespace whais {
+namespace pastra {
+
+
+BufferPool::BufferPool()
+  : mSync(),
+    mCapacity(0),
+    mUsed(0),
+    mReclaimed(0),
+    mClients()
+{
+}
+
+BufferPool&
+BufferPool::Instance()
+{
+  static BufferPool pool;
+
+  return pool;
+}
+
+void
+BufferPool::Capacity(const uint64_t capacity)
+{
+  LockGuard<Lock> _l(mSync);
+
+  mCapacity = capacity;
+}
+
+uint64_t
+BufferPool::FairShare()
+{
+  LockGuard<Lock> _l(mSync);
+
+  return mClients.empty() ? mCapacity : mCapacity / mClients.size();
+}
+
+void
+BufferPool::Register(IBufferPoolClient& client)
+{
+  LockGuard<Lock> _l(mSync);
+
+  assert(mClients.find(&client) == mClients.end());
+
+  mClients[&client] = 0;
+}
+
+void
+BufferPool::Unregister(IBufferPoolClient& client)
+{
+  LockGuard<Lock> _l(mSync);
+
+  auto it = mClients.find(&client);
+  if (it == mClients.end())
+    return;
+
+  assert(mUsed >= it->second);
+
+  mUsed -= it->second;
+  mClients.erase(it);
+}
+
+bool
+BufferPool::Reserve(IBufferPoolClient& client, const uint64_t size)
+{
+  LockGuard<Lock> _l(mSync);
+
+  auto it = mClients.find(&client);
+
+  assert(it != mClients.end());
+
+  it->second += size;
+  mUsed      += size;
+
+  if ((mCapacity == 0) || (mUsed <= mCapacity))
+    return true;
+
+  //A cache that holds more than its share has to make room by itself.
+  const uint64_t fairShare = mCapacity / mClients.size();
+  if (it->second > fairShare)
+    return false;
+
+  auto victim = mClients.end();
+  for (auto c = mClients.begin(); c != mClients.end(); ++c)
+  {
+    if ((c != it) && ((victim == mClients.end()) || (victim->second < c->second)))
+      victim = c;
+  }
+
+  if ((victim == mClients.end()) || (victim->second <= it->second))
+    return false;
+
+  const uint64_t released = victim->first->ReclaimBuffers(mUsed - mCapacity);
+
+  assert(released <= victim->second);
+
+  victim->second -= released;
+  mUsed          -= released;
+  mReclaimed     += released;
+
+  return mUsed <= mCapacity;
+}
+
+void
+BufferPool::Release(IBufferPoolClient& client, const uint64_t size)
+{
+  LockGuard<Lock> _l(mSync);
+
+  auto it = mClients.find(&client);
+
+  assert(it != mClients.end());
+  assert((it->second >= size) && (mUsed >= size));
+
+  it->second -= size;
+  mUsed      -= size;
+}
+
+BufferPoolStats
+BufferPool::Statistics()
+{
+  LockGuard<Lock> _l(mSync);
+
+  BufferPoolStats result;
+
+  result.mCapacity     = mCapacity;
+  result.mUsed         = mUsed;
+  result.mReclaimed    = mReclaimed;
+  result.mClientsCount = mClients.size();
+
+  return result;
+}
+
+
+} //namespace pastra
+} //namespace whais
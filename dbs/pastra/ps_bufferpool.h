@@ -0,0 +1,108 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PS_BUFFERPOOL_H_
+#define PS_BUFFERPOOL_H_
+
+#include <map>
+
+#include "whais.h"
+#include "utils/wthread.h"
+
+
+namespace whais {
+namespace pastra  {
+
+
+/* Implemented by every cache that takes its memory from the buffer pool. */
+class IBufferPoolClient
+{
+public:
+  virtual ~IBufferPoolClient() = default;
+
+  /* Drop clean and unused buffers until at least 'size' bytes are freed.
+     It's called from another cache's context, with the pool lock held, so
+     it must not block on the client's own lock and must not call back into
+     the pool. Returns the amount of memory that was actually released. */
+  virtual uint64_t ReclaimBuffers(const uint64_t size) = 0;
+};
+
+
+struct BufferPoolStats
+{
+  uint64_t mCapacity;
+  uint64_t mUsed;
+  uint64_t mReclaimed;
+  uint_t   mClientsCount;
+};
+
+
+/* Accounts the memory used by all block and B-tree node caches of the
+   process against a single limit. When the limit is reached, a cache that
+   uses less than its fair share gets memory reclaimed from the biggest
+   consumer, while a cache that already uses more than that is asked to
+   recycle its own buffers. A capacity of 0 means no global limit; each
+   cache is then bounded only by its own settings. */
+class BufferPool
+{
+public:
+  static BufferPool& Instance();
+
+  void Capacity(const uint64_t capacity);
+  uint64_t Capacity() const { return mCapacity; }
+  bool IsLimited() const { return mCapacity > 0; }
+
+  /* The part of the capacity each registered client is entitled to. */
+  uint64_t FairShare();
+
+  void Register(IBufferPoolClient& client);
+  void Unregister(IBufferPoolClient& client);
+
+  /* Charges 'size' bytes to the client. Returns false if the pool is
+     exhausted, in which case the client should release some of its own
+     buffers. The memory is charged regardless. */
+  bool Reserve(IBufferPoolClient& client, const uint64_t size);
+  void Release(IBufferPoolClient& client, const uint64_t size);
+
+  BufferPoolStats Statistics();
+
+private:
+  BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator= (const BufferPool&) = delete;
+
+  Lock                                    mSync;
+  uint64_t                                mCapacity;
+  uint64_t                                mUsed;
+  uint64_t                                mReclaimed;
+  std::map<IBufferPoolClient*, uint64_t>  mClients;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_BUFFERPOOL_H_ */
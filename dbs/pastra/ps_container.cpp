@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "dbs/dbs_mgr.h"
 #include "ps_container.h"
+#include "ps_wal.h"
 
 
 using namespace std;
@@ -145,10 +146,17 @@ WFileContainerException::Description() const
 FileContainer::FileContainer(const char*       baseName,
                              const uint64_t    maxFileSize,
                              const uint64_t    unitsCount,
-                             const bool        truncate)
+                             const bool        truncate,
+                             WriteAheadLog*    log,
+                             const uint32_t    logOwner)
   : mMaxFileUnitSize(maxFileSize),
     mFilesHandles(),
+    mLogFiles(),
     mFileNamePrefix(baseName),
+    mLog(log),
+    mLogOwner(logOwner),
+    mBytesRead(0),
+    mBytesWritten(0),
     mToRemove(false),
     mIgnoreExistingData(truncate)
 {
@@ -194,27 +202,87 @@ FileContainer::FileContainer(const char*       baseName,
                                     maxFileSize);
     }
   }
+
+  if (mLog != nullptr)
+  {
+    for (uint_t unit = 0; unit < unitsCount; ++unit)
+    {
+      const string baseName = mFileNamePrefix + (unit ? to_string(unit) : "");
+
+      mLogFiles.push_back(mLog->RegisterFile(baseName, mLogOwner, mFilesHandles[unit].Size()));
+    }
+  }
 }
 
 FileContainer::~FileContainer()
 {
   if (mToRemove)
     Colapse(0, Size() );
+
+  else if (mLog != nullptr)
+  {
+    for (const auto file : mLogFiles)
+      mLog->ReleaseFile(file);
+  }
+}
+
+
+uint64_t
+FileContainer::UnitSize(const uint_t unit) const
+{
+  if (mLog != nullptr)
+    return mLog->FileSize(mLogFiles[unit]);
+
+  return mFilesHandles[unit].Size();
 }
 
+
 void
-FileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
+FileContainer::WriteUnit(const uint_t     unit,
+                         const uint64_t   offset,
+                         const WIOVec*    vecs,
+                         uint_t           vecsCount)
+{
+  if (mLog != nullptr)
+    mLog->Write(mLogOwner, mLogFiles[unit], offset, vecs, vecsCount);
+
+  else
+    mFilesHandles[unit].Write(offset, vecs, vecsCount);
+
+  uint64_t written = 0;
+  for (uint_t v = 0; v < vecsCount; ++v)
+    written += vecs[v].size;
+
+  wh_atomic_fetch_add64(&mBytesWritten, written);
+}
+
+
+void
+FileContainer::ReadUnit(const uint_t     unit,
+                        const uint64_t   offset,
+                        const uint64_t   size,
+                        uint8_t*         buffer)
+{
+  if (mLog != nullptr)
+    mLog->Read(mLogFiles[unit], offset, size, buffer, mFilesHandles[unit]);
+
+  else
+    mFilesHandles[unit].Read(offset, buffer, size);
+
+  wh_atomic_fetch_add64(&mBytesRead, size);
+}
+
+File&
+FileContainer::AccessUnit(const uint64_t unitIndex, const uint64_t unitPosition)
 {
   const uint_t unitsCount = mFilesHandles.size();
-  uint64_t unitIndex = to / mMaxFileUnitSize;
-  uint64_t unitPosition = to % mMaxFileUnitSize;
 
   if (unitIndex > unitsCount)
   {
     throw WFileContainerException(_EXTRA(WFileContainerException::INVALID_ACCESS_POSITION),
                                   "Could not access file container offset %d, "
                                   "unit %d(%d * %lu)!",
-                                  to,
+                                  unitIndex * mMaxFileUnitSize + unitPosition,
                                   unitIndex,
                                   unitsCount,
                                   _SC(long, mMaxFileUnitSize));
@@ -226,7 +294,7 @@ FileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
       throw WFileContainerException(_EXTRA(WFileContainerException::INVALID_ACCESS_POSITION),
                                     "Could not access file container offset %d, "
                                       "unit %d(of %d * %lu).",
-                                     to,
+                                     unitIndex * mMaxFileUnitSize + unitPosition,
                                      unitIndex,
                                      unitsCount,
                                      _SC(long, mMaxFileUnitSize));
@@ -235,25 +303,37 @@ FileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
       ExtendContainer();
   }
 
-  uint64_t actualSize = size;
-
-  if ((actualSize + unitPosition) > mMaxFileUnitSize)
-    actualSize = mMaxFileUnitSize - unitPosition;
-
-  assert(actualSize <= size);
-
   File& file = mFilesHandles[unitIndex];
 
-  if (file.Size() < unitPosition)
+  if (UnitSize(unitIndex) < unitPosition)
   {
     throw WFileContainerException(_EXTRA(WFileContainerException::INVALID_ACCESS_POSITION),
                                   "Unit position %lu(%lu).",
                                   _SC(long, unitPosition),
-                                  _SC(long, file.Size()));
+                                  _SC(long, UnitSize(unitIndex)));
   }
 
-  file.Seek(unitPosition, WH_SEEK_BEGIN);
-  file.Write(buffer, actualSize);
+  return file;
+}
+
+
+void
+FileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
+{
+  const uint64_t unitIndex = to / mMaxFileUnitSize;
+  const uint64_t unitPosition = to % mMaxFileUnitSize;
+
+  AccessUnit(unitIndex, unitPosition);
+
+  uint64_t actualSize = size;
+
+  if ((actualSize + unitPosition) > mMaxFileUnitSize)
+    actualSize = mMaxFileUnitSize - unitPosition;
+
+  assert(actualSize <= size);
+
+  const WIOVec vec = { buffer, _SC(uint_t, actualSize) };
+  WriteUnit(unitIndex, unitPosition, &vec, 1);
 
   //Write the rest
   if (actualSize < size)
@@ -261,6 +341,43 @@ FileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
 }
 
 
+void
+FileContainer::Write(uint64_t to, const WIOVec* vecs, uint_t vecsCount)
+{
+  while (vecsCount > 0)
+  {
+    const uint64_t unitIndex = to / mMaxFileUnitSize;
+    const uint64_t unitPosition = to % mMaxFileUnitSize;
+
+    //Gather the buffers that fit entirely in the current unit.
+    uint64_t gathered = 0;
+    uint_t count = 0;
+    while ((count < vecsCount)
+           && (unitPosition + gathered + vecs[count].size <= mMaxFileUnitSize))
+    {
+      gathered += vecs[count++].size;
+    }
+
+    if (count == 0)
+    {
+      //This one crosses the unit boundary.
+      Write(to, vecs->size, vecs->buffer);
+
+      to += vecs->size;
+      ++vecs, --vecsCount;
+
+      continue;
+    }
+
+    AccessUnit(unitIndex, unitPosition);
+    WriteUnit(unitIndex, unitPosition, vecs, count);
+
+    to += gathered;
+    vecs += count, vecsCount -= count;
+  }
+}
+
+
 void
 FileContainer::Read(uint64_t from, uint64_t size, uint8_t* buffer)
 {
@@ -283,15 +400,12 @@ FileContainer::Read(uint64_t from, uint64_t size, uint8_t* buffer)
                                     unitsCount);
   }
 
-  File& file = mFilesHandles[unitIndex];
-
   uint64_t actualSize = size;
 
-  if (actualSize + unitPosition > file.Size())
-    actualSize = file.Size() - unitPosition;
+  if (actualSize + unitPosition > UnitSize(unitIndex))
+    actualSize = UnitSize(unitIndex) - unitPosition;
 
-  file.Seek(unitPosition, WH_SEEK_BEGIN);
-  file.Read(buffer, actualSize);
+  ReadUnit(unitIndex, unitPosition, actualSize, buffer);
 
   //Read the rest
   if (actualSize < size)
@@ -303,6 +417,29 @@ FileContainer::Read(uint64_t from, uint64_t size, uint8_t* buffer)
 void
 FileContainer::Colapse(uint64_t from, uint64_t to)
 {
+  if (mLog != nullptr)
+  {
+    /* The logged content is collapsed only entirely, when the container is
+       removed. The log forgets the units before their files go away. */
+    if ((from != 0) || (to != Size()))
+    {
+      throw WFileContainerException(_EXTRA(WFileContainerException::INVALID_PARAMETERS),
+                                    "Failed to collapse from %lu to %lu of a logged container.",
+                                    _SC(long, from),
+                                    _SC(long, to));
+    }
+
+    for (const auto file : mLogFiles)
+      mLog->DropFile(file);
+
+    mLog->Sync();
+    mLog = nullptr;
+    mLogFiles.clear();
+
+    Colapse(0, Size());
+    return;
+  }
+
   const uint64_t intervalSize = to - from;
   const uint64_t containerSize = Size();
 
@@ -363,9 +500,7 @@ FileContainer::Size() const
   if (mFilesHandles.size() == 0)
     return 0;
 
-  const File& lastUnitFile = mFilesHandles[mFilesHandles.size() - 1];
-
-  return  (mFilesHandles.size() - 1) * mMaxFileUnitSize + lastUnitFile.Size();
+  return  (mFilesHandles.size() - 1) * mMaxFileUnitSize + UnitSize(mFilesHandles.size() - 1);
 }
 
 
@@ -379,6 +514,10 @@ FileContainer::MarkForRemoval()
 void
 FileContainer::Flush()
 {
+  //The log makes the content durable when its owner commits.
+  if (mLog != nullptr)
+    return;
+
   for (auto& f : mFilesHandles)
     f.Sync();
 }
@@ -427,10 +566,186 @@ FileContainer::ExtendContainer()
   const uint_t count = mFilesHandles.size();
   const string baseName = mFileNamePrefix + (count ? to_string(count) : "");
 
-  const uint_t openMode = mIgnoreExistingData
+  /* A logged container could find a unit left by a crash before it was
+     committed, so its content is not of use. */
+  const uint_t openMode = (mIgnoreExistingData || (mLog != nullptr))
                             ? WH_FILECREATE | WH_FILETRUNC | WH_FILERDWR
                             : WH_FILECREATE_NEW | WH_FILERDWR;
   mFilesHandles.push_back(File(baseName.c_str(), openMode));
+
+  if (mLog != nullptr)
+    mLogFiles.push_back(mLog->RegisterFile(baseName, mLogOwner, 0));
+}
+
+
+
+MappedFileContainer::MappedFileContainer(const char*       baseName,
+                                         const uint64_t    maxFileSize,
+                                         const uint64_t    unitsCount)
+  : FileContainer(baseName, maxFileSize, unitsCount, false),
+    mWindowSize(MIN(maxFileSize, MAP_WINDOW_SIZE)),
+    mUnitWindows((maxFileSize + mWindowSize - 1) / mWindowSize),
+    mMappedWindows()
+{
+}
+
+
+MappedFileContainer::~MappedFileContainer()
+{
+  UnmapUnits();
+}
+
+
+const uint8_t*
+MappedFileContainer::MappedContent(const uint64_t from)
+{
+  const uint64_t unitPosition = from % mMaxFileUnitSize;
+  const uint64_t window = (from / mMaxFileUnitSize) * mUnitWindows + unitPosition / mWindowSize;
+
+  LockGuard<Lock> _l(mMapSync);
+
+  if ((window >= mMappedWindows.size()) || (mMappedWindows[window] == nullptr))
+    return nullptr;
+
+  return mMappedWindows[window] + unitPosition % mWindowSize;
+}
+
+
+uint8_t*
+MappedFileContainer::MappedAddress(const uint64_t from, const uint64_t size)
+{
+  const uint64_t unitIndex = from / mMaxFileUnitSize;
+  const uint64_t unitPosition = from % mMaxFileUnitSize;
+  const uint64_t windowPosition = unitPosition % mWindowSize;
+
+  if ((unitIndex >= mFilesHandles.size())
+      || (windowPosition + size > mWindowSize)
+      || (unitPosition + size > mFilesHandles[unitIndex].Size()))
+  {
+    return nullptr;
+  }
+
+  const uint64_t window = unitIndex * mUnitWindows + unitPosition / mWindowSize;
+
+  LockGuard<Lock> _l(mMapSync);
+
+  if (mMappedWindows.size() <= window)
+    mMappedWindows.resize(window + 1, nullptr);
+
+  uint8_t*& content = mMappedWindows[window];
+  if (content == nullptr)
+    content = mFilesHandles[unitIndex].Map(unitPosition - windowPosition, mWindowSize);
+
+  return (content != nullptr) ? content + windowPosition : nullptr;
+}
+
+
+void
+MappedFileContainer::Write(uint64_t to, uint64_t size, const uint8_t* buffer)
+{
+  if (MappedContent(to) == buffer)
+    return; //The content is already in place.
+
+  FileContainer::Write(to, size, buffer);
+}
+
+
+void
+MappedFileContainer::Write(uint64_t to, const WIOVec* vecs, uint_t vecsCount)
+{
+  while (vecsCount > 0)
+  {
+    if (MappedContent(to) == vecs->buffer)
+    {
+      to += vecs->size;
+      ++vecs, --vecsCount;
+
+      continue;
+    }
+
+    uint64_t runSize = 0;
+    uint_t count = 0;
+    while ((count < vecsCount) && (MappedContent(to + runSize) != vecs[count].buffer))
+      runSize += vecs[count++].size;
+
+    FileContainer::Write(to, vecs, count);
+
+    to += runSize;
+    vecs += count, vecsCount -= count;
+  }
+}
+
+
+void
+MappedFileContainer::Read(uint64_t from, uint64_t size, uint8_t* buffer)
+{
+  const uint8_t* const content = MappedContent(from);
+
+  if (content == buffer)
+    return;
+
+  else if ((content != nullptr)
+           && (from % mWindowSize + size <= mWindowSize)
+           && (from % mMaxFileUnitSize + size <= mFilesHandles[from / mMaxFileUnitSize].Size()))
+  {
+    memcpy(buffer, content, size);
+    return;
+  }
+
+  FileContainer::Read(from, size, buffer);
+}
+
+
+void
+MappedFileContainer::Colapse(uint64_t from, uint64_t to)
+{
+  //The units are about to shrink, don't leave mappings past their end.
+  UnmapUnits();
+
+  FileContainer::Colapse(from, to);
+}
+
+
+void
+MappedFileContainer::Flush()
+{
+  LockGuard<Lock> _l(mMapSync);
+
+  for (size_t window = 0; window < mMappedWindows.size(); ++window)
+  {
+    const uint64_t unit = window / mUnitWindows;
+    const uint64_t offset = (window % mUnitWindows) * mWindowSize;
+    const uint64_t unitSize = mFilesHandles[unit].Size();
+
+    if ((mMappedWindows[window] == nullptr) || (unitSize <= offset))
+      continue;
+
+    if ( ! whf_sync_map(mMappedWindows[window], MIN(mWindowSize, unitSize - offset)))
+    {
+      throw WFileContainerException(_EXTRA(WFileContainerException::FILE_OS_IO_ERROR),
+                                    "Failed to sync the mapped content of '%s', unit %d.",
+                                    mFileNamePrefix.c_str(),
+                                    _SC(int, unit));
+    }
+  }
+  _l.unlock();
+
+  FileContainer::Flush();
+}
+
+
+void
+MappedFileContainer::UnmapUnits()
+{
+  LockGuard<Lock> _l(mMapSync);
+
+  for (auto window : mMappedWindows)
+  {
+    if (window != nullptr)
+      whf_unmap(window, mWindowSize);
+  }
+
+  mMappedWindows.clear();
 }
 
 
@@ -41,6 +41,9 @@ namespace pastra {
 static const uint_t DEFAULT_TEMP_MEM_RESERVED = 4096; //4KB
 
 
+class WriteAheadLog;
+
+
 void
 append_int_to_str(uint64_t number, std::string& dest);
 
@@ -93,17 +96,41 @@ public:
   virtual uint64_t Size() const = 0;
   virtual void MarkForRemoval() = 0;
   virtual void Flush() = 0;
+
+  /* Write several buffers at consecutive positions starting from 'to'. */
+  virtual void Write(uint64_t to, const WIOVec* vecs, uint_t vecsCount)
+  {
+    for (uint_t v = 0; v < vecsCount; to += vecs[v++].size)
+      Write(to, vecs[v].size, vecs[v].buffer);
+  }
+
+  /* Address where the content could be accessed in place, or nullptr if
+     the container does not support it for the specified range. */
+  virtual uint8_t* MappedAddress(const uint64_t from, const uint64_t size)
+  {
+    return nullptr;
+  }
+
+  /* How many bytes were read from and written to the storage since the
+     container was opened. The accesses to a mapped content aren't counted. */
+  virtual uint64_t BytesRead() const { return 0; }
+  virtual uint64_t BytesWritten() const { return 0; }
 };
 
 
 
+/* A container kept in one or several unit files. When it's given a log,
+   the writes go to the log and the units' files are updated only when the
+   log copies its content to them. */
 class FileContainer : public IDataContainer
 {
 public:
   FileContainer(const char      *baseFile,
                 const uint64_t   maxFileSize,
                 const uint64_t   unitsCount,
-                const bool       ignoreExistingData);
+                const bool       ignoreExistingData,
+                WriteAheadLog*   log = nullptr,
+                const uint32_t   logOwner = 0);
 
   virtual ~FileContainer() override;
 
@@ -116,17 +143,67 @@ public:
   virtual void MarkForRemoval() override;
   virtual void Flush() override;
 
+  virtual void Write(uint64_t to, const WIOVec* vecs, uint_t vecsCount) override;
+
+  virtual uint64_t BytesRead() const override { return mBytesRead; }
+  virtual uint64_t BytesWritten() const override { return mBytesWritten; }
+
   static void Fix(const char* const   baseFile,
                   const uint64_t      maxFileSize,
                   const uint64_t      newContainerSize);
-private:
+protected:
   void ExtendContainer();
+  File& AccessUnit(const uint64_t unitIndex, const uint64_t unitPosition);
+
+  uint64_t UnitSize(const uint_t unit) const;
+  void WriteUnit(const uint_t unit, const uint64_t offset, const WIOVec* vecs, uint_t vecsCount);
+  void ReadUnit(const uint_t unit, const uint64_t offset, const uint64_t size, uint8_t* buffer);
+
+  const uint64_t          mMaxFileUnitSize;
+  std::vector<File>       mFilesHandles;
+  std::vector<uint32_t>   mLogFiles;
+  std::string             mFileNamePrefix;
+  WriteAheadLog*          mLog;
+  const uint32_t          mLogOwner;
+  volatile int64_t        mBytesRead;
+  volatile int64_t        mBytesWritten;
+  bool                    mToRemove;
+  bool                    mIgnoreExistingData;
+};
+
+
+/* A file container whose units are mapped in memory, so callers could work
+   directly on the file pages. The units are mapped lazily in windows of at
+   most MAP_WINDOW_SIZE bytes that stay in place until the container is
+   collapsed or closed, so an address remains valid while the unit grows.
+   Writes from buffers that already alias the mapped content are skipped. */
+class MappedFileContainer : public FileContainer
+{
+public:
+  MappedFileContainer(const char      *baseFile,
+                      const uint64_t   maxFileSize,
+                      const uint64_t   unitsCount);
+
+  virtual ~MappedFileContainer() override;
+
+  virtual void Write(uint64_t to, uint64_t size, const uint8_t* buffer) override;
+  virtual void Write(uint64_t to, const WIOVec* vecs, uint_t vecsCount) override;
+  virtual void Read(uint64_t from, uint64_t size, uint8_t* buffer) override;
+  virtual void Colapse(uint64_t from, uint64_t to) override;
+  virtual void Flush() override;
+
+  virtual uint8_t* MappedAddress(const uint64_t from, const uint64_t size) override;
+
+  static const uint64_t MAP_WINDOW_SIZE = 16 * 1024 * 1024;
+
+private:
+  const uint8_t* MappedContent(const uint64_t from);
+  void UnmapUnits();
 
-  const uint64_t      mMaxFileUnitSize;
-  std::vector<File>   mFilesHandles;
-  std::string         mFileNamePrefix;
-  bool                mToRemove;
-  bool                mIgnoreExistingData;
+  const uint64_t        mWindowSize;
+  const uint64_t        mUnitWindows;
+  std::vector<uint8_t*> mMappedWindows;
+  Lock                  mMapSync;
 };
 
 
@@ -34,6 +34,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/endianness.h"
 #include "ps_dbsmgr.h"
 #include "ps_table.h"
+#include "ps_bufferpool.h"
+#include "ps_writeback.h"
 
 
 using namespace std;
@@ -43,6 +45,7 @@ namespace pastra {
 
 
 static const char DBS_FILE_EXT[]       = ".db";
+static const char DBS_LOG_FILE_EXT[]   = ".wal";
 static const char DBS_FILE_SIGNATURE[] = { 0x50, 0x41, 0x53, 0x54, 0x52, 0x41, 0x20, 0x44 };
 
 static const uint16_t PS_DBS_VER_MAJ   = 1;
@@ -75,8 +78,10 @@ DbsHandler::DbsHandler(const DBSSettings&   settings,
     mDbsLocationDir(locationDir),
     mFileName(mDbsLocationDir + name + DBS_FILE_EXT),
     mFile(mFileName.c_str(), WH_FILEOPEN_EXISTING | WH_FILERDWR | WH_FILESYNC),
+    mLog(),
     mCreatedTemporalTables(0),
-    mNeedsSync(false)
+    mNeedsSync(false),
+    mMapTablesRows(false)
 {
   const uint_t fileSize = mFile.Size();
   unique_ptr<uint8_t[]> fileContent(unique_array_make(uint8_t, fileSize));
@@ -141,6 +146,15 @@ DbsHandler::DbsHandler(const DBSSettings&   settings,
                                             make_tuple<PersistentTable*, uint32_t>(nullptr, 0)));
     buffer += strlen(_RC(char*, buffer)) + 1;
   }
+
+  //Replays what was committed to the tables if the database was not closed properly.
+  if (mGlbSettings.mWalSyncPolicy != WAL_DISABLED)
+  {
+    mLog.reset(new WriteAheadLog(mDbsLocationDir,
+                                 mDbsLocationDir + name + DBS_LOG_FILE_EXT,
+                                 mGlbSettings.mWalSyncPolicy,
+                                 mGlbSettings.mWalCheckpointSize));
+  }
 }
 
 DbsHandler::DbsHandler(DbsHandler&& source)
@@ -149,8 +163,10 @@ DbsHandler::DbsHandler(DbsHandler&& source)
     mFileName(move(source.mFileName)),
     mFile(move(source.mFile)),
     mTables(move(source.mTables)),
+    mLog(move(source.mLog)),
     mCreatedTemporalTables(move(source.mCreatedTemporalTables)),
-    mNeedsSync(move(source.mNeedsSync))
+    mNeedsSync(move(source.mNeedsSync)),
+    mMapTablesRows(source.mMapTablesRows)
 {
   assert(mCreatedTemporalTables == 0);
 }
@@ -227,7 +243,8 @@ DbsHandler::RetrievePersistentTable(const char* const name)
 void
 DbsHandler::AddTable(const char* const           name,
                      const FIELD_INDEX           fieldsCount,
-                     DBSFieldDescriptor* const   inoutFields)
+                     DBSFieldDescriptor* const   inoutFields,
+                     const TABLE_LAYOUT          layout)
 {
   LockGuard<Lock> syncHolder(mSync);
 
@@ -254,7 +271,8 @@ DbsHandler::AddTable(const char* const           name,
   unique_ptr<PersistentTable> table(new PersistentTable(*this,
                                                         tableName,
                                                         inoutFields,
-                                                        fieldsCount));
+                                                        fieldsCount,
+                                                        layout));
   const auto tableData = make_tuple<PersistentTable*, uint32_t>(table.get(), 1);
   mTables.insert(pair<string, TABLE_DATA>(tableName, tableData));
   table.release();
@@ -367,12 +385,14 @@ DbsHandler::DeleteTable(const char* const name)
 
   assert (get<1>(it->second) == 1);
 
+  //Take the table out of the database before its files are removed.
   unique_ptr<PersistentTable> table {get<0>(it->second)};
-  table->RemoveFromDatabase();
-  table.reset();
   mTables.erase(it);
 
   SyncToFile();
+
+  table->RemoveFromDatabase();
+  table.reset();
 }
 
 
@@ -384,6 +404,27 @@ DbsHandler::SyncAllTablesContent()
   if ( ! mNeedsSync)
     return;
 
+  /* With the log, the tables' commits only have to reach the disk. The
+     tables are flushed just before a checkpoint, so it finds them committed
+     and could copy all their content in place. */
+  if (mLog)
+  {
+    mNeedsSync = false;
+    mLog->Sync();
+
+    if ( ! mLog->CheckpointDue())
+      return;
+
+    for (auto& table: mTables)
+    {
+      if (get<0>(table.second) != nullptr)
+        get<0>(table.second)->Flush();
+    }
+
+    mLog->Checkpoint(false);
+    return;
+  }
+
   for (auto& table: mTables)
   {
     if (get<0>(table.second) != nullptr)
@@ -428,6 +469,36 @@ DbsHandler::SyncTableContent(const TABLE_INDEX index)
     get<0>(it->second)->Flush();
 }
 
+
+bool
+DbsHandler::TableStatistics(const TABLE_INDEX index, DBSTableStats& outStats)
+{
+  LockGuard<Lock> syncHolder(mSync);
+
+  if (index >= mTables.size())
+  {
+    throw DBSException(_EXTRA(DBSException::TABLE_NOT_FUND),
+                       "Cannot retrieve table by index %u(count %u).",
+                       index,
+                       mTables.size());
+  }
+
+  TABLE_INDEX iterator = index;
+  auto it = mTables.begin();
+  while (iterator-- > 0)
+  {
+    assert(it != mTables.end());
+    ++it;
+  }
+
+  if (get<0>(it->second) == nullptr)
+    return false;
+
+  get<0>(it->second)->Statistics(outStats);
+  return true;
+}
+
+
 bool
 DbsHandler::NotifyDatabaseUpdate(const bool tryDbLock)
 {
@@ -445,6 +516,10 @@ DbsHandler::NotifyDatabaseUpdate(const bool tryDbLock)
 
   mNeedsSync = true;
 
+  //The log keeps the tables consistent, so there is nothing to repair later.
+  if (mLog)
+    return true;
+
   uint8_t flags[sizeof(uint64_t)];
 
   mFile.Seek(PS_DBS_FLAGS_OFF, WH_SEEK_BEGIN);
@@ -499,7 +574,7 @@ DbsHandler::SyncToFile()
   store_le_int16(PS_DBS_VER_MIN, header + PS_DBS_VER_MIN_OFF);
   store_le_int16(mTables.size(), header + PS_DBS_NUM_TABLES_OFF);
   store_le_int64(MaxFileSize(), header + PS_DBS_MAX_FILE_OFF);
-  store_le_int64(PS_FLAG_NOT_CLOSED, header + PS_DBS_FLAGS_OFF);
+  store_le_int64(mLog ? 0 : PS_FLAG_NOT_CLOSED, header + PS_DBS_FLAGS_OFF);
 
   mFile.Size(0);
   mFile.Seek(0, WH_SEEK_BEGIN);
@@ -570,6 +645,11 @@ DBSInit(const DBSSettings& settings)
                        "DBS framework was already initialized.");
   }
   dbsMgrs_ = unique_make(DbsManager, settings);
+
+  BufferPool::Instance().Capacity(settings.mBufferPoolSize);
+
+  if (settings.mWriteBackInterval > 0)
+    WriteBackFlusher::Instance().Start(settings.mWriteBackInterval);
 }
 
 
@@ -579,7 +659,11 @@ DBSShoutdown()
   if (dbsMgrs_.get() == nullptr)
     throw DBSException(_EXTRA(DBSException::NOT_INITED), "DBS framework is not initialized.");
 
+   WriteBackFlusher::Instance().Stop();
+
    dbsMgrs_.release();
+
+   BufferPool::Instance().Capacity(0);
 }
 
 
@@ -764,7 +848,7 @@ DBSRepairDatabase(const char* const name, const char* path, FIX_ERROR_CALLBACK f
 
 
 DBS_SHL IDBSHandler&
-DBSRetrieveDatabase(const char* const name, const char* path)
+DBSRetrieveDatabase(const char* const name, const char* path, const bool mapTablesRows)
 {
   if (dbsMgrs_.get() == nullptr)
     throw DBSException(_EXTRA(DBSException::NOT_INITED), "DBS framework is not initialized.");
@@ -789,6 +873,10 @@ DBSRetrieveDatabase(const char* const name, const char* path)
 
   it->second.mRefCount++;
 
+  //Affects only the tables opened from now on.
+  if (mapTablesRows)
+    it->second.mDbs.MapTablesRows(true);
+
   return it->second.mDbs;
 }
 
@@ -34,6 +34,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "dbs/dbs_mgr.h"
 #include "dbs/dbs_types.h"
 
+#include "ps_wal.h"
+
 
 namespace whais {
 namespace pastra {
@@ -60,7 +62,8 @@ public:
 
   virtual void AddTable(const char* const          name,
                        const FIELD_INDEX           fieldsCount,
-                       DBSFieldDescriptor* const   inoutFields) override;
+                       DBSFieldDescriptor* const   inoutFields,
+                       const TABLE_LAYOUT          layout = TABLE_ROWS_LAYOUT) override;
   virtual void DeleteTable(const char* const name) override;
   virtual void SyncAllTablesContent() override;
   virtual void SyncTableContent(const TABLE_INDEX index) override;
@@ -68,6 +71,7 @@ public:
 
   virtual ITable& CreateTempTable(const FIELD_INDEX fieldsCount, DBSFieldDescriptor* inoutFields) override;
   virtual const char* TableName(const TABLE_INDEX index) override;
+  virtual bool TableStatistics(const TABLE_INDEX index, DBSTableStats& outStats) override;
 
   void Discard();
   void RemoveFromStorage();
@@ -76,6 +80,9 @@ public:
   const std::string& TemporalDir() const { return mGlbSettings.mTempDir; }
   uint64_t MaxFileSize() const { return mGlbSettings.mMaxFileSize; }
   const DBSSettings& Settings() const { return mGlbSettings; }
+  bool MapTablesRows() const { return mMapTablesRows; }
+  WriteAheadLog* Log() const { return mLog.get(); }
+  void MapTablesRows(const bool map) { mMapTablesRows = map; }
 
   bool HasUnreleasedTables();
   void RegisterTableSpawn();
@@ -87,14 +94,16 @@ private:
 
   void SyncToFile();
 
-  const DBSSettings&   mGlbSettings;
-  Lock                 mSync;
-  const std::string    mDbsLocationDir;
-  const std::string    mFileName;
-  File                 mFile;
-  TABLES               mTables;
-  int                  mCreatedTemporalTables;
-  bool                 mNeedsSync;
+  const DBSSettings&               mGlbSettings;
+  Lock                             mSync;
+  const std::string                mDbsLocationDir;
+  const std::string                mFileName;
+  File                             mFile;
+  TABLES                           mTables;
+  std::unique_ptr<WriteAheadLog>   mLog;
+  int                              mCreatedTemporalTables;
+  bool                             mNeedsSync;
+  bool                             mMapTablesRows;
 };
 
 
@@ -123,7 +132,10 @@ struct DbsManager
         || mDBSSettings.mTableCacheBlkCount == 0
         || mDBSSettings.mVLStoreCacheBlkSize == 0
         || mDBSSettings.mVLStoreCacheBlkCount == 0
-        || mDBSSettings.mVLValueCacheSize == 0)
+        || mDBSSettings.mVLValueCacheSize == 0
+        || (mDBSSettings.mBufferPoolSize != 0
+            && (mDBSSettings.mBufferPoolSize < mDBSSettings.mTableCacheBlkSize
+                || mDBSSettings.mBufferPoolSize < mDBSSettings.mVLStoreCacheBlkSize)))
     {
       throw DBSException(_EXTRA(DBSException::BAD_PARAMETERS),
           "Cannot create a database manager with the specified parameters.");
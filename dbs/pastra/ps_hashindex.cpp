@@ -0,0 +1,344 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#include "utils/endianness.h"
+#include "utils/whash.h"
+#include "dbs/dbs_exception.h"
+
+#include "ps_hashindex.h"
+
+
+using namespace std;
+
+namespace whais {
+namespace pastra {
+
+
+static const uint_t HASH_HEADER_SIZE     = 32;
+static const uint_t HASH_PAGE_SIZE       = 4096;
+static const uint_t HASH_PAGE_HDR_SIZE   = 8;
+static const uint_t HASH_ENTRY_SIZE      = 12;
+static const uint_t HASH_PAGE_ENTRIES    = (HASH_PAGE_SIZE - HASH_PAGE_HDR_SIZE) / HASH_ENTRY_SIZE;
+static const uint_t HASH_INITIAL_BUCKETS = 8;
+
+//Split a bucket once the buckets are this full (in percents), on average.
+static const uint_t HASH_SPLIT_LOAD      = 75;
+
+static const uint8_t HASH_SIGNATURE[]    = { 0x50, 0x41, 0x53, 0x48, 0x41, 0x53, 0x48, 0x58 };
+
+
+static uint64_t
+page_offset(const uint32_t page)
+{
+  return HASH_HEADER_SIZE + _SC(uint64_t, page) * HASH_PAGE_SIZE;
+}
+
+
+FieldHashIndex::FieldHashIndex(unique_ptr<IDataContainer>& container, const bool create)
+  : mContainer(container.release()),
+    mBuckets(),
+    mSync(),
+    mEntriesCount(0),
+    mLevel(0),
+    mSplitBucket(0),
+    mPagesCount(0),
+    mModified(false)
+{
+  if (create)
+  {
+    mContainer->Colapse(0, mContainer->Size());
+
+    mBuckets.resize(HASH_INITIAL_BUCKETS);
+    for (auto& bucket : mBuckets)
+      bucket.mDirty = true;
+
+    mModified = true;
+    Flush();
+  }
+  else
+    Load();
+}
+
+
+uint64_t
+FieldHashIndex::Hash(const uint8_t* const value, const uint_t valueSize)
+{
+  return wh_hash(value, valueSize);
+}
+
+
+void
+FieldHashIndex::Insert(const uint64_t hash, const ROW_INDEX row)
+{
+  LockGuard<RWLock> _l(mSync);
+
+  Bucket& bucket = mBuckets[BucketOf(hash)];
+  const Entry entry = { hash, row };
+
+  bucket.mEntries.push_back(entry);
+  bucket.mDirty = true;
+
+  mModified = true;
+
+  if (++mEntriesCount * 100 > _SC(uint64_t, mBuckets.size()) * HASH_PAGE_ENTRIES * HASH_SPLIT_LOAD)
+    SplitBucket();
+}
+
+
+void
+FieldHashIndex::Remove(const uint64_t hash, const ROW_INDEX row)
+{
+  LockGuard<RWLock> _l(mSync);
+
+  Bucket& bucket = mBuckets[BucketOf(hash)];
+
+  for (size_t e = 0; e < bucket.mEntries.size(); ++e)
+  {
+    if ((bucket.mEntries[e].mHash != hash) || (bucket.mEntries[e].mRow != row))
+      continue;
+
+    bucket.mEntries[e] = bucket.mEntries.back();
+    bucket.mEntries.pop_back();
+    bucket.mDirty = true;
+
+    mModified = true;
+    --mEntriesCount;
+
+    return;
+  }
+
+  throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR),
+                     "The hash index has no entry for row %u.",
+                     row);
+}
+
+
+void
+FieldHashIndex::Find(const uint64_t hash, vector<ROW_INDEX>& outRows)
+{
+  SharedLockGuard<RWLock> _l(mSync);
+
+  for (const auto& entry : mBuckets[BucketOf(hash)].mEntries)
+  {
+    if (entry.mHash == hash)
+      outRows.push_back(entry.mRow);
+  }
+}
+
+
+uint_t
+FieldHashIndex::BucketOf(const uint64_t hash) const
+{
+  const uint64_t roundBuckets = _SC(uint64_t, HASH_INITIAL_BUCKETS) << mLevel;
+
+  //The buckets before the split one were split already this round.
+  uint64_t bucket = hash % roundBuckets;
+  if (bucket < mSplitBucket)
+    bucket = hash % (2 * roundBuckets);
+
+  assert(bucket < mBuckets.size());
+
+  return bucket;
+}
+
+
+void
+FieldHashIndex::SplitBucket()
+{
+  const uint64_t roundBuckets = _SC(uint64_t, HASH_INITIAL_BUCKETS) << mLevel;
+
+  assert(mBuckets.size() == roundBuckets + mSplitBucket);
+
+  mBuckets.push_back(Bucket());
+
+  Bucket& splitBucket = mBuckets[mSplitBucket];
+  Bucket& newBucket = mBuckets.back();
+
+  vector<Entry> entries;
+  entries.swap(splitBucket.mEntries);
+
+  for (const auto& entry : entries)
+  {
+    if (entry.mHash % (2 * roundBuckets) == mSplitBucket)
+      splitBucket.mEntries.push_back(entry);
+
+    else
+      newBucket.mEntries.push_back(entry);
+  }
+
+  splitBucket.mDirty = true;
+  newBucket.mDirty = true;
+
+  if (++mSplitBucket == roundBuckets)
+  {
+    mSplitBucket = 0;
+    ++mLevel;
+  }
+}
+
+
+void
+FieldHashIndex::Load()
+{
+  uint8_t header[HASH_HEADER_SIZE];
+
+  if (mContainer->Size() < HASH_HEADER_SIZE)
+  {
+    throw DBSException(_EXTRA(DBSException::TABLE_INCONSITENCY),
+                       "The hash index container is too small.");
+  }
+
+  mContainer->Read(0, sizeof header, header);
+
+  mLevel = load_le_int32(header + 8);
+  mSplitBucket = load_le_int32(header + 12);
+  mPagesCount = load_le_int32(header + 16);
+  mEntriesCount = load_le_int64(header + 24);
+
+  const uint32_t bucketsCount = load_le_int32(header + 20);
+
+  if ((memcmp(header, HASH_SIGNATURE, sizeof HASH_SIGNATURE) != 0)
+      || (mLevel >= 32)
+      || (bucketsCount != (HASH_INITIAL_BUCKETS << mLevel) + mSplitBucket)
+      || (mContainer->Size() < page_offset(mPagesCount)))
+  {
+    throw DBSException(_EXTRA(DBSException::TABLE_INCONSITENCY),
+                       "The hash index container has an invalid header.");
+  }
+
+  mBuckets.resize(bucketsCount);
+
+  vector<uint8_t> page(HASH_PAGE_SIZE);
+  uint64_t entriesCount = 0;
+
+  for (uint32_t p = 0; p < mPagesCount; ++p)
+  {
+    mContainer->Read(page_offset(p), HASH_PAGE_SIZE, page.data());
+
+    const uint32_t bucketId = load_le_int32(page.data());
+    const uint32_t count = load_le_int32(page.data() + 4);
+
+    if ((bucketId >= bucketsCount) || (count > HASH_PAGE_ENTRIES))
+    {
+      throw DBSException(_EXTRA(DBSException::TABLE_INCONSITENCY),
+                         "The hash index container has an invalid page.");
+    }
+
+    Bucket& bucket = mBuckets[bucketId];
+    bucket.mPages.push_back(p);
+
+    const uint8_t* raw = page.data() + HASH_PAGE_HDR_SIZE;
+    for (uint32_t e = 0; e < count; ++e, raw += HASH_ENTRY_SIZE)
+    {
+      const Entry entry = { load_le_int64(raw), load_le_int32(raw + 8) };
+      bucket.mEntries.push_back(entry);
+    }
+
+    entriesCount += count;
+  }
+
+  if (entriesCount != mEntriesCount)
+  {
+    throw DBSException(_EXTRA(DBSException::TABLE_INCONSITENCY),
+                       "The hash index container has a wrong entries count.");
+  }
+}
+
+
+void
+FieldHashIndex::StoreBucket(Bucket& bucket, const uint32_t bucketId)
+{
+  const size_t pagesCount = MAX(_SC(size_t, 1),
+                                (bucket.mEntries.size() + HASH_PAGE_ENTRIES - 1) / HASH_PAGE_ENTRIES);
+
+  //A bucket keeps its pages, even when it gets to need fewer.
+  while (bucket.mPages.size() < pagesCount)
+    bucket.mPages.push_back(mPagesCount++);
+
+  vector<uint8_t> page(HASH_PAGE_SIZE);
+  size_t entry = 0;
+
+  for (const auto p : bucket.mPages)
+  {
+    const uint32_t count = MIN(_SC(size_t, HASH_PAGE_ENTRIES), bucket.mEntries.size() - entry);
+
+    store_le_int32(bucketId, page.data());
+    store_le_int32(count, page.data() + 4);
+
+    uint8_t* raw = page.data() + HASH_PAGE_HDR_SIZE;
+    for (uint32_t e = 0; e < count; ++e, ++entry, raw += HASH_ENTRY_SIZE)
+    {
+      store_le_int64(bucket.mEntries[entry].mHash, raw);
+      store_le_int32(bucket.mEntries[entry].mRow, raw + 8);
+    }
+
+    /* The new pages are the last ones, allocated in order, so they never
+       have to be written past the container's end. */
+    mContainer->Write(page_offset(p), HASH_PAGE_SIZE, page.data());
+  }
+
+  bucket.mDirty = false;
+}
+
+
+void
+FieldHashIndex::Flush()
+{
+  LockGuard<RWLock> _l(mSync);
+
+  if ( ! mModified)
+    return;
+
+  uint8_t header[HASH_HEADER_SIZE];
+
+  //Go first, to hold the pages' space.
+  memset(header, 0, sizeof header);
+  memcpy(header, HASH_SIGNATURE, sizeof HASH_SIGNATURE);
+  mContainer->Write(0, sizeof header, header);
+
+  for (uint32_t b = 0; b < mBuckets.size(); ++b)
+  {
+    if (mBuckets[b].mDirty)
+      StoreBucket(mBuckets[b], b);
+  }
+
+  store_le_int32(mLevel, header + 8);
+  store_le_int32(mSplitBucket, header + 12);
+  store_le_int32(mPagesCount, header + 16);
+  store_le_int32(mBuckets.size(), header + 20);
+  store_le_int64(mEntriesCount, header + 24);
+
+  mContainer->Write(0, sizeof header, header);
+  mContainer->Flush();
+
+  mModified = false;
+}
+
+
+} //namespace pastra
+} //namespace whais
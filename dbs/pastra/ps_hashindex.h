@@ -0,0 +1,104 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PS_HASHINDEX_H_
+#define PS_HASHINDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "whais.h"
+#include "utils/wthread.h"
+#include "dbs/dbs_types.h"
+#include "ps_container.h"
+
+
+namespace whais {
+namespace pastra {
+
+
+/* An index of a field's values to the rows holding them, for the lookups
+   of a single value. It's a linear hashing table: the buckets are split
+   one at the time, in order, as the entries are added, so a lookup always
+   goes to one bucket. Only the hashes of the values are kept, so the rows
+   found have to be checked against the value looked for. The null values
+   are not indexed.
+
+   The entries are held in memory and the buckets changed since the last
+   flush are written to the container in pages. A page records its bucket,
+   so the table is built back by reading the pages in any order. */
+class FieldHashIndex
+{
+public:
+  FieldHashIndex(std::unique_ptr<IDataContainer>& container, const bool create);
+
+  static uint64_t Hash(const uint8_t* const value, const uint_t valueSize);
+
+  void Insert(const uint64_t hash, const ROW_INDEX row);
+  void Remove(const uint64_t hash, const ROW_INDEX row);
+
+  /* Add to 'outRows' the rows whose values have the hash, in no order. */
+  void Find(const uint64_t hash, std::vector<ROW_INDEX>& outRows);
+
+  uint64_t EntriesCount() const { return mEntriesCount; }
+  uint64_t RawSize() const { return mContainer->Size(); }
+  const IDataContainer& Container() const { return *mContainer; }
+
+  void Flush();
+  void MarkForRemoval() { mContainer->MarkForRemoval(); }
+
+private:
+  struct Entry
+  {
+    uint64_t    mHash;
+    ROW_INDEX   mRow;
+  };
+
+  struct Bucket
+  {
+    std::vector<Entry>      mEntries;
+    std::vector<uint32_t>   mPages;
+    bool                    mDirty;
+  };
+
+  uint_t BucketOf(const uint64_t hash) const;
+  void SplitBucket();
+  void Load();
+  void StoreBucket(Bucket& bucket, const uint32_t bucketId);
+
+  std::unique_ptr<IDataContainer>   mContainer;
+  std::vector<Bucket>               mBuckets;
+  RWLock                            mSync;
+  uint64_t                          mEntriesCount;
+  uint32_t                          mLevel;
+  uint32_t                          mSplitBucket;
+  uint32_t                          mPagesCount;
+  bool                              mModified;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+#endif /* PS_HASHINDEX_H_ */
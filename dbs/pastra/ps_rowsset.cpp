@@ -0,0 +1,552 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+
+#include "dbs/dbs_rowsset.h"
+#include "dbs/dbs_exception.h"
+
+
+using namespace std;
+
+namespace whais {
+
+
+static const uint_t ROWS_PER_CHUNK = 65536;
+
+
+static inline bool
+test_bit(const vector<uint64_t>& bits, const uint16_t low)
+{
+  return (bits[low / 64] >> (low % 64)) & 1;
+}
+
+
+static inline void
+set_bit(vector<uint64_t>& bits, const uint16_t low)
+{
+  bits[low / 64] |= 1ull << (low % 64);
+}
+
+
+static inline void
+clear_bit(vector<uint64_t>& bits, const uint16_t low)
+{
+  bits[low / 64] &= ~(1ull << (low % 64));
+}
+
+
+/* The bitmaps are combined a few words at a time, which lets the compiler
+   keep them in its vector registers where it knows to. */
+static uint32_t
+or_bitmaps(uint64_t* const dest, const uint64_t* const src)
+{
+  uint32_t count = 0;
+
+  for (uint_t w = 0; w < RowsSet::BITMAP_WORDS; w += 4)
+  {
+    dest[w]     |= src[w];
+    dest[w + 1] |= src[w + 1];
+    dest[w + 2] |= src[w + 2];
+    dest[w + 3] |= src[w + 3];
+
+    count += RowsSet::CountBits(dest[w]) + RowsSet::CountBits(dest[w + 1])
+             + RowsSet::CountBits(dest[w + 2]) + RowsSet::CountBits(dest[w + 3]);
+  }
+
+  return count;
+}
+
+
+static uint32_t
+and_bitmaps(uint64_t* const dest, const uint64_t* const src)
+{
+  uint32_t count = 0;
+
+  for (uint_t w = 0; w < RowsSet::BITMAP_WORDS; w += 4)
+  {
+    dest[w]     &= src[w];
+    dest[w + 1] &= src[w + 1];
+    dest[w + 2] &= src[w + 2];
+    dest[w + 3] &= src[w + 3];
+
+    count += RowsSet::CountBits(dest[w]) + RowsSet::CountBits(dest[w + 1])
+             + RowsSet::CountBits(dest[w + 2]) + RowsSet::CountBits(dest[w + 3]);
+  }
+
+  return count;
+}
+
+
+static uint32_t
+andnot_bitmaps(uint64_t* const dest, const uint64_t* const src)
+{
+  uint32_t count = 0;
+
+  for (uint_t w = 0; w < RowsSet::BITMAP_WORDS; w += 4)
+  {
+    dest[w]     &= ~src[w];
+    dest[w + 1] &= ~src[w + 1];
+    dest[w + 2] &= ~src[w + 2];
+    dest[w + 3] &= ~src[w + 3];
+
+    count += RowsSet::CountBits(dest[w]) + RowsSet::CountBits(dest[w + 1])
+             + RowsSet::CountBits(dest[w + 2]) + RowsSet::CountBits(dest[w + 3]);
+  }
+
+  return count;
+}
+
+
+template<class CHUNK> static void
+make_bitmap_chunk(CHUNK& chunk)
+{
+  if ( ! chunk.mBits.empty())
+    return;
+
+  chunk.mBits.assign(RowsSet::BITMAP_WORDS, 0);
+  for (const auto low : chunk.mRows)
+    set_bit(chunk.mBits, low);
+
+  chunk.mRows = vector<uint16_t>();
+}
+
+
+template<class CHUNK> static void
+make_list_chunk(CHUNK& chunk)
+{
+  if (chunk.mBits.empty() || (chunk.mCount > RowsSet::MAX_LIST_ROWS))
+    return;
+
+  chunk.mRows.clear();
+  chunk.mRows.reserve(chunk.mCount);
+
+  for (uint_t w = 0; w < RowsSet::BITMAP_WORDS; ++w)
+  {
+    for (uint64_t word = chunk.mBits[w]; word != 0; word &= word - 1)
+      chunk.mRows.push_back(w * 64 + RowsSet::CountBits((word & (~word + 1)) - 1));
+  }
+
+  chunk.mBits = vector<uint64_t>();
+}
+
+
+template<class CHUNK> static void
+unite_chunks(CHUNK& dest, const CHUNK& src)
+{
+  if (dest.mBits.empty()
+      && src.mBits.empty()
+      && (dest.mCount + src.mCount <= RowsSet::MAX_LIST_ROWS))
+  {
+    vector<uint16_t> rows;
+    rows.reserve(dest.mCount + src.mCount);
+
+    set_union(dest.mRows.begin(),
+              dest.mRows.end(),
+              src.mRows.begin(),
+              src.mRows.end(),
+              back_inserter(rows));
+
+    dest.mRows.swap(rows);
+    dest.mCount = dest.mRows.size();
+    return;
+  }
+
+  make_bitmap_chunk(dest);
+  if ( ! src.mBits.empty())
+  {
+    dest.mCount = or_bitmaps(dest.mBits.data(), src.mBits.data());
+    return;
+  }
+
+  for (const auto low : src.mRows)
+  {
+    if ( ! test_bit(dest.mBits, low))
+    {
+      set_bit(dest.mBits, low);
+      ++dest.mCount;
+    }
+  }
+}
+
+
+template<class CHUNK> static void
+intersect_chunks(CHUNK& dest, const CHUNK& src)
+{
+  if ( ! dest.mBits.empty() && ! src.mBits.empty())
+  {
+    dest.mCount = and_bitmaps(dest.mBits.data(), src.mBits.data());
+    make_list_chunk(dest);
+    return;
+  }
+
+  vector<uint16_t> rows;
+
+  if (dest.mBits.empty() && src.mBits.empty())
+  {
+    set_intersection(dest.mRows.begin(),
+                     dest.mRows.end(),
+                     src.mRows.begin(),
+                     src.mRows.end(),
+                     back_inserter(rows));
+  }
+  else
+  {
+    const CHUNK& list = dest.mBits.empty() ? dest : src;
+    const CHUNK& bitmap = dest.mBits.empty() ? src : dest;
+
+    for (const auto low : list.mRows)
+    {
+      if (test_bit(bitmap.mBits, low))
+        rows.push_back(low);
+    }
+  }
+
+  dest.mBits = vector<uint64_t>();
+  dest.mRows.swap(rows);
+  dest.mCount = dest.mRows.size();
+}
+
+
+template<class CHUNK> static void
+subtract_chunks(CHUNK& dest, const CHUNK& src)
+{
+  if ( ! dest.mBits.empty())
+  {
+    if ( ! src.mBits.empty())
+      dest.mCount = andnot_bitmaps(dest.mBits.data(), src.mBits.data());
+
+    else
+    {
+      for (const auto low : src.mRows)
+      {
+        if (test_bit(dest.mBits, low))
+        {
+          clear_bit(dest.mBits, low);
+          --dest.mCount;
+        }
+      }
+    }
+
+    make_list_chunk(dest);
+    return;
+  }
+
+  vector<uint16_t> rows;
+
+  if (src.mBits.empty())
+  {
+    set_difference(dest.mRows.begin(),
+                   dest.mRows.end(),
+                   src.mRows.begin(),
+                   src.mRows.end(),
+                   back_inserter(rows));
+  }
+  else
+  {
+    for (const auto low : dest.mRows)
+    {
+      if ( ! test_bit(src.mBits, low))
+        rows.push_back(low);
+    }
+  }
+
+  dest.mRows.swap(rows);
+  dest.mCount = dest.mRows.size();
+}
+
+
+
+RowsSet::RowsSet(const DArray& rows)
+{
+  const uint64_t count = rows.Count();
+
+  if (count == 0)
+    return;
+
+  if (rows.Type() == T_UINT32)
+  {
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      DUInt32 row;
+      rows.Get(i, row);
+
+      Add(row.mValue);
+    }
+  }
+  else if (rows.Type() == T_UINT64)
+  {
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      DUInt64 row;
+      rows.Get(i, row);
+
+      if (row.mValue >= INVALID_ROW_INDEX)
+        throw DBSException(_EXTRA(DBSException::BAD_PARAMETERS));
+
+      Add(row.mValue);
+    }
+  }
+  else
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+}
+
+
+uint64_t
+RowsSet::Count() const
+{
+  uint64_t result = 0;
+
+  for (const auto& chunk : mChunks)
+    result += chunk.mCount;
+
+  return result;
+}
+
+
+bool
+RowsSet::Contains(const ROW_INDEX row) const
+{
+  const Chunk* const chunk = FindChunk(row >> 16);
+  const uint16_t low = row & 0xFFFF;
+
+  if (chunk == nullptr)
+    return false;
+
+  else if ( ! chunk->mBits.empty())
+    return test_bit(chunk->mBits, low);
+
+  return binary_search(chunk->mRows.begin(), chunk->mRows.end(), low);
+}
+
+
+void
+RowsSet::Add(const ROW_INDEX row)
+{
+  Chunk* const chunk = FindChunk(row >> 16, true);
+  const uint16_t low = row & 0xFFFF;
+
+  if ( ! chunk->mBits.empty())
+  {
+    if ( ! test_bit(chunk->mBits, low))
+    {
+      set_bit(chunk->mBits, low);
+      ++chunk->mCount;
+    }
+    return;
+  }
+
+  //Rows are usually added in order, so try the end of the list first.
+  if (chunk->mRows.empty() || (chunk->mRows.back() < low))
+    chunk->mRows.push_back(low);
+
+  else
+  {
+    auto it = lower_bound(chunk->mRows.begin(), chunk->mRows.end(), low);
+    if (*it == low)
+      return;
+
+    chunk->mRows.insert(it, low);
+  }
+
+  if (++chunk->mCount > MAX_LIST_ROWS)
+    make_bitmap_chunk( *chunk);
+}
+
+
+void
+RowsSet::AddRange(ROW_INDEX from, const ROW_INDEX to)
+{
+  while (from <= to)
+  {
+    const ROW_INDEX chunkLast = (from | (ROWS_PER_CHUNK - 1));
+    const ROW_INDEX last = MIN(chunkLast, to);
+
+    Chunk* const chunk = FindChunk(from >> 16, true);
+
+    if (chunk->mBits.empty() && (chunk->mCount + (last - from + 1) <= MAX_LIST_ROWS))
+    {
+      for (ROW_INDEX row = from; row <= last; ++row)
+        Add(row);
+    }
+    else
+    {
+      make_bitmap_chunk( *chunk);
+
+      for (uint_t low = from & 0xFFFF; low <= (last & 0xFFFF); )
+      {
+        if (((low % 64) == 0) && (low + 63 <= (last & 0xFFFF)))
+        {
+          chunk->mBits[low / 64] = ~0ull;
+          low += 64;
+        }
+        else
+          set_bit(chunk->mBits, low++);
+      }
+
+      chunk->mCount = 0;
+      for (const auto word : chunk->mBits)
+        chunk->mCount += CountBits(word);
+    }
+
+    if (last == INVALID_ROW_INDEX)
+      break;
+
+    from = last + 1;
+  }
+}
+
+
+RowsSet&
+RowsSet::Unite(const RowsSet& second)
+{
+  vector<Chunk> result;
+  result.reserve(mChunks.size() + second.mChunks.size());
+
+  auto first = mChunks.begin();
+  auto other = second.mChunks.begin();
+
+  while ((first != mChunks.end()) || (other != second.mChunks.end()))
+  {
+    if ((other == second.mChunks.end())
+        || ((first != mChunks.end()) && (first->mKey < other->mKey)))
+    {
+      result.push_back(std::move( *first++));
+    }
+    else if ((first == mChunks.end()) || (other->mKey < first->mKey))
+      result.push_back( *other++);
+
+    else
+    {
+      unite_chunks( *first, *other++);
+      result.push_back(std::move( *first++));
+    }
+  }
+
+  mChunks.swap(result);
+  return *this;
+}
+
+
+RowsSet&
+RowsSet::Intersect(const RowsSet& second)
+{
+  vector<Chunk> result;
+
+  auto first = mChunks.begin();
+  auto other = second.mChunks.begin();
+
+  while ((first != mChunks.end()) && (other != second.mChunks.end()))
+  {
+    if (first->mKey < other->mKey)
+      ++first;
+
+    else if (other->mKey < first->mKey)
+      ++other;
+
+    else
+    {
+      intersect_chunks( *first, *other++);
+      if (first->mCount > 0)
+        result.push_back(std::move( *first));
+
+      ++first;
+    }
+  }
+
+  mChunks.swap(result);
+  return *this;
+}
+
+
+RowsSet&
+RowsSet::Subtract(const RowsSet& second)
+{
+  vector<Chunk> result;
+  result.reserve(mChunks.size());
+
+  auto other = second.mChunks.begin();
+
+  for (auto& chunk : mChunks)
+  {
+    while ((other != second.mChunks.end()) && (other->mKey < chunk.mKey))
+      ++other;
+
+    if ((other != second.mChunks.end()) && (other->mKey == chunk.mKey))
+      subtract_chunks(chunk, *other);
+
+    if (chunk.mCount > 0)
+      result.push_back(std::move(chunk));
+  }
+
+  mChunks.swap(result);
+  return *this;
+}
+
+
+DArray
+RowsSet::ToArray() const
+{
+  DArray result;
+
+  ForEach([&result](const ROW_INDEX row) { result.Add(DROW_INDEX(row)); });
+
+  return result;
+}
+
+
+RowsSet::Chunk*
+RowsSet::FindChunk(const uint16_t key, const bool create)
+{
+  if ( ! mChunks.empty() && (mChunks.back().mKey == key))
+    return &mChunks.back();
+
+  auto it = lower_bound(mChunks.begin(),
+                        mChunks.end(),
+                        key,
+                        [](const Chunk& chunk, const uint16_t k) { return chunk.mKey < k; });
+
+  if ((it != mChunks.end()) && (it->mKey == key))
+    return &*it;
+
+  else if ( ! create)
+    return nullptr;
+
+  Chunk chunk;
+  chunk.mKey = key;
+  chunk.mCount = 0;
+
+  return &*mChunks.insert(it, std::move(chunk));
+}
+
+
+const RowsSet::Chunk*
+RowsSet::FindChunk(const uint16_t key) const
+{
+  return _CC(RowsSet*, this)->FindChunk(key, false);
+}
+
+
+} //namespace whais
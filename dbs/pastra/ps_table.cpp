@@ -46,6 +46,7 @@ namespace pastra {
 static const char PS_TEMP_TABLE_SUFFIX[]   = "pttable_";
 static const char PS_TABLE_FIXFIELDS_EXT[] = "_f";
 static const char PS_TABLE_VARFIELDS_EXT[] = "_v";
+static const char PS_TABLE_ZONES_EXT[]     = "_z";
 static const uint8_t PS_TABLE_SIGNATURE[]  = { 0x50, 0x41, 0x53, 0x54, 0x52, 0x41, 0x54, 0x42 };
 
 static const uint_t PS_HEADER_SIZE = 128;
@@ -72,12 +73,17 @@ static const uint_t PS_TABLE_ROW_SIZE_OFF          = 56;
 static const uint_t PS_TABLE_ROW_SIZE_LEN          = 4;
 static const uint_t PS_TABLE_FLAGS_OFF             = 60;
 static const uint_t PS_TABLE_FLAGS_LEN             = 4;
+static const uint_t PS_TABLE_BLOCK_ROWS_OFF        = 64;
+static const uint_t PS_TABLE_BLOCK_ROWS_LEN        = 4;
+static const uint_t PS_TABLE_ZONES_SIZE_OFF        = 68;
+static const uint_t PS_TABLE_ZONES_SIZE_LEN        = 8;
 
-static const uint_t PS_RESEVED_FOR_FUTURE_OFF   = 64;
+static const uint_t PS_RESEVED_FOR_FUTURE_OFF   = 76;
 static const uint_t PS_RESEVED_FOR_FUTURE_LEN   = PS_HEADER_SIZE - PS_RESEVED_FOR_FUTURE_OFF;
 
 static const uint32_t PS_TABLE_MODIFIED_MASK    = 1;
 static const uint32_t PS_TABLE_TO_REPAIR_MASK   = 2;
+static const uint32_t PS_TABLE_PAX_LAYOUT_MASK  = 4;
 
 
 
@@ -330,7 +336,9 @@ static void
 create_table_file(const uint64_t                    maxFileSize,
                   const char* const                 filePrefix,
                   const DBSFieldDescriptor* const   inoutFields,
-                  const uint_t                      fieldsCount)
+                  const uint_t                      fieldsCount,
+                  const TABLE_LAYOUT                layout,
+                  uint_t                            blockSize)
 {
   //Check the arguments
   if ((inoutFields == nullptr) || (fieldsCount == 0) || (fieldsCount > 0xFFFFu))
@@ -353,6 +361,16 @@ create_table_file(const uint64_t                    maxFileSize,
 
   normalize_fields(vect, &rowSize, fieldsDescs.get());
 
+  //A PAX block keeps its rows count for the table's lifetime.
+  uint_t blockRows = 0;
+  if (layout == TABLE_PAX_LAYOUT)
+  {
+    while (blockSize < rowSize)
+      blockSize *= 2;
+
+    blockRows = blockSize / rowSize;
+  }
+
   File tableFile(filePrefix, WH_FILECREATE_NEW | WH_FILERDWR);
 
   unique_ptr<uint8_t[]> tableHeader(unique_array_make(uint8_t, PS_HEADER_SIZE));
@@ -364,12 +382,15 @@ create_table_file(const uint64_t                    maxFileSize,
   store_le_int32(descriptorsSize, header + PS_TABLE_ELEMS_SIZE_OFF);
   store_le_int64(0,               header + PS_TABLE_ROWS_COUNT_OFF);
   store_le_int64(0,               header + PS_TABLE_VARSTORAGE_SIZE_OFF);
+  store_le_int64(0,               header + PS_TABLE_ZONES_SIZE_OFF);
   store_le_int32(rowSize,         header + PS_TABLE_ROW_SIZE_OFF);
   store_le_int32(NIL_NODE,        header + PS_TABLE_BT_ROOT_OFF);
   store_le_int32(NIL_NODE,        header + PS_TABLE_BT_HEAD_OFF);
   store_le_int64(maxFileSize,     header + PS_TABLE_MAX_FILE_SIZE_OFF);
   store_le_int64(~(uint64_t)0,    header + PS_TABLE_MAINTABLE_SIZE_OFF);
-  store_le_int32(0,               header + PS_TABLE_FLAGS_OFF);
+  store_le_int32((blockRows > 0) ? PS_TABLE_PAX_LAYOUT_MASK : 0,
+                 header + PS_TABLE_FLAGS_OFF);
+  store_le_int32(blockRows,       header + PS_TABLE_BLOCK_ROWS_OFF);
 
   assert(sizeof(NODE_INDEX) == PS_TABLE_BT_HEAD_LEN);
   assert(sizeof(NODE_INDEX) == PS_TABLE_BT_ROOT_LEN);
@@ -392,6 +413,9 @@ create_table_file(const uint64_t                    maxFileSize,
 
   tableFile.Seek(0, WH_SEEK_BEGIN);
   tableFile.Write(header, PS_HEADER_SIZE);
+
+  //The database lists the table only after this, so it should be on the disk.
+  tableFile.Sync();
 }
 
 
@@ -585,8 +609,8 @@ repair_table_header(const string&              name,
 
   uint64_t vsSize = load_le_int64(header + PS_TABLE_VARSTORAGE_SIZE_OFF);
 
-  vsSize /= sizeof(StoreEntry);
-  vsSize *= sizeof(StoreEntry);
+  vsSize /= VariableSizeStore::UNIT_SIZE;
+  vsSize *= VariableSizeStore::UNIT_SIZE;
 
   store_le_int64(vsSize, header + PS_TABLE_VARSTORAGE_SIZE_OFF);
 
@@ -718,8 +742,11 @@ PersistentTable::PersistentTable(DbsHandler& dbs, const string& name)
     mDbsSettings(DBSGetSeettings()),
     mMaxFileSize(0),
     mVSDataSize(0),
+    mZonesDataSize(0),
     mFileNamePrefix(dbs.WorkingDir() + name),
     mVSData(nullptr),
+    mLog(dbs.Log()),
+    mLogOwner((mLog != nullptr) ? mLog->RegisterOwner() : 0),
     mRemoved(false)
 {
   InitFromFile(name);
@@ -736,73 +763,93 @@ PersistentTable::PersistentTable(DbsHandler& dbs, const string& name)
 
   assert(mTableData.get() != nullptr);
 
-  uint_t blkSize = DBSSettings().mTableCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mTableCacheBlkCount;
+  uint_t blkSize = mDbsSettings.mTableCacheBlkSize;
+  const uint_t blkCount = mDbsSettings.mTableCacheBlkCount;
 
   assert((blkSize != 0) && (blkCount != 0));
 
   while (blkSize < mRowSize)
     blkSize *= 2;
 
+  //The rows are spread over the whole of a PAX block.
+  if (mLayout.IsPax())
+    blkSize = mLayout.BlockRows() * mRowSize;
+
   mRowCache.Init(*this, mRowSize, blkSize, blkCount, false);
 
   InitVariableStorages();
   InitIndexedFields();
+  InitZones();
+
+  WriteBackFlusher::Instance().Register(*this);
 }
 
 
 PersistentTable::PersistentTable(DbsHandler&                       dbs,
                                  const string&                     name,
                                  const DBSFieldDescriptor* const   inoutFields,
-                                 const uint_t                      fieldsCount)
+                                 const uint_t                      fieldsCount,
+                                 const TABLE_LAYOUT                layout)
   : PrototypeTable(dbs),
     mDbsSettings(DBSGetSeettings()),
     mMaxFileSize(0),
     mVSDataSize(0),
+    mZonesDataSize(0),
     mFileNamePrefix(dbs.WorkingDir() + name),
     mVSData(nullptr),
+    mLog(dbs.Log()),
+    mLogOwner((mLog != nullptr) ? mLog->RegisterOwner() : 0),
     mRemoved(false)
 {
-  create_table_file(dbs.MaxFileSize(), mFileNamePrefix.c_str(), inoutFields, fieldsCount);
+  create_table_file(dbs.MaxFileSize(),
+                    mFileNamePrefix.c_str(),
+                    inoutFields,
+                    fieldsCount,
+                    layout,
+                    mDbsSettings.mTableCacheBlkSize);
   InitFromFile(name);
 
   assert(mTableData.get() != nullptr);
 
-  uint_t blkSize = DBSSettings().mTableCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mTableCacheBlkCount;
+  uint_t blkSize = mDbsSettings.mTableCacheBlkSize;
+  const uint_t blkCount = mDbsSettings.mTableCacheBlkCount;
 
   assert((blkSize != 0) && (blkCount != 0));
 
   while (blkSize < mRowSize)
     blkSize *= 2;
 
+  //The rows are spread over the whole of a PAX block.
+  if (mLayout.IsPax())
+    blkSize = mLayout.BlockRows() * mRowSize;
+
   mRowCache.Init(*this, mRowSize, blkSize, blkCount, false);
 
   InitVariableStorages();
   InitIndexedFields();
+  InitZones();
+
+  WriteBackFlusher::Instance().Register(*this);
 }
 
 
 PersistentTable::~PersistentTable()
 {
+  WriteBackFlusher::Instance().Unregister(*this);
+
   Flush();
 
+  UpdateIndexesUnitsCount();
   for (FIELD_INDEX fieldIndex = 0; fieldIndex < mFieldsCount; ++fieldIndex)
   {
-    if (mvIndexNodeMgrs[fieldIndex] != nullptr)
-    {
-      FieldDescriptor& field = GetFieldDescriptorInternal(fieldIndex);
-
-      uint64_t unitsCount = mMaxFileSize - 1;
-
-      unitsCount += mvIndexNodeMgrs[fieldIndex]->IndexRawSize();
-      unitsCount /= mMaxFileSize;
-
-      field.IndexUnitsCount(unitsCount);
-      delete mvIndexNodeMgrs[fieldIndex];
-    }
+    delete mvIndexNodeMgrs[fieldIndex];
+    delete mvHashIndexes[fieldIndex];
   }
+
   MakeHeaderPersistent();
+
+  if (mLog != nullptr)
+    mLog->Commit(mLogOwner);
 }
 
 
@@ -813,6 +860,53 @@ PersistentTable::IsTemporal() const
 }
 
 
+void
+PersistentTable::WriteBack(const bool urgent)
+{
+  /* Some rows are updated with the table held exclusively and without their
+     block's latch, so holding the table shared keeps those updates away. */
+  SharedLockGuard<MeteredRWLock> _l(mRowsSync, true);
+  if ( ! _l.try_lock())
+    return;
+
+  mRowCache.WriteBack(urgent);
+}
+
+
+void
+PersistentTable::Statistics(DBSTableStats& outStats)
+{
+  PrototypeTable::Statistics(outStats);
+
+  const FileContainer* const containers[] = {
+    mTableData.get(), mRowsData.get(), mZonesData.get()
+  };
+
+  for (auto container : containers)
+  {
+    if (container == nullptr)
+      continue;
+
+    outStats.mBytesRead    += container->BytesRead();
+    outStats.mBytesWritten += container->BytesWritten();
+  }
+
+  if (mVSData != nullptr)
+  {
+    const BlockCacheStats cacheStats = mVSData->CacheStatistics();
+
+    uint64_t bytesRead, bytesWritten;
+    mVSData->IOStatistics(&bytesRead, &bytesWritten);
+
+    outStats.mCacheHits      += cacheStats.mHits;
+    outStats.mCacheMisses    += cacheStats.mMisses;
+    outStats.mCacheEvictions += cacheStats.mEvictions;
+    outStats.mBytesRead      += bytesRead;
+    outStats.mBytesWritten   += bytesWritten;
+  }
+}
+
+
 ITable&
 PersistentTable::Spawn() const
 {
@@ -845,21 +939,28 @@ PersistentTable::InitFromFile(const string& tableName)
   mDescriptorsSize = load_le_int32(tableHdr + PS_TABLE_ELEMS_SIZE_OFF);
   mRowsCount       = load_le_int64(tableHdr + PS_TABLE_ROWS_COUNT_OFF);
   mVSDataSize      = load_le_int64(tableHdr + PS_TABLE_VARSTORAGE_SIZE_OFF);
+  mZonesDataSize   = load_le_int64(tableHdr + PS_TABLE_ZONES_SIZE_OFF);
   mRowSize         = load_le_int32(tableHdr + PS_TABLE_ROW_SIZE_OFF);
   mRootNode        = load_le_int32(tableHdr + PS_TABLE_BT_ROOT_OFF);
   mUnallocatedHead = load_le_int32(tableHdr + PS_TABLE_BT_HEAD_OFF);
   mMaxFileSize     = load_le_int64(tableHdr + PS_TABLE_MAX_FILE_SIZE_OFF);
   mainTableSize    = load_le_int64(tableHdr + PS_TABLE_MAINTABLE_SIZE_OFF);
 
+  const uint32_t flags = load_le_int32(tableHdr + PS_TABLE_FLAGS_OFF);
+  const uint_t blockRows = (flags & PS_TABLE_PAX_LAYOUT_MASK)
+                           ? load_le_int32(tableHdr + PS_TABLE_BLOCK_ROWS_OFF)
+                           : 0;
+
   if (mFieldsCount == 0
      || mDescriptorsSize < sizeof(FieldDescriptor) * mFieldsCount
-     || mainTableSize < PS_HEADER_SIZE)
+     || mainTableSize < PS_HEADER_SIZE
+     || ((flags & PS_TABLE_PAX_LAYOUT_MASK) && (blockRows == 0)))
     {
       throw DBSException(_EXTRA(DBSException::TABLE_INVALID),
                          "Persistent table file '%s' has an invalid signature.",
                          mFileNamePrefix.c_str());
     }
-  else if (load_le_int32(tableHdr + PS_TABLE_FLAGS_OFF) & PS_TABLE_MODIFIED_MASK)
+  else if (flags & PS_TABLE_MODIFIED_MASK)
     {
       throw DBSException(_EXTRA(DBSException::TABLE_IN_USE),
                          "Cannot open table '%s' as is already in use or was not closed properly"
@@ -867,6 +968,8 @@ PersistentTable::InitFromFile(const string& tableName)
                          tableName.c_str());
     }
 
+  mLayout = RowsLayout(mRowSize, mFieldsCount, blockRows);
+
   //Cache the field descriptors in memory
   mFieldsDescriptors.reset(new uint8_t[mDescriptorsSize]);
   mainTableFile.Read(_CC(uint8_t*, mFieldsDescriptors.get()), mDescriptorsSize);
@@ -875,17 +978,48 @@ PersistentTable::InitFromFile(const string& tableName)
   mTableData.reset(new FileContainer(mFileNamePrefix.c_str(),
                                      mMaxFileSize,
                                      (mainTableSize + mMaxFileSize - 1) / mMaxFileSize,
-                                     false));
+                                     false,
+                                     mLog,
+                                     mLogOwner));
 }
 
 void
 PersistentTable::InitVariableStorages()
 {
   // Loading the rows regular should be done up front.
-  mRowsData.reset (new FileContainer((mFileNamePrefix + PS_TABLE_FIXFIELDS_EXT).c_str(),
+  const string rowsFileName = mFileNamePrefix + PS_TABLE_FIXFIELDS_EXT;
+  const uint64_t rowsUnitsCount = ((mRowSize * StoredRowsCount()) + mMaxFileSize - 1) / mMaxFileSize;
+
+  //The mapped rows are written in place, so these could not be logged.
+  if (mDbs.MapTablesRows() && (mLog == nullptr))
+  {
+    mRowsData.reset(new MappedFileContainer(rowsFileName.c_str(),
+                                            mMaxFileSize,
+                                            rowsUnitsCount));
+  }
+  else
+  {
+    mRowsData.reset(new FileContainer(rowsFileName.c_str(),
+                                      mMaxFileSize,
+                                      rowsUnitsCount,
+                                      false,
+                                      mLog,
+                                      mLogOwner));
+  }
+
+  //The zones are built again from the rows when they are not found.
+  const string zonesFileName = mFileNamePrefix + PS_TABLE_ZONES_EXT;
+  const uint64_t zonesUnitsCount = (mZonesDataSize + mMaxFileSize - 1) / mMaxFileSize;
+
+  if ((zonesUnitsCount == 0) && whf_file_exists(zonesFileName.c_str()))
+    whf_remove(zonesFileName.c_str());
+
+  mZonesData.reset(new FileContainer(zonesFileName.c_str(),
                                      mMaxFileSize,
-                                     ((mRowSize * mRowsCount) + mMaxFileSize - 1) / mMaxFileSize,
-                                     false));
+                                     zonesUnitsCount,
+                                     false,
+                                     mLog,
+                                     mLogOwner));
 
   //Check if are fields demanding variable size store.
   for (FIELD_INDEX i = 0; i < mFieldsCount; ++i)
@@ -899,7 +1033,14 @@ PersistentTable::InitVariableStorages()
       mVSData = shared_make(VariableSizeStore);
       mVSData->Init((mFileNamePrefix + PS_TABLE_VARFIELDS_EXT).c_str(),
                     mVSDataSize,
-                    mMaxFileSize);
+                    mMaxFileSize,
+                    false,
+                    mLog,
+                    mLogOwner);
+
+      //The store might have been converted from an older format.
+      if (mVSData->Size() != mVSDataSize)
+        MakeHeaderPersistent();
 
       //We only need one field to require variable storage initialisation
       //and it would be enough for the(if they are present).
@@ -915,6 +1056,34 @@ PersistentTable::InitIndexedFields()
   {
     FieldDescriptor& field = GetFieldDescriptorInternal(fieldIndex);
 
+    if (field.HashIndexed())
+    {
+      const string containerName = mFileNamePrefix
+                                   + '_'
+                                   + _RC(const char*, mFieldsDescriptors.get() + field.NameOffset())
+                                   + "_hs";
+
+      /* A repaired table keeps the flag with no units, and the index is
+         built again from the rows. */
+      const bool rebuild = (field.IndexUnitsCount() == 0);
+      unique_ptr<IDataContainer> indexContainer(unique_make(FileContainer,
+                                                            containerName.c_str(),
+                                                            mMaxFileSize,
+                                                            field.IndexUnitsCount(),
+                                                            false,
+                                                            mLog,
+                                                            mLogOwner));
+      mvIndexNodeMgrs.push_back(nullptr);
+      mvHashIndexes.push_back(new FieldHashIndex(indexContainer, rebuild));
+
+      if (rebuild)
+        BuildHashIndex( *mvHashIndexes.back(), field, nullptr, nullptr);
+
+      continue;
+    }
+
+    mvHashIndexes.push_back(nullptr);
+
     if (field.IndexNodeSizeKB() == 0)
     {
       assert(field.IndexUnitsCount() == 0);
@@ -932,7 +1101,9 @@ PersistentTable::InitIndexedFields()
                                                           containerName.c_str(),
                                                           mMaxFileSize,
                                                           field.IndexUnitsCount(),
-                                                          false));
+                                                          false,
+                                                          mLog,
+                                                          mLogOwner));
     mvIndexNodeMgrs.push_back(new FieldIndexNodeManager(indexContainer,
                                                         field.IndexNodeSizeKB() * 1024,
                                                         0x400000, //4MB
@@ -941,6 +1112,30 @@ PersistentTable::InitIndexedFields()
   }
 }
 
+void
+PersistentTable::UpdateIndexesUnitsCount()
+{
+  for (FIELD_INDEX fieldIndex = 0; fieldIndex < mFieldsCount; ++fieldIndex)
+  {
+    if ((mvIndexNodeMgrs[fieldIndex] == nullptr) && (mvHashIndexes[fieldIndex] == nullptr))
+      continue;
+
+    FieldDescriptor& field = GetFieldDescriptorInternal(fieldIndex);
+
+    uint64_t unitsCount = mMaxFileSize - 1;
+
+    if (mvIndexNodeMgrs[fieldIndex] != nullptr)
+      unitsCount += mvIndexNodeMgrs[fieldIndex]->IndexRawSize();
+
+    else
+      unitsCount += mvHashIndexes[fieldIndex]->RawSize();
+
+    unitsCount /= mMaxFileSize;
+
+    field.IndexUnitsCount(unitsCount);
+  }
+}
+
 void
 PersistentTable::MakeHeaderPersistent()
 {
@@ -952,6 +1147,9 @@ PersistentTable::MakeHeaderPersistent()
   if (mRowModified)
     flags |= PS_TABLE_MODIFIED_MASK;
 
+  if (mLayout.IsPax())
+    flags |= PS_TABLE_PAX_LAYOUT_MASK;
+
   uint8_t tableHdr[PS_HEADER_SIZE];
 
   memcpy(tableHdr, PS_TABLE_SIGNATURE, sizeof PS_TABLE_SIGNATURE);
@@ -965,9 +1163,12 @@ PersistentTable::MakeHeaderPersistent()
   store_le_int64(mMaxFileSize,        tableHdr + PS_TABLE_MAX_FILE_SIZE_OFF);
   store_le_int64(mTableData->Size(),  tableHdr + PS_TABLE_MAINTABLE_SIZE_OFF);
   store_le_int32(flags,               tableHdr + PS_TABLE_FLAGS_OFF);
+  store_le_int32(mLayout.BlockRows(), tableHdr + PS_TABLE_BLOCK_ROWS_OFF);
 
   store_le_int64((mVSData != nullptr) ? mVSData->Size() : 0,
                  tableHdr + PS_TABLE_VARSTORAGE_SIZE_OFF);
+  store_le_int64((mZonesData.get() != nullptr) ? mZonesData->Size() : 0,
+                 tableHdr + PS_TABLE_ZONES_SIZE_OFF);
 
   memset(tableHdr + PS_RESEVED_FOR_FUTURE_OFF, 0, PS_RESEVED_FOR_FUTURE_LEN);
 
@@ -985,10 +1186,16 @@ PersistentTable::RemoveFromDatabase()
   if (mVSData != nullptr)
     mVSData->MarkForRemoval();
 
+  if (mZonesData.get() != nullptr)
+    mZonesData->MarkForRemoval();
+
   for (FIELD_INDEX i = 0; i < mFieldsCount; ++i)
   {
     if (mvIndexNodeMgrs[i] != nullptr)
       mvIndexNodeMgrs[i]->MarkForRemoval();
+
+    if (mvHashIndexes[i] != nullptr)
+      mvHashIndexes[i]->MarkForRemoval();
   }
 
   mTableData->MarkForRemoval();
@@ -997,14 +1204,22 @@ PersistentTable::RemoveFromDatabase()
 
 
 IDataContainer*
-PersistentTable::CreateIndexContainer(const FIELD_INDEX field)
+PersistentTable::CreateIndexContainer(const FIELD_INDEX field, const INDEX_KIND kind)
 {
   assert(!mFileNamePrefix.empty());
 
   const DBSFieldDescriptor desc = DescribeField(field);
-  const string containerNameBase = mFileNamePrefix + '_' + desc.name + "_bt";
-
-  return new FileContainer(containerNameBase.c_str(), mDbsSettings.mMaxFileSize, 0, false);
+  const string containerNameBase = mFileNamePrefix
+                                   + '_'
+                                   + desc.name
+                                   + ((kind == INDEX_HASH) ? "_hs" : "_bt");
+
+  return new FileContainer(containerNameBase.c_str(),
+                           mDbsSettings.mMaxFileSize,
+                           0,
+                           false,
+                           mLog,
+                           mLogOwner);
 }
 
 
@@ -1017,8 +1232,18 @@ PersistentTable::FlushEpilog()
   if (mRowsData.get() != nullptr)
     mRowsData->Flush();
 
+  if (mZonesData.get() != nullptr)
+    mZonesData->Flush();
+
+  UpdateIndexesUnitsCount();
+  MakeHeaderPersistent();
+
   if (mTableData.get() != nullptr)
     mTableData->Flush();
+
+  //Everything the table has written up to here is consistent.
+  if (mLog != nullptr)
+    mLog->Commit(mLogOwner);
 }
 
 
@@ -1049,6 +1274,13 @@ PersistentTable::VSStore()
 }
 
 
+IDataContainer*
+PersistentTable::ZonesContainer()
+{
+  return mZonesData.get();
+}
+
+
 bool
 PersistentTable::ValidateTable(const std::string& path, const std::string& name)
 {
@@ -1221,6 +1453,14 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
   const uint_t fieldsCount = load_le_int32(tableHeader.get() + PS_TABLE_FIELDS_COUNT_OFF);
   const uint_t descSize = load_le_int32(tableHeader.get() + PS_TABLE_ELEMS_SIZE_OFF);
   const uint32_t rowSize = load_le_int32(tableHeader.get() + PS_TABLE_ROW_SIZE_OFF);
+  const uint32_t flags = load_le_int32(tableHeader.get() + PS_TABLE_FLAGS_OFF);
+  const uint32_t paxBlockRows = (flags & PS_TABLE_PAX_LAYOUT_MASK)
+                                ? load_le_int32(tableHeader.get() + PS_TABLE_BLOCK_ROWS_OFF)
+                                : 0;
+
+  //Check the rows one block at the time, a PAX block being kept whole.
+  const RowsLayout layout(rowSize, fieldsCount, paxBlockRows);
+  const uint32_t blockRows = layout.IsPax() ? paxBlockRows : 1;
 
   uint32_t rowsCount = load_le_int32(tableHeader.get() + PS_TABLE_ROWS_COUNT_OFF);
   uint64_t vsDataSize = load_le_int64(tableHeader.get() + PS_TABLE_VARSTORAGE_SIZE_OFF);
@@ -1237,6 +1477,23 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
   std::vector<FieldIndexNodeManager*> indexNodeMgrs;
   for (FIELD_INDEX i = 0; i < fieldsCount; ++i)
   {
+    if (fds[i].HashIndexed())
+    {
+      //The hash indexes are not to be trusted, so they are built again at open.
+      const string containerName = fileNamePrefix
+                                   + '_'
+                                   + (_RC(const char*, fds) + fds[i].NameOffset())
+                                   + "_hs";
+
+      remove_extra_container_files(fixCallback, containerName, 0, settings.mMaxFileSize);
+
+      fds[i].IndexNodeSizeKB(0);
+      fds[i].IndexUnitsCount(0);
+
+      indexNodeMgrs.push_back(nullptr);
+      continue;
+    }
+
     if ((fds[i].IndexNodeSizeKB() == 0)
         || (fds[i].IndexUnitsCount() == 0))
       {
@@ -1268,25 +1525,29 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
   }
 
   FileContainer tableData(fileNamePrefix.c_str(), settings.mMaxFileSize, 1, false);
+  const uint64_t blockSize = _SC(uint64_t, blockRows) * rowSize;
+  uint64_t rowsSize = ((rowsCount + blockRows - 1) / blockRows) * blockSize;
+
   FileContainer rowsData((fileNamePrefix + PS_TABLE_FIXFIELDS_EXT).c_str(),
                          settings.mMaxFileSize,
-                         ((rowSize * rowsCount) + settings.mMaxFileSize - 1) / settings.mMaxFileSize,
+                         (rowsSize + settings.mMaxFileSize - 1) / settings.mMaxFileSize,
                          false);
 
   RepairTableNodeManager tableNodeMgr(dbs, tableData);
 
-  if (rowSize * rowsCount != rowsData.Size())
+  if (rowsSize != rowsData.Size())
   {
     const bool fix = fixCallback(FIX_QUESTION,
                                 "The table's row data does not match table header descriptions.");
     if (! fix )
       return false;
 
-    rowsCount = min<uint64_t> (rowsData.Size() / rowSize, rowsCount);
+    rowsCount = min<uint64_t> ((rowsData.Size() / blockSize) * blockRows, rowsCount);
+    rowsSize = ((rowsCount + blockRows - 1) / blockRows) * blockSize;
 
     fixCallback(INFORMATION, "Set the table rows count at '%u'.", rowsCount);
 
-    rowsData.Colapse(rowsCount * rowSize, rowsData.Size());
+    rowsData.Colapse(rowsSize, rowsData.Size());
   }
   else
     fixCallback(INFORMATION, "Table '%s' has %u row(s) allocated.", name.c_str(), rowsCount);
@@ -1296,12 +1557,15 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
   {
     vsData->Init((fileNamePrefix + PS_TABLE_VARFIELDS_EXT).c_str(),
                  vsDataSize,
-                 settings.mMaxFileSize);
+                 settings.mMaxFileSize,
+                 true);
     vsData->PrepareToCheckStorage();
   }
 
   unique_ptr<uint8_t[]> _d(unique_array_make(uint8_t, rowSize));
+  unique_ptr<uint8_t[]> _b(unique_array_make(uint8_t, blockSize));
   uint8_t* const rowData = _d.get();
+  uint8_t* const blockData = _b.get();
   for (ROW_INDEX row = 0; row < rowsCount; ++row)
   {
     NODE_INDEX dummyNode;
@@ -1309,7 +1573,13 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
 
     bool allFieldsAreNull = true;
 
-    rowsData.Read(row * rowSize, rowSize, rowData);
+    const uint64_t blockOffset = (row / blockRows) * blockSize;
+    const uint_t itemOffset = (row % blockRows) * rowSize;
+
+    if (itemOffset == 0)
+      rowsData.Read(blockOffset, blockSize, blockData);
+
+    layout.LoadRow(blockData, itemOffset, fds, rowData);
 
     for (FIELD_INDEX field = 0; field < fieldsCount; ++field)
     {
@@ -1634,7 +1904,10 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
 
       allFieldsAreNull &= isNullValue;
     }
-    rowsData.Write(row * rowSize, rowSize, rowData);
+    layout.StoreRow(blockData, itemOffset, fds, rowData);
+
+    if ((itemOffset + rowSize == blockSize) || (row + 1 == rowsCount))
+      rowsData.Write(blockOffset, blockSize, blockData);
 
     if (allFieldsAreNull)
     {
@@ -1660,12 +1933,21 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
                                rowsData.Size(),
                                settings.mMaxFileSize);
 
+  //The zones are not to be trusted either, so they are built again at open.
+  remove_extra_container_files(fixCallback,
+                               (fileNamePrefix + PS_TABLE_ZONES_EXT),
+                               0,
+                               settings.mMaxFileSize);
+  store_le_int64(0, tableHeader.get() + PS_TABLE_ZONES_SIZE_OFF);
+
   store_le_int64(rowsCount, tableHeader.get() + PS_TABLE_ROWS_COUNT_OFF);
   store_le_int64(vsDataSize, tableHeader.get() + PS_TABLE_VARSTORAGE_SIZE_OFF);
   store_le_int32(tableNodeMgr.RootNodeId(), tableHeader.get() + PS_TABLE_BT_ROOT_OFF);
   store_le_int64(tableData.Size(), tableHeader.get() + PS_TABLE_MAINTABLE_SIZE_OFF);
 
-  store_le_int32(0, tableHeader.get() + PS_TABLE_FLAGS_OFF);
+  //A PAX flag with no block rows count was not set by us.
+  store_le_int32(layout.IsPax() ? PS_TABLE_PAX_LAYOUT_MASK : 0,
+                 tableHeader.get() + PS_TABLE_FLAGS_OFF);
 
   for (FIELD_INDEX field = 0; field < fieldsCount; ++field)
   {
@@ -1731,12 +2013,14 @@ TemporalTable::TemporalTable(DbsHandler&                       dbs,
   mFieldsCount = fieldsCount;
   mDescriptorsSize = descriptorsSize;
   mRowSize = rowSize;
+  mLayout = RowsLayout(mRowSize, mFieldsCount);
   mFieldsDescriptors.reset(fieldDescs.release());
 
   mvIndexNodeMgrs.insert(mvIndexNodeMgrs.begin(), mFieldsCount, nullptr);
+  mvHashIndexes.insert(mvHashIndexes.begin(), mFieldsCount, nullptr);
 
-  uint_t blkSize = DBSSettings().mTableCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mTableCacheBlkCount;
+  uint_t blkSize = mDbs.Settings().mTableCacheBlkSize;
+  const uint_t blkCount = mDbs.Settings().mTableCacheBlkCount;
 
   assert((blkSize != 0) && (blkCount != 0));
 
@@ -1744,6 +2028,8 @@ TemporalTable::TemporalTable(DbsHandler&                       dbs,
     blkSize *= 2;
 
   mRowCache.Init(*this, mRowSize, blkSize, blkCount, true);
+
+  InitZones();
 }
 
 
@@ -1753,9 +2039,10 @@ TemporalTable::TemporalTable(const PrototypeTable& prototype)
 {
 
   mvIndexNodeMgrs.insert(mvIndexNodeMgrs.begin(), mFieldsCount, nullptr);
+  mvHashIndexes.insert(mvHashIndexes.begin(), mFieldsCount, nullptr);
 
-  uint_t       blkSize  = DBSSettings().mTableCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mTableCacheBlkCount;
+  uint_t       blkSize  = mDbs.Settings().mTableCacheBlkSize;
+  const uint_t blkCount = mDbs.Settings().mTableCacheBlkCount;
 
   assert((blkSize != 0) && (blkCount != 0));
 
@@ -1763,12 +2050,17 @@ TemporalTable::TemporalTable(const PrototypeTable& prototype)
     blkSize *= 2;
 
   mRowCache.Init(*this, mRowSize, blkSize, blkCount, true);
+
+  InitZones();
 }
 
 TemporalTable::~TemporalTable()
 {
   for (FIELD_INDEX fieldIndex = 0; fieldIndex < mFieldsCount; ++fieldIndex)
+  {
     delete mvIndexNodeMgrs[fieldIndex];
+    delete mvHashIndexes[fieldIndex];
+  }
 }
 
 bool
@@ -1792,6 +2084,8 @@ TemporalTable::FlushEpilog()
 {
   if (mVSData != nullptr)
     mVSData->Flush();
+
+  MakeHeaderPersistent();
 }
 
 void
@@ -1801,7 +2095,7 @@ TemporalTable::MakeHeaderPersistent()
 }
 
 IDataContainer*
-TemporalTable::CreateIndexContainer(const FIELD_INDEX)
+TemporalTable::CreateIndexContainer(const FIELD_INDEX, const INDEX_KIND)
 {
   return new TemporalContainer();
 }
@@ -1836,6 +2130,13 @@ TemporalTable::VSStore()
   return mVSData;
 }
 
+IDataContainer*
+TemporalTable::ZonesContainer()
+{
+  //The zones of a temporal table are kept only in memory.
+  return nullptr;
+}
+
 
 } //namespace pastra
 } //namespace whais
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PS_TABLE_H_
 
 #include "ps_templatetable.h"
+#include "ps_writeback.h"
 
 
 namespace whais {
@@ -38,14 +39,15 @@ prototype_fix_table(DbsHandler&          dbs,
                     FIX_ERROR_CALLBACK   fixCallback);
 
 
-class PersistentTable : public PrototypeTable
+class PersistentTable : public PrototypeTable, public IWriteBackClient
 {
 public:
   PersistentTable(DbsHandler& dbs, const std::string& name);
   PersistentTable(DbsHandler&                       dbs,
                   const std::string&                name,
                   const DBSFieldDescriptor* const   inoutFields,
-                  const uint_t                      fieldsCount);
+                  const uint_t                      fieldsCount,
+                  const TABLE_LAYOUT                layout = TABLE_ROWS_LAYOUT);
   PersistentTable(const PrototypeTable& prototype);
   virtual ~PersistentTable() override;
 
@@ -54,6 +56,8 @@ public:
   virtual bool IsTemporal() const override;
   virtual ITable& Spawn() const override;
   virtual void FlushEpilog() override;
+  virtual void WriteBack(const bool urgent) override;
+  virtual void Statistics(DBSTableStats& outStats) override;
 
 public:
   static bool ValidateTable(const std::string& path, const std::string& name);
@@ -64,23 +68,30 @@ public:
 
 protected:
   virtual void MakeHeaderPersistent() override;
-  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) override;
+  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field,
+                                               const INDEX_KIND kind) override;
   virtual IDataContainer& RowsContainer() override;
   virtual IDataContainer& TableContainer() override;
   virtual VariableSizeStoreSPtr VSStore() override;
+  virtual IDataContainer* ZonesContainer() override;
 
   const DBSSettings&               mDbsSettings;
   uint64_t                         mMaxFileSize;
   uint64_t                         mVSDataSize;
+  uint64_t                         mZonesDataSize;
   std::string                      mFileNamePrefix;
   std::unique_ptr<FileContainer>   mTableData;
   std::unique_ptr<FileContainer>   mRowsData;
+  std::unique_ptr<FileContainer>   mZonesData;
   VariableSizeStoreSPtr            mVSData;
+  WriteAheadLog* const             mLog;
+  const uint32_t                   mLogOwner;
   bool                             mRemoved;
 
 private:
   void InitFromFile(const std::string& tableName);
   void InitIndexedFields();
+  void UpdateIndexesUnitsCount();
   void InitVariableStorages();
   void CheckTableValues(FIX_ERROR_CALLBACK fixCallback);
 };
@@ -102,10 +113,12 @@ public:
 
 protected:
   virtual void MakeHeaderPersistent() override;
-  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) override;
+  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field,
+                                               const INDEX_KIND kind) override;
   virtual IDataContainer& RowsContainer() override;
   virtual IDataContainer& TableContainer() override;
   virtual VariableSizeStoreSPtr VSStore() override;
+  virtual IDataContainer* ZonesContainer() override;
 
   std::unique_ptr<TemporalContainer>   mTableData;
   std::unique_ptr<TemporalContainer>   mRowsData;
@@ -22,6 +22,9 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
+#include <queue>
+
 #include "utils/endianness.h"
 #include "utils/wutf.h"
 #include "utils/wunicode.h"
@@ -38,6 +41,105 @@ namespace whais {
 namespace pastra {
 
 
+static uint_t
+field_value_size(const FieldDescriptor& desc)
+{
+  return Serializer::Size(_SC(DBS_FIELD_TYPE, GET_BASE_TYPE(desc.Type())),
+                          IS_ARRAY(desc.Type()));
+}
+
+
+static bool
+is_null_row_value(const FieldDescriptor& desc, const uint8_t* const nullBits)
+{
+  return (nullBits[desc.NullBitIndex() / 8] & (1 << (desc.NullBitIndex() % 8))) != 0;
+}
+
+
+/* The values are hashed as they are stored in the rows, so the hash of a
+   value looked for is the hash of its serialized form. */
+static uint64_t
+hash_row_value(const FieldDescriptor& desc, const uint8_t* const fieldData)
+{
+  return FieldHashIndex::Hash(fieldData, field_value_size(desc));
+}
+
+
+template<class T> static uint64_t
+hash_field_value(const T& value)
+{
+  uint8_t data[2 * sizeof(uint64_t)];
+
+  assert(Serializer::Size(value.DBSType(), false) <= sizeof data);
+
+  Serializer::Store(data, value);
+  return FieldHashIndex::Hash(data, Serializer::Size(value.DBSType(), false));
+}
+
+
+uint_t
+RowsLayout::ValueOffset(const uint_t itemOffset, const FieldDescriptor& desc) const
+{
+  if ( ! IsPax())
+    return itemOffset + desc.RowDataOff();
+
+  return mBlockRows * desc.RowDataOff() + (itemOffset / mRowSize) * field_value_size(desc);
+}
+
+
+uint_t
+RowsLayout::ValueStride(const FieldDescriptor& desc) const
+{
+  return IsPax() ? field_value_size(desc) : mRowSize;
+}
+
+
+void
+RowsLayout::LoadRow(const uint8_t* const           block,
+                    const uint_t                   itemOffset,
+                    const FieldDescriptor* const   fields,
+                    uint8_t* const                 to) const
+{
+  if ( ! IsPax())
+  {
+    memcpy(to, block + itemOffset, mRowSize);
+    return;
+  }
+
+  memcpy(to, block + NullBitsOffset(itemOffset), mNullBytes);
+
+  for (uint_t f = 0; f < mFieldsCount; ++f)
+  {
+    memcpy(to + fields[f].RowDataOff(),
+           block + ValueOffset(itemOffset, fields[f]),
+           field_value_size(fields[f]));
+  }
+}
+
+
+void
+RowsLayout::StoreRow(uint8_t* const                 block,
+                     const uint_t                   itemOffset,
+                     const FieldDescriptor* const   fields,
+                     const uint8_t* const           from) const
+{
+  if ( ! IsPax())
+  {
+    memcpy(block + itemOffset, from, mRowSize);
+    return;
+  }
+
+  memcpy(block + NullBitsOffset(itemOffset), from, mNullBytes);
+
+  for (uint_t f = 0; f < mFieldsCount; ++f)
+  {
+    memcpy(block + ValueOffset(itemOffset, fields[f]),
+           from + fields[f].RowDataOff(),
+           field_value_size(fields[f]));
+  }
+}
+
+
 PrototypeTable::PrototypeTable(DbsHandler& dbs)
   : mDbs(dbs),
     mRowsCount(0),
@@ -58,12 +160,15 @@ PrototypeTable::PrototypeTable(const PrototypeTable& prototype)
     mRootNode(NIL_NODE),
     mUnallocatedHead(NIL_NODE),
     mRowSize(prototype.mRowSize),
+    mLayout(prototype.mRowSize, prototype.mFieldsCount),
     mDescriptorsSize(prototype.mDescriptorsSize),
     mFieldsCount(prototype.mFieldsCount),
     mFieldsDescriptors(),
     mvIndexNodeMgrs(),
+    mvHashIndexes(),
     mRowsSync(),
     mIndexesSync(),
+    mUpdatesSync(),
     mRowModified(false),
     mLockInProgress(false)
 {
@@ -78,12 +183,57 @@ PrototypeTable::PrototypeTable(const PrototypeTable& prototype)
 void
 PrototypeTable::Flush()
 {
-  DoubleLockGuard<Lock> _l(mRowsSync, mIndexesSync);
+  LockGuard<MeteredRWLock> _l(mRowsSync);
+  LockGuard<MeteredLock> _l2(mIndexesSync);
 
   FlushInternal();
 }
 
 
+void
+PrototypeTable::Statistics(DBSTableStats& outStats)
+{
+  const BlockCacheStats cacheStats = mRowCache.Statistics();
+
+  memset(&outStats, 0, sizeof outStats);
+
+  outStats.mCacheHits           = cacheStats.mHits;
+  outStats.mCacheMisses         = cacheStats.mMisses;
+  outStats.mCacheEvictions      = cacheStats.mEvictions;
+  outStats.mRowsLockWaits       = mRowsSync.Waits();
+  outStats.mRowsLockWaitTime    = mRowsSync.WaitTime();
+  outStats.mIndexesLockWaits    = mIndexesSync.Waits();
+  outStats.mIndexesLockWaitTime = mIndexesSync.WaitTime();
+
+  LockGuard<MeteredLock> _l(mIndexesSync, true);
+  if ( ! _l.try_lock())
+    return;
+
+  for (auto nodeMgr : mvIndexNodeMgrs)
+  {
+    if (nodeMgr == nullptr)
+      continue;
+
+    uint64_t retrieved, loaded;
+    nodeMgr->NodesStatistics(&retrieved, &loaded);
+
+    outStats.mNodesRetrieved += retrieved;
+    outStats.mNodesLoaded    += loaded;
+    outStats.mBytesRead      += nodeMgr->Container().BytesRead();
+    outStats.mBytesWritten   += nodeMgr->Container().BytesWritten();
+  }
+
+  for (auto hashIndex : mvHashIndexes)
+  {
+    if (hashIndex == nullptr)
+      continue;
+
+    outStats.mBytesRead    += hashIndex->Container().BytesRead();
+    outStats.mBytesWritten += hashIndex->Container().BytesWritten();
+  }
+}
+
+
 void
 PrototypeTable::LockTable()
 {
@@ -182,7 +332,7 @@ insert_null_field_value(BTree& tree, const ROW_INDEX row)
 ROW_INDEX
 PrototypeTable::AddRow(const bool skipThreadSafety)
 {
-  LockGuard<Lock> syncGuard(mRowsSync, skipThreadSafety);
+  LockGuard<MeteredRWLock> syncGuard(mRowsSync, skipThreadSafety);
   MarkRowModification(skipThreadSafety ? nullptr : &syncGuard);
 
   uint64_t lastRowPosition = mRowsCount * mRowSize;
@@ -191,7 +341,23 @@ PrototypeTable::AddRow(const bool skipThreadSafety)
   uint8_t dummyValue[128];
   memset(dummyValue, 0xFF, sizeof dummyValue);
 
-  mRowCache.FlushItem(mRowsCount - 1);
+  if (mLayout.IsPax())
+  {
+    /* The blocks are stored whole, so a new row has its place already set
+       unless it starts a new block. */
+    if (mRowsCount % mLayout.BlockRows() == 0)
+    {
+      const uint_t blockSize = mLayout.BlockRows() * mRowSize;
+      unique_ptr<uint8_t[]> block(new uint8_t[blockSize]);
+
+      memset(block.get(), 0xFF, blockSize);
+      RowsContainer().Write(lastRowPosition, blockSize, block.get());
+    }
+
+    toWrite = 0;
+  }
+  else
+    mRowCache.FlushItem(mRowsCount - 1);
 
   while (toWrite > 0)
   {
@@ -208,7 +374,7 @@ PrototypeTable::AddRow(const bool skipThreadSafety)
 
   removedRows.InsertKey(TableRmKey(mRowsCount), &dummyNode, &dummyKey);
 
-  LockGuard<Lock> syncHolder2(mIndexesSync);
+  LockGuard<MeteredLock> syncHolder2(mIndexesSync);
 
   for (uint_t f = 0; f < mvIndexNodeMgrs.size(); f++)
   {
@@ -309,6 +475,11 @@ PrototypeTable::AddRow(const bool skipThreadSafety)
     }
   }
 
+  mZones.AddRow(mRowsCount);
+
+  if (mLayout.IsPax())
+    return mRowsCount++;
+
   // The rows count has to be update before the procedure code is executed.
   // Other way the new content will not be refreshed.
   mRowCache.RefreshItem(mRowsCount++);
@@ -325,7 +496,7 @@ PrototypeTable::GetReusableRow(const bool forceAdd)
   TableRmKey key(0);
   BTree removedRows( *this);
 
-  LockGuard<Lock> syncHolder(mRowsSync);
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync);
   if (removedRows.FindBiggerOrEqual(key, &node, &keyIndex) == false)
   {
     if (forceAdd)
@@ -359,7 +530,7 @@ PrototypeTable::ReusableRowsCount()
   TableRmKey key(0);
   BTree removedRows( *this);
 
-  LockGuard<Lock> syncHolder(mRowsSync);
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync);
   if (removedRows.FindBiggerOrEqual(key, &nodeId, &keyIndex) == false)
     return 0;
 
@@ -466,160 +637,252 @@ PrototypeTable::MarkRowForReuse(const ROW_INDEX row)
 }
 
 
-template<class T> static void
-insert_row_field(PrototypeTable& table,
-                 BTree& tree,
-                 const ROW_INDEX row,
-                 const FIELD_INDEX field)
+static const uint_t INDEX_SORT_RUN_KEYS  = 256 * 1024;
+static const uint_t INDEX_SORT_RUN_CACHE = 64 * 1024;
+
+
+/* Collects the keys of a new field index and hands them back in descending
+   order. The keys that do not fit in memory are spilled in sorted runs to
+   temporal containers, which are merged back at the end. */
+template<class T>
+class IndexKeysSorter
 {
-  NODE_INDEX dummyNode;
-  KEY_INDEX dummyKey;
+public:
+  IndexKeysSorter()
+    : mValueSize(Serializer::Size(T().DBSType(), false)),
+      mRecordSize(sizeof(ROW_INDEX) + 1 + mValueSize),
+      mNextKey(0)
+  {
+    mKeys.reserve(INDEX_SORT_RUN_KEYS);
+  }
 
-  T rowValue;
-  table.Get(row, field, rowValue, true);
+  void Add(const T& value, const ROW_INDEX row)
+  {
+    mKeys.push_back(Key(value, row));
 
-  T_BTreeKey<T> keyValue(rowValue, row);
+    if (mKeys.size() >= INDEX_SORT_RUN_KEYS)
+      SpillRun();
+  }
 
-  tree.InsertKey(keyValue, &dummyNode, &dummyKey);
-}
+  void Sort()
+  {
+    if (mRuns.empty())
+    {
+      sort(mKeys.begin(), mKeys.end(), descending_order);
+      return;
+    }
 
+    if ( ! mKeys.empty())
+      SpillRun();
 
-void
-PrototypeTable::CreateIndex(const FIELD_INDEX field,
-                            CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
-                            CreateIndexCallbackContext* const cbContext)
-{
-  if ((cbFunc == nullptr) && (cbContext != nullptr))
-    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+    for (uint_t r = 0; r < mRuns.size(); ++r)
+      MergeNext(r);
+  }
 
-  if (field >= mFieldsCount)
+  T_BTreeKey<T> operator() ()
   {
-    throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
-                       "Table field index is invalid %u(%u),",
-                       field,
-                       mFieldsCount);
+    if (mRuns.empty())
+    {
+      assert(mNextKey < mKeys.size());
+
+      const Key& key = mKeys[mNextKey++];
+      return T_BTreeKey<T>(key.mValue, key.mRow);
+    }
+
+    assert( ! mMergeHeap.empty());
+
+    const MergeEntry top = mMergeHeap.top();
+    mMergeHeap.pop();
+
+    MergeNext(top.mRun);
+
+    return T_BTreeKey<T>(top.mKey.mValue, top.mKey.mRow);
   }
 
-  LockGuard<Lock> syncHolder(mRowsSync);
+private:
+  struct Key
+  {
+    Key(const T& value, const ROW_INDEX row)
+      : mValue(value),
+        mRow(row)
+    {
+    }
 
-  assert(mvIndexNodeMgrs.size() == mFieldsCount);
+    bool operator< (const Key& second) const
+    {
+      if (mValue == second.mValue)
+        return mRow < second.mRow;
 
-  if (mvIndexNodeMgrs[field] != nullptr)
-    throw DBSException(_EXTRA(DBSException::FIELD_INDEXED));
+      return mValue < second.mValue;
+    }
 
-  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+    T           mValue;
+    ROW_INDEX   mRow;
+  };
 
-  if ((desc.Type() == T_TEXT) || (desc.Type() & PS_TABLE_ARRAY_MASK) != 0)
+  struct Run
   {
-    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
-                       "This implementation does not support indexing text "
-                       "or array fields.");
-  }
+    std::unique_ptr<TemporalContainer> mContainer;
+    uint64_t                           mPosition;
+  };
 
-  const uint_t nodeSizeKB  = 16; //16KB
+  struct MergeEntry
+  {
+    bool operator< (const MergeEntry& second) const { return mKey < second.mKey; }
 
-  unique_ptr<IDataContainer> indexContainer(CreateIndexContainer(field));
-  unique_ptr<FieldIndexNodeManager> nodeMgr(new FieldIndexNodeManager(indexContainer,
-                                                                      nodeSizeKB * 1024,
-                                                                      0x400000, //4MB
-                                                                      _SC(DBS_FIELD_TYPE,
-                                                                          desc.Type()),
-                                                                      true));
+    Key      mKey;
+    uint_t   mRun;
+  };
 
-  BTree fieldTree( *nodeMgr.get());
-  for (ROW_INDEX row = 0; row < mRowsCount; ++row)
+  static bool descending_order(const Key& first, const Key& second)
+  {
+    return second < first;
+  }
+
+  void SpillRun()
   {
-    switch (desc.Type())
+    sort(mKeys.begin(), mKeys.end(), descending_order);
+
+    Run run;
+    run.mContainer.reset(new TemporalContainer(INDEX_SORT_RUN_CACHE));
+    run.mPosition = 0;
+
+    const uint_t bufferKeys = INDEX_SORT_RUN_CACHE / mRecordSize;
+    unique_ptr<uint8_t[]> buffer(new uint8_t[bufferKeys * mRecordSize]);
+
+    uint64_t position = 0;
+    for (size_t k = 0; k < mKeys.size(); )
     {
-    case T_BOOL:
-      insert_row_field<DBool>( *this, fieldTree, row, field);
-      break;
+      uint_t count = 0;
+      for (; (count < bufferKeys) && (k < mKeys.size()); ++count, ++k)
+      {
+        uint8_t* const record = buffer.get() + count * mRecordSize;
 
-    case T_CHAR:
-      insert_row_field<DChar>( *this, fieldTree, row, field);
-      break;
+        memcpy(record, &mKeys[k].mRow, sizeof(ROW_INDEX));
+        record[sizeof(ROW_INDEX)] = mKeys[k].mValue.IsNull() ? 1 : 0;
+        if ( ! mKeys[k].mValue.IsNull())
+          Serializer::Store(record + sizeof(ROW_INDEX) + 1, mKeys[k].mValue);
+      }
 
-    case T_DATE:
-      insert_row_field<DDate>( *this, fieldTree, row, field);
-      break;
+      run.mContainer->Write(position, count * mRecordSize, buffer.get());
+      position += count * mRecordSize;
+    }
 
-    case T_DATETIME:
-      insert_row_field<DDateTime>( *this, fieldTree, row, field);
-      break;
+    mRuns.push_back(std::move(run));
+    mKeys.clear();
+  }
 
-    case T_HIRESTIME:
-      insert_row_field<DHiresTime>( *this, fieldTree, row, field);
-      break;
+  void MergeNext(const uint_t runIndex)
+  {
+    Run& run = mRuns[runIndex];
 
-    case T_UINT8:
-      insert_row_field<DUInt8>( *this, fieldTree, row, field);
-      break;
+    if (run.mPosition >= run.mContainer->Size())
+    {
+      run.mContainer.reset();
+      return;
+    }
 
-    case T_UINT16:
-      insert_row_field<DUInt16>( *this, fieldTree, row, field);
-      break;
+    uint8_t record[sizeof(ROW_INDEX) + 1 + 16];
+    assert(mRecordSize <= sizeof record);
 
-    case T_UINT32:
-      insert_row_field<DUInt32>( *this, fieldTree, row, field);
-      break;
+    run.mContainer->Read(run.mPosition, mRecordSize, record);
+    run.mPosition += mRecordSize;
 
-    case T_UINT64:
-      insert_row_field<DUInt64>( *this, fieldTree, row, field);
-      break;
+    ROW_INDEX row;
+    memcpy(&row, record, sizeof(ROW_INDEX));
 
-    case T_INT8:
-      insert_row_field<DInt8>( *this, fieldTree, row, field);
-      break;
+    T value;
+    if (record[sizeof(ROW_INDEX)] == 0)
+      Serializer::Load(record + sizeof(ROW_INDEX) + 1, &value);
 
-    case T_INT16:
-      insert_row_field<DInt16>( *this, fieldTree, row, field);
-      break;
+    mMergeHeap.push(MergeEntry{Key(value, row), runIndex});
+  }
 
-    case T_INT32:
-      insert_row_field<DInt32>( *this, fieldTree, row, field);
-      break;
+  const uint_t                       mValueSize;
+  const uint_t                       mRecordSize;
+  std::vector<Key>                   mKeys;
+  size_t                             mNextKey;
+  std::vector<Run>                   mRuns;
+  std::priority_queue<MergeEntry>    mMergeHeap;
+};
 
-    case T_INT64:
-      insert_row_field<DInt64>( *this, fieldTree, row, field);
-      break;
 
-    case T_REAL:
-      insert_row_field<DReal>( *this, fieldTree, row, field);
-      break;
+template<class T> static void
+build_field_index(PrototypeTable&                    table,
+                  FieldIndexNodeManager&             nodeMgr,
+                  const FIELD_INDEX                  field,
+                  const ROW_INDEX                    rowsCount,
+                  CREATE_INDEX_CALLBACK_FUNC* const  cbFunc,
+                  CreateIndexCallbackContext* const  cbContext)
+{
+  IndexKeysSorter<T> keys;
 
-    case T_RICHREAL:
-      insert_row_field<DRichReal>( *this, fieldTree, row, field);
-      break;
+  for (ROW_INDEX row = 0; row < rowsCount; ++row)
+  {
+    T rowValue;
+    table.Get(row, field, rowValue, true);
 
-    default:
-      assert(false);
-    }
+    keys.Add(rowValue, row);
 
     if (cbFunc != nullptr)
     {
       if (cbContext != nullptr)
       {
-        cbContext->mRowsCount = mRowsCount;
+        cbContext->mRowsCount = rowsCount;
         cbContext->mRowIndex = row;
       }
       cbFunc(cbContext);
     }
   }
 
-  desc.IndexNodeSizeKB(nodeSizeKB);
-  desc.IndexUnitsCount(1);
+  if (rowsCount == 0)
+    return;
 
-  MakeHeaderPersistent();
+  keys.Sort();
+  nodeMgr.BulkLoad<T>(keys, rowsCount, DBSGetSeettings().mIndexFillFactor);
+}
 
-  assert(mvIndexNodeMgrs[field] == nullptr);
 
-  mvIndexNodeMgrs[field] = nodeMgr.release();
+void
+PrototypeTable::BuildHashIndex(FieldHashIndex&                    hashIndex,
+                               const FieldDescriptor&             desc,
+                               CREATE_INDEX_CALLBACK_FUNC* const  cbFunc,
+                               CreateIndexCallbackContext* const  cbContext)
+{
+  for (ROW_INDEX row = 0; row < mRowsCount; ++row)
+  {
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+
+    if ( ! is_null_row_value(desc, RowNullBits(cachedItem)))
+      hashIndex.Insert(hash_row_value(desc, RowValue(cachedItem, desc)), row);
+
+    if (cbFunc != nullptr)
+    {
+      if (cbContext != nullptr)
+      {
+        cbContext->mRowsCount = mRowsCount;
+        cbContext->mRowIndex = row;
+      }
+      cbFunc(cbContext);
+    }
+  }
+
+  hashIndex.Flush();
 }
 
 
 void
-PrototypeTable::RemoveIndex(const FIELD_INDEX field)
+PrototypeTable::CreateIndex(const FIELD_INDEX field,
+                            CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
+                            CreateIndexCallbackContext* const cbContext,
+                            const INDEX_KIND kind)
 {
+  if (((cbFunc == nullptr) && (cbContext != nullptr))
+      || ((kind != INDEX_BTREE) && (kind != INDEX_HASH)))
+  {
+    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+  }
+
   if (field >= mFieldsCount)
   {
     throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
@@ -628,36 +891,187 @@ PrototypeTable::RemoveIndex(const FIELD_INDEX field)
                        mFieldsCount);
   }
 
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync);
+
   assert(mvIndexNodeMgrs.size() == mFieldsCount);
+  assert(mvHashIndexes.size() == mFieldsCount);
 
-  LockGuard<Lock> syncHolder(mRowsSync);
+  if ((mvIndexNodeMgrs[field] != nullptr) || (mvHashIndexes[field] != nullptr))
+    throw DBSException(_EXTRA(DBSException::FIELD_INDEXED));
 
   FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
-  if (mvIndexNodeMgrs[field] == nullptr)
-    throw DBSException(_EXTRA(DBSException::FIELD_NOT_INDEXED));
-
-  AcquireFieldIndex( &desc);
-  assert(desc.IndexNodeSizeKB() > 0);
-  assert(desc.IndexUnitsCount() > 0);
+  if ((desc.Type() == T_TEXT) || (desc.Type() & PS_TABLE_ARRAY_MASK) != 0)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                       "This implementation does not support indexing text "
+                       "or array fields.");
+  }
 
-  desc.IndexNodeSizeKB(0);
-  desc.IndexUnitsCount(0);
+  if (kind == INDEX_HASH)
+  {
+    unique_ptr<IDataContainer> indexContainer(CreateIndexContainer(field, INDEX_HASH));
+    unique_ptr<FieldHashIndex> hashIndex(new FieldHashIndex(indexContainer, true));
 
-  unique_ptr<FieldIndexNodeManager> fieldMgr(mvIndexNodeMgrs[field]);
-  fieldMgr->MarkForRemoval();
+    BuildHashIndex( *hashIndex, desc, cbFunc, cbContext);
 
-  mvIndexNodeMgrs[field] = nullptr;
-  ReleaseIndexField( &desc);
+    desc.HashIndexed(true);
+    desc.IndexUnitsCount(1);
 
-  MakeHeaderPersistent();
-}
+    MakeHeaderPersistent();
 
+    mvHashIndexes[field] = hashIndex.release();
+    return;
+  }
 
-bool
-PrototypeTable::IsIndexed(const FIELD_INDEX field) const
-{
-  LockGuard<Lock> syncHolder(_CC(Lock&, mRowsSync));
+  const uint_t nodeSizeKB  = 16; //16KB
+
+  unique_ptr<IDataContainer> indexContainer(CreateIndexContainer(field, INDEX_BTREE));
+  unique_ptr<FieldIndexNodeManager> nodeMgr(new FieldIndexNodeManager(indexContainer,
+                                                                      nodeSizeKB * 1024,
+                                                                      0x400000, //4MB
+                                                                      _SC(DBS_FIELD_TYPE,
+                                                                          desc.Type()),
+                                                                      true));
+
+  //Sort the keys first, then write the index nodes at once.
+  switch (desc.Type())
+  {
+  case T_BOOL:
+    build_field_index<DBool>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_CHAR:
+    build_field_index<DChar>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_DATE:
+    build_field_index<DDate>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_DATETIME:
+    build_field_index<DDateTime>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_HIRESTIME:
+    build_field_index<DHiresTime>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_UINT8:
+    build_field_index<DUInt8>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_UINT16:
+    build_field_index<DUInt16>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_UINT32:
+    build_field_index<DUInt32>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_UINT64:
+    build_field_index<DUInt64>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_INT8:
+    build_field_index<DInt8>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_INT16:
+    build_field_index<DInt16>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_INT32:
+    build_field_index<DInt32>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_INT64:
+    build_field_index<DInt64>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_REAL:
+    build_field_index<DReal>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  case T_RICHREAL:
+    build_field_index<DRichReal>( *this, *nodeMgr, field, mRowsCount, cbFunc, cbContext);
+    break;
+
+  default:
+    assert(false);
+  }
+
+  desc.IndexNodeSizeKB(nodeSizeKB);
+  desc.IndexUnitsCount(1);
+
+  MakeHeaderPersistent();
+
+  assert(mvIndexNodeMgrs[field] == nullptr);
+
+  mvIndexNodeMgrs[field] = nodeMgr.release();
+}
+
+
+void
+PrototypeTable::RemoveIndex(const FIELD_INDEX field)
+{
+  if (field >= mFieldsCount)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
+                       "Table field index is invalid %u(%u),",
+                       field,
+                       mFieldsCount);
+  }
+
+  assert(mvIndexNodeMgrs.size() == mFieldsCount);
+
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync);
+
+  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  if (mvHashIndexes[field] != nullptr)
+  {
+    assert(desc.HashIndexed());
+
+    desc.HashIndexed(false);
+    desc.IndexUnitsCount(0);
+
+    unique_ptr<FieldHashIndex> hashIndex(mvHashIndexes[field]);
+    hashIndex->MarkForRemoval();
+
+    mvHashIndexes[field] = nullptr;
+
+    LockGuard<MeteredLock> _l(mIndexesSync);
+    FlushInternal();
+    return;
+  }
+
+  if (mvIndexNodeMgrs[field] == nullptr)
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_INDEXED));
+
+  AcquireFieldIndex( &desc);
+  assert(desc.IndexNodeSizeKB() > 0);
+  assert(desc.IndexUnitsCount() > 0);
+
+  desc.IndexNodeSizeKB(0);
+  desc.IndexUnitsCount(0);
+
+  unique_ptr<FieldIndexNodeManager> fieldMgr(mvIndexNodeMgrs[field]);
+  fieldMgr->MarkForRemoval();
+
+  mvIndexNodeMgrs[field] = nullptr;
+  ReleaseIndexField( &desc);
+
+  //Make the table durable without the index before the index files go away.
+  LockGuard<MeteredLock> _l(mIndexesSync);
+  FlushInternal();
+}
+
+
+bool
+PrototypeTable::IsIndexed(const FIELD_INDEX field) const
+{
+  SharedLockGuard<MeteredRWLock> syncHolder(_CC(MeteredRWLock&, mRowsSync));
 
   if (field >= mFieldsCount)
   {
@@ -669,7 +1083,27 @@ PrototypeTable::IsIndexed(const FIELD_INDEX field) const
 
   assert(mvIndexNodeMgrs.size() == mFieldsCount);
 
-  return mvIndexNodeMgrs[field] != nullptr;
+  return (mvIndexNodeMgrs[field] != nullptr) || (mvHashIndexes[field] != nullptr);
+}
+
+
+INDEX_KIND
+PrototypeTable::IndexKind(const FIELD_INDEX field) const
+{
+  SharedLockGuard<MeteredRWLock> syncHolder(_CC(MeteredRWLock&, mRowsSync));
+
+  if (field >= mFieldsCount)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
+                       "Table field index is invalid %u(%u),",
+                       field,
+                       mFieldsCount);
+  }
+
+  if (mvIndexNodeMgrs[field] != nullptr)
+    return INDEX_BTREE;
+
+  return (mvHashIndexes[field] != nullptr) ? INDEX_HASH : INDEX_NONE;
 }
 
 
@@ -800,7 +1234,7 @@ PrototypeTable::LoadNode(const NODE_INDEX nodeId)
 
   else
   {
-    MarkRowModification(nullptr);
+    MarkRowModification();
 
     //Reserve space for this node
     assert(TableContainer().Size() == (nodeId * NodeRawSize()));
@@ -833,49 +1267,98 @@ PrototypeTable::StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t*
 {
   assert(mRowModified);
 
-  if (itemsCount + firstItem > mRowsCount)
-    itemsCount = mRowsCount - firstItem;
+  if (itemsCount + firstItem > StoredRowsCount())
+    itemsCount = StoredRowsCount() - firstItem;
 
   RowsContainer().Write(firstItem * mRowSize, itemsCount * mRowSize, from);
 }
 
 
+void
+PrototypeTable::StoreBlocks(uint64_t               firstItem,
+                            const uint_t           itemsPerBlock,
+                            const uint8_t* const*  blocks,
+                            const uint_t           blocksCount)
+{
+  assert(mRowModified);
+
+  const uint64_t to = firstItem * mRowSize;
+  const uint64_t storedRows = StoredRowsCount();
+
+  vector<WIOVec> vecs;
+  vecs.reserve(blocksCount);
+
+  for (uint_t b = 0; (b < blocksCount) && (firstItem < storedRows); ++b)
+  {
+    const uint64_t itemsCount = min<uint64_t>(itemsPerBlock, storedRows - firstItem);
+    const WIOVec vec = { blocks[b], _SC(uint_t, itemsCount * mRowSize) };
+
+    vecs.push_back(vec);
+    firstItem += itemsCount;
+  }
+
+  RowsContainer().Write(to, vecs.data(), vecs.size());
+}
+
+
+uint8_t*
+PrototypeTable::MapItems(uint64_t firstItem, uint_t itemsCount)
+{
+  //Only whole blocks of existing rows, the last one is still growing.
+  if (firstItem + itemsCount > mRowsCount)
+    return nullptr;
+
+  return RowsContainer().MappedAddress(firstItem * mRowSize, _SC(uint64_t, itemsCount) * mRowSize);
+}
+
+
 void
 PrototypeTable::RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to)
 {
-  if (itemsCount + firstItem > mRowsCount)
-    itemsCount = mRowsCount - firstItem;
+  if (itemsCount + firstItem > StoredRowsCount())
+    itemsCount = StoredRowsCount() - firstItem;
 
   RowsContainer().Read(firstItem * mRowSize, itemsCount * mRowSize, to);
 }
 
 
+uint_t
+PrototypeTable::RetrieveBlocks(uint64_t               firstItem,
+                               const uint_t           itemsPerBlock,
+                               uint8_t* const*        blocks,
+                               const uint_t           blocksCount)
+{
+  assert(firstItem < mRowsCount);
+
+  //Only the blocks holding rows, all read with a single request.
+  const uint64_t itemsCount = min<uint64_t>(_SC(uint64_t, blocksCount) * itemsPerBlock,
+                                            StoredRowsCount() - firstItem);
+  const uint64_t blockSize = _SC(uint64_t, itemsPerBlock) * mRowSize;
+  const uint64_t size = itemsCount * mRowSize;
+
+  unique_ptr<uint8_t[]> content(new uint8_t[size]);
+  RowsContainer().Read(firstItem * mRowSize, size, content.get());
+
+  uint_t count = 0;
+  for (uint64_t offset = 0; offset < size; offset += blockSize)
+    memcpy(blocks[count++], content.get() + offset, min(blockSize, size - offset));
+
+  return count;
+}
+
+
 void
 PrototypeTable::CheckRowToDelete(const ROW_INDEX row)
 {
   assert(mRowModified);
 
-  bool allFieldsNull = true;
-
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t* const rowData = cachedItem.GetDataForUpdate();
-
-  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
-  {
-    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
-    const uint8_t bitsSet = ~0;
-
-    if (rowData[fieldDesc.NullBitIndex() / 8] != bitsSet)
-    {
-      allFieldsNull = false;
-      break;
-    }
-  }
 
-  if (allFieldsNull)
+  if (IsNullRowData(RowNullBits(cachedItem)))
   {
     NODE_INDEX dummyNode;
     KEY_INDEX dummyKey;
+    LockGuard<Lock> _l(mUpdatesSync);
     BTree removedNodes( *this);
     TableRmKey key(row);
 
@@ -889,25 +1372,11 @@ PrototypeTable::CheckRowToReuse(const ROW_INDEX row)
 {
   assert(mRowModified);
 
-  bool allFieldsNull = true;
-
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t* const rowData = cachedItem.GetDataForUpdate();
-
-  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
-  {
-    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
-    const uint8_t bitsSet = ~0;
-
-    if (rowData[fieldDesc.NullBitIndex() / 8] != bitsSet)
-    {
-      allFieldsNull = false;
-      break;
-    }
-  }
 
-  if (allFieldsNull)
+  if (IsNullRowData(RowNullBits(cachedItem)))
   {
+    LockGuard<Lock> _l(mUpdatesSync);
     BTree removedNodes( *this);
     TableRmKey key(row);
 
@@ -921,7 +1390,7 @@ PrototypeTable::AcquireFieldIndex(FieldDescriptor* const field)
 {
   while (true)
   {
-    LockGuard<Lock> syncHolder(mIndexesSync);
+    LockGuard<MeteredLock> syncHolder(mIndexesSync);
 
     if ( !field->IsAcquired())
     {
@@ -945,82 +1414,149 @@ PrototypeTable::ReleaseIndexField(FieldDescriptor* const field)
 }
 
 
+template<class T> static void
+load_row_value(const FieldDescriptor&   desc,
+               const uint8_t* const     nullBits,
+               const uint8_t* const     fieldData,
+               T&                       outValue)
+{
+  const uint_t byteOff = desc.NullBitIndex() / 8;
+  const uint8_t bitOff = desc.NullBitIndex() % 8;
+
+  if (nullBits[byteOff] & (1 << bitOff))
+    outValue = T();
+
+  else
+  {
+    outValue.~T();
+    Serializer::Load(fieldData, &outValue);
+  }
+}
+
+
+template<class T> static void
+load_row_value(const FieldDescriptor& desc, const uint8_t* const rowData, T& outValue)
+{
+  load_row_value(desc, rowData, rowData + desc.RowDataOff(), outValue);
+}
+
+
 template <class T> void
 PrototypeTable::StoreEntry(const ROW_INDEX row,
                            const FIELD_INDEX field,
                            const bool threadSafe,
                            const T& value)
 {
-  T currentValue;
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
+
+  if (row < mRowsCount)
+  {
+    UpdateEntry(row, field, threadSafe, value, syncHolder);
+    return;
+  }
+
+  //Adding a row needs the table for itself.
+  syncHolder.unlock();
+
+  LockGuard<MeteredRWLock> exclusiveHolder(mRowsSync, !threadSafe);
   if (row == mRowsCount)
     AddRow(true);
 
-  else
-    RetrieveEntry(row, field, false, currentValue);
+  else if (row > mRowsCount)
+    throw DBSException(_EXTRA(DBSException::ROW_NOT_ALLOCATED));
+
+  UpdateEntry(row, field, threadSafe, value, exclusiveHolder);
+}
+
+
+template <class T, class GUARD> void
+PrototypeTable::UpdateEntry(const ROW_INDEX row,
+                            const FIELD_INDEX field,
+                            const bool threadSafe,
+                            const T& value,
+                            GUARD& syncHolder)
+{
+  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  if ((desc.Type() & PS_TABLE_ARRAY_MASK)
+      || ((desc.Type() & PS_TABLE_FIELD_TYPE_MASK) != _SC(uint_t, value.DBSType())))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+  }
+
+  /* The table may be held only shared, so other sessions could read or
+     update rows at the same time. The row's block latch keeps the updates
+     of the rows sharing the block apart. */
+  StoredItem cachedItem = mRowCache.RetriveItem(row);
+  LockGuard<RWLock> latch(cachedItem.Latch());
+
+  T currentValue;
+  load_row_value(desc, RowNullBits(cachedItem), RowValue(cachedItem, desc), currentValue);
 
   if (currentValue == value)
     return; //Nothing to change
 
-  MarkRowModification(threadSafe ? &syncHolder : nullptr);
+  if ( ! mRowModified)
+  {
+    //This may have to release the table for a while, so don't keep the latch.
+    latch.unlock();
+    MarkRowModification(threadSafe ? &syncHolder : nullptr);
+    latch.lock();
+
+    load_row_value(desc, RowNullBits(cachedItem), RowValue(cachedItem, desc), currentValue);
+    if (currentValue == value)
+      return;
+  }
 
   const uint8_t bitsSet = ~0;
-  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
   const uint_t byteOff = desc.NullBitIndex() / 8;
   const uint8_t bitOff = desc.NullBitIndex() % 8;
 
-  StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t * const rowData = cachedItem.GetDataForUpdate();
+  uint8_t * const nullBits = RowNullBitsForUpdate(cachedItem);
+
+  if (mvHashIndexes[field] != nullptr)
+  {
+    if ( ! currentValue.IsNull())
+      mvHashIndexes[field]->Remove(hash_field_value(currentValue), row);
+
+    if ( ! value.IsNull())
+      mvHashIndexes[field]->Insert(hash_field_value(value), row);
+  }
 
   if (value.IsNull())
   {
-    assert((rowData[byteOff] & (1 << bitOff)) == 0);
+    assert((nullBits[byteOff] & (1 << bitOff)) == 0);
 
-    rowData[byteOff] |= (1 << bitOff);
+    nullBits[byteOff] |= (1 << bitOff);
 
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
       CheckRowToDelete(row);
   }
   else
   {
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
       CheckRowToReuse(row);
 
-    rowData[byteOff] &= ~(1 << bitOff);
+    nullBits[byteOff] &= ~(1 << bitOff);
 
-    Serializer::Store(rowData + desc.RowDataOff(), value);
+    Serializer::Store(RowValueForUpdate(cachedItem, desc), value);
   }
 
+  if (mZones.IsZoned(field))
+    UpdateRowZone(field, row, currentValue.IsNull(), cachedItem);
+
   //Update the field index if it exists
   if (mvIndexNodeMgrs[field] != nullptr)
   {
     NODE_INDEX dummyNode;
     KEY_INDEX dummyKey;
 
-    if (threadSafe)
-    {
-      AcquireFieldIndex( &desc);
-      syncHolder.unlock();
-    }
-
-    try
-    {
-      BTree fieldIndexTree( *mvIndexNodeMgrs[field]);
-
-      fieldIndexTree.RemoveKey(T_BTreeKey<T>(currentValue, row));
-      fieldIndexTree.InsertKey(T_BTreeKey<T>(value, row), &dummyNode, &dummyKey);
-    }
-    catch (...)
-    {
-      ReleaseIndexField( &desc);
-      throw;
-    }
+    /* The tree latches itself, but keep the row's latch until the index
+       is updated, so the updates of the same row reach it in order. */
+    BTree fieldIndexTree( *mvIndexNodeMgrs[field]);
 
-    if (threadSafe)
-    {
-      ReleaseIndexField( &desc);
-      syncHolder.lock();
-    }
+    fieldIndexTree.RemoveKey(T_BTreeKey<T>(currentValue, row));
+    fieldIndexTree.InsertKey(T_BTreeKey<T>(value, row), &dummyNode, &dummyKey);
   }
 }
 
@@ -1042,7 +1578,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
 
   assert(Serializer::Size(T_TEXT, false) == 2 * sizeof(uint64_t));
 
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
   MarkRowModification(threadSafe ? &syncHolder : nullptr);
 
   shared_ptr<ITextStrategy> s = value.GetStrategy();
@@ -1106,17 +1642,18 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
     AddRow(true);
 
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t* const rowData = cachedItem.GetDataForUpdate();
+  uint8_t* const nullBits = RowNullBitsForUpdate(cachedItem);
+  uint8_t* const fieldData = RowValueForUpdate(cachedItem, desc);
   const uint8_t bitsSet = ~0;
   bool fieldValueWasNull = false;
 
-  uint8_t* const fieldFirstEntry = rowData + desc.RowDataOff();
-  uint8_t* const fieldValueSize = rowData + desc.RowDataOff() + sizeof(uint64_t);
+  uint8_t* const fieldFirstEntry = fieldData;
+  uint8_t* const fieldValueSize = fieldData + sizeof(uint64_t);
 
   const uint_t byteOff = desc.NullBitIndex() / 8;
   const uint8_t bitOff = desc.NullBitIndex() % 8;
 
-  if ((rowData[byteOff] & (1 << bitOff)) != 0)
+  if ((nullBits[byteOff] & (1 << bitOff)) != 0)
     fieldValueWasNull = true;
 
   if (fieldValueWasNull && (s->mCachedCharsCount == 0))
@@ -1124,20 +1661,20 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
 
   else if ((fieldValueWasNull == false) && (s->mCachedCharsCount == 0))
   {
-    rowData[byteOff] |= (1 << bitOff);
+    nullBits[byteOff] |= (1 << bitOff);
 
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
       CheckRowToDelete(row);
   }
   else if (s->mCachedCharsCount != 0)
   {
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
     {
       assert(fieldValueWasNull == true);
 
       CheckRowToReuse(row);
     }
-    rowData[byteOff] &= ~(1 << bitOff);
+    nullBits[byteOff] &= ~(1 << bitOff);
   }
 
   if ((fieldValueWasNull == false)
@@ -1151,7 +1688,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
     assert(s->Utf8CountU() < _SC(uint_t, Serializer::Size(T_TEXT, false)));
 
     store_le_int64((s->Utf8CountU() | 0x80) << 56, fieldValueSize);
-    s->ReadUtf8U(0, s->Utf8CountU(), rowData + desc.RowDataOff());
+    s->ReadUtf8U(0, s->Utf8CountU(), fieldData);
   }
   else
   {
@@ -1169,7 +1706,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
 {
   const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  LockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
   MarkRowModification(threadSafe ? &syncHolder : nullptr);
 
   auto s = value.GetStrategy();
@@ -1233,15 +1770,16 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
     AddRow(true);
 
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t * const rowData = cachedItem.GetDataForUpdate();
+  uint8_t * const nullBits = RowNullBitsForUpdate(cachedItem);
+  uint8_t * const fieldData = RowValueForUpdate(cachedItem, desc);
 
-  uint8_t * const fieldFirstEntry = rowData + desc.RowDataOff();
-  uint8_t * const fieldValueSize = rowData + desc.RowDataOff() + sizeof(uint64_t);
+  uint8_t * const fieldFirstEntry = fieldData;
+  uint8_t * const fieldValueSize = fieldData + sizeof(uint64_t);
 
   const uint_t byteOff = desc.NullBitIndex() / 8;
   const uint8_t bitOff = desc.NullBitIndex() % 8;
 
-  if ((rowData[byteOff] & (1 << bitOff)) != 0)
+  if ((nullBits[byteOff] & (1 << bitOff)) != 0)
     fieldValueWasNull = true;
 
   if (fieldValueWasNull && (s->Count() == 0))
@@ -1249,20 +1787,20 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
 
   else if ((fieldValueWasNull == false) && (s->Count() == 0))
   {
-    rowData[byteOff] |= (1 << bitOff);
+    nullBits[byteOff] |= (1 << bitOff);
 
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
       CheckRowToDelete(row);
   }
   else if (s->Count() != 0)
   {
-    if (rowData[byteOff] == bitsSet)
+    if (nullBits[byteOff] == bitsSet)
     {
       assert(fieldValueWasNull == true);
 
       CheckRowToReuse(row);
     }
-    rowData[byteOff] &= ~(1 << bitOff);
+    nullBits[byteOff] &= ~(1 << bitOff);
   }
 
   if ((fieldValueWasNull == false)
@@ -1276,7 +1814,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
     assert(s->RawSize() < _SC(uint_t, Serializer::Size(T_HIRESTIME, true)));
 
     store_le_int64((s->RawSize() | 0x80) << 56, fieldValueSize);
-    s->RawRead(0, s->RawSize(), rowData + desc.RowDataOff());
+    s->RawRead(0, s->RawSize(), fieldData);
   }
   else
   {
@@ -1489,7 +2027,7 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
                               const bool        threadSafe,
                               T&                outValue)
 {
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
 
   const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
@@ -1499,23 +2037,13 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
     throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
   }
 
-  const uint_t byteOff = desc.NullBitIndex() / 8;
-  const uint8_t bitOff = desc.NullBitIndex() % 8;
-
   if (row >= mRowsCount)
     throw DBSException(_EXTRA(DBSException::ROW_NOT_ALLOCATED));
 
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  const uint8_t* const rowData = cachedItem.GetDataForRead();
-
-  if (rowData[byteOff] & (1 << bitOff))
-    outValue = T();
+  SharedLockGuard<RWLock> latch(cachedItem.Latch());
 
-  else
-  {
-    outValue.~T();
-    Serializer::Load(rowData + desc.RowDataOff(), &outValue);
-  }
+  load_row_value(desc, RowNullBits(cachedItem), RowValue(cachedItem, desc), outValue);
 }
 
 
@@ -1525,7 +2053,7 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
                               const bool        threadSafe,
                               DText&            outValue)
 {
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
 
   const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
@@ -1538,13 +2066,15 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
   }
 
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  const uint8_t* const rowData = cachedItem.GetDataForRead();
+  SharedLockGuard<RWLock> latch(cachedItem.Latch());
+  const uint8_t* const nullBits = RowNullBits(cachedItem);
+  const uint8_t* const fieldData = RowValue(cachedItem, desc);
 
-  const uint64_t fieldValueSize = load_le_int64(rowData + desc.RowDataOff() + sizeof(uint64_t));
+  const uint64_t fieldValueSize = load_le_int64(fieldData + sizeof(uint64_t));
   const uint_t byteOff = desc.NullBitIndex() / 8;
   const uint8_t bitOff = desc.NullBitIndex() % 8;
 
-  if (rowData[byteOff] & (1 << bitOff))
+  if (nullBits[byteOff] & (1 << bitOff))
     outValue = DText();
 
   else if ((fieldValueSize & 0x8000000000000000ull) != 0)
@@ -1552,11 +2082,11 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
     assert(((fieldValueSize >> 56) & 0x7F) > 0);
     assert(((fieldValueSize >> 56) & 0x7F) < Serializer::Size(T_TEXT, false));
 
-    outValue = DText(rowData + desc.RowDataOff(), (fieldValueSize >> 56) & 0x7F);
+    outValue = DText(fieldData, (fieldValueSize >> 56) & 0x7F);
   }
   else
   {
-    const uint64_t fieldFirstEntry = load_le_int64(rowData + desc.RowDataOff());
+    const uint64_t fieldFirstEntry = load_le_int64(fieldData);
     outValue = DText(allocate_row_field_text(VSStore(), fieldFirstEntry, fieldValueSize));
   }
 }
@@ -1568,7 +2098,7 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
                               const bool        threadSafe,
                               DArray&           outValue)
 {
-  LockGuard<Lock> syncHolder(mRowsSync, !threadSafe);
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync, !threadSafe);
 
   const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
@@ -1582,14 +2112,16 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
   }
 
   StoredItem cachedItem = mRowCache.RetriveItem(row);
-  const uint8_t * const rowData = cachedItem.GetDataForRead();
+  SharedLockGuard<RWLock> latch(cachedItem.Latch());
+  const uint8_t * const nullBits = RowNullBits(cachedItem);
+  const uint8_t * const fieldData = RowValue(cachedItem, desc);
 
-  const uint64_t fieldValueSize = load_le_int64(rowData + desc.RowDataOff() + sizeof(uint64_t));
+  const uint64_t fieldValueSize = load_le_int64(fieldData + sizeof(uint64_t));
 
   const uint_t byteOff = desc.NullBitIndex() / 8;
   const uint8_t bitOff = desc.NullBitIndex() % 8;
 
-  if (rowData[byteOff] & (1 << bitOff))
+  if (nullBits[byteOff] & (1 << bitOff))
   {
     switch (GET_BASE_TYPE(desc.Type()))
     {
@@ -1666,13 +2198,13 @@ PrototypeTable::RetrieveEntry(const ROW_INDEX   row,
     assert(((fieldValueSize >> 56) & 0x7F) < Serializer::Size(T_BOOL, true));
 
     const uint64_t size = (fieldValueSize >> 56) & 0x7F;
-    strategy->RawWrite(0, size, rowData + desc.RowDataOff());
+    strategy->RawWrite(0, size, fieldData);
     strategy->mElementsCount = size / strategy->mElementRawSize;
     outValue = DArray(strategy);
   }
   else
   {
-    const uint64_t fieldFirstEntry = load_le_int64(rowData + desc.RowDataOff());
+    const uint64_t fieldFirstEntry = load_le_int64(fieldData);
     outValue = DArray(allocate_row_field_array(VSStore(),
                                                fieldFirstEntry,
                                                _SC(DBS_FIELD_TYPE,
@@ -1874,7 +2406,7 @@ PrototypeTable::ExchangeRows(const ROW_INDEX    row1,
                              const ROW_INDEX    row2,
                              const bool         skipTthreadSafety)
 {
-  LockGuard<Lock> _l(mRowsSync, skipTthreadSafety);
+  LockGuard<MeteredRWLock> _l(mRowsSync, skipTthreadSafety);
 
   const ROW_INDEX allocatedRows = AllocatedRows();
   const FIELD_INDEX fieldsCount = FieldsCount();
@@ -1967,554 +2499,2159 @@ PrototypeTable::ExchangeRows(const ROW_INDEX    row1,
   }
 }
 
-template<typename TF> class
-SortTableContainer
-{
-public:
-  SortTableContainer(PrototypeTable& table, const FIELD_INDEX field)
-    : mTable(table),
-      mField(field)
-  {
-    mRowsPermutation.resize(table.AllocatedRows());
-    for (ROW_INDEX i = 0; i < mRowsPermutation.size(); ++i)
-      mRowsPermutation[i] = i;
-  }
+static const uint_t   TABLE_SORT_RUN_ROWS     = 1024 * 1024;
+static const uint_t   TABLE_SORT_RUN_CACHE    = 64 * 1024;
+static const uint_t   TABLE_SORT_LOAD_CHUNK   = 64 * 1024;
+static const uint64_t TABLE_SORT_ROWS_MEMORY  = 64 * 1024 * 1024;
+static const uint_t   SORT_KEY_MAX_SIZE       = 1 + 2 * sizeof(uint64_t);
+static const uint_t   SORT_ENTRY_MAX_SIZE     = SORT_KEY_MAX_SIZE + sizeof(ROW_INDEX);
 
-  ~SortTableContainer()
-  {
-    ROW_INDEX row = 0;
-    while (row < mRowsPermutation.size())
-    {
-      if (mRowsPermutation[row] == row)
-      {
-        ++row;
-        continue;
-      }
 
-      ROW_INDEX currentRow = row;
-      do
-      {
-        const ROW_INDEX correctRow = mRowsPermutation[currentRow];
-        if (correctRow == row)
-        {
-          mRowsPermutation[currentRow] = currentRow;
-          break;
-        }
+/* Order preserving encodings of the fields values, used to sort the rows
+   with a radix sort. The keys compare as strings of unsigned bytes, with
+   the null values first. All keys of a type have the same size. */
+static void
+store_sort_key_be(uint64_t value, const uint_t size, uint8_t* const key)
+{
+  for (uint_t i = size; i-- > 0; value >>= 8)
+    key[i] = value & 0xFF;
+}
 
-        mTable.ExchangeRows(currentRow, correctRow, true);
-        mRowsPermutation[currentRow] = currentRow;
 
-        currentRow = correctRow;
-      } while (true);
-    }
-  }
-  const TF operator[] (const int64_t index) const
-  {
-    TF value;
-    mTable.Get(mRowsPermutation[index], mField, value, true);
+template<class T> static uint_t
+encode_sort_key_unsigned(const T& value, uint8_t* const key)
+{
+  key[0] = value.IsNull() ? 0 : 1;
+  store_sort_key_be(value.IsNull() ? 0 : value.mValue, sizeof value.mValue, key + 1);
 
-    return value;
-  }
-  void Exchange(const int64_t pos1, const int64_t pos2)
-  {
-    const ROW_INDEX t      = mRowsPermutation[pos1];
-    mRowsPermutation[pos1] = mRowsPermutation[pos2];
-    mRowsPermutation[pos2] = t;
-  }
+  return 1 + sizeof value.mValue;
+}
 
-  uint64_t Count() const { return mRowsPermutation.size(); }
-  void Pivot(const uint64_t index) { mTable.Get(mRowsPermutation[index], mField, mPivot, true); }
-  const TF& Pivot() const { return mPivot; }
 
-private:
-  PrototypeTable&           mTable;
-  std::vector<ROW_INDEX>    mRowsPermutation;
-  const FIELD_INDEX         mField;
-  TF                        mPivot;
-};
+template<class T> static uint_t
+encode_sort_key_signed(const T& value, uint8_t* const key)
+{
+  const uint_t bits = 8 * sizeof value.mValue;
+  const uint64_t mask = (bits < 64) ? ((1ull << bits) - 1) : ~0ull;
 
+  key[0] = value.IsNull() ? 0 : 1;
+  store_sort_key_be(value.IsNull()
+                      ? 0
+                      : ((_SC(uint64_t, value.mValue) & mask) ^ (1ull << (bits - 1))),
+                    sizeof value.mValue,
+                    key + 1);
 
-void
-PrototypeTable::Sort(const FIELD_INDEX field,
-                        const ROW_INDEX fromRow,
-                        const ROW_INDEX toRow,
-                        const bool reverse)
+  return 1 + sizeof value.mValue;
+}
+
+
+template<class T> static uint_t
+encode_sort_key_real(const T& value, uint8_t* const key)
 {
-  const DBSFieldDescriptor fd = DescribeField(field);
+  const uint64_t signBit = 0x8000000000000000ull;
 
-  if (fd.isArray)
-  {
-    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
-                       "This implementation does not sort array fields.");
-  }
+  key[0] = value.IsNull() ? 0 : 1;
+  store_sort_key_be(value.IsNull() ? 0 : (_SC(uint64_t, value.mValue.Integer()) ^ signBit),
+                    sizeof(uint64_t),
+                    key + 1);
+  store_sort_key_be(value.IsNull() ? 0 : (_SC(uint64_t, value.mValue.Fractional()) ^ signBit),
+                    sizeof(uint64_t),
+                    key + 1 + sizeof(uint64_t));
 
-  LockGuard<Lock> _l(mRowsSync);
+  return 1 + 2 * sizeof(uint64_t);
+}
 
-  const ROW_INDEX from = MIN(fromRow, toRow);
-  const ROW_INDEX to = MIN(MAX(fromRow, toRow), AllocatedRows() - 1);
 
-  if (from > to)
-    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+static uint_t
+encode_sort_key(const DBool& value, uint8_t* const key)
+{
+  key[0] = value.IsNull() ? 0 : 1;
+  key[1] = (value.IsNull() || ! value.mValue) ? 0 : 1;
 
-  else
-    if (from == to)
-      return;
+  return 2;
+}
 
-  switch (fd.type)
-  {
-  case T_BOOL:
+
+static uint_t
+encode_sort_key(const DChar& value, uint8_t* const key)
+{
+  //Follow the alphabetical order used to compare the characters.
+  const uint32_t canonical = value.IsNull() ? 0 : wh_to_canonical(value.mValue);
+
+  key[0] = value.IsNull() ? 0 : 1;
+  store_sort_key_be(value.IsNull() ? 0 : wh_to_uppercase(canonical), 3, key + 1);
+  store_sort_key_be(canonical, 3, key + 4);
+  store_sort_key_be(value.IsNull() ? 0 : value.mValue, 3, key + 7);
+
+  return 10;
+}
+
+
+static uint_t
+encode_sort_key(const DDate& value, uint8_t* const key)
+{
+  memset(key, 0, 5);
+  if (value.IsNull())
+    return 5;
+
+  key[0] = 1;
+  store_sort_key_be(_SC(uint16_t, value.mYear) ^ 0x8000, 2, key + 1);
+  key[3] = value.mMonth;
+  key[4] = value.mDay;
+
+  return 5;
+}
+
+
+static uint_t
+encode_sort_key(const DDateTime& value, uint8_t* const key)
+{
+  memset(key, 0, 8);
+  if (value.IsNull())
+    return 8;
+
+  key[0] = 1;
+  store_sort_key_be(_SC(uint16_t, value.mYear) ^ 0x8000, 2, key + 1);
+  key[3] = value.mMonth;
+  key[4] = value.mDay;
+  key[5] = value.mHour;
+  key[6] = value.mMinutes;
+  key[7] = value.mSeconds;
+
+  return 8;
+}
+
+
+static uint_t
+encode_sort_key(const DHiresTime& value, uint8_t* const key)
+{
+  memset(key, 0, 12);
+  if (value.IsNull())
+    return 12;
+
+  key[0] = 1;
+  store_sort_key_be(_SC(uint16_t, value.mYear) ^ 0x8000, 2, key + 1);
+  key[3] = value.mMonth;
+  key[4] = value.mDay;
+  key[5] = value.mHour;
+  key[6] = value.mMinutes;
+  key[7] = value.mSeconds;
+  store_sort_key_be(value.mMicrosec, 4, key + 8);
+
+  return 12;
+}
+
+
+static uint_t
+encode_sort_key(const DUInt8& value, uint8_t* const key)
+{
+  return encode_sort_key_unsigned(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DUInt16& value, uint8_t* const key)
+{
+  return encode_sort_key_unsigned(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DUInt32& value, uint8_t* const key)
+{
+  return encode_sort_key_unsigned(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DUInt64& value, uint8_t* const key)
+{
+  return encode_sort_key_unsigned(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DInt8& value, uint8_t* const key)
+{
+  return encode_sort_key_signed(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DInt16& value, uint8_t* const key)
+{
+  return encode_sort_key_signed(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DInt32& value, uint8_t* const key)
+{
+  return encode_sort_key_signed(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DInt64& value, uint8_t* const key)
+{
+  return encode_sort_key_signed(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DReal& value, uint8_t* const key)
+{
+  return encode_sort_key_real(value, key);
+}
+
+
+static uint_t
+encode_sort_key(const DRichReal& value, uint8_t* const key)
+{
+  return encode_sort_key_real(value, key);
+}
+
+
+/* Hands back the rows in the order of their keys. A run of keys is sorted
+   with a radix sort, least significant byte first. The runs that do not fit
+   in memory are spilled to temporal containers and merged back at the end.
+   The rows with equal keys keep their order. */
+class RowsKeysSorter
+{
+public:
+  RowsKeysSorter(const uint_t keySize, const bool reverse)
+    : mKeySize(keySize),
+      mEntrySize(keySize + sizeof(ROW_INDEX)),
+      mReverse(reverse),
+      mCount(0),
+      mNextEntry(0)
   {
-    SortTableContainer<DBool> temp( *this, field);
-    quick_sort<DBool, decltype(temp)>(from, to, reverse, temp);
+    assert(keySize <= SORT_KEY_MAX_SIZE);
   }
-    break;
 
-  case T_CHAR:
+  void Add(const uint8_t* const key, const ROW_INDEX row)
   {
-    SortTableContainer<DChar> temp( *this, field);
-    quick_sort<DChar, decltype(temp)>(from, to, reverse, temp);
+    if (mCount >= TABLE_SORT_RUN_ROWS)
+      SpillRun();
+
+    mEntries.resize((mCount + 1) * mEntrySize);
+
+    uint8_t* const entry = mEntries.data() + mCount++ * mEntrySize;
+    for (uint_t i = 0; i < mKeySize; ++i)
+      entry[i] = mReverse ? ~key[i] : key[i];
+
+    store_sort_key_be(row, sizeof(ROW_INDEX), entry + mKeySize);
   }
-    break;
 
-  case T_DATE:
+  void Sort()
   {
-    SortTableContainer<DDate> temp( *this, field);
-    quick_sort<DDate, decltype(temp)>(from, to, reverse, temp);
+    if (mRuns.empty())
+    {
+      SortRun();
+      return;
+    }
+
+    if (mCount > 0)
+      SpillRun();
+
+    mEntries = vector<uint8_t>();
+    mScratch = vector<uint8_t>();
+
+    for (uint_t r = 0; r < mRuns.size(); ++r)
+      MergeNext(r);
   }
-    break;
 
-  case T_DATETIME:
+  ROW_INDEX operator() ()
   {
-    SortTableContainer<DDateTime> temp( *this, field);
-    quick_sort<DDateTime, decltype(temp)>(from, to, reverse, temp);
+    if (mRuns.empty())
+    {
+      assert(mNextEntry < mCount);
+
+      return load_entry_row(mEntries.data() + mNextEntry++ * mEntrySize);
+    }
+
+    assert( ! mMergeHeap.empty());
+
+    const MergeEntry top = mMergeHeap.top();
+    mMergeHeap.pop();
+
+    MergeNext(top.mRun);
+
+    return load_entry_row(top.mEntry);
   }
-    break;
 
-  case T_HIRESTIME:
+private:
+  struct Run
   {
-    SortTableContainer<DHiresTime> temp( *this, field);
-    quick_sort<DHiresTime, decltype(temp)>(from, to, reverse, temp);
-  }
-    break;
+    std::unique_ptr<TemporalContainer> mContainer;
+    uint64_t                           mPosition;
+  };
 
-  case T_UINT8:
+  struct MergeEntry
   {
-    SortTableContainer<DUInt8> temp( *this, field);
-    quick_sort<DUInt8, decltype(temp)>(from, to, reverse, temp);
-  }
-    break;
+    //The queue keeps the biggest entry on top, so reverse the order.
+    bool operator< (const MergeEntry& second) const
+    {
+      return memcmp(mEntry, second.mEntry, sizeof mEntry) > 0;
+    }
 
-  case T_UINT16:
+    uint8_t  mEntry[SORT_ENTRY_MAX_SIZE];
+    uint_t   mRun;
+  };
+
+  ROW_INDEX load_entry_row(const uint8_t* const entry) const
   {
-    SortTableContainer<DUInt16> temp( *this, field);
-    quick_sort<DUInt16, decltype(temp)>(from, to, reverse, temp);
+    ROW_INDEX row = 0;
+    for (uint_t i = 0; i < sizeof(ROW_INDEX); ++i)
+      row = (row << 8) | entry[mKeySize + i];
+
+    return row;
   }
-    break;
 
-  case T_UINT32:
+  void SortRun()
   {
-    SortTableContainer<DUInt32> temp( *this, field);
-    quick_sort<DUInt32, decltype(temp)>(from, to, reverse, temp);
+    mScratch.resize(mEntries.size());
+
+    uint8_t* from = mEntries.data();
+    uint8_t* to = mScratch.data();
+
+    for (uint_t b = mKeySize; b-- > 0; )
+    {
+      size_t offsets[256] = {0, };
+
+      for (size_t e = 0; e < mCount; ++e)
+        ++offsets[from[e * mEntrySize + b]];
+
+      //Nothing to do if all keys have the same byte here.
+      if (offsets[from[b]] == mCount)
+        continue;
+
+      for (size_t i = 0, total = 0; i < 256; ++i)
+      {
+        const size_t count = offsets[i];
+
+        offsets[i] = total;
+        total += count;
+      }
+
+      for (size_t e = 0; e < mCount; ++e)
+      {
+        const uint8_t* const entry = from + e * mEntrySize;
+        memcpy(to + offsets[entry[b]]++ * mEntrySize, entry, mEntrySize);
+      }
+
+      swap(from, to);
+    }
+
+    if (from != mEntries.data())
+      mEntries.swap(mScratch);
   }
-    break;
 
-  case T_UINT64:
+  void SpillRun()
   {
-    SortTableContainer<DUInt64> temp( *this, field);
-    quick_sort<DUInt64, decltype(temp)>(from, to, reverse, temp);
+    SortRun();
+
+    Run run;
+    run.mContainer.reset(new TemporalContainer(TABLE_SORT_RUN_CACHE));
+    run.mContainer->Write(0, mCount * mEntrySize, mEntries.data());
+    run.mPosition = 0;
+
+    mRuns.push_back(std::move(run));
+    mCount = 0;
   }
-    break;
 
-  case T_REAL:
+  void MergeNext(const uint_t runIndex)
   {
-    SortTableContainer<DReal> temp( *this, field);
-    quick_sort<DReal, decltype(temp)>(from, to, reverse, temp);
+    Run& run = mRuns[runIndex];
+
+    if (run.mPosition >= run.mContainer->Size())
+    {
+      run.mContainer.reset();
+      return;
+    }
+
+    MergeEntry entry;
+    memset(entry.mEntry, 0, sizeof entry.mEntry);
+    entry.mRun = runIndex;
+
+    run.mContainer->Read(run.mPosition, mEntrySize, entry.mEntry);
+    run.mPosition += mEntrySize;
+
+    mMergeHeap.push(entry);
   }
-    break;
 
-  case T_RICHREAL:
+  const uint_t                       mKeySize;
+  const uint_t                       mEntrySize;
+  const bool                         mReverse;
+  std::vector<uint8_t>               mEntries;
+  std::vector<uint8_t>               mScratch;
+  size_t                             mCount;
+  size_t                             mNextEntry;
+  std::vector<Run>                   mRuns;
+  std::priority_queue<MergeEntry>    mMergeHeap;
+};
+
+
+/* The text values have no fixed size keys. Every character is encoded as
+   a character key (without its null flag) and the keys, kept together in one
+   buffer, are compared with a merge sort. A shorter text sorts first, as does
+   a null character compared to any other. */
+class TextRowsSorter
+{
+public:
+  explicit TextRowsSorter(const bool reverse)
+    : mReverse(reverse),
+      mNextKey(0)
   {
-    SortTableContainer<DRichReal> temp( *this, field);
-    quick_sort<DRichReal, decltype(temp)>(from, to, reverse, temp);
   }
-    break;
 
-  case T_INT8:
+  void Add(const DText& value, const ROW_INDEX row)
   {
-    SortTableContainer<DInt8> temp( *this, field);
-    quick_sort<DInt8, decltype(temp)>(from, to, reverse, temp);
+    const uint64_t rawSize = value.RawSize();
+
+    mRawText.resize(rawSize);
+    if (rawSize > 0)
+      value.RawRead(0, rawSize, mRawText.data());
+
+    const size_t offset = mKeysData.size();
+    uint8_t charKey[SORT_KEY_MAX_SIZE];
+
+    for (uint64_t i = 0; i < rawSize; )
+    {
+      uint32_t codePoint = 0;
+      const uint_t units = wh_load_utf8_cp(mRawText.data() + i, &codePoint);
+
+      if (units == 0)
+        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+
+      const uint_t keySize = encode_sort_key(DChar(codePoint), charKey);
+      mKeysData.insert(mKeysData.end(), charKey + 1, charKey + keySize);
+
+      i += units;
+    }
+
+    mKeys.push_back(Key{offset, mKeysData.size() - offset, row});
   }
-    break;
 
-  case T_INT16:
+  void Sort()
   {
-    SortTableContainer<DInt16> temp( *this, field);
-    quick_sort<DInt16, decltype(temp)>(from, to, reverse, temp);
+    const uint8_t* const data = mKeysData.data();
+    const bool reverse = mReverse;
+
+    mRawText = vector<uint8_t>();
+    stable_sort(mKeys.begin(),
+                mKeys.end(),
+                [data, reverse] (const Key& first, const Key& second)
+                {
+                  return reverse
+                           ? compare_keys(data, second, first) < 0
+                           : compare_keys(data, first, second) < 0;
+                });
   }
-    break;
 
-  case T_INT32:
+  ROW_INDEX operator() ()
   {
-    SortTableContainer<DInt32> temp( *this, field);
-    quick_sort<DInt32, decltype(temp)>(from, to, reverse, temp);
+    assert(mNextKey < mKeys.size());
+
+    return mKeys[mNextKey++].mRow;
   }
-    break;
 
-  case T_INT64:
+private:
+  struct Key
   {
-    SortTableContainer<DInt64> temp( *this, field);
-    quick_sort<DInt64, decltype(temp)>(from, to, reverse, temp);
-  }
-    break;
-  case T_TEXT:
+    size_t      mOffset;
+    size_t      mSize;
+    ROW_INDEX   mRow;
+  };
+
+  static int compare_keys(const uint8_t* const data, const Key& first, const Key& second)
   {
-    SortTableContainer<DText> temp( *this, field);
-    quick_sort<DText, decltype(temp)>(from, to, reverse, temp);
-  }
-    break;
+    const int result = memcmp(data + first.mOffset,
+                              data + second.mOffset,
+                              MIN(first.mSize, second.mSize));
+    if (result != 0)
+      return result;
 
-  default:
-    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+    return (first.mSize < second.mSize) ? -1 : (first.mSize > second.mSize);
   }
-}
 
+  const bool              mReverse;
+  std::vector<uint8_t>    mKeysData;
+  std::vector<uint8_t>    mRawText;
+  std::vector<Key>        mKeys;
+  size_t                  mNextKey;
+};
 
-DArray
-PrototypeTable::MatchRows(const DBool&       min,
-                          const DBool&       max,
-                          const ROW_INDEX    fromRow,
-                          const ROW_INDEX    toRow,
-                          const FIELD_INDEX  field)
+
+/* A copy of the rows being sorted, so they could be written back in their
+   new order. It is kept in memory if it fits, otherwise in a temporal file. */
+class SortedRowsCopy
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+public:
+  SortedRowsCopy(const uint_t rowSize, const ROW_INDEX rowsCount)
+    : mRowSize(rowSize),
+      mRowsCount(rowsCount)
+  {
+    const uint64_t size = _SC(uint64_t, rowSize) * rowsCount;
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
-}
+    if (size <= TABLE_SORT_ROWS_MEMORY)
+      mRows.reset(new uint8_t[size]);
 
+    else
+    {
+      const DBSSettings& settings = DBSGetSeettings();
+      const uint64_t id = wh_atomic_fetch_inc64(_RC(int64_t*, &smSpillsCount));
+      const string baseName = settings.mTempDir + "wsort" + to_string(id) + ".tmp";
 
-DArray
-PrototypeTable::MatchRows(const DChar&         min,
-                           const DChar&         max,
-                           const ROW_INDEX      fromRow,
-                           const ROW_INDEX      toRow,
-                           const FIELD_INDEX    field)
-{
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+      mSpilled.reset(new TemporalFileContainer(baseName.c_str(), settings.mMaxFileSize));
+    }
+  }
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
-}
+  /* Copy the rows in one sequential pass, calling the visitor with the
+     content of every one of them. The rows are taken from the cache, as
+     the temporal tables do not flush it to their container. */
+  template<class VISITOR> void
+  Load(PrototypeTable& table, const ROW_INDEX from, VISITOR visitor)
+  {
+    const ROW_INDEX chunkRows = MAX(1u, TABLE_SORT_LOAD_CHUNK / mRowSize);
 
+    unique_ptr<uint8_t[]> chunk;
+    if ( ! mRows)
+      chunk.reset(new uint8_t[_SC(uint64_t, chunkRows) * mRowSize]);
 
-DArray
-PrototypeTable::MatchRows(const DDate&         min,
-                          const DDate&         max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+    for (ROW_INDEX row = 0; row < mRowsCount; )
+    {
+      const ROW_INDEX count = MIN(chunkRows, mRowsCount - row);
+      const uint64_t offset = _SC(uint64_t, row) * mRowSize;
+      uint8_t* const data = mRows ? mRows.get() + offset : chunk.get();
+
+      for (ROW_INDEX r = 0; r < count; ++r)
+      {
+        StoredItem cachedItem = table.mRowCache.RetriveItem(from + row + r);
+        uint8_t* const rowData = data + r * mRowSize;
+
+        table.LoadRow(cachedItem, rowData);
+        visitor(from + row + r, rowData);
+      }
+
+      if (mSpilled)
+        mSpilled->Write(offset, count * mRowSize, data);
+
+      row += count;
+    }
+  }
+
+  void Read(const ROW_INDEX row, uint8_t* const to)
+  {
+    assert(row < mRowsCount);
+
+    if (mRows)
+      memcpy(to, mRows.get() + _SC(uint64_t, row) * mRowSize, mRowSize);
+
+    else
+      mSpilled->Read(_SC(uint64_t, row) * mRowSize, mRowSize, to);
+  }
+
+private:
+  const uint_t                              mRowSize;
+  const ROW_INDEX                           mRowsCount;
+  std::unique_ptr<uint8_t[]>                mRows;
+  std::unique_ptr<TemporalFileContainer>    mSpilled;
+
+  static uint64_t smSpillsCount;
+};
+
+uint64_t SortedRowsCopy::smSpillsCount = 1;
+
+
+template<class T> static void
+reindex_row_value(FieldIndexNodeManager&   nodeMgr,
+                  const FieldDescriptor&   desc,
+                  const ROW_INDEX          row,
+                  const uint8_t* const     oldRowData,
+                  const uint8_t* const     newRowData)
+{
+  T oldValue, newValue;
+
+  load_row_value(desc, oldRowData, oldValue);
+  load_row_value(desc, newRowData, newValue);
+
+  if (oldValue == newValue)
+    return;
+
+  NODE_INDEX dummyNode;
+  KEY_INDEX dummyKey;
+  BTree fieldIndexTree(nodeMgr);
+
+  fieldIndexTree.RemoveKey(T_BTreeKey<T>(oldValue, row));
+  fieldIndexTree.InsertKey(T_BTreeKey<T>(newValue, row), &dummyNode, &dummyKey);
+}
+
+
+bool
+PrototypeTable::IsNullRowData(const uint8_t* const nullBits) const
+{
+  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
+  {
+    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
+    const uint8_t bitsSet = ~0;
+
+    if (nullBits[fieldDesc.NullBitIndex() / 8] != bitsSet)
+      return false;
+  }
+
+  return true;
+}
+
+
+const uint8_t*
+PrototypeTable::RowNullBits(const StoredItem& cachedItem) const
+{
+  return cachedItem.GetBlockForRead() + mLayout.NullBitsOffset(cachedItem.ItemOffset());
+}
+
+
+const uint8_t*
+PrototypeTable::RowValue(const StoredItem& cachedItem, const FieldDescriptor& desc) const
+{
+  return cachedItem.GetBlockForRead() + mLayout.ValueOffset(cachedItem.ItemOffset(), desc);
+}
+
+
+uint8_t*
+PrototypeTable::RowNullBitsForUpdate(const StoredItem& cachedItem) const
+{
+  return cachedItem.GetBlockForUpdate() + mLayout.NullBitsOffset(cachedItem.ItemOffset());
+}
+
+
+uint8_t*
+PrototypeTable::RowValueForUpdate(const StoredItem& cachedItem, const FieldDescriptor& desc) const
+{
+  return cachedItem.GetBlockForUpdate() + mLayout.ValueOffset(cachedItem.ItemOffset(), desc);
+}
+
+
+void
+PrototypeTable::LoadRow(const StoredItem& cachedItem, uint8_t* const to) const
+{
+  mLayout.LoadRow(cachedItem.GetBlockForRead(),
+                  cachedItem.ItemOffset(),
+                  _RC(const FieldDescriptor*, mFieldsDescriptors.get()),
+                  to);
+}
+
+
+void
+PrototypeTable::StoreRow(const StoredItem& cachedItem, const uint8_t* const from) const
+{
+  mLayout.StoreRow(cachedItem.GetBlockForUpdate(),
+                   cachedItem.ItemOffset(),
+                   _RC(const FieldDescriptor*, mFieldsDescriptors.get()),
+                   from);
+}
+
+
+uint64_t
+PrototypeTable::StoredRowsCount() const
+{
+  if ( ! mLayout.IsPax())
+    return mRowsCount;
+
+  //The rows file keeps the last block whole.
+  const uint64_t blockRows = mLayout.BlockRows();
+  return ((mRowsCount + blockRows - 1) / blockRows) * blockRows;
+}
+
+
+/* Update the reusable rows and the fields indexes of a row, about to have
+   its content replaced. */
+void
+PrototypeTable::ReindexRow(const ROW_INDEX        row,
+                           const uint8_t* const   oldRowData,
+                           const uint8_t* const   newRowData)
+{
+  const bool wasNull = IsNullRowData(oldRowData);
+  const bool isNull = IsNullRowData(newRowData);
+
+  if (wasNull != isNull)
+  {
+    LockGuard<Lock> _l(mUpdatesSync);
+    BTree removedNodes( *this);
+    TableRmKey key(row);
+
+    if (isNull)
+    {
+      NODE_INDEX dummyNode;
+      KEY_INDEX dummyKey;
+
+      removedNodes.InsertKey(key, &dummyNode, &dummyKey);
+    }
+    else
+      removedNodes.RemoveKey(key);
+  }
+
+  for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+    if (mvHashIndexes[field] != nullptr)
+    {
+      const uint_t valueSize = field_value_size(desc);
+      const uint8_t* const oldValue = oldRowData + desc.RowDataOff();
+      const uint8_t* const newValue = newRowData + desc.RowDataOff();
+      const bool wasNullValue = is_null_row_value(desc, oldRowData);
+      const bool isNullValue = is_null_row_value(desc, newRowData);
+
+      if ((wasNullValue == isNullValue)
+          && (isNullValue || (memcmp(oldValue, newValue, valueSize) == 0)))
+      {
+        continue;
+      }
+
+      if ( ! wasNullValue)
+        mvHashIndexes[field]->Remove(hash_row_value(desc, oldValue), row);
+
+      if ( ! isNullValue)
+        mvHashIndexes[field]->Insert(hash_row_value(desc, newValue), row);
+
+      continue;
+    }
+
+    if (mvIndexNodeMgrs[field] == nullptr)
+      continue;
+
+    FieldIndexNodeManager& nodeMgr = *mvIndexNodeMgrs[field];
+
+    switch (GET_BASE_TYPE(desc.Type()))
+    {
+    case T_BOOL:
+      reindex_row_value<DBool>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_CHAR:
+      reindex_row_value<DChar>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_DATE:
+      reindex_row_value<DDate>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_DATETIME:
+      reindex_row_value<DDateTime>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_HIRESTIME:
+      reindex_row_value<DHiresTime>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_UINT8:
+      reindex_row_value<DUInt8>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_UINT16:
+      reindex_row_value<DUInt16>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_UINT32:
+      reindex_row_value<DUInt32>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_UINT64:
+      reindex_row_value<DUInt64>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_INT8:
+      reindex_row_value<DInt8>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_INT16:
+      reindex_row_value<DInt16>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_INT32:
+      reindex_row_value<DInt32>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_INT64:
+      reindex_row_value<DInt64>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_REAL:
+      reindex_row_value<DReal>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    case T_RICHREAL:
+      reindex_row_value<DRichReal>(nodeMgr, desc, row, oldRowData, newRowData);
+      break;
+
+    default:
+      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+    }
+  }
+}
+
+
+/* Write the rows back in one sequential pass, taking them in the order
+   handed by the sorter. Moving the rows content keeps the references of
+   their text and array values, so those need no update. */
+template<class SORTER> void
+PrototypeTable::RewriteSortedRows(SortedRowsCopy&   rows,
+                                  const ROW_INDEX   from,
+                                  const ROW_INDEX   to,
+                                  SORTER&           sorter)
+{
+  unique_ptr<uint8_t[]> oldRowData(new uint8_t[mRowSize]);
+  unique_ptr<uint8_t[]> newRowData(new uint8_t[mRowSize]);
+
+  for (ROW_INDEX row = from; row <= to; ++row)
+  {
+    const ROW_INDEX source = sorter();
+
+    assert((from <= source) && (source <= to));
+
+    if (source == row)
+      continue;
+
+    rows.Read(source - from, newRowData.get());
+
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    LoadRow(cachedItem, oldRowData.get());
+
+    if (memcmp(oldRowData.get(), newRowData.get(), mRowSize) == 0)
+      continue;
+
+    ReindexRow(row, oldRowData.get(), newRowData.get());
+    StoreRow(cachedItem, newRowData.get());
+    ReplaceRowZones(row, oldRowData.get(), newRowData.get());
+  }
+}
+
+
+template<class T> void
+PrototypeTable::SortRowsByKeys(const FIELD_INDEX   field,
+                               const ROW_INDEX     from,
+                               const ROW_INDEX     to,
+                               const bool          reverse)
+{
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  uint8_t key[SORT_KEY_MAX_SIZE];
+  RowsKeysSorter sorter(encode_sort_key(T(), key), reverse);
+  SortedRowsCopy rows(mRowSize, to - from + 1);
+
+  rows.Load(*this,
+            from,
+            [&desc, &key, &sorter] (const ROW_INDEX row, const uint8_t* const rowData)
+            {
+              T value;
+              load_row_value(desc, rowData, value);
+
+              encode_sort_key(value, key);
+              sorter.Add(key, row);
+            });
+
+  sorter.Sort();
+  RewriteSortedRows(rows, from, to, sorter);
+}
+
+
+void
+PrototypeTable::SortRowsByText(const FIELD_INDEX   field,
+                               const ROW_INDEX     from,
+                               const ROW_INDEX     to,
+                               const bool          reverse)
+{
+  TextRowsSorter sorter(reverse);
+  SortedRowsCopy rows(mRowSize, to - from + 1);
+
+  rows.Load(*this,
+            from,
+            [this, field, &sorter] (const ROW_INDEX row, const uint8_t* const)
+            {
+              DText value;
+              Get(row, field, value, true);
+
+              sorter.Add(value, row);
+            });
+
+  sorter.Sort();
+  RewriteSortedRows(rows, from, to, sorter);
+}
+
+
+/* The rows are sorted by keys taken with one pass over them, then are
+   written back in their new order with another one. */
+void
+PrototypeTable::Sort(const FIELD_INDEX field,
+                        const ROW_INDEX fromRow,
+                        const ROW_INDEX toRow,
+                        const bool reverse)
+{
+  const DBSFieldDescriptor fd = DescribeField(field);
+
+  if (fd.isArray)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                       "This implementation does not sort array fields.");
+  }
+
+  LockGuard<MeteredRWLock> _l(mRowsSync);
+
+  const ROW_INDEX from = MIN(fromRow, toRow);
+  const ROW_INDEX to = MIN(MAX(fromRow, toRow), AllocatedRows() - 1);
+
+  if (from > to)
+    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+
+  else
+    if (from == to)
+      return;
+
+  MarkRowModification( &_l);
+
+  switch (fd.type)
+  {
+  case T_BOOL:
+    SortRowsByKeys<DBool>(field, from, to, reverse);
+    break;
+
+  case T_CHAR:
+    SortRowsByKeys<DChar>(field, from, to, reverse);
+    break;
+
+  case T_DATE:
+    SortRowsByKeys<DDate>(field, from, to, reverse);
+    break;
+
+  case T_DATETIME:
+    SortRowsByKeys<DDateTime>(field, from, to, reverse);
+    break;
+
+  case T_HIRESTIME:
+    SortRowsByKeys<DHiresTime>(field, from, to, reverse);
+    break;
+
+  case T_UINT8:
+    SortRowsByKeys<DUInt8>(field, from, to, reverse);
+    break;
+
+  case T_UINT16:
+    SortRowsByKeys<DUInt16>(field, from, to, reverse);
+    break;
+
+  case T_UINT32:
+    SortRowsByKeys<DUInt32>(field, from, to, reverse);
+    break;
+
+  case T_UINT64:
+    SortRowsByKeys<DUInt64>(field, from, to, reverse);
+    break;
+
+  case T_REAL:
+    SortRowsByKeys<DReal>(field, from, to, reverse);
+    break;
+
+  case T_RICHREAL:
+    SortRowsByKeys<DRichReal>(field, from, to, reverse);
+    break;
+
+  case T_INT8:
+    SortRowsByKeys<DInt8>(field, from, to, reverse);
+    break;
+
+  case T_INT16:
+    SortRowsByKeys<DInt16>(field, from, to, reverse);
+    break;
+
+  case T_INT32:
+    SortRowsByKeys<DInt32>(field, from, to, reverse);
+    break;
+
+  case T_INT64:
+    SortRowsByKeys<DInt64>(field, from, to, reverse);
+    break;
+
+  case T_TEXT:
+    SortRowsByText(field, from, to, reverse);
+    break;
+
+  default:
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  }
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DBool&       min,
+                          const DBool&       max,
+                          const ROW_INDEX    fromRow,
+                          const ROW_INDEX    toRow,
+                          const FIELD_INDEX  field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DChar&         min,
+                           const DChar&         max,
+                           const ROW_INDEX      fromRow,
+                           const ROW_INDEX      toRow,
+                           const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DDate&         min,
+                          const DDate&         max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DDateTime&     min,
+                          const DDateTime&     max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DHiresTime&     min,
+                          const DHiresTime&     max,
+                          const ROW_INDEX       fromRow,
+                          const ROW_INDEX       toRow,
+                          const FIELD_INDEX     field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DUInt8&        min,
+                          const DUInt8&        max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DUInt16&       min,
+                          const DUInt16&       max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DUInt32&       min,
+                          const DUInt32&       max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DUInt64&       min,
+                          const DUInt64&       max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DInt8&         min,
+                          const DInt8&         max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DInt16&        min,
+                          const DInt16&        max,
+                          const ROW_INDEX      fromRow,
+                          const ROW_INDEX      toRow,
+                          const FIELD_INDEX    field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DInt32&       min,
+                          const DInt32&       max,
+                          const ROW_INDEX     fromRow,
+                          const ROW_INDEX     toRow,
+                          const FIELD_INDEX   field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DInt64&       min,
+                          const DInt64&       max,
+                          const ROW_INDEX     fromRow,
+                          const ROW_INDEX     toRow,
+                          const FIELD_INDEX   field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DReal&        min,
+                          const DReal&        max,
+                          const ROW_INDEX     fromRow,
+                          const ROW_INDEX     toRow,
+                          const FIELD_INDEX   field)
+{
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchRows(const DRichReal&    min,
+                          const DRichReal&    max,
+                          const ROW_INDEX     fromRow,
+                          const ROW_INDEX     toRow,
+                          const FIELD_INDEX   field)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  DArray result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  return result;
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DDateTime&     min,
-                          const DDateTime&     max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+RowsSet
+PrototypeTable::MatchRowsSet(const DBool& min,
+                             const DBool& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  RowsSet result;
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DHiresTime&     min,
-                          const DHiresTime&     max,
-                          const ROW_INDEX       fromRow,
-                          const ROW_INDEX       toRow,
-                          const FIELD_INDEX     field)
+RowsSet
+PrototypeTable::MatchRowsSet(const DChar& min,
+                             const DChar& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  return result;
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DUInt8&        min,
-                          const DUInt8&        max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+RowsSet
+PrototypeTable::MatchRowsSet(const DDate& min,
+                             const DDate& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DDateTime& min,
+                             const DDateTime& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DHiresTime& min,
+                             const DHiresTime& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DUInt8& min,
+                             const DUInt8& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DUInt16& min,
+                             const DUInt16& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DUInt32& min,
+                             const DUInt32& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DUInt64& min,
+                             const DUInt64& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DInt8& min,
+                             const DInt8& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DInt16& min,
+                             const DInt16& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DInt32& min,
+                             const DInt32& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DInt64& min,
+                             const DInt64& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DReal& min,
+                             const DReal& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+RowsSet
+PrototypeTable::MatchRowsSet(const DRichReal& min,
+                             const DRichReal& max,
+                             const ROW_INDEX fromRow,
+                             const ROW_INDEX toRow,
+                             const FIELD_INDEX field)
+{
+  RowsSet result;
+
+  MatchRowsWithIndex(min, max, fromRow, toRow, field, result);
+
+  return result;
+}
+
+
+static inline void
+add_matched_row(DArray& result, const ROW_INDEX row)
+{
+  result.Add(DROW_INDEX(row));
+}
+
+
+static inline void
+add_matched_row(RowsSet& result, const ROW_INDEX row)
+{
+  result.Add(row);
+}
+
+
+template <class T, class OUTPUT> void
+PrototypeTable::MatchRowsWithIndex(const T&          min,
+                                   const T&          max,
+                                   const ROW_INDEX   fromRow,
+                                   ROW_INDEX         toRow,
+                                   const FIELD_INDEX field,
+                                   OUTPUT&           result)
+{
+  //Keeps the index from being removed while is used.
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync);
+
+  if (mRowsCount == 0)
+    return;
+
+  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  if ((desc.Type() & PS_TABLE_ARRAY_MASK)
+      || ((desc.Type() & PS_TABLE_FIELD_TYPE_MASK) != _SC(uint_t, min.DBSType())))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+  }
+
+  FieldIndexNodeManager* const nodeMgr = mvIndexNodeMgrs[field];
+  if (nodeMgr == nullptr)
+  {
+    //A hash index helps only the lookups of a single value.
+    FieldHashIndex* const hashIndex = mvHashIndexes[field];
+    if ((hashIndex != nullptr) && ! min.IsNull() && (min == max))
+    {
+      MatchRowsWithHash( *hashIndex, desc, min, fromRow, toRow, result);
+      return;
+    }
+
+    syncHolder.unlock();
+    MatchRowsNoIndex(min, max, fromRow, toRow, field, result);
+    return;
+  }
+
+  toRow = MIN(toRow, mRowsCount - 1);
+
+  NODE_INDEX nodeId;
+  KEY_INDEX fromKey;
+  const T_BTreeKey<T> firstKey(min, fromRow);
+  const T_BTreeKey<T> lastKey(max, toRow);
+
+  /* Keep the tree's shape for the whole scan. Other sessions could still
+     update the leaves, so each one is latched while its keys are read. */
+  SharedLockGuard<RWLock> treeHolder(nodeMgr->TreeLatch());
+  BTree fieldIndexTree( *nodeMgr);
+
+  if ( !fieldIndexTree.FindBiggerOrEqual(firstKey, &nodeId, &fromKey, false))
+    return;
+
+  auto currentNode = nodeMgr->RetrieveNode(nodeId);
+  currentNode->Latch().lock_shared();
+
+  try
+  {
+    //The leaf might have been updated since the key was found.
+    if ( ! currentNode->FindBiggerOrEqual(firstKey, &fromKey)
+        || ((fromKey == 0)
+            && (currentNode->CompareKey(currentNode->SentinelKey(), 0) == 0)))
+    {
+      currentNode->Latch().unlock_shared();
+      return;
+    }
+
+    assert(fromKey < currentNode->KeysCount());
+    while (true)
+    {
+      IBTreeFieldIndexNode* node = _SC(IBTreeFieldIndexNode*, &*currentNode);
+      KEY_INDEX toKey = ~0;
+
+      bool lastNode = false;
+
+      if (node->FindBiggerOrEqual(lastKey, &toKey))
+      {
+        lastNode = true;
+
+        if (node->CompareKey(lastKey, toKey) < 0)
+          toKey++;
+      }
+      else
+        toKey = 0;
+
+      if (fromKey >= toKey)
+        node->GetRows(fromKey, toKey, fromRow, toRow, result);
+
+      if (lastNode || (node->Next() == NIL_NODE))
+        break;
+
+      else
+      {
+        auto nextNode = nodeMgr->RetrieveNode(node->Next());
+
+        nextNode->Latch().lock_shared();
+        currentNode->Latch().unlock_shared();
+        currentNode = nextNode;
+
+        assert(currentNode->KeysCount() > 0);
+
+        fromKey = currentNode->KeysCount() - 1;
+      }
+    }
+  }
+  catch (...)
+  {
+    currentNode->Latch().unlock_shared();
+
+    throw;
+  }
+
+  currentNode->Latch().unlock_shared();
+}
+
+
+/* Scan keys map the values of a fixed size field on unsigned integers that
+   keep their order. A range scan decodes them straight from the rows data
+   and checks a whole batch of them with plain integer compares. */
+static const uint64_t SCAN_KEY_SIGN = 0x8000000000000000ull;
+
+static inline uint64_t
+signed_scan_key(const int64_t value)
+{
+  return _SC(uint64_t, value) ^ SCAN_KEY_SIGN;
+}
+
+static inline uint64_t
+date_scan_key(const int16_t year, const uint8_t month, const uint8_t day)
+{
+  return (_SC(uint64_t, _SC(uint16_t, year) ^ 0x8000) << 16) | (month << 8) | day;
+}
+
+static inline uint64_t
+datetime_scan_key(const int16_t year,
+                  const uint8_t month,
+                  const uint8_t day,
+                  const uint8_t hour,
+                  const uint8_t mins,
+                  const uint8_t secs)
+{
+  return (date_scan_key(year, month, day) << 24) | (hour << 16) | (mins << 8) | secs;
+}
+
+//Stored reals keep 40 bits of their integer parts and 6 decimals.
+static const int64_t REAL_SCAN_INT_LIMIT = _SC(int64_t, 1) << 39;
+
+static inline uint64_t
+real_scan_key(const int64_t integer, const int64_t fractional)
+{
+  //The bounds of a range may lay outside of what a field stores.
+  if (integer >= REAL_SCAN_INT_LIMIT)
+    return ~_SC(uint64_t, 0);
+
+  else if (integer < -REAL_SCAN_INT_LIMIT)
+    return 0;
+
+  return signed_scan_key(integer * DBS_REAL_PREC + fractional);
+}
+
+static inline uint64_t
+char_scan_key(const uint32_t codePoint)
+{
+  //Follow the alphabetical order used to compare the characters.
+  const uint64_t canonical = wh_to_canonical(codePoint);
+
+  return (_SC(uint64_t, wh_to_uppercase(canonical)) << 42) | (canonical << 21) | codePoint;
+}
+
+static inline uint64_t scan_key(const DBool& v) { return v.mValue ? 1 : 0; }
+static inline uint64_t scan_key(const DChar& v) { return char_scan_key(v.mValue); }
+static inline uint64_t scan_key(const DInt8& v) { return signed_scan_key(v.mValue); }
+static inline uint64_t scan_key(const DInt16& v) { return signed_scan_key(v.mValue); }
+static inline uint64_t scan_key(const DInt32& v) { return signed_scan_key(v.mValue); }
+static inline uint64_t scan_key(const DInt64& v) { return signed_scan_key(v.mValue); }
+static inline uint64_t scan_key(const DUInt8& v) { return v.mValue; }
+static inline uint64_t scan_key(const DUInt16& v) { return v.mValue; }
+static inline uint64_t scan_key(const DUInt32& v) { return v.mValue; }
+static inline uint64_t scan_key(const DUInt64& v) { return v.mValue; }
+
+static inline uint64_t
+scan_key(const DDate& v)
+{
+  return date_scan_key(v.mYear, v.mMonth, v.mDay);
+}
+
+static inline uint64_t
+scan_key(const DDateTime& v)
+{
+  return datetime_scan_key(v.mYear, v.mMonth, v.mDay, v.mHour, v.mMinutes, v.mSeconds);
+}
+
+static inline uint64_t
+scan_key(const DReal& v)
+{
+  return real_scan_key(v.mValue.Integer(), v.mValue.Fractional());
+}
+
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DBool*)
+{
+  return src[0] != 0 ? 1 : 0;
+}
+
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DChar*)
+{
+  return char_scan_key(load_le_int32(src));
+}
+
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DInt8*)
+{
+  return signed_scan_key(_SC(int8_t, src[0]));
+}
+
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DInt16*)
+{
+  return signed_scan_key(_SC(int16_t, load_le_int16(src)));
+}
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DInt32*)
+{
+  return signed_scan_key(_SC(int32_t, load_le_int32(src)));
 }
 
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DInt64*)
+{
+  return signed_scan_key(_SC(int64_t, load_le_int64(src)));
+}
 
-DArray
-PrototypeTable::MatchRows(const DUInt16&       min,
-                          const DUInt16&       max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DUInt8*)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  return src[0];
+}
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DUInt16*)
+{
+  return load_le_int16(src);
 }
 
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DUInt32*)
+{
+  return load_le_int32(src);
+}
 
-DArray
-PrototypeTable::MatchRows(const DUInt32&       min,
-                          const DUInt32&       max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DUInt64*)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  return load_le_int64(src);
+}
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DDate*)
+{
+  return date_scan_key(load_le_int16(src), src[2], src[3]);
 }
 
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DDateTime*)
+{
+  return datetime_scan_key(load_le_int16(src), src[2], src[3], src[4], src[5], src[6]);
+}
 
-DArray
-PrototypeTable::MatchRows(const DUInt64&       min,
-                          const DUInt64&       max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+static inline uint64_t
+load_scan_key(const uint8_t* const src, const DReal*)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  //Same layout as Serializer::Load(), 5 bytes integer and 3 bytes fraction.
+  int64_t integer = _SC(int64_t, load_le_int32(src)) | (_SC(int64_t, src[4]) << 32);
+  int64_t fractional = src[5] | (src[6] << 8) | (src[7] << 16);
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  if (integer & 0x8000000000)
+    integer |= ~_SC(int64_t, 0xFFFFFFFFFF);
+
+  if (fractional & 0x800000)
+    fractional |= ~_SC(int64_t, 0xFFFFFF);
+
+  return signed_scan_key(integer * DBS_REAL_PREC + fractional);
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DInt8&         min,
-                          const DInt8&         max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
+/* Decode the scan key of a field's value, unless the value is null. */
+static bool
+load_field_scan_key(const FieldDescriptor&   desc,
+                    const uint8_t* const     nullBits,
+                    const uint8_t* const     fieldData,
+                    uint64_t* const          outKey)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  if (nullBits[desc.NullBitIndex() / 8] & (1 << (desc.NullBitIndex() % 8)))
+    return false;
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
-}
+  switch (GET_BASE_TYPE(desc.Type()))
+  {
+  case T_BOOL:
+    *outKey = load_scan_key(fieldData, _SC(const DBool*, nullptr));
+    break;
 
+  case T_CHAR:
+    *outKey = load_scan_key(fieldData, _SC(const DChar*, nullptr));
+    break;
 
-DArray
-PrototypeTable::MatchRows(const DInt16&        min,
-                          const DInt16&        max,
-                          const ROW_INDEX      fromRow,
-                          const ROW_INDEX      toRow,
-                          const FIELD_INDEX    field)
-{
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  case T_DATE:
+    *outKey = load_scan_key(fieldData, _SC(const DDate*, nullptr));
+    break;
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
-}
+  case T_DATETIME:
+    *outKey = load_scan_key(fieldData, _SC(const DDateTime*, nullptr));
+    break;
 
+  case T_INT8:
+    *outKey = load_scan_key(fieldData, _SC(const DInt8*, nullptr));
+    break;
 
-DArray
-PrototypeTable::MatchRows(const DInt32&       min,
-                          const DInt32&       max,
-                          const ROW_INDEX     fromRow,
-                          const ROW_INDEX     toRow,
-                          const FIELD_INDEX   field)
-{
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  case T_INT16:
+    *outKey = load_scan_key(fieldData, _SC(const DInt16*, nullptr));
+    break;
+
+  case T_INT32:
+    *outKey = load_scan_key(fieldData, _SC(const DInt32*, nullptr));
+    break;
+
+  case T_INT64:
+    *outKey = load_scan_key(fieldData, _SC(const DInt64*, nullptr));
+    break;
+
+  case T_REAL:
+    *outKey = load_scan_key(fieldData, _SC(const DReal*, nullptr));
+    break;
+
+  case T_UINT8:
+    *outKey = load_scan_key(fieldData, _SC(const DUInt8*, nullptr));
+    break;
+
+  case T_UINT16:
+    *outKey = load_scan_key(fieldData, _SC(const DUInt16*, nullptr));
+    break;
+
+  case T_UINT32:
+    *outKey = load_scan_key(fieldData, _SC(const DUInt32*, nullptr));
+    break;
+
+  case T_UINT64:
+    *outKey = load_scan_key(fieldData, _SC(const DUInt64*, nullptr));
+    break;
+
+  default:
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  }
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  return true;
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DInt64&       min,
-                          const DInt64&       max,
-                          const ROW_INDEX     fromRow,
-                          const ROW_INDEX     toRow,
-                          const FIELD_INDEX   field)
+//Only the fields with scan keys get zones.
+static bool
+is_zoned_field(const FieldDescriptor& desc)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  if (IS_ARRAY(desc.Type()))
+    return false;
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  switch (GET_BASE_TYPE(desc.Type()))
+  {
+  case T_TEXT:
+  case T_HIRESTIME:
+  case T_RICHREAL:
+    return false;
+
+  default:
+    return true;
+  }
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DReal&        min,
-                          const DReal&        max,
-                          const ROW_INDEX     fromRow,
-                          const ROW_INDEX     toRow,
-                          const FIELD_INDEX   field)
+void
+PrototypeTable::InitZones()
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  vector<bool> zoned(mFieldsCount, false);
+
+  for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+    zoned[field] = is_zoned_field(GetFieldDescriptorInternal(field));
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  mZones.Init(zoned, mRowCache.ItemsPerBlock());
+
+  IDataContainer* const container = ZonesContainer();
+  if ((container != nullptr) && mZones.Load(*container, mRowsCount))
+    return;
+
+  //Build them from the rows, e.g. for a table created without them.
+  for (ROW_INDEX row = 0; row < mRowsCount; ++row)
+  {
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+
+    mZones.AddRow(row);
+    for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+    {
+      if (mZones.IsZoned(field))
+        UpdateRowZone(field, row, true, cachedItem);
+    }
+  }
 }
 
 
-DArray
-PrototypeTable::MatchRows(const DRichReal&    min,
-                          const DRichReal&    max,
-                          const ROW_INDEX     fromRow,
-                          const ROW_INDEX     toRow,
-                          const FIELD_INDEX   field)
+void
+PrototypeTable::UpdateRowZone(const FIELD_INDEX    field,
+                              const ROW_INDEX      row,
+                              const bool           wasNull,
+                              const StoredItem&    cachedItem)
 {
-  if (mvIndexNodeMgrs[field] != nullptr)
-    return MatchRowsWithIndex(min, max, fromRow, toRow, field);
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
 
-  return MatchRowsNoIndex(min, max, fromRow, toRow, field);
+  uint64_t key = 0;
+  const bool isNull = ! load_field_scan_key(desc,
+                                            RowNullBits(cachedItem),
+                                            RowValue(cachedItem, desc),
+                                            &key);
+  mZones.Update(field, row, wasNull, isNull, key);
 }
 
 
-template <class T> DArray
-PrototypeTable::MatchRowsWithIndex(const T&          min,
-                                   const T&          max,
-                                   const ROW_INDEX   fromRow,
-                                   ROW_INDEX         toRow,
-                                   const FIELD_INDEX field)
+void
+PrototypeTable::ReplaceRowZones(const ROW_INDEX        row,
+                                const uint8_t* const   oldRowData,
+                                const uint8_t* const   newRowData)
 {
-  DArray result;
-  if (mRowsCount == 0)
-    return result;
+  for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+  {
+    if ( ! mZones.IsZoned(field))
+      continue;
 
-  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+    uint64_t key = 0;
+    const bool wasNull = ! load_field_scan_key(desc,
+                                               oldRowData,
+                                               oldRowData + desc.RowDataOff(),
+                                               &key);
+    const bool isNull = ! load_field_scan_key(desc,
+                                              newRowData,
+                                              newRowData + desc.RowDataOff(),
+                                              &key);
+    mZones.Update(field, row, wasNull, isNull, key);
+  }
+}
 
-  if ((desc.Type() & PS_TABLE_ARRAY_MASK)
-      || ((desc.Type() & PS_TABLE_FIELD_TYPE_MASK) != _SC(uint_t, min.DBSType())))
+
+template<class T> struct ScanKeyed { static const bool VALUE = false; };
+
+template<> struct ScanKeyed<DBool> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DChar> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DDate> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DDateTime> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DInt8> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DInt16> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DInt32> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DInt64> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DReal> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DUInt8> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DUInt16> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DUInt32> { static const bool VALUE = true; };
+template<> struct ScanKeyed<DUInt64> { static const bool VALUE = true; };
+
+
+/* Matches the rows of a cached block against a range of values. The rows
+   are read in place; a row matches as it would by comparing its value with
+   the bounds (e.g. nulls go before any other value). */
+template<class T, bool KEYED = ScanKeyed<T>::VALUE>
+class BlockRowsMatcher
+{
+public:
+  BlockRowsMatcher(const FieldDescriptor& desc, const T& min, const T& max)
+    : mDesc(desc),
+      mMin(min),
+      mMax(max)
   {
-    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
   }
 
-  toRow = MIN(toRow, mRowsCount - 1);
+  bool MatchesNothing() const { return mMax < mMin; }
 
-  FieldIndexNodeManager* const nodeMgr = mvIndexNodeMgrs[field];
+  bool MayMatch(const ZoneMaps&, const FIELD_INDEX, const uint64_t) const { return true; }
 
-  NODE_INDEX nodeId;
-  KEY_INDEX fromKey;
-  const T_BTreeKey<T> firstKey(min, fromRow);
-  const T_BTreeKey<T> lastKey(max, toRow);
+  template<class OUTPUT> void
+  Match(const uint8_t*    nullBits,
+        const uint_t      nullBitsStride,
+        const uint8_t*    values,
+        const uint_t      valuesStride,
+        const ROW_INDEX   firstRow,
+        const uint_t      count,
+        OUTPUT&           result) const
+  {
+    for (uint_t r = 0; r < count; ++r, nullBits += nullBitsStride, values += valuesStride)
+    {
+      T rowValue;
+      load_row_value(mDesc, nullBits, values, rowValue);
 
-  assert(nodeMgr != nullptr);
+      if ((rowValue < mMin) || (mMax < rowValue))
+        continue;
 
-  AcquireFieldIndex( &desc);
+      add_matched_row(result, firstRow + r);
+    }
+  }
 
-  try
+private:
+  const FieldDescriptor&   mDesc;
+  const T&                 mMin;
+  const T&                 mMax;
+};
+
+
+template<class T>
+class BlockRowsMatcher<T, true>
+{
+public:
+  BlockRowsMatcher(const FieldDescriptor& desc, const T& min, const T& max)
+    : mNullByte(desc.NullBitIndex() / 8),
+      mNullMask(1 << (desc.NullBitIndex() % 8)),
+      mMatchNulls(min.IsNull()),
+      mMatchValues( ! max.IsNull() && ! (max < min)),
+      mLowKey(min.IsNull() ? 0 : scan_key(min)),
+      mKeysSpan(mMatchValues ? scan_key(max) - mLowKey : 0)
   {
-    BTree fieldIndexTree( *nodeMgr);
+  }
 
-    if ( !fieldIndexTree.FindBiggerOrEqual(firstKey, &nodeId, &fromKey))
-      goto force_return;
+  bool MatchesNothing() const { return ! (mMatchNulls || mMatchValues); }
 
-    auto currentNode = nodeMgr->RetrieveNode(nodeId);
+  bool MayMatch(const ZoneMaps& zones, const FIELD_INDEX field, const uint64_t block) const
+  {
+    return zones.MayMatch(field, block, mMatchNulls, mMatchValues, mLowKey, mLowKey + mKeysSpan);
+  }
 
-    assert(fromKey < currentNode->KeysCount());
-    while (true)
-    {
-      IBTreeFieldIndexNode* node = _SC(IBTreeFieldIndexNode*, &*currentNode);
-      KEY_INDEX toKey = ~0;
+  template<class OUTPUT> void
+  Match(const uint8_t*    nullBits,
+        const uint_t      nullBitsStride,
+        const uint8_t*    values,
+        const uint_t      valuesStride,
+        const ROW_INDEX   firstRow,
+        const uint_t      count,
+        OUTPUT&           result) const
+  {
+    uint64_t keys[BATCH_ROWS];
 
-      bool lastNode = false;
+    for (uint_t batch = 0; batch < count; batch += BATCH_ROWS)
+    {
+      const uint_t batchCount = MIN(BATCH_ROWS, count - batch);
 
-      if (node->FindBiggerOrEqual(lastKey, &toKey))
+      uint64_t nulls = 0;
+      for (uint_t r = 0; r < batchCount; ++r)
       {
-        lastNode = true;
+        nulls |= _SC(uint64_t, (nullBits[mNullByte] & mNullMask) != 0) << r;
+        keys[r] = load_scan_key(values, _SC(const T*, nullptr));
 
-        if (node->CompareKey(lastKey, toKey) < 0)
-          toKey++;
+        nullBits += nullBitsStride, values += valuesStride;
       }
-      else
-        toKey = 0;
 
-      if (fromKey >= toKey)
-        node->GetRows(fromKey, toKey, fromRow, toRow, result);
-
-      if (lastNode || (node->Next() == NIL_NODE))
-        break;
-
-      else
+      /* A key is in range when its distance from the low bound does not
+         exceed the range's span, so each value needs a single compare and
+         no branch. */
+      uint64_t matches = 0;
+      uint_t r = 0;
+      for (; r + 4 <= batchCount; r += 4)
       {
-        currentNode = nodeMgr->RetrieveNode(node->Next());
+        matches |= _SC(uint64_t, (keys[r] - mLowKey) <= mKeysSpan) << r;
+        matches |= _SC(uint64_t, (keys[r + 1] - mLowKey) <= mKeysSpan) << (r + 1);
+        matches |= _SC(uint64_t, (keys[r + 2] - mLowKey) <= mKeysSpan) << (r + 2);
+        matches |= _SC(uint64_t, (keys[r + 3] - mLowKey) <= mKeysSpan) << (r + 3);
+      }
 
-        assert(currentNode->KeysCount() > 0);
+      for (; r < batchCount; ++r)
+        matches |= _SC(uint64_t, (keys[r] - mLowKey) <= mKeysSpan) << r;
 
-        fromKey = currentNode->KeysCount() - 1;
+      matches = mMatchValues ? (matches & ~nulls) : 0;
+      if (mMatchNulls)
+        matches |= nulls;
+
+      for (; matches != 0; matches &= matches - 1)
+      {
+        const uint_t bit = RowsSet::CountBits((matches & (~matches + 1)) - 1);
+        add_matched_row(result, firstRow + batch + bit);
       }
     }
   }
-  catch (...)
-  {
-    ReleaseIndexField( &desc);
 
-    throw;
-  }
+private:
+  static const uint_t BATCH_ROWS = 64;
+
+  const uint_t     mNullByte;
+  const uint8_t    mNullMask;
+  const bool       mMatchNulls;
+  const bool       mMatchValues;
+  const uint64_t   mLowKey;
+  const uint64_t   mKeysSpan;
+};
 
-  force_return:
 
-  ReleaseIndexField( &desc);
+template <class T, class OUTPUT> void
+PrototypeTable::MatchRowsWithHash(FieldHashIndex&           hashIndex,
+                                  const FieldDescriptor&    desc,
+                                  const T&                  value,
+                                  const ROW_INDEX           fromRow,
+                                  const ROW_INDEX           toRow,
+                                  OUTPUT&                   result)
+{
+  vector<ROW_INDEX> rows;
+  hashIndex.Find(hash_field_value(value), rows);
 
-  return result;
+  sort(rows.begin(), rows.end());
+
+  //Only the hashes are indexed, so every row found is checked.
+  const ROW_INDEX lastRow = MIN(toRow, mRowsCount - 1);
+  for (const ROW_INDEX row : rows)
+  {
+    if ((row < fromRow) || (row > lastRow))
+      continue;
+
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    SharedLockGuard<RWLock> latch(cachedItem.Latch());
+
+    T rowValue;
+    load_row_value(desc, RowNullBits(cachedItem), RowValue(cachedItem, desc), rowValue);
+
+    if (rowValue == value)
+      add_matched_row(result, row);
+  }
 }
 
 
-template <class T> DArray
+template <class T, class OUTPUT> void
 PrototypeTable::MatchRowsNoIndex(const T&          min,
                                  const T&          max,
                                  const ROW_INDEX   fromRow,
                                  ROW_INDEX         toRow,
-                                 const FIELD_INDEX field)
+                                 const FIELD_INDEX field,
+                                 OUTPUT&           result)
 {
-  DArray result;
+  //Take the table once for the whole scan, not for every row.
+  SharedLockGuard<MeteredRWLock> syncHolder(mRowsSync);
 
   if (mRowsCount == 0)
-    return result;
+    return;
+
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  if ((desc.Type() & PS_TABLE_ARRAY_MASK)
+      || ((desc.Type() & PS_TABLE_FIELD_TYPE_MASK) != _SC(uint_t, min.DBSType())))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+  }
+
+  const BlockRowsMatcher<T> matcher(desc, min, max);
+  if (matcher.MatchesNothing())
+    return;
+
+  /* Walk the rows one cached block at the time, holding its latch only
+     once for all of the block's rows in range. With the PAX layout only the
+     null bits and the field's mini page of a block are read. The blocks
+     whose zones hold no value in range are not read at all. */
+  const uint_t blockRows = mRowCache.ItemsPerBlock();
+  const uint_t nullBitsStride = mLayout.NullBitsStride();
+  const uint_t valuesStride = mLayout.ValueStride(desc);
 
   toRow = MIN(toRow, mRowsCount - 1);
-  for (ROW_INDEX row = fromRow; row <= toRow; ++row)
+  for (uint64_t row = fromRow; row <= toRow; )
   {
-    T rowValue;
-    Get(row, field, rowValue);
+    const uint64_t blockEnd = (row / blockRows + 1) * blockRows;
+    const uint_t count = MIN(blockEnd, _SC(uint64_t, toRow) + 1) - row;
 
-    if ((rowValue < min) || (max < rowValue))
+    if ( ! matcher.MayMatch(mZones, field, row / blockRows))
+    {
+      row += count;
       continue;
+    }
 
-    result.Add(DROW_INDEX(row));
-  }
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    SharedLockGuard<RWLock> latch(cachedItem.Latch());
 
-  return result;
+    matcher.Match(RowNullBits(cachedItem),
+                  nullBitsStride,
+                  RowValue(cachedItem, desc),
+                  valuesStride,
+                  row,
+                  count,
+                  result);
+
+    row += count;
+  }
 }
 
 
-void
-PrototypeTable::MarkRowModification(LockGuard<Lock>* const guard)
+template<class GUARD> void
+PrototypeTable::MarkRowModification(GUARD* const guard)
 {
   if (mRowModified)
     return ;
 
+  //Sessions holding the table only shared could get here at the same time.
+  LockGuard<Lock> _l(mUpdatesSync);
+
   while (! mDbs.NotifyDatabaseUpdate(true))
   {
+    _l.unlock();
+
     if (guard != nullptr)
       guard->unlock();
 
@@ -2522,7 +4659,13 @@ PrototypeTable::MarkRowModification(LockGuard<Lock>* const guard)
 
     if (guard != nullptr)
       guard->lock();
+
+    _l.lock();
   }
+
+  if (mRowModified)
+    return;
+
   mRowModified = true;
   MakeHeaderPersistent();
 }
@@ -2534,6 +4677,10 @@ PrototypeTable::FlushInternal()
   mRowCache.Flush();
   FlushNodes();
 
+  IDataContainer* const zonesContainer = ZonesContainer();
+  if (zonesContainer != nullptr)
+    mZones.Store(*zonesContainer, mRowsCount);
+
   for (int field = 0; field < mFieldsCount; ++field)
   {
     if (mvIndexNodeMgrs[field] == nullptr)
@@ -2547,11 +4694,16 @@ PrototypeTable::FlushInternal()
     mvIndexNodeMgrs[field]->FlushNodes();
   }
 
-  FlushEpilog();
+  for (int field = 0; field < mFieldsCount; ++field)
+  {
+    if (mvHashIndexes[field] != nullptr)
+      mvHashIndexes[field]->Flush();
+  }
 
+  //The header written by the epilog should not mark the table as modified.
   mRowModified = false;
 
-  MakeHeaderPersistent();
+  FlushEpilog();
 }
 
 
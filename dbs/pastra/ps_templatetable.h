@@ -37,6 +37,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "ps_blockcache.h"
 #include "ps_varstorage.h"
 #include "ps_btree_fields.h"
+#include "ps_hashindex.h"
+#include "ps_zonemap.h"
 
 
 namespace whais {
@@ -45,8 +47,11 @@ namespace pastra {
 
 static const uint_t PS_TABLE_FIELD_TYPE_MASK = 0x00FF;
 static const uint_t PS_TABLE_ARRAY_MASK      = 0x0100;
+static const uint_t PS_TABLE_HASH_INDEX_MASK = 0x8000;
 
 
+class SortedRowsCopy;
+
 class FieldDescriptor
 {
 public:
@@ -58,7 +63,7 @@ public:
     NameOffset(0);
     IndexNodeSizeKB(0);
     IndexUnitsCount(0);
-    Type(0);
+    store_le_int16(0, mType);
     mAcquired = 0;
   }
 
@@ -68,8 +73,13 @@ public:
   void RowDataOff(const uint_t off) { store_le_int32(off, mRowDataOff); }
   uint_t NameOffset() const { return load_le_int32(mNameOffset); }
   void NameOffset(const uint_t off) { store_le_int32(off, mNameOffset); }
-  uint_t Type() const { return load_le_int16(mType); }
+  uint_t Type() const { return load_le_int16(mType) & ~PS_TABLE_HASH_INDEX_MASK; }
   void Type(const uint_t type) { store_le_int16(type, mType); }
+  bool HashIndexed() const { return (load_le_int16(mType) & PS_TABLE_HASH_INDEX_MASK) != 0; }
+  void HashIndexed(const bool indexed)
+  {
+    store_le_int16(indexed ? (Type() | PS_TABLE_HASH_INDEX_MASK) : Type(), mType);
+  }
   bool IsAcquired() const { return mAcquired != 0; }
   void Acquire() { assert(mAcquired == 0); mAcquired = 1; }
   void Release() { assert(mAcquired > 0); mAcquired = 0; }
@@ -89,6 +99,57 @@ private:
   uint8_t  mIndexNodeSizeKB;
 };
 
+/* Locates the parts of a row in a block of the rows cache, given the
+   offset the row would have if the block kept its rows one after the other.
+   With the PAX layout a block of 'BlockRows()' rows starts with the null
+   bits of all its rows, followed by a mini page for each field holding the
+   values of all the rows. The mini pages are placed in the order the values
+   are found in a row, so a block has the same size with both layouts. */
+class RowsLayout
+{
+public:
+  RowsLayout(const uint_t rowSize = 0,
+             const uint_t fieldsCount = 0,
+             const uint_t blockRows = 0)
+    : mRowSize(rowSize),
+      mNullBytes((fieldsCount + 7) / 8),
+      mFieldsCount(fieldsCount),
+      mBlockRows(blockRows)
+  {
+  }
+
+  bool IsPax() const { return mBlockRows > 0; }
+  uint_t BlockRows() const { return mBlockRows; }
+
+  uint_t NullBitsOffset(const uint_t itemOffset) const
+  {
+    return IsPax() ? (itemOffset / mRowSize) * mNullBytes : itemOffset;
+  }
+
+  uint_t ValueOffset(const uint_t itemOffset, const FieldDescriptor& desc) const;
+
+  /* The distance between the same parts of two consecutive rows. */
+  uint_t NullBitsStride() const { return IsPax() ? mNullBytes : mRowSize; }
+  uint_t ValueStride(const FieldDescriptor& desc) const;
+
+  /* Copy a row of a block to or from a buffer holding it as a record. */
+  void LoadRow(const uint8_t* const           block,
+               const uint_t                   itemOffset,
+               const FieldDescriptor* const   fields,
+               uint8_t* const                 to) const;
+  void StoreRow(uint8_t* const                 block,
+                const uint_t                   itemOffset,
+                const FieldDescriptor* const   fields,
+                const uint8_t* const           from) const;
+
+private:
+  uint_t mRowSize;
+  uint_t mNullBytes;
+  uint_t mFieldsCount;
+  uint_t mBlockRows;
+};
+
+
 class PrototypeTable : public ITable,
                        public IBlocksManager,
                        public IBTreeNodeManager
@@ -104,6 +165,15 @@ public:
   virtual void RootNodeId(const NODE_INDEX node) override;
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) override;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) override;
+  virtual void StoreBlocks(uint64_t               firstItem,
+                           const uint_t           itemsPerBlock,
+                           const uint8_t* const*  blocks,
+                           const uint_t           blocksCount) override;
+  virtual uint_t RetrieveBlocks(uint64_t               firstItem,
+                                const uint_t           itemsPerBlock,
+                                uint8_t* const*        blocks,
+                                const uint_t           blocksCount) override;
+  virtual uint8_t* MapItems(uint64_t firstItem, uint_t itemsCount) override;
   virtual FIELD_INDEX FieldsCount() override;
   virtual FIELD_INDEX RetrieveField(const char* name) override;
   virtual DBSFieldDescriptor DescribeField(const FIELD_INDEX field) override;
@@ -114,9 +184,11 @@ public:
   virtual void MarkRowForReuse(const ROW_INDEX row) override;
   virtual void CreateIndex(const FIELD_INDEX                   field,
                            CREATE_INDEX_CALLBACK_FUNC* const   cbFunc,
-                           CreateIndexCallbackContext* const   cbContext);
+                           CreateIndexCallbackContext* const   cbContext,
+                           const INDEX_KIND                    kind = INDEX_BTREE) override;
   virtual void RemoveIndex(const FIELD_INDEX field) override;
   virtual bool IsIndexed(const FIELD_INDEX field) const override;
+  virtual INDEX_KIND IndexKind(const FIELD_INDEX field) const override;
 
   virtual void Set(const ROW_INDEX row,
                    const FIELD_INDEX field,
@@ -386,6 +458,96 @@ public:
                            const ROW_INDEX fromRow,
                            const ROW_INDEX toRow,
                            const FIELD_INDEX field);
+
+  virtual RowsSet MatchRowsSet(const DBool& min,
+                               const DBool& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DChar& min,
+                               const DChar& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DDate& min,
+                               const DDate& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DDateTime& min,
+                               const DDateTime& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DHiresTime& min,
+                               const DHiresTime& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DUInt8& min,
+                               const DUInt8& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DUInt16& min,
+                               const DUInt16& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DUInt32& min,
+                               const DUInt32& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DUInt64& min,
+                               const DUInt64& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DInt8& min,
+                               const DInt8& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DInt16& min,
+                               const DInt16& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DInt32& min,
+                               const DInt32& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DInt64& min,
+                               const DInt64& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DReal& min,
+                               const DReal& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
+
+  virtual RowsSet MatchRowsSet(const DRichReal& min,
+                               const DRichReal& max,
+                               const ROW_INDEX fromRow,
+                               const ROW_INDEX toRow,
+                               const FIELD_INDEX field) override;
   virtual void LockTable() override;
   virtual void UnlockTable() override;
   virtual void Flush() override;
@@ -393,6 +555,10 @@ public:
 
   DbsHandler& GetDbsHandler() { return mDbs; };
 
+  /* Gather the counters of the rows cache, indexes and locks. The indexes
+     are skipped while the table is locked, not to stall the caller. */
+  virtual void Statistics(DBSTableStats& outStats);
+
   //Followings declarations shouldn't be public,
   //but kept here to ease the testing procedures.
   uint_t RowSize() const;
@@ -400,13 +566,22 @@ public:
 
 protected:
   virtual void MakeHeaderPersistent() = 0;
-  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) = 0;
+  virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field,
+                                               const INDEX_KIND kind) = 0;
   virtual IDataContainer& RowsContainer() = 0;
   virtual IDataContainer& TableContainer() = 0;
   virtual VariableSizeStoreSPtr VSStore() = 0;
+  virtual IDataContainer* ZonesContainer() = 0;
   virtual void FlushEpilog() = 0;
-  void MarkRowModification(LockGuard<Lock>* const guard);
+  template<class GUARD> void MarkRowModification(GUARD* const guard);
+  void MarkRowModification() { MarkRowModification<LockGuard<MeteredRWLock>>(nullptr); }
   void FlushInternal();
+  uint64_t StoredRowsCount() const;
+  void InitZones();
+  void BuildHashIndex(FieldHashIndex&                    hashIndex,
+                      const FieldDescriptor&             desc,
+                      CREATE_INDEX_CALLBACK_FUNC* const  cbFunc,
+                      CreateIndexCallbackContext* const  cbContext);
 
   //Data members
   DbsHandler&                           mDbs;
@@ -414,32 +589,78 @@ protected:
   NODE_INDEX                            mRootNode;
   NODE_INDEX                            mUnallocatedHead;
   uint32_t                              mRowSize;
+  RowsLayout                            mLayout;
   uint32_t                              mDescriptorsSize;
   FIELD_INDEX                           mFieldsCount;
   std::unique_ptr<uint8_t>              mFieldsDescriptors;
   std::vector<FieldIndexNodeManager*>   mvIndexNodeMgrs;
+  std::vector<FieldHashIndex*>          mvHashIndexes;
   BlockCache                            mRowCache;
-  Lock                                  mRowsSync;
-  Lock                                  mIndexesSync;
+  ZoneMaps                              mZones;
+  MeteredRWLock                         mRowsSync;
+  MeteredLock                           mIndexesSync;
+  Lock                                  mUpdatesSync;
   bool                                  mRowModified;
   bool                                  mLockInProgress;
 
 private:
+  friend class SortedRowsCopy;
+
   template<class T> void StoreEntry(const ROW_INDEX, const FIELD_INDEX, const bool, const T&);
   template<class T> void RetrieveEntry(const ROW_INDEX, const FIELD_INDEX, const bool, T&);
+  template<class T, class GUARD> void UpdateEntry(const ROW_INDEX,
+                                                  const FIELD_INDEX,
+                                                  const bool,
+                                                  const T&,
+                                                  GUARD&);
   template<typename T> void table_exchange_rows(const FIELD_INDEX field,
                                                 const ROW_INDEX row1,
                                                 const ROW_INDEX row2);
-  template<class T> DArray MatchRowsWithIndex(const T& min,
-                                              const T& max,
-                                              const ROW_INDEX fromRow,
-                                              ROW_INDEX toRow,
-                                              const FIELD_INDEX fieldIndex);
-  template<class T> DArray MatchRowsNoIndex(const T& min,
-                                            const T& max,
-                                            const ROW_INDEX fromRow,
-                                            ROW_INDEX toRow,
-                                            const FIELD_INDEX filedIndex);
+  template<class T, class OUTPUT> void MatchRowsWithIndex(const T& min,
+                                                         const T& max,
+                                                         const ROW_INDEX fromRow,
+                                                         ROW_INDEX toRow,
+                                                         const FIELD_INDEX fieldIndex,
+                                                         OUTPUT& result);
+  template<class T, class OUTPUT> void MatchRowsWithHash(FieldHashIndex& hashIndex,
+                                                        const FieldDescriptor& desc,
+                                                        const T& value,
+                                                        const ROW_INDEX fromRow,
+                                                        const ROW_INDEX toRow,
+                                                        OUTPUT& result);
+  template<class T, class OUTPUT> void MatchRowsNoIndex(const T& min,
+                                                       const T& max,
+                                                       const ROW_INDEX fromRow,
+                                                       ROW_INDEX toRow,
+                                                       const FIELD_INDEX filedIndex,
+                                                       OUTPUT& result);
+  template<class T> void SortRowsByKeys(const FIELD_INDEX field,
+                                         const ROW_INDEX from,
+                                         const ROW_INDEX to,
+                                         const bool reverse);
+  void SortRowsByText(const FIELD_INDEX field,
+                      const ROW_INDEX from,
+                      const ROW_INDEX to,
+                      const bool reverse);
+  template<class SORTER> void RewriteSortedRows(SortedRowsCopy& rows,
+                                                const ROW_INDEX from,
+                                                const ROW_INDEX to,
+                                                SORTER& sorter);
+  void ReindexRow(const ROW_INDEX row, const uint8_t* const oldRowData, const uint8_t* const newRowData);
+  bool IsNullRowData(const uint8_t* const nullBits) const;
+  const uint8_t* RowNullBits(const StoredItem& cachedItem) const;
+  const uint8_t* RowValue(const StoredItem& cachedItem, const FieldDescriptor& desc) const;
+  uint8_t* RowNullBitsForUpdate(const StoredItem& cachedItem) const;
+  uint8_t* RowValueForUpdate(const StoredItem& cachedItem, const FieldDescriptor& desc) const;
+  void LoadRow(const StoredItem& cachedItem, uint8_t* const to) const;
+  void StoreRow(const StoredItem& cachedItem, const uint8_t* const from) const;
+  void UpdateRowZone(const FIELD_INDEX    field,
+                     const ROW_INDEX      row,
+                     const bool           wasNull,
+                     const StoredItem&    cachedItem);
+  void ReplaceRowZones(const ROW_INDEX        row,
+                       const uint8_t* const   oldRowData,
+                       const uint8_t* const   newRowData);
   void CheckRowToReuse(const ROW_INDEX row);
   void CheckRowToDelete(const ROW_INDEX row);
   void AcquireFieldIndex(FieldDescriptor* const field);
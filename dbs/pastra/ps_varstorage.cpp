@@ -22,6 +22,8 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+
+#include <algorithm>
 #include <memory.h>
 #include <assert.h>
 
@@ -39,248 +41,593 @@ namespace whais {
 namespace pastra {
 
 
-typedef bool(*VALUE_VALIDATOR) (const uint8_t* const);
+static const uint8_t PS_VS_SIGNATURE[] = { 0x50, 0x41, 0x53, 0x54, 0x52, 0x41, 0x56, 0x53 };
+
+static const uint_t PS_VS_SIG_OFF             = 0;
+static const uint_t PS_VS_SIG_LEN             = 8;
+static const uint_t PS_VS_FREE_MAP_OFF        = 8;
+static const uint_t PS_VS_FREE_MAP_LEN        = 8;
+
+static const uint64_t NIL_UNIT                = 0;
+static const uint_t   FREE_MAP_CLASS          = 2;
+static const uint_t   LARGE_EXTENT_CLASS      = 10;
+static const uint_t   DIRECTORY_ENTRY_SIZE    = sizeof(uint64_t);
+static const uint_t   COPY_BUFFER_SIZE        = 64 * 1024;
 
+/* The stores were kept as chains of 64 bytes entries (two links and 48 bytes
+   of content) before. These are needed only to convert them. */
+static const uint_t   CHAINED_ENTRY_SIZE      = 64;
+static const uint_t   CHAINED_DATA_OFF        = 16;
+static const uint_t   CHAINED_DATA_SIZE       = 48;
+static const uint64_t CHAINED_LAST_ENTRY      = 0x0FFFFFFFFFFFFFFFull;
+static const uint64_t CHAINED_DELETED_MASK    = 0x8000000000000000ull;
+static const uint64_t CHAINED_FIRST_MASK      = 0x4000000000000000ull;
 
-uint_t
-StoreEntry::Read(uint_t offset, uint_t count, uint8_t* buffer) const
+static const char     PS_VS_CONVERT_SUFFIX[]  = "_cv";
+static const char     PS_VS_CONVERTED_MARK[]  = "_cv_done";
+
+
+static uint_t
+size_class(const uint64_t unitsCount)
 {
-  assert(IsDeleted() == false);
+  assert(unitsCount > 0);
 
-  if (count + offset > Size() )
-    count = Size() - offset;
+  uint_t result = 0;
+  while ((1ull << result) < unitsCount)
+    ++result;
 
-  memcpy(buffer, mRawData + offset, count);
+  return result;
+}
 
-  return count;
+
+static bool
+is_power_of_two(const uint64_t value)
+{
+  return (value != 0) && ((value & (value - 1)) == 0);
 }
 
 
-uint_t
-StoreEntry::Write(uint_t offset, uint_t count, const uint8_t* buffer)
+static bool
+is_chained_store(const uint8_t* const firstEntry)
 {
-  assert(IsDeleted() == false);
+  return (load_le_int64(firstEntry) == 0)
+          && ((load_le_int64(firstEntry + sizeof(uint64_t)) & CHAINED_DELETED_MASK) != 0);
+}
 
-  if (count + offset > Size() )
-    count = Size() - offset;
 
-  memcpy(mRawData + offset, buffer, count);
+static string
+unit_file_name(const string& baseName, const uint64_t unit)
+{
+  return baseName + (unit ? to_string(unit) : "");
+}
+
 
-  return count;
+static void
+remove_file(const string& fileName)
+{
+  if ( ! whf_remove(fileName.c_str()))
+  {
+    throw WFileContainerException(_EXTRA(WFileContainerException::FILE_OS_IO_ERROR),
+                                  "Failed to remove file '%s'.",
+                                  fileName.c_str());
+  }
 }
 
 
-void VariableSizeStore::Init(const char* tempDir, const uint32_t reservedMem)
+/* Remove the files of a series starting with the unit 'firstUnit'. The last
+   ones go first, so an interrupted removal leaves no gaps behind. */
+static void
+remove_units_files(const string& baseName, const uint64_t firstUnit)
 {
-  mEntriesContainer.reset(new TemporalContainer());
-  mEntriesCount = 0;
+  uint64_t lastUnit = firstUnit;
+  while (whf_file_exists(unit_file_name(baseName, lastUnit).c_str()))
+    ++lastUnit;
 
-  FinishInit(true);
+  while (lastUnit-- > firstUnit)
+    remove_file(unit_file_name(baseName, lastUnit));
 }
 
 
-void
-VariableSizeStore::Init(const char* baseName,
-                        const uint64_t containerSize,
-                        const uint64_t maxFileSize)
+/* Put the files of a converted store in place of the original ones. It
+   also finishes a replacement that was interrupted, so any of its steps
+   might have been done already. */
+static void
+replace_converted_files(const string& baseName, const uint64_t filesCount)
 {
-  assert(maxFileSize != 0);
+  const string convertedName = baseName + PS_VS_CONVERT_SUFFIX;
+
+  //The original store might have been spread over more files.
+  remove_units_files(baseName, filesCount);
+
+  for (uint64_t f = 0; f < filesCount; ++f)
+  {
+    const string converted = unit_file_name(convertedName, f);
+    const string original  = unit_file_name(baseName, f);
+
+    if ( ! whf_file_exists(converted.c_str()))
+      continue;
 
-  const uint64_t unitsCount = (containerSize + maxFileSize - 1) / maxFileSize;
+    if (whf_file_exists(original.c_str()))
+      remove_file(original);
 
-  mEntriesContainer.reset(new FileContainer(baseName, maxFileSize, unitsCount, false));
-  mEntriesCount = mEntriesContainer->Size() / sizeof(StoreEntry);
+    if ( ! whf_move_file(converted.c_str(), original.c_str()))
+    {
+      throw WFileContainerException(_EXTRA(WFileContainerException::FILE_OS_IO_ERROR),
+                                    "Failed to move file '%s' to '%s'.",
+                                    converted.c_str(),
+                                    original.c_str());
+    }
+  }
 
-  FinishInit(false);
+  remove_file(baseName + PS_VS_CONVERTED_MARK);
 }
 
 
-void
-VariableSizeStore::PrepareToCheckStorage()
+/* Deal with what a conversion interrupted by a crash has left behind.
+   Once its mark is written, the converted files are complete and they
+   replace the original ones. Before that, the original files were not
+   touched and the converted ones are discarded. Returns the count of
+   the store's files when these were replaced, 0 otherwise. */
+static uint64_t
+recover_conversion(const string& baseName)
 {
-  assert(mUsedEntries.size() == 0);
+  const string markName = baseName + PS_VS_CONVERTED_MARK;
 
-  //Disable the cache block.
-  mEntriesCache.~BlockCache();
-  memset(_RC(void*, &mEntriesCache), 0, sizeof(mEntriesCache));
+  if ( ! whf_file_exists(markName.c_str()))
+  {
+    remove_units_files(baseName + PS_VS_CONVERT_SUFFIX, 0);
+    return 0;
+  }
 
-  assert(mEntriesCount > 0);
+  uint64_t filesCount = 0;
+  {
+    File mark(markName.c_str(), WH_FILEOPEN_EXISTING | WH_FILEREAD);
+
+    if (mark.Size() == sizeof filesCount)
+    {
+      uint8_t content[sizeof filesCount];
+      mark.Read(0, content, sizeof content);
 
-  mUsedEntries.resize(mEntriesCount, false);
-  mUsedEntries[0] = true; //The first entry is always in use. It holds the
-                          //chain head of the removed ones.
+      filesCount = load_le_int64(content);
+    }
+  }
 
-  const uint64_t containerSize = mEntriesCount * sizeof(StoreEntry);
+  if (filesCount == 0)
+  {
+    remove_units_files(baseName + PS_VS_CONVERT_SUFFIX, 0);
+    remove_file(markName);
+    return 0;
+  }
 
-  if (containerSize < mEntriesContainer->Size())
-    mEntriesContainer->Colapse(containerSize, mEntriesContainer->Size());
+  replace_converted_files(baseName, filesCount);
+  return filesCount;
 }
 
 
-static bool
-is_entry_valid(const StoreEntry&    entry,
-               const uint64_t       prevEntry,
-               const bool           firstEntry,
-               const bool           lastEntry)
+void
+VariableSizeStore::Init(const char* tempDir, const uint32_t reservedMem)
 {
-  if (firstEntry && ! entry.IsFirstEntry())
-    return false;
+  mUnitsContainer.reset(new TemporalContainer());
+  mUnitsCount = 0;
 
-  else if ( ! firstEntry && entry.IsFirstEntry())
-    return false;
+  FinishInit(true, false);
+}
 
-  else if (lastEntry && (entry.NextEntry() != StoreEntry::LAST_CHAINED_ENTRY))
-    return false;
 
-  return firstEntry
-         ? entry.PrevEntry() >= StoreEntry::FIRST_PREV_ENTRY
-         : entry.PrevEntry() == prevEntry;
+void
+VariableSizeStore::Init(const char*     baseName,
+                        const uint64_t  containerSize,
+                        const uint64_t  maxFileSize,
+                        const bool      toCheck,
+                        WriteAheadLog*  log,
+                        const uint32_t  logOwner)
+{
+  assert(maxFileSize != 0);
+
+  uint64_t unitsCount = recover_conversion(baseName);
+  if (unitsCount == 0)
+    unitsCount = (containerSize + maxFileSize - 1) / maxFileSize;
+
+  mUnitsContainer.reset(new FileContainer(baseName, maxFileSize, unitsCount, false));
+
+  if (mUnitsContainer->Size() >= UNIT_SIZE)
+  {
+    uint8_t header[UNIT_SIZE];
+    mUnitsContainer->Read(0, sizeof header, header);
+
+    if (is_chained_store(header))
+      ConvertChainedStore(baseName, maxFileSize);
+
+    else if ( ! toCheck
+             && (memcmp(header + PS_VS_SIG_OFF, PS_VS_SIGNATURE, PS_VS_SIG_LEN) != 0))
+    {
+      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR),
+                         "The variable size store '%s' has an invalid signature.",
+                         baseName);
+    }
+  }
+
+  //The store's files are logged only once they are in the current format.
+  if (log != nullptr)
+  {
+    const uint64_t filesCount = (mUnitsContainer->Size() + maxFileSize - 1) / maxFileSize;
+
+    mUnitsContainer.reset();
+    mUnitsContainer.reset(new FileContainer(baseName,
+                                            maxFileSize,
+                                            filesCount,
+                                            false,
+                                            log,
+                                            logOwner));
+  }
+
+  mUnitsCount = mUnitsContainer->Size() / UNIT_SIZE;
+
+  FinishInit(false, toCheck);
 }
 
 
-bool
-VariableSizeStore::CheckArrayEntry(const uint64_t         recordFirstEntry,
-                                   const uint64_t         recordSize,
-                                   const DBS_FIELD_TYPE   itemType)
+void
+VariableSizeStore::InitCache(const bool nonPersitentData)
 {
-  if (_SC(int64_t, recordSize) <= Serializer::Size(itemType, true) - 1)
-    return false;
+  uint_t blkSize = DBSGetSeettings().mVLStoreCacheBlkSize;
+  const uint_t blkCount = DBSGetSeettings().mVLStoreCacheBlkCount;
 
-  const uint_t itemSize = Serializer::Size(itemType, false);
+  assert((blkSize != 0) && (blkCount != 0));
 
-  const Serializer::VALUE_VALIDATOR validator = Serializer::SelectValidator(itemType);
+  while (blkSize < UNIT_SIZE)
+    blkSize *= 2;
 
-  uint64_t currentEntry = recordFirstEntry;
-  uint64_t prevEntry = 0;
-  StoreEntry vsEntry;
-  vector<uint64_t> entriesUsed;
+  blkSize -= blkSize % UNIT_SIZE;
+  mUnitsPerBlock = blkSize / UNIT_SIZE;
 
-  if ((recordFirstEntry >= mUsedEntries.size()) || mUsedEntries[currentEntry])
-    return false;
+  mUnitsCache.Init( *this, UNIT_SIZE, blkSize, blkCount, nonPersitentData);
+}
 
-  entriesUsed.push_back(currentEntry);
-  mEntriesContainer.get()->Read(currentEntry * sizeof vsEntry,
-                                sizeof vsEntry,
-                                _RC(uint8_t*, &vsEntry));
-  if (vsEntry.IsDeleted())
-    return false;
 
-  uint8_t temp[sizeof(uint64_t)];
-  vsEntry.Read(0, sizeof temp, temp);
+void
+VariableSizeStore::FinishInit(const bool nonPersitentData, const bool toCheck)
+{
+  assert((mUnitsContainer->Size() % UNIT_SIZE) == 0);
 
-  const uint64_t itemsCount = load_le_int64(temp);
-  if ((itemsCount == 0)
-      || ((recordSize - sizeof(uint64_t)) % itemSize != 0)
-      || ((recordSize - sizeof(uint64_t)) / itemSize != itemsCount))
+  InitCache(nonPersitentData);
+
+  mFreeExtents.clear();
+
+  if (mUnitsCount == 0)
   {
-    return false;
+    ExtendStore(1);
+
+    fill(begin(mFreeHeads), end(mFreeHeads), NIL_UNIT);
+
+    mFreeMapUnit = AllocateExtent(FREE_MAP_CLASS);
+    for (uint_t c = 0; c < FREE_CLASSES_COUNT; ++c)
+      StoreFreeHead(c);
+
+    StoreHeader();
+    return;
   }
+  else if (toCheck)
+  {
+    //The free space is rebuilt once the records are checked.
+    mFreeMapUnit = NIL_UNIT;
+    fill(begin(mFreeHeads), end(mFreeHeads), NIL_UNIT);
+    return;
+  }
+
+  uint8_t header[UNIT_SIZE];
+  ReadUnits(0, 0, sizeof header, header);
+
+  mFreeMapUnit = load_le_int64(header + PS_VS_FREE_MAP_OFF);
+
+  if (mFreeMapUnit + (1ull << FREE_MAP_CLASS) > mUnitsCount)
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
 
-  uint64_t actualSize = sizeof(uint64_t);
-  uint64_t itemsChecked = 0;
-  uint_t itemBytesRead = 0;
-  uint8_t itemBuffer[StoreEntry::ENTRY_SIZE];
-  bool entryValidated = false;
-  while (itemsChecked < itemsCount)
+  uint8_t heads[FREE_CLASSES_COUNT * sizeof(uint64_t)];
+  ReadUnits(mFreeMapUnit, 0, sizeof heads, heads);
+
+  for (uint_t c = 0; c < FREE_CLASSES_COUNT; ++c)
+    mFreeHeads[c] = load_le_int64(heads + c * sizeof(uint64_t));
+
+  LoadFreeExtents();
+}
+
+
+/* Rewrite a store kept in the older chained entries format. Every record
+   keeps its identifier, as its header takes the unit of its first entry.
+   The new content is built aside and replaces the old files only when
+   it is complete and a mark that says so is durable. */
+void
+VariableSizeStore::ConvertChainedStore(const char* baseName, const uint64_t maxFileSize)
+{
+  IDataContainer& source = *mUnitsContainer;
+
+  const uint64_t entriesCount = source.Size() / CHAINED_ENTRY_SIZE;
+  const string convertedName = string(baseName) + PS_VS_CONVERT_SUFFIX;
+
+  uint64_t convertedSize = 0;
   {
-    const bool lastEntry = (recordSize - actualSize)
-        <= (StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE);
-    if ( ! entryValidated
-        && ! is_entry_valid(vsEntry, prevEntry, currentEntry == recordFirstEntry, lastEntry))
+    VariableSizeStore converted;
+
+    converted.mUnitsContainer.reset(new FileContainer(convertedName.c_str(),
+                                                      maxFileSize,
+                                                      0,
+                                                      true));
+    converted.mUnitsCount = 0;
+    converted.InitCache(false);
+    converted.ExtendStore(entriesCount);
+    converted.mUsedUnits.resize(entriesCount, false);
+    converted.mUsedUnits[0] = true;
+
+    //Find the first entries of the records, they give the records' identifiers.
+    vector<pair<uint64_t, uint64_t>> records;
+    unique_ptr<uint8_t[]> window(new uint8_t[COPY_BUFFER_SIZE]);
+    const uint64_t windowEntries = COPY_BUFFER_SIZE / CHAINED_ENTRY_SIZE;
+
+    for (uint64_t first = 0; first < entriesCount; first += windowEntries)
     {
-      return false;
+      const uint64_t count = min(windowEntries, entriesCount - first);
+      source.Read(first * CHAINED_ENTRY_SIZE, count * CHAINED_ENTRY_SIZE, window.get());
+
+      for (uint64_t e = (first == 0) ? 1 : 0; e < count; ++e)
+      {
+        const uint8_t* const entry = window.get() + e * CHAINED_ENTRY_SIZE;
+        const uint64_t refCount = load_le_int64(entry);
+        const uint64_t next = load_le_int64(entry + sizeof(uint64_t));
+
+        if (((next & CHAINED_DELETED_MASK) == 0)
+            && ((next & CHAINED_FIRST_MASK) != 0)
+            && (refCount > 0))
+        {
+          records.push_back(make_pair(first + e, refCount));
+          converted.mUsedUnits[first + e] = true;
+        }
+      }
     }
-    else
-      entryValidated = true;
 
-    if (itemBytesRead == 0)
+    converted.RebuildFreeSpace();
+
+    //Copy the content of every record, following its chain of entries.
+    vector<bool> visited(entriesCount, false);
+    uint64_t windowFirst = 0, windowCount = 0;
+
+    for (const auto& r : records)
     {
-      if (itemSize > StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE)
-        itemBytesRead = StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE;
+      StoreUnitHeader header;
 
-      else
-        itemBytesRead = itemSize;
+      header.State(StoreUnitHeader::UNIT_RECORD);
+      header.Layout(StoreUnitHeader::LAYOUT_INLINE);
+      header.RefCount(r.second);
 
-      vsEntry.Read(actualSize % StoreEntry::ENTRY_SIZE, itemBytesRead, itemBuffer);
+      converted.SaveUnitHeader(r.first, header);
 
-      actualSize += itemBytesRead;
+      uint64_t entryId = r.first, offset = 0;
+      while ((entryId < entriesCount) && ! visited[entryId])
+      {
+        if ((entryId < windowFirst) || (entryId >= windowFirst + windowCount))
+        {
+          windowFirst = entryId;
+          windowCount = min(windowEntries, entriesCount - entryId);
+          source.Read(windowFirst * CHAINED_ENTRY_SIZE,
+                      windowCount * CHAINED_ENTRY_SIZE,
+                      window.get());
+        }
+
+        const uint8_t* const entry = window.get() + (entryId - windowFirst) * CHAINED_ENTRY_SIZE;
+        const uint64_t next = load_le_int64(entry + sizeof(uint64_t));
+
+        if (((next & CHAINED_DELETED_MASK) != 0)
+            || (((next & CHAINED_FIRST_MASK) != 0) != (entryId == r.first)))
+        {
+          break;
+        }
+
+        visited[entryId] = true;
+
+        converted.WriteRecord(r.first, offset, CHAINED_DATA_SIZE, entry + CHAINED_DATA_OFF);
+        offset += CHAINED_DATA_SIZE;
+
+        entryId = next & ~(CHAINED_DELETED_MASK | CHAINED_FIRST_MASK);
+        if (entryId == CHAINED_LAST_ENTRY)
+          break;
+      }
     }
-    else
+
+    converted.mUnitsCache.Flush();
+    converted.mUnitsContainer->Flush();
+
+    convertedSize = converted.mUnitsContainer->Size();
+  }
+
+  const uint64_t filesCount = (convertedSize + maxFileSize - 1) / maxFileSize;
+  {
+    uint8_t content[sizeof filesCount];
+    store_le_int64(filesCount, content);
+
+    File mark((string(baseName) + PS_VS_CONVERTED_MARK).c_str(),
+              WH_FILECREATE | WH_FILETRUNC | WH_FILEWRITE);
+
+    mark.Write(0, content, sizeof content);
+    mark.Sync();
+  }
+
+  mUnitsContainer.reset();
+  replace_converted_files(baseName, filesCount);
+
+  mUnitsContainer.reset(new FileContainer(baseName, maxFileSize, filesCount, false));
+}
+
+
+void
+VariableSizeStore::PrepareToCheckStorage()
+{
+  assert(mUsedUnits.size() == 0);
+  assert(mUnitsCount > 0);
+
+  mUsedUnits.resize(mUnitsCount, false);
+  mUsedUnits[0] = true; //The first unit is always in use. It holds the
+                        //store's header.
+}
+
+
+bool
+VariableSizeStore::CheckRecordSpace(const uint64_t   record,
+                                    const uint64_t   recordSize,
+                                    const bool       markUnits)
+{
+  if ((record == NIL_UNIT) || (record >= mUnitsCount) || mUsedUnits[record])
+    return false;
+
+  const StoreUnitHeader header = LoadUnitHeader(record);
+
+  if ((header.State() != StoreUnitHeader::UNIT_RECORD) || (header.RefCount() == 0))
+    return false;
+
+  vector<pair<uint64_t, uint64_t>> extents;
+  extents.push_back(make_pair(record, 1));
+
+  uint64_t capacity = 0;
+  switch (header.Layout())
+  {
+  case StoreUnitHeader::LAYOUT_INLINE:
+    capacity = StoreUnitHeader::INLINE_SIZE;
+    break;
+
+  case StoreUnitHeader::LAYOUT_EXTENT:
+    extents.push_back(make_pair(header.ExtentUnit(), header.ExtentUnitsCount()));
+    capacity = header.ExtentUnitsCount() * UNIT_SIZE;
+
+    if ((header.ExtentUnitsCount() > LARGE_EXTENT_UNITS)
+        || ! is_power_of_two(header.ExtentUnitsCount()))
     {
-      assert(itemBytesRead < itemSize);
-      assert(actualSize % StoreEntry::ENTRY_SIZE == 0);
+      return false;
+    }
+    break;
 
-      vsEntry.Read(actualSize % StoreEntry::ENTRY_SIZE,
-                   itemSize - itemBytesRead,
-                   itemBuffer + itemBytesRead);
+  case StoreUnitHeader::LAYOUT_DIRECTORY:
+    extents.push_back(make_pair(header.ExtentUnit(), header.ExtentUnitsCount()));
+    capacity = header.DirectoryExtentsCount() * LARGE_EXTENT_SIZE;
 
-      actualSize += itemSize - itemBytesRead;
-      itemBytesRead = itemSize;
+    if ((header.ExtentUnitsCount() > mUnitsCount)
+        || ! is_power_of_two(header.ExtentUnitsCount())
+        || (header.ExtentUnit() > mUnitsCount - header.ExtentUnitsCount())
+        || (header.DirectoryExtentsCount()
+            > header.ExtentUnitsCount() * (UNIT_SIZE / DIRECTORY_ENTRY_SIZE)))
+    {
+      return false;
     }
 
-    if (itemBytesRead == itemSize)
+    for (uint64_t e = 0; e < header.DirectoryExtentsCount(); ++e)
     {
-      ++itemsChecked;
-      itemBytesRead = 0;
+      uint8_t entry[DIRECTORY_ENTRY_SIZE];
+      ReadUnits(header.ExtentUnit(), e * DIRECTORY_ENTRY_SIZE, sizeof entry, entry);
 
-      if ( !validator(itemBuffer))
-        return false;
+      extents.push_back(make_pair(load_le_int64(entry), _SC(uint64_t, LARGE_EXTENT_UNITS)));
+    }
+    break;
+
+  default:
+    return false;
+  }
+
+  if (capacity < recordSize)
+    return false;
+
+  //Every unit should be in the store and be used only once.
+  vector<uint64_t> marked;
+  bool result = true;
+  for (const auto& extent : extents)
+  {
+    if ((extent.first == NIL_UNIT)
+        || (extent.second == 0)
+        || (extent.second > mUnitsCount)
+        || (extent.first > mUnitsCount - extent.second))
+    {
+      result = false;
+      break;
     }
 
-    if ((itemsChecked < itemsCount) && (actualSize % StoreEntry::ENTRY_SIZE == 0))
+    for (uint64_t u = extent.first; result && (u < extent.first + extent.second); ++u)
     {
-      prevEntry = currentEntry;
-      currentEntry = vsEntry.NextEntry();
+      if (mUsedUnits[u])
+        result = false;
 
-      if (currentEntry >= mEntriesCount
-          || mUsedEntries[currentEntry])
+      else
       {
-        return false;
+        mUsedUnits[u] = true;
+        marked.push_back(u);
       }
-      else
-        entriesUsed.push_back(currentEntry);
-
-      mEntriesContainer.get()->Read(currentEntry * sizeof vsEntry,
-                                    sizeof vsEntry,
-                                    _RC(uint8_t*, &vsEntry));
-      entryValidated = false;
     }
   }
 
-  if (actualSize != recordSize)
+  if ( ! result || ! markUnits)
+  {
+    for (const auto u : marked)
+      mUsedUnits[u] = false;
+  }
+
+  return result;
+}
+
+
+bool
+VariableSizeStore::CheckArrayEntry(const uint64_t         record,
+                                   const uint64_t         recordSize,
+                                   const DBS_FIELD_TYPE   itemType)
+{
+  if (_SC(int64_t, recordSize) <= Serializer::Size(itemType, true) - 1)
+    return false;
+
+  else if ( ! CheckRecordSpace(record, recordSize, false))
+    return false;
+
+  const uint_t itemSize = Serializer::Size(itemType, false);
+
+  const Serializer::VALUE_VALIDATOR validator = Serializer::SelectValidator(itemType);
+
+  uint8_t temp[sizeof(uint64_t)];
+  ReadRecord(record, 0, sizeof temp, temp);
+
+  const uint64_t itemsCount = load_le_int64(temp);
+  if ((itemsCount == 0)
+      || ((recordSize - sizeof(uint64_t)) % itemSize != 0)
+      || ((recordSize - sizeof(uint64_t)) / itemSize != itemsCount))
+  {
     return false;
+  }
 
-  for (size_t i = 0; i < entriesUsed.size(); ++i)
-    mUsedEntries[entriesUsed[i]] = true;
+  const uint64_t chunkItems = COPY_BUFFER_SIZE / itemSize;
+  unique_ptr<uint8_t[]> buffer(new uint8_t[chunkItems * itemSize]);
 
-  return true;
+  for (uint64_t item = 0; item < itemsCount; item += chunkItems)
+  {
+    const uint64_t count = min(chunkItems, itemsCount - item);
+
+    ReadRecord(record, sizeof(uint64_t) + item * itemSize, count * itemSize, buffer.get());
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      if ( ! validator(buffer.get() + i * itemSize))
+        return false;
+    }
+  }
+
+  return CheckRecordSpace(record, recordSize, true);
 }
 
 
 bool
-VariableSizeStore::CheckTextEntry(const uint64_t   recordFirstEntry,
+VariableSizeStore::CheckTextEntry(const uint64_t   record,
                                   const uint64_t   recordSize)
 {
   if (_SC(int64_t, recordSize) <= Serializer::Size(T_TEXT, false) - 1)
     return false;
 
-  uint64_t currentEntry = recordFirstEntry;
-  uint64_t prevEntry = 0;
-  StoreEntry vsEntry;
-  vector<uint64_t> entriesUsed;
-
-  if ((recordFirstEntry >= mUsedEntries.size()) || mUsedEntries[currentEntry])
-    return false;
-
-  entriesUsed.push_back(currentEntry);
-  mEntriesContainer.get()->Read(currentEntry * sizeof vsEntry,
-                                sizeof vsEntry,
-                                _RC(uint8_t*, &vsEntry));
-  if (vsEntry.IsDeleted())
+  else if ( ! CheckRecordSpace(record, recordSize, false))
     return false;
 
-  uint8_t temp[StoreEntry::ENTRY_SIZE];
-  vsEntry.Read(0, sizeof temp, temp);
+  uint8_t temp[RowFieldText::CACHE_META_DATA_SIZE];
+  ReadRecord(record, 0, sizeof temp, temp);
 
   const uint32_t charsCount = load_le_int32(temp);
   const uint32_t charIndex = load_le_int32(temp + sizeof(uint32_t));
@@ -289,989 +636,991 @@ VariableSizeStore::CheckTextEntry(const uint64_t   recordFirstEntry,
   if (charsCount == 0)
     return false;
 
+  unique_ptr<uint8_t[]> buffer(new uint8_t[COPY_BUFFER_SIZE]);
+  uint64_t bufferStart = 0, bufferValid = 0;
+
   uint32_t checkedChars = 0;
-  uint32_t actualSize = RowFieldText::CACHE_META_DATA_SIZE;
+  uint64_t actualSize = RowFieldText::CACHE_META_DATA_SIZE;
 
-  uint8_t readCodeUnits = 0;
-  uint8_t codeUnitsCount = 0;
-  uint8_t codeUnits[7]; //UTF-8 has a maximum of 6 code units per
-  bool entryValidated = false;
   while (checkedChars < charsCount)
   {
-    const bool lastEntry = (recordSize - actualSize)
-        <= (StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE);
-
-    if ( !entryValidated
-        && !is_entry_valid(vsEntry, prevEntry, currentEntry == recordFirstEntry, lastEntry))
+    //UTF-8 has a maximum of 6 code units per character.
+    if ((actualSize + 6 > bufferStart + bufferValid)
+        && (bufferStart + bufferValid < recordSize))
     {
-      return false;
-    }
-    else
-      entryValidated = true;
+      bufferStart = actualSize;
+      bufferValid = min<uint64_t>(COPY_BUFFER_SIZE, recordSize - actualSize);
 
-    if (readCodeUnits == 0)
-    {
-      codeUnitsCount = wh_utf8_cu_count(temp[actualSize % StoreEntry::ENTRY_SIZE]);
-      if ((codeUnitsCount == 0) || (actualSize + codeUnitsCount > recordSize))
-      {
-        return false;
-      }
+      ReadRecord(record, bufferStart, bufferValid, buffer.get());
+    }
 
-      else if (checkedChars == charIndex
-               && charOffset != (actualSize - RowFieldText::CACHE_META_DATA_SIZE))
-      {
-        return false;
-      }
+    if (actualSize >= bufferStart + bufferValid)
+      return false;
 
-      if (codeUnitsCount > StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE)
-      {
-        readCodeUnits = StoreEntry::ENTRY_SIZE - actualSize % StoreEntry::ENTRY_SIZE;
-      }
-      else
-        readCodeUnits = codeUnitsCount;
+    const uint8_t* const codeUnits = buffer.get() + (actualSize - bufferStart);
+    const uint_t codeUnitsCount = wh_utf8_cu_count(codeUnits[0]);
 
-      memcpy(codeUnits, temp + actualSize % StoreEntry::ENTRY_SIZE, readCodeUnits);
+    if ((codeUnitsCount == 0) || (actualSize + codeUnitsCount > recordSize))
+      return false;
 
-      actualSize += readCodeUnits;
-    }
-    else
+    else if ((checkedChars == charIndex)
+             && (charOffset != (actualSize - RowFieldText::CACHE_META_DATA_SIZE)))
     {
-      assert(readCodeUnits < codeUnitsCount);
-      assert(actualSize % StoreEntry::ENTRY_SIZE == 0);
-
-      memcpy(codeUnits + readCodeUnits,
-             temp + actualSize % StoreEntry::ENTRY_SIZE,
-             codeUnitsCount - readCodeUnits);
-
-      actualSize += codeUnitsCount - readCodeUnits;
-      readCodeUnits = codeUnitsCount;
+      return false;
     }
 
     try
     {
-      if (readCodeUnits == codeUnitsCount)
-      {
-        uint32_t codePoint;
-        wh_load_utf8_cp(codeUnits, &codePoint);
-
-        //Throw an exception if the code point is not Unicode valid.
-        DChar validateCodePoint(codePoint);
+      uint32_t codePoint;
+      wh_load_utf8_cp(codeUnits, &codePoint);
 
-        ++checkedChars;
-        readCodeUnits = codeUnitsCount = 0;
-      }
+      //Throw an exception if the code point is not Unicode valid.
+      DChar validateCodePoint(codePoint);
     }
     catch (...)
     {
       return false;
     }
 
-    if ((checkedChars < charsCount) && (actualSize % StoreEntry::ENTRY_SIZE == 0))
-    {
-      prevEntry = currentEntry;
-      currentEntry = vsEntry.NextEntry();
-
-      if ((currentEntry >= mEntriesCount) || mUsedEntries[currentEntry])
-      {
-        return false;
-      }
-      else
-        entriesUsed.push_back(currentEntry);
-
-      mEntriesContainer.get()->Read(currentEntry * sizeof vsEntry,
-                                    sizeof vsEntry,
-                                    _RC(uint8_t*, &vsEntry));
-      vsEntry.Read(0, sizeof temp, temp);
-    }
+    ++checkedChars;
+    actualSize += codeUnitsCount;
   }
 
   if (actualSize != recordSize)
     return false;
 
-  for (size_t i = 0; i < entriesUsed.size(); ++i)
-    mUsedEntries[entriesUsed[i]] = true;
-
-  return true;
+  return CheckRecordSpace(record, recordSize, true);
 }
 
 
 void
 VariableSizeStore::ConcludeStorageCheck()
 {
-  assert(mUsedEntries[0]);
-  assert(mUsedEntries.size() == mEntriesCount);
+  assert(mUsedUnits[0]);
+  assert(mUsedUnits.size() == mUnitsCount);
 
-  while (mEntriesCount > 0)
-  {
-    if (mUsedEntries[mEntriesCount - 1])
-      break;
+  RebuildFreeSpace();
+  Flush();
+}
 
-    --mEntriesCount;
-  }
 
-  const uint64_t containerSize = mEntriesCount * sizeof(StoreEntry);
+void
+VariableSizeStore::Flush()
+{
+  LockGuard<Lock> sync(mSync);
 
-  if (containerSize <= mEntriesContainer->Size())
-    mEntriesContainer->Colapse(containerSize, mEntriesContainer->Size());
+  mUnitsCache.Flush();
+}
 
-  else
+
+void
+VariableSizeStore::MarkForRemoval()
+{
+  mUnitsContainer->MarkForRemoval();
+}
+
+
+uint64_t
+VariableSizeStore::AddRecord(const uint8_t* buffer, const uint64_t size)
+{
+  assert(mUsedUnits.size() == 0);
+
+  LockGuard<Lock> sync(mSync);
+
+  const uint64_t record = NewRecord();
+
+  if (size > 0)
   {
-    assert(false);
+    assert(buffer != nullptr);
+
+    WriteRecord(record, 0, size, buffer);
   }
 
-  assert(mEntriesCount >= 1);
+  return record;
+}
 
-  mUsedEntries.resize(mEntriesCount);
 
-  StoreEntry templateEntry;
+uint64_t
+VariableSizeStore::AddRecord(VariableSizeStore& sourceStore,
+                             uint64_t           sourceRecord,
+                             uint64_t           sourceOffset,
+                             uint64_t           sourceSize)
+{
+  assert(mUsedUnits.size() == 0);
 
-  mEntriesContainer.get()->Read(0, sizeof templateEntry, _RC(uint8_t*, &templateEntry));
+  LockGuard<Lock> sync(mSync);
 
-  templateEntry.MarkAsDeleted(true);
-  templateEntry.MarkAsFirstEntry(false);
-  templateEntry.PrevEntry(0);
+  const uint64_t record = NewRecord();
 
-  templateEntry.NextEntry(StoreEntry::LAST_DELETED_ENTRY);
-  mFirstFreeEntry = StoreEntry::LAST_DELETED_ENTRY;
+  sync.unlock();
 
-  uint64_t lastFreeEntry = 0, currentEntry = 1;
-  while (currentEntry < mUsedEntries.size())
-  {
-    if (mUsedEntries[currentEntry])
-    {
-      currentEntry++;
-      continue;
-    }
+  if (sourceSize > 0)
+    UpdateRecord(record, 0, sourceStore, sourceRecord, sourceOffset, sourceSize);
 
-    templateEntry.NextEntry(currentEntry);
+  return record;
+}
 
-    if (mFirstFreeEntry == StoreEntry::LAST_DELETED_ENTRY)
-      mFirstFreeEntry = currentEntry;
 
-    mEntriesContainer.get()->Write(lastFreeEntry * sizeof templateEntry,
-                                   sizeof templateEntry,
-                                   _RC(uint8_t*, &templateEntry));
+uint64_t
+VariableSizeStore::AddRecord(IDataContainer& sourceContainer,
+                             uint64_t        sourceOffset,
+                             uint64_t        sourceSize)
+{
+  assert(mUsedUnits.size() == 0);
 
-    templateEntry.PrevEntry(lastFreeEntry);
-    templateEntry.NextEntry(StoreEntry::LAST_DELETED_ENTRY);
+  LockGuard<Lock> sync(mSync);
 
-    lastFreeEntry = currentEntry++;
-  }
+  const uint64_t record = NewRecord();
 
-  mEntriesContainer.get()->Write(lastFreeEntry * sizeof templateEntry,
-                                 sizeof templateEntry,
-                                 _RC(uint8_t*, &templateEntry));
+  sync.unlock();
 
-  _placement_new(_RC(void*, &mEntriesCache), BlockCache());
+  if (sourceSize > 0)
+    UpdateRecord(record, 0, sourceContainer, sourceOffset, sourceSize);
 
-  uint_t blkSize = DBSSettings().mVLStoreCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mVLStoreCacheBlkCount;
+  return record;
+}
 
-  assert((blkSize != 0) && (blkCount != 0));
 
-  while (blkSize < sizeof(StoreEntry))
-    blkSize *= 2;
+void
+VariableSizeStore::GetRecord(uint64_t  record,
+                             uint64_t  offset,
+                             uint64_t  size,
+                             uint8_t*  buffer)
+{
+  assert(mUsedUnits.size() == 0);
 
-  mEntriesCache.Init( *this, sizeof(StoreEntry), blkSize, blkCount, false);
+  LockGuard<Lock> sync(mSync);
+
+  ReadRecord(record, offset, size, buffer);
 }
 
+
 void
-VariableSizeStore::FinishInit(const bool nonPersitentData)
+VariableSizeStore::UpdateRecord(uint64_t       record,
+                                uint64_t       offset,
+                                uint64_t       size,
+                                const uint8_t* buffer)
 {
-  if (mEntriesCount == 0)
-  {
-    StoreEntry entry;
+  assert(mUsedUnits.size() == 0);
 
-    entry.MarkAsDeleted(true);
-    entry.MarkAsFirstEntry(false);
+  LockGuard<Lock> sync(mSync);
 
-    entry.PrevEntry(0);
-    entry.NextEntry(StoreEntry::LAST_DELETED_ENTRY);
+  WriteRecord(record, offset, size, buffer);
+}
 
-    mEntriesContainer.get()->Write(0, sizeof entry, _RC(uint8_t*, &entry));
 
-    mEntriesCount++;
-  }
+void
+VariableSizeStore::UpdateRecord(uint64_t           record,
+                                uint64_t           offset,
+                                VariableSizeStore& sourceStore,
+                                uint64_t           sourceRecord,
+                                uint64_t           sourceOffset,
+                                uint64_t           sourceSize)
+{
+  assert(mUsedUnits.size() == 0);
 
-  uint_t blkSize = DBSSettings().mVLStoreCacheBlkSize;
-  const uint_t blkCount = DBSSettings().mVLStoreCacheBlkCount;
+  DoubleLockGuard<Lock> sync(mSync, sourceStore.mSync);
 
-  assert((blkSize != 0) && (blkCount != 0));
+  //Make room first, the source might be this very record.
+  WriteRecord(record, offset, 0, nullptr);
+  GrowRecord(record, offset + sourceSize);
+
+  unique_ptr<uint8_t[]> buffer(new uint8_t[min<uint64_t>(sourceSize, COPY_BUFFER_SIZE)]);
+  while (sourceSize > 0)
+  {
+    const uint64_t chunkSize = min<uint64_t>(sourceSize, COPY_BUFFER_SIZE);
+
+    sourceStore.ReadRecord(sourceRecord, sourceOffset, chunkSize, buffer.get());
+    WriteRecord(record, offset, chunkSize, buffer.get());
+
+    sourceSize -= chunkSize, sourceOffset += chunkSize, offset += chunkSize;
+  }
+}
 
-  while (blkSize < sizeof(StoreEntry))
-    blkSize *= 2;
 
-  mEntriesCache.Init( *this, sizeof(StoreEntry), blkSize, blkCount, nonPersitentData);
+void
+VariableSizeStore::UpdateRecord(uint64_t         record,
+                                uint64_t         offset,
+                                IDataContainer&  sourceContainer,
+                                uint64_t         sourceOffset,
+                                uint64_t         sourceSize)
+{
+  assert(mUsedUnits.size() == 0);
+
+  LockGuard<Lock> sync(mSync);
 
-  StoredItem cachedItem = mEntriesCache.RetriveItem(0);
-  const StoreEntry* const entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+  WriteRecord(record, offset, 0, nullptr);
+  GrowRecord(record, offset + sourceSize);
 
-  //TBD: What we should with these? Leave them like this for now, maybe we are
-  //     in the middle of a repair.
-  //assert(entry->IsDeleted());
-  //assert(entry->IsFirstEntry() == false);
+  unique_ptr<uint8_t[]> buffer(new uint8_t[min<uint64_t>(sourceSize, COPY_BUFFER_SIZE)]);
+  while (sourceSize > 0)
+  {
+    const uint64_t chunkSize = min<uint64_t>(sourceSize, COPY_BUFFER_SIZE);
 
-  mFirstFreeEntry = entry->NextEntry();
+    sourceContainer.Read(sourceOffset, chunkSize, buffer.get());
+    WriteRecord(record, offset, chunkSize, buffer.get());
 
-  assert((mEntriesContainer->Size() % sizeof(StoreEntry)) == 0);
-  assert(mEntriesCount > 0);
+    sourceSize -= chunkSize, sourceOffset += chunkSize, offset += chunkSize;
+  }
 }
 
 
 void
-VariableSizeStore::Flush()
+VariableSizeStore::IncrementRecordRef(const uint64_t record)
 {
   LockGuard<Lock> sync(mSync);
 
-  mEntriesCache.Flush();
-}
+  StoreUnitHeader header = LoadRecordHeader(record);
 
+  assert(header.RefCount() > 0);
 
-void
-VariableSizeStore::MarkForRemoval()
-{
-  mEntriesContainer.get()->MarkForRemoval();
+  header.RefCount(header.RefCount() + 1);
+  SaveUnitHeader(record, header);
 }
 
 
-uint64_t
-VariableSizeStore::AddRecord(const uint8_t* buffer, const uint64_t size)
+void
+VariableSizeStore::DecrementRecordRef(const uint64_t record)
 {
-  assert(mUsedEntries.size() == 0);
-
   LockGuard<Lock> sync(mSync);
 
-  uint64_t resultEntry = AllocateEntry(0);
-  StoredItem cachedItem = mEntriesCache.RetriveItem(resultEntry);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-  entry->MarkAsDeleted(false);
-  entry->MarkAsFirstEntry(true);
-
-  entry->NextEntry(StoreEntry::LAST_CHAINED_ENTRY);
-  entry->PrevEntry(StoreEntry::FIRST_PREV_ENTRY);
+  StoreUnitHeader header = LoadRecordHeader(record);
 
-  sync.unlock();
+  uint64_t refCount = header.RefCount();
 
-  if ((resultEntry != 0) && (size > 0))
-  {
-    assert(buffer != nullptr);
+  assert(refCount > 0);
 
-    UpdateRecord(resultEntry, 0, size, buffer);
-  }
+  header.RefCount(--refCount);
+  SaveUnitHeader(record, header);
 
-  return resultEntry;
+  if (refCount == 0)
+    RemoveRecord(record);
 }
 
 
 uint64_t
-VariableSizeStore::AddRecord(VariableSizeStore& sourceStore,
-                             uint64_t           sourceFirstEntry,
-                             uint64_t           sourceOffset,
-                             uint64_t           sourceSize)
+VariableSizeStore::Size() const
 {
-  assert(mUsedEntries.size() == 0);
-
-  LockGuard<Lock> sync(mSync);
-
-  uint64_t resultEntry = AllocateEntry(0);
-  StoredItem cachedItem = mEntriesCache.RetriveItem(resultEntry);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-  entry->MarkAsDeleted(false);
-  entry->MarkAsFirstEntry(true);
+  LockGuard<Lock> sync(_CC(Lock&, mSync));
 
-  entry->NextEntry(StoreEntry::LAST_CHAINED_ENTRY);
-  entry->PrevEntry(StoreEntry::FIRST_PREV_ENTRY);
+  if (mUnitsContainer.get() == nullptr)
+    return 0;
 
-  sync.unlock();
+  return mUnitsContainer->Size();
+}
 
-  if ((resultEntry != 0) && (sourceSize > 0))
-  {
-    UpdateRecord(resultEntry, 0, sourceStore, sourceFirstEntry, sourceOffset, sourceSize);
-  }
 
-  return resultEntry;
+BlockCacheStats
+VariableSizeStore::CacheStatistics() const
+{
+  return mUnitsCache.Statistics();
 }
 
 
-uint64_t
-VariableSizeStore::AddRecord(IDataContainer& sourceContainer,
-                             uint64_t        sourceOffset,
-                             uint64_t        sourceSize)
+void
+VariableSizeStore::IOStatistics(uint64_t* const outRead, uint64_t* const outWritten) const
 {
-  assert(mUsedEntries.size() == 0);
-
-  LockGuard<Lock> sync(mSync);
+  LockGuard<Lock> sync(_CC(Lock&, mSync));
 
-  uint64_t resultEntry = AllocateEntry(0);
-  StoredItem cachedItem = mEntriesCache.RetriveItem(resultEntry);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+  *outRead = *outWritten = 0;
+  if (mUnitsContainer.get() == nullptr)
+    return;
 
-  entry->MarkAsDeleted(false);
-  entry->MarkAsFirstEntry(true);
+  *outRead    = mUnitsContainer->BytesRead();
+  *outWritten = mUnitsContainer->BytesWritten();
+}
 
-  entry->NextEntry(StoreEntry::LAST_CHAINED_ENTRY);
-  entry->PrevEntry(StoreEntry::FIRST_PREV_ENTRY);
 
-  sync.unlock();
+void
+VariableSizeStore::StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* from)
+{
+  if (firstItem + itemsCount > mUnitsCount)
+    itemsCount = mUnitsCount - firstItem;
 
-  if ((resultEntry != 0) && (sourceSize > 0))
-    UpdateRecord(resultEntry, 0, sourceContainer, sourceOffset, sourceSize);
+  const uint64_t start = firstItem * UNIT_SIZE;
+  const uint64_t count = itemsCount * UNIT_SIZE;
 
-  return resultEntry;
+  mUnitsContainer->Write(start, count, from);
 }
 
 
 void
-VariableSizeStore::GetRecord(uint64_t  recordFirstEntry,
-                             uint64_t  offset,
-                             uint64_t  size,
-                             uint8_t*  buffer)
+VariableSizeStore::StoreBlocks(uint64_t               firstItem,
+                               const uint_t           itemsPerBlock,
+                               const uint8_t* const*  blocks,
+                               const uint_t           blocksCount)
 {
-  assert(mUsedEntries.size() == 0);
-
-  LockGuard<Lock> sync(mSync);
-  do
-  {
+  const uint64_t start = firstItem * UNIT_SIZE;
 
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  vector<WIOVec> vecs;
+  vecs.reserve(blocksCount);
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
+  for (uint_t b = 0; (b < blocksCount) && (firstItem < mUnitsCount); ++b)
+  {
+    const uint64_t itemsCount = min<uint64_t>(itemsPerBlock, mUnitsCount - firstItem);
+    const WIOVec vec = { blocks[b], _SC(uint_t, itemsCount * UNIT_SIZE) };
 
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+    vecs.push_back(vec);
+    firstItem += itemsCount;
+  }
 
-    assert(entry->IsDeleted() == false);
+  mUnitsContainer->Write(start, vecs.data(), vecs.size());
+}
 
-    if (offset < entry->Size())
-      break;
 
-    offset -= entry->Size();
-    recordFirstEntry = entry->NextEntry();
-  } while (true);
+void
+VariableSizeStore::RetrieveItems(uint64_t    firstItem,
+                                 uint_t      itemsCount,
+                                 uint8_t*    to)
+{
+  if (firstItem + itemsCount > mUnitsCount)
+    itemsCount = mUnitsCount - firstItem;
 
-  while (size > 0)
-  {
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  const uint64_t start = firstItem * UNIT_SIZE;
+  const uint64_t count = itemsCount * UNIT_SIZE;
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
+  mUnitsContainer->Read(start, count, to);
+}
 
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
 
-    assert(entry->IsDeleted() == false);
+StoreUnitHeader
+VariableSizeStore::LoadUnitHeader(const uint64_t unit)
+{
+  assert(unit < mUnitsCount);
 
-    const uint64_t chunkSize = min(size, entry->Size() - offset);
-    entry->Read(offset, chunkSize, buffer);
+  StoreUnitHeader header;
+  ReadUnits(unit, 0, sizeof header, _RC(uint8_t*, &header));
 
-    size -= chunkSize, buffer += chunkSize;
-    offset = (offset + chunkSize) % entry->Size();
-    recordFirstEntry = entry->NextEntry();
-  }
+  return header;
 }
 
+
 void
-VariableSizeStore::UpdateRecord(uint64_t       recordFirstEntry,
-                                uint64_t       offset,
-                                uint64_t       size,
-                                const uint8_t* buffer)
+VariableSizeStore::SaveUnitHeader(const uint64_t unit, const StoreUnitHeader& header)
 {
-  assert(mUsedEntries.size() == 0);
-
-  uint64_t prevEntry = recordFirstEntry;
+  assert((unit != NIL_UNIT) && (unit < mUnitsCount));
 
-  LockGuard<Lock> sync(mSync);
-  do
-  {
-
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-    {
-      if (offset != 0)
-        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  WriteUnits(unit, 0, sizeof header, _RC(const uint8_t*, &header));
+}
 
-      else
-        break;
-    }
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
+void
+VariableSizeStore::StoreHeader()
+{
+  uint8_t header[UNIT_SIZE];
 
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+  memset(header, 0, sizeof header);
+  memcpy(header + PS_VS_SIG_OFF, PS_VS_SIGNATURE, PS_VS_SIG_LEN);
+  store_le_int64(mFreeMapUnit, header + PS_VS_FREE_MAP_OFF);
 
-    assert(entry->IsDeleted() == false);
+  WriteUnits(0, 0, sizeof header, header);
+}
 
-    if (offset < entry->Size())
-      break;
 
-    offset -= entry->Size();
-    prevEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
-  } while (true);
+/* The units of a cache block are adjacent in its memory, so the content is
+   copied a block at a time. */
+void
+VariableSizeStore::ReadUnits(uint64_t unit, uint64_t offset, uint64_t size, uint8_t* buffer)
+{
+  unit += offset / UNIT_SIZE;
+  offset %= UNIT_SIZE;
 
   while (size > 0)
   {
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      recordFirstEntry = AllocateEntry(prevEntry);
-
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
+    assert(unit < mUnitsCount);
 
-    StoreEntry* const entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+    StoredItem cachedItem = mUnitsCache.RetriveItem(unit);
 
-    assert(entry->IsDeleted() == false);
+    const uint64_t blockUnits = mUnitsPerBlock - unit % mUnitsPerBlock;
+    const uint64_t chunkSize = min(size, blockUnits * UNIT_SIZE - offset);
 
-    const uint64_t chunkSize = entry->Write(offset, size, buffer);
-    assert(chunkSize > 0);
+    memcpy(buffer, cachedItem.GetDataForRead() + offset, chunkSize);
 
     size -= chunkSize, buffer += chunkSize;
-
-    offset = (offset + chunkSize) % entry->Size();
-
-    prevEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
+    unit += blockUnits, offset = 0;
   }
 }
 
 
 void
-VariableSizeStore::UpdateRecord(uint64_t           recordFirstEntry,
-                                uint64_t           offset,
-                                VariableSizeStore& sourceStore,
-                                uint64_t           sourceFirstEntry,
-                                uint64_t           sourceOffset,
-                                uint64_t           sourceSize)
+VariableSizeStore::WriteUnits(uint64_t unit, uint64_t offset, uint64_t size, const uint8_t* buffer)
 {
-  assert(mUsedEntries.size() == 0);
+  unit += offset / UNIT_SIZE;
+  offset %= UNIT_SIZE;
 
-  uint64_t prevEntry = recordFirstEntry;
-  uint64_t sourcePrevEntry = sourceFirstEntry;
-
-  DoubleLockGuard<Lock> sync(mSync, sourceStore.mSync);
-  do
+  while (size > 0)
   {
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-    {
-      if (offset != 0)
-        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+    assert(unit < mUnitsCount);
 
-      else
-        break;
-    }
+    StoredItem cachedItem = mUnitsCache.RetriveItem(unit);
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-    auto entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+    const uint64_t blockUnits = mUnitsPerBlock - unit % mUnitsPerBlock;
+    const uint64_t chunkSize = min(size, blockUnits * UNIT_SIZE - offset);
 
-    assert(entry->IsDeleted() == false);
-
-    if (offset < entry->Size())
-      break;
+    memcpy(cachedItem.GetDataForUpdate() + offset, buffer, chunkSize);
 
-    offset -= entry->Size();
-    prevEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
+    size -= chunkSize, buffer += chunkSize;
+    unit += blockUnits, offset = 0;
+  }
+}
 
-  } while (true);
 
-  do
+static uint64_t
+record_capacity(const StoreUnitHeader& header)
+{
+  switch (header.Layout())
   {
-    if (sourceFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-    {
-      if (sourceOffset != 0)
-        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  case StoreUnitHeader::LAYOUT_INLINE:
+    return StoreUnitHeader::INLINE_SIZE;
 
-      else
-        break;
-    }
+  case StoreUnitHeader::LAYOUT_EXTENT:
+    return header.ExtentUnitsCount() * VariableSizeStore::UNIT_SIZE;
 
-    StoredItem cachedItem = sourceStore.mEntriesCache.RetriveItem(sourceFirstEntry);
-    auto entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+  case StoreUnitHeader::LAYOUT_DIRECTORY:
+    return header.DirectoryExtentsCount() * VariableSizeStore::LARGE_EXTENT_SIZE;
+  }
 
-    assert(entry->IsDeleted() == false);
+  throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+}
 
-    if (sourceOffset < entry->Size())
-      break;
 
-    sourceOffset -= entry->Size();
-    sourceFirstEntry = entry->NextEntry();
-  } while (true);
+/* Call 'op' for every run of adjacent units that holds a part of the
+   record's content, from 'offset' and up to 'size' bytes. */
+template<class OP> void
+VariableSizeStore::VisitRecord(const uint64_t          record,
+                               const StoreUnitHeader&  header,
+                               uint64_t                offset,
+                               uint64_t                size,
+                               OP                      op)
+{
+  assert(offset + size <= record_capacity(header));
 
-  while (sourceSize > 0)
+  switch (header.Layout())
   {
-    if (sourceFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  case StoreUnitHeader::LAYOUT_INLINE:
+    op(record, StoreUnitHeader::InlineDataOffset() + offset, size);
+    break;
 
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      recordFirstEntry = AllocateEntry(prevEntry);
-
-    uint8_t tembuffer[64];
-    uint_t tempValid = 0;
+  case StoreUnitHeader::LAYOUT_EXTENT:
+    op(header.ExtentUnit(), offset, size);
+    break;
 
+  case StoreUnitHeader::LAYOUT_DIRECTORY:
+    while (size > 0)
     {
-      StoredItem cachedItem = sourceStore.mEntriesCache.RetriveItem(sourceFirstEntry);
-      const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+      const uint64_t extent = offset / LARGE_EXTENT_SIZE;
+      const uint64_t extentOffset = offset % LARGE_EXTENT_SIZE;
+      const uint64_t chunkSize = min(size, LARGE_EXTENT_SIZE - extentOffset);
 
+      uint8_t entry[DIRECTORY_ENTRY_SIZE];
+      ReadUnits(header.ExtentUnit(), extent * DIRECTORY_ENTRY_SIZE, sizeof entry, entry);
 
-      assert(entry->Size() <= sizeof tembuffer);
+      op(load_le_int64(entry), extentOffset, chunkSize);
 
-      tempValid = entry->Read(sourceOffset, sourceSize, tembuffer);
-      sourcePrevEntry = sourceFirstEntry;
-      sourceFirstEntry = entry->NextEntry();
+      offset += chunkSize, size -= chunkSize;
     }
+    break;
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-    const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-    assert(entry->IsDeleted() == false);
+  default:
+    assert(false);
+  }
+}
 
-    const uint64_t chunkSize = entry->Write(offset, tempValid, tembuffer);
 
-    assert(chunkSize > 0);
+StoreUnitHeader
+VariableSizeStore::LoadRecordHeader(const uint64_t record)
+{
+  if ((record == NIL_UNIT) || (record >= mUnitsCount))
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
 
-    sourceSize -= chunkSize, offset += chunkSize;
+  const StoreUnitHeader header = LoadUnitHeader(record);
 
-    if (offset >= entry->Size())
-    {
-      prevEntry = recordFirstEntry;
-      recordFirstEntry = entry->NextEntry();
+  if (header.State() != StoreUnitHeader::UNIT_RECORD)
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
 
-      offset -= entry->Size();
-    }
+  return header;
+}
 
-    sourceOffset += chunkSize;
-    if (sourceOffset < entry->Size())
-      sourceFirstEntry = sourcePrevEntry;
 
-    else
-      sourceOffset -= entry->Size();
-  }
+void
+VariableSizeStore::ReadRecord(const uint64_t  record,
+                              uint64_t        offset,
+                              uint64_t        size,
+                              uint8_t*        buffer)
+{
+  const StoreUnitHeader header = LoadRecordHeader(record);
+
+  if (offset + size > record_capacity(header))
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+
+  VisitRecord(record,
+              header,
+              offset,
+              size,
+              [this, &buffer] (const uint64_t unit, const uint64_t from, const uint64_t count)
+              {
+                ReadUnits(unit, from, count, buffer);
+                buffer += count;
+              });
 }
 
+
 void
-VariableSizeStore::UpdateRecord(uint64_t         recordFirstEntry,
-                                uint64_t         offset,
-                                IDataContainer&  sourceContainer,
-                                uint64_t         sourceOffset,
-                                uint64_t         sourceSize)
+VariableSizeStore::WriteRecord(const uint64_t   record,
+                               uint64_t         offset,
+                               uint64_t         size,
+                               const uint8_t*   buffer)
 {
-  assert(mUsedEntries.size() == 0);
+  StoreUnitHeader header = LoadRecordHeader(record);
 
-  uint64_t prevEntry = recordFirstEntry;
+  if (offset > record_capacity(header))
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
 
-  LockGuard<Lock> sync(mSync);
+  else if (size == 0)
+    return;
 
-  do
+  if (offset + size > record_capacity(header))
   {
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-    {
-      if (offset != 0)
-        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+    GrowRecord(record, offset + size);
+    header = LoadUnitHeader(record);
+  }
 
-      else
-        break;
-    }
+  VisitRecord(record,
+              header,
+              offset,
+              size,
+              [this, &buffer] (const uint64_t unit, const uint64_t from, const uint64_t count)
+              {
+                WriteUnits(unit, from, count, buffer);
+                buffer += count;
+              });
+}
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
 
-    const auto entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+/* Records bigger than a large extent get a directory of large extents. The
+   smaller ones move to a twice as big extent when they outgrow their own, so
+   the content copied around stays proportional to the records' sizes. */
+void
+VariableSizeStore::GrowRecord(const uint64_t record, const uint64_t capacity)
+{
+  StoreUnitHeader header = LoadRecordHeader(record);
 
-    assert(entry->IsDeleted() == false);
+  if (capacity <= record_capacity(header))
+    return;
 
-    if (offset < entry->Size())
-      break;
+  if (capacity <= LARGE_EXTENT_SIZE)
+  {
+    const uint_t sizeClass = size_class((capacity + UNIT_SIZE - 1) / UNIT_SIZE);
+    const uint64_t extent = AllocateExtent(sizeClass);
 
-    offset -= entry->Size();
-    prevEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
+    MoveRecordContent(record, header, extent);
 
-  } while (true);
+    header.Layout(StoreUnitHeader::LAYOUT_EXTENT);
+    header.ExtentUnit(extent);
+    header.ExtentUnitsCount(1ull << sizeClass);
 
-  while (sourceSize > 0)
+    SaveUnitHeader(record, header);
+    return;
+  }
+
+  if (header.Layout() != StoreUnitHeader::LAYOUT_DIRECTORY)
   {
-    if (recordFirstEntry == StoreEntry::LAST_CHAINED_ENTRY)
-      recordFirstEntry = AllocateEntry(prevEntry);
+    uint64_t extent;
+
+    if ((header.Layout() == StoreUnitHeader::LAYOUT_EXTENT)
+        && (header.ExtentUnitsCount() == LARGE_EXTENT_UNITS))
+    {
+      extent = header.ExtentUnit();
+    }
+    else
+    {
+      extent = AllocateExtent(LARGE_EXTENT_CLASS);
+      MoveRecordContent(record, header, extent);
+    }
 
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
+    const uint64_t directory = AllocateExtent(0);
 
-    const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+    uint8_t entry[DIRECTORY_ENTRY_SIZE];
+    store_le_int64(extent, entry);
+    WriteUnits(directory, 0, sizeof entry, entry);
 
-    assert(entry->IsDeleted() == false);
+    header.Layout(StoreUnitHeader::LAYOUT_DIRECTORY);
+    header.ExtentUnit(directory);
+    header.ExtentUnitsCount(1);
+    header.DirectoryExtentsCount(1);
+  }
 
-    uint8_t tembuffer[64];
-    uint_t tempValid = MIN(entry->Size() - offset, sourceSize);
+  const uint64_t extentsCount = (capacity + LARGE_EXTENT_SIZE - 1) / LARGE_EXTENT_SIZE;
+  uint64_t directory = header.ExtentUnit();
 
-    assert(entry->Size() < sizeof tembuffer);
+  if (extentsCount * DIRECTORY_ENTRY_SIZE > header.ExtentUnitsCount() * UNIT_SIZE)
+  {
+    const uint64_t usedSize = header.DirectoryExtentsCount() * DIRECTORY_ENTRY_SIZE;
+    const uint_t sizeClass = size_class((extentsCount * DIRECTORY_ENTRY_SIZE + UNIT_SIZE - 1)
+                                          / UNIT_SIZE);
 
-    sourceContainer.Read(sourceOffset, tempValid, tembuffer);
+    unique_ptr<uint8_t[]> entries(new uint8_t[usedSize]);
+    ReadUnits(directory, 0, usedSize, entries.get());
 
-    const uint64_t chunkSize = entry->Write(offset, tempValid, tembuffer);
+    FreeExtent(directory, size_class(header.ExtentUnitsCount()));
 
-    (void)chunkSize;
-    assert(chunkSize == tempValid);
+    directory = AllocateExtent(sizeClass);
+    WriteUnits(directory, 0, usedSize, entries.get());
 
-    sourceSize -= tempValid, sourceOffset += tempValid;
+    header.ExtentUnit(directory);
+    header.ExtentUnitsCount(1ull << sizeClass);
+  }
 
-    offset = (offset + tempValid) % entry->Size();
+  for (uint64_t e = header.DirectoryExtentsCount(); e < extentsCount; ++e)
+  {
+    uint8_t entry[DIRECTORY_ENTRY_SIZE];
+    store_le_int64(AllocateExtent(LARGE_EXTENT_CLASS), entry);
 
-    prevEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
+    WriteUnits(directory, e * DIRECTORY_ENTRY_SIZE, sizeof entry, entry);
   }
+
+  header.DirectoryExtentsCount(extentsCount);
+  SaveUnitHeader(record, header);
 }
 
 
 void
-VariableSizeStore::IncrementRecordRef(const uint64_t recordFirstEntry)
+VariableSizeStore::MoveRecordContent(const uint64_t           record,
+                                     const StoreUnitHeader&   header,
+                                     const uint64_t           toUnit)
 {
-  LockGuard<Lock> sync(mSync);
+  assert(header.Layout() != StoreUnitHeader::LAYOUT_DIRECTORY);
 
-  StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-  const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+  const uint64_t size = record_capacity(header);
+  unique_ptr<uint8_t[]> content(new uint8_t[size]);
 
-  assert(entry->IsFirstEntry());
-  assert(entry->IsDeleted() == false);
-  assert(entry->PrevEntry() > 0);
+  ReadRecord(record, 0, size, content.get());
+  WriteUnits(toUnit, 0, size, content.get());
 
-  entry->PrevEntry(entry->PrevEntry() + 1);
+  ReleaseRecordExtents(header);
 }
 
 
 void
-VariableSizeStore::DecrementRecordRef(const uint64_t recordFirstEntry)
+VariableSizeStore::ReleaseRecordExtents(const StoreUnitHeader& header)
 {
-  LockGuard<Lock> sync(mSync);
-
-  StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-  const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-  assert(entry->IsFirstEntry());
-  assert(entry->IsDeleted() == false);
+  switch (header.Layout())
+  {
+  case StoreUnitHeader::LAYOUT_INLINE:
+    break;
 
-  uint64_t refCount = entry->PrevEntry();
+  case StoreUnitHeader::LAYOUT_EXTENT:
+    FreeExtent(header.ExtentUnit(), size_class(header.ExtentUnitsCount()));
+    break;
 
-  assert(refCount > 0);
+  case StoreUnitHeader::LAYOUT_DIRECTORY:
+    for (uint64_t e = 0; e < header.DirectoryExtentsCount(); ++e)
+    {
+      uint8_t entry[DIRECTORY_ENTRY_SIZE];
+      ReadUnits(header.ExtentUnit(), e * DIRECTORY_ENTRY_SIZE, sizeof entry, entry);
 
-  entry->PrevEntry(--refCount);
+      FreeExtent(load_le_int64(entry), LARGE_EXTENT_CLASS);
+    }
+    FreeExtent(header.ExtentUnit(), size_class(header.ExtentUnitsCount()));
+    break;
 
-  if (refCount == 0)
-    RemoveRecord(recordFirstEntry);
+  default:
+    assert(false);
+  }
 }
 
 
 uint64_t
-VariableSizeStore::Size() const
+VariableSizeStore::NewRecord()
 {
-  LockGuard<Lock> sync(_CC(Lock&, mSync));
-
-  if (mEntriesContainer.get() == nullptr)
-    return 0;
-
-  return mEntriesContainer->Size();
-}
+  const uint64_t record = AllocateExtent(0);
 
+  StoreUnitHeader header;
 
-void
-VariableSizeStore::StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* from)
-{
-  if (firstItem + itemsCount > mEntriesCount)
-    itemsCount = mEntriesCount - firstItem;
+  header.State(StoreUnitHeader::UNIT_RECORD);
+  header.Layout(StoreUnitHeader::LAYOUT_INLINE);
+  header.RefCount(1);
 
-  const uint64_t start = firstItem * sizeof(StoreEntry);
-  const uint64_t count = itemsCount * sizeof(StoreEntry);
+  SaveUnitHeader(record, header);
 
-  mEntriesContainer->Write(start, count, from);
+  return record;
 }
 
 
 void
-VariableSizeStore::RetrieveItems(uint64_t    firstItem,
-                                 uint_t      itemsCount,
-                                 uint8_t*    to)
+VariableSizeStore::RemoveRecord(const uint64_t record)
 {
-  if (firstItem + itemsCount > mEntriesCount)
-    itemsCount = mEntriesCount - firstItem;
+  assert(mUsedUnits.size() == 0);
+
+  const StoreUnitHeader header = LoadRecordHeader(record);
 
-  const uint64_t start = firstItem * sizeof(StoreEntry);
-  const uint64_t count = itemsCount * sizeof(StoreEntry);
+  assert(header.RefCount() == 0);
 
-  mEntriesContainer->Read(start, count, to);
+  ReleaseRecordExtents(header);
+  FreeExtent(record, 0);
 }
 
 
+/* Take the extent from its size class list, or split a bigger one. Only
+   when none is free the store grows. */
 uint64_t
-VariableSizeStore::AllocateEntry(const uint64_t prevEntryId)
+VariableSizeStore::AllocateExtent(const uint_t sizeClass)
 {
-  uint64_t foundFree = mFirstFreeEntry;
-
-  //Try to find a free neighbor of the previous entry;
-  if ((prevEntryId + 1) < mEntriesCount)
-  {
-    StoredItem cachedItem = mEntriesCache.RetriveItem(prevEntryId + 1);
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
-    if (entry->IsDeleted())
-      foundFree = prevEntryId + 1;
-  }
-  else if (prevEntryId > 1)
-  {
-    StoredItem cachedItem = mEntriesCache.RetriveItem(prevEntryId - 1);
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
-    if (entry->IsDeleted())
-      foundFree = prevEntryId - 1;
-  }
-
-  if (foundFree == StoreEntry::LAST_DELETED_ENTRY)
-    foundFree = ExtentFreeList();
+  assert(sizeClass < FREE_CLASSES_COUNT);
 
-  ExtractFromFreeList(foundFree);
-
-  StoredItem cachedItem = mEntriesCache.RetriveItem(foundFree);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-  if (prevEntryId > 0)
+  for (uint_t c = sizeClass; c < FREE_CLASSES_COUNT; ++c)
   {
-    StoredItem prevCachedItem = mEntriesCache.RetriveItem(prevEntryId);
-    StoreEntry* prevEntry = _RC(StoreEntry*, prevCachedItem.GetDataForUpdate());
-
-    const uint64_t prevNext = prevEntry->NextEntry();
-
-    assert(prevEntry->IsDeleted() == false);
-    assert(prevEntry->NextEntry() == StoreEntry::LAST_CHAINED_ENTRY);
+    const uint64_t unit = mFreeHeads[c];
 
-    prevEntry->NextEntry(foundFree);
+    if (unit == NIL_UNIT)
+      continue;
 
-    entry->PrevEntry(prevEntryId);
-    entry->MarkAsFirstEntry(false);
-    entry->NextEntry(prevNext);
+    UnlinkFreeExtent(unit);
 
-    if (entry->NextEntry() != StoreEntry::LAST_CHAINED_ENTRY)
-    {
-      StoredItem nextCachedItem = mEntriesCache.RetriveItem(entry->NextEntry());
-      entry = _RC(StoreEntry*, nextCachedItem.GetDataForUpdate());
+    if (c > sizeClass)
+      FreeUnits(unit + (1ull << sizeClass), (1ull << c) - (1ull << sizeClass));
 
-      entry->PrevEntry(foundFree);
-    }
-  }
-  else
-  {
-    entry->MarkAsFirstEntry(true);
-    entry->PrevEntry(0);
-    entry->NextEntry(StoreEntry::LAST_CHAINED_ENTRY);
+    return unit;
   }
 
-  return foundFree;
+  return ExtendStore(1ull << sizeClass);
 }
 
 
-uint64_t
-VariableSizeStore::ExtentFreeList()
+void
+VariableSizeStore::FreeExtent(const uint64_t unit, const uint_t sizeClass)
 {
-  assert(mFirstFreeEntry == StoreEntry::LAST_DELETED_ENTRY);
-  StoreEntry newEntry;
+  assert(sizeClass < FREE_CLASSES_COUNT);
 
-  newEntry.MarkAsDeleted(true);
-  newEntry.PrevEntry(0);
-  newEntry.NextEntry(StoreEntry::LAST_DELETED_ENTRY);
-
-  newEntry.MarkAsFirstEntry(false);
+  FreeUnits(unit, 1ull << sizeClass);
+}
 
-  const uint64_t insertPos = mEntriesContainer.get()->Size();
 
-  mFirstFreeEntry = insertPos / sizeof(newEntry);
+/* The units are joined with the free extents found right before and after
+   them, then the whole free run is split again in the biggest extents that
+   fit, so the space of the small records could serve the bigger ones. */
+void
+VariableSizeStore::FreeUnits(uint64_t unit, const uint64_t unitsCount)
+{
+  uint64_t end = unit + unitsCount;
 
-  //Flush the current content
-  mEntriesCache.FlushItem(mFirstFreeEntry - 1);
+  for (auto next = mFreeExtents.find(end); next != mFreeExtents.end(); next = mFreeExtents.find(end))
+  {
+    end += 1ull << next->second.mClass;
+    UnlinkFreeExtent(next->first);
+  }
 
-  assert((insertPos % sizeof(newEntry)) == 0);
-  mEntriesContainer->Write(insertPos, sizeof(newEntry), _RC(uint8_t*, &newEntry));
-  ++mEntriesCount;
+  while (true)
+  {
+    auto prev = mFreeExtents.lower_bound(unit);
+    if (prev == mFreeExtents.begin())
+      break;
 
-  //Reload the content of item's block.
-  mEntriesCache.RefreshItem(mFirstFreeEntry);
+    --prev;
+    if (prev->first + (1ull << prev->second.mClass) != unit)
+      break;
 
-  StoredItem cachedItem = mEntriesCache.RetriveItem(0);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+    unit = prev->first;
+    UnlinkFreeExtent(unit);
+  }
 
-  entry->NextEntry(mFirstFreeEntry);
+  while (unit < end)
+  {
+    uint_t sizeClass = 0;
+    while ((sizeClass + 1 < FREE_CLASSES_COUNT) && ((2ull << sizeClass) <= end - unit))
+      ++sizeClass;
 
-  return mFirstFreeEntry;
+    LinkFreeExtent(unit, sizeClass);
+    unit += 1ull << sizeClass;
+  }
 }
 
 
 void
-VariableSizeStore::RemoveRecord(uint64_t recordFirstEntry)
+VariableSizeStore::LinkFreeExtent(const uint64_t unit, const uint_t sizeClass)
 {
-  assert(mUsedEntries.size() == 0);
+  assert(sizeClass < FREE_CLASSES_COUNT);
 
-  StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-  const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+  StoreUnitHeader header;
 
-  (void)entry;
-  assert(entry->IsDeleted() == false);
-  assert(entry->IsFirstEntry());
+  header.State(StoreUnitHeader::UNIT_FREE);
+  header.ExtentUnitsCount(1ull << sizeClass);
+  header.NextFreeUnit(mFreeHeads[sizeClass]);
 
-  while (recordFirstEntry != StoreEntry::LAST_CHAINED_ENTRY)
-  {
-    StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
-    const StoreEntry* entry = _RC(const StoreEntry*, cachedItem.GetDataForRead());
+  SaveUnitHeader(unit, header);
 
-    assert(entry->IsDeleted() == false);
+  FreeExtentLinks& links = mFreeExtents[unit];
 
-    const uint64_t currentEntry = recordFirstEntry;
-    recordFirstEntry = entry->NextEntry();
+  links.mClass = sizeClass;
+  links.mPrev = NIL_UNIT;
+  links.mNext = mFreeHeads[sizeClass];
 
-    AddToFreeList(currentEntry);
-  }
+  if (links.mNext != NIL_UNIT)
+    mFreeExtents[links.mNext].mPrev = unit;
+
+  mFreeHeads[sizeClass] = unit;
+  StoreFreeHead(sizeClass);
 }
 
 
 void
-VariableSizeStore::ExtractFromFreeList(const uint64_t entryId)
+VariableSizeStore::UnlinkFreeExtent(const uint64_t unit)
 {
-  StoredItem cachedItem = mEntriesCache.RetriveItem(entryId);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
-
-  assert(entryId != 0);
-  assert(entry->IsDeleted());
-  assert(entry->IsFirstEntry() == false);
-
-  const uint64_t prevEntry = entry->PrevEntry();
-  const uint64_t nextEntry = entry->NextEntry();
-
-  assert(prevEntry < mEntriesCount);
-  assert((nextEntry == StoreEntry::LAST_DELETED_ENTRY) || (nextEntry < mEntriesCount));
-
-  entry->MarkAsDeleted(false);
-  entry->PrevEntry(0);
-  entry->NextEntry(0);
-
-  cachedItem = mEntriesCache.RetriveItem(prevEntry);
-  entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+  auto it = mFreeExtents.find(unit);
 
-  assert(entry->IsDeleted());
-  assert(entry->IsFirstEntry() == false);
-
-  entry->NextEntry(nextEntry);
+  if (it == mFreeExtents.end())
+  {
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR),
+                       "The free space of a variable size store is corrupted.");
+  }
 
-  if (entryId == mFirstFreeEntry)
-    mFirstFreeEntry = nextEntry;
+  const FreeExtentLinks links = it->second;
+  mFreeExtents.erase(it);
 
-  if (nextEntry != StoreEntry::LAST_DELETED_ENTRY)
+  if (links.mPrev == NIL_UNIT)
+  {
+    mFreeHeads[links.mClass] = links.mNext;
+    StoreFreeHead(links.mClass);
+  }
+  else
   {
-    cachedItem = mEntriesCache.RetriveItem(nextEntry);
-    entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+    StoreUnitHeader header = LoadUnitHeader(links.mPrev);
 
-    assert(entry->IsDeleted());
-    assert(entry->IsFirstEntry() == false);
+    header.NextFreeUnit(links.mNext);
+    SaveUnitHeader(links.mPrev, header);
 
-    entry->PrevEntry(prevEntry);
+    mFreeExtents[links.mPrev].mNext = links.mNext;
   }
+
+  if (links.mNext != NIL_UNIT)
+    mFreeExtents[links.mNext].mPrev = links.mPrev;
 }
 
 
+/* Walk the lists of free extents to find where each one is. */
 void
-VariableSizeStore::AddToFreeList(const uint64_t entryId)
+VariableSizeStore::LoadFreeExtents()
 {
-  assert(mEntriesCount > entryId);
+  mFreeExtents.clear();
 
-  StoredItem cachedItem = mEntriesCache.RetriveItem(entryId);
-  StoreEntry* entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+  for (uint_t c = 0; c < FREE_CLASSES_COUNT; ++c)
+  {
+    uint64_t prev = NIL_UNIT;
 
-  //Just to have a valid initialization
-  StoredItem neighborCachedItem = cachedItem;
-  StoreEntry* neighborEntry = nullptr;
+    for (uint64_t unit = mFreeHeads[c]; unit != NIL_UNIT; )
+    {
+      const StoreUnitHeader header = (unit < mUnitsCount)
+                                       ? LoadUnitHeader(unit)
+                                       : StoreUnitHeader();
 
-  assert(entry > 0);
-  assert(entry->IsDeleted() == false);
+      if ((header.State() != StoreUnitHeader::UNIT_FREE)
+          || (header.ExtentUnitsCount() != (1ull << c))
+          || (mFreeExtents.find(unit) != mFreeExtents.end()))
+      {
+        throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR),
+                           "The free space of a variable size store is corrupted.");
+      }
 
-  entry->MarkAsDeleted(true);
-  entry->MarkAsFirstEntry(false);
+      FreeExtentLinks& links = mFreeExtents[unit];
 
-  //Maybe we are lucky! Check to see if we can link to one of our neighbors!
-  if ((entryId + 1) < mEntriesCount)
-  {
-    neighborCachedItem = mEntriesCache.RetriveItem(entryId + 1);
-    neighborEntry = _RC(StoreEntry*, neighborCachedItem.GetDataForUpdate());
+      links.mClass = c;
+      links.mPrev = prev;
+      links.mNext = header.NextFreeUnit();
 
-    if (neighborEntry->IsDeleted())
-    {
-      assert(neighborEntry->IsFirstEntry() == false);
+      prev = unit;
+      unit = links.mNext;
+    }
+  }
+}
 
-      const uint64_t prevEntry = neighborEntry->PrevEntry();
 
-      neighborEntry->PrevEntry(entryId);
-      entry->PrevEntry(prevEntry);
-      entry->NextEntry(entryId + 1);
+uint64_t
+VariableSizeStore::ExtendStore(const uint64_t unitsCount)
+{
+  const uint64_t firstUnit = mUnitsCount;
 
-      neighborCachedItem = mEntriesCache.RetriveItem(prevEntry);
-      neighborEntry = _RC(StoreEntry*, neighborCachedItem.GetDataForUpdate());
+  //The block of the last unit might be cached, and it holds the new ones too.
+  if (firstUnit > 0)
+    mUnitsCache.FlushItem(firstUnit - 1);
 
-      assert(neighborEntry->IsDeleted());
-      assert(neighborEntry->IsFirstEntry() == false);
+  const uint64_t zeroesSize = min<uint64_t>(unitsCount * UNIT_SIZE, COPY_BUFFER_SIZE);
+  unique_ptr<uint8_t[]> zeroes(new uint8_t[zeroesSize]);
+  memset(zeroes.get(), 0, zeroesSize);
 
-      neighborEntry->NextEntry(entryId);
+  for (uint64_t written = 0; written < unitsCount * UNIT_SIZE; )
+  {
+    const uint64_t chunkSize = min(zeroesSize, unitsCount * UNIT_SIZE - written);
 
-      if (mFirstFreeEntry == (entryId + 1))
-      {
-        assert(prevEntry == 0);
+    mUnitsContainer->Write(firstUnit * UNIT_SIZE + written, chunkSize, zeroes.get());
+    written += chunkSize;
+  }
 
-        mFirstFreeEntry = entryId;
-      }
+  mUnitsCount += unitsCount;
+  mUnitsCache.RefreshItem(firstUnit);
 
-      return;
-    }
-  }
-  else if (entryId > 1)
-  {
-    neighborCachedItem = mEntriesCache.RetriveItem(entryId - 1);
-    neighborEntry = _RC(StoreEntry*, neighborCachedItem.GetDataForUpdate());
+  return firstUnit;
+}
 
-    if (neighborEntry->IsDeleted())
-    {
-      assert(neighborEntry->IsFirstEntry() == false);
 
-      const uint64_t nextEntry = neighborEntry->NextEntry();
+void
+VariableSizeStore::StoreFreeHead(const uint_t sizeClass)
+{
+  if (mFreeMapUnit == NIL_UNIT)
+    return;
 
-      neighborEntry->NextEntry(entryId);
-      entry->NextEntry(nextEntry);
-      entry->PrevEntry(entryId - 1);
+  uint8_t head[sizeof(uint64_t)];
+  store_le_int64(mFreeHeads[sizeClass], head);
 
-      if (nextEntry == StoreEntry::LAST_CHAINED_ENTRY)
-        return;
+  WriteUnits(mFreeMapUnit, sizeClass * sizeof head, sizeof head, head);
+}
 
-      neighborCachedItem = mEntriesCache.RetriveItem(nextEntry);
-      neighborEntry = _RC(StoreEntry*, neighborCachedItem.GetDataForUpdate());
 
-      assert(neighborEntry->IsDeleted());
-      assert(neighborEntry->IsFirstEntry() == false);
+/* Put every unit not marked as used in the free lists, then set a new map
+   for them. The lower units are handed out first. */
+void
+VariableSizeStore::RebuildFreeSpace()
+{
+  assert(mUsedUnits.size() == mUnitsCount);
 
-      neighborEntry->PrevEntry(entryId);
+  mFreeMapUnit = NIL_UNIT;
+  fill(begin(mFreeHeads), end(mFreeHeads), NIL_UNIT);
+  mFreeExtents.clear();
 
-      return;
+  vector<pair<uint64_t, uint_t>> extents;
+  for (uint64_t unit = 1; unit < mUnitsCount; )
+  {
+    if (mUsedUnits[unit])
+    {
+      ++unit;
+      continue;
     }
-  }
 
-  //No neighbors! Let's add it at the front of the free entries chain.
-  if (mFirstFreeEntry != StoreEntry::LAST_CHAINED_ENTRY)
-  {
-    neighborCachedItem = mEntriesCache.RetriveItem(mFirstFreeEntry);
-    neighborEntry = _RC(StoreEntry*, neighborCachedItem.GetDataForUpdate());
+    uint64_t end = unit;
+    while ((end < mUnitsCount) && ! mUsedUnits[end])
+      ++end;
 
-    assert(neighborEntry->IsDeleted());
-    assert(neighborEntry->IsFirstEntry() == false);
+    while (unit < end)
+    {
+      uint_t sizeClass = 0;
+      while ((sizeClass + 1 < FREE_CLASSES_COUNT) && ((2ull << sizeClass) <= end - unit))
+        ++sizeClass;
 
-    neighborEntry->PrevEntry(entryId);
+      extents.push_back(make_pair(unit, sizeClass));
+      unit += 1ull << sizeClass;
+    }
   }
 
-  entry->PrevEntry(0);
-  entry->NextEntry(mFirstFreeEntry);
+  mUsedUnits.clear();
 
-  mFirstFreeEntry = entryId;
-  cachedItem = mEntriesCache.RetriveItem(0);
-  entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
+  for (auto it = extents.rbegin(); it != extents.rend(); ++it)
+    LinkFreeExtent(it->first, it->second);
 
-  assert(entry->IsDeleted());
-  assert(entry->IsFirstEntry() == false);
+  mFreeMapUnit = AllocateExtent(FREE_MAP_CLASS);
+  for (uint_t c = 0; c < FREE_CLASSES_COUNT; ++c)
+    StoreFreeHead(c);
 
-  entry->NextEntry(entryId);
+  StoreHeader();
 }
 
 } //namespace pastra
 } //namespace whais
-
@@ -25,6 +25,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PS_VARSTORAGE_H_
 #define PS_VARSTORAGE_H_
 
+#include <stddef.h>
+#include <map>
+
 #include "whais.h"
 
 #include "utils/wthread.h"
@@ -40,140 +43,194 @@ namespace pastra
 
 
 
-class StoreEntry
+/* The header unit of a record, or the first unit of a free extent. A record
+   keeps its content in the header itself if it is small enough, in one
+   extent of adjacent units, or in a list of large extents kept by a
+   directory extent. */
+class StoreUnitHeader
 {
 public:
-  static const uint64_t LAST_DELETED_ENTRY = 0x0FFFFFFFFFFFFFFFull;
-  static const uint64_t LAST_CHAINED_ENTRY = 0x0FFFFFFFFFFFFFFFull;
-  static const uint64_t ENTRY_DELETED_MASK = 0x8000000000000000ull;
-  static const uint64_t FIRST_RECORD_ENTRY = 0x4000000000000000ull;
-  static const uint64_t FIRST_PREV_ENTRY   = 0x0000000000000001ull;
-  static const uint_t  ENTRY_SIZE          = 48;
-
-  StoreEntry()
-  {
-    memset(mPrevEntry, 0xFF, sizeof mPrevEntry);
-    memset(mNextEntry, 0xFF, sizeof mPrevEntry);
-    memset(mRawData,   0xFF, sizeof mRawData);
-  }
+  static const uint8_t UNIT_FREE        = 0x46;
+  static const uint8_t UNIT_RECORD      = 0x52;
 
-  void MarkAsDeleted(const bool deleted)
-  {
-    uint64_t entry = load_le_int64(mNextEntry);
+  static const uint8_t LAYOUT_INLINE    = 0;
+  static const uint8_t LAYOUT_EXTENT    = 1;
+  static const uint8_t LAYOUT_DIRECTORY = 2;
 
-    deleted ? (entry |= ENTRY_DELETED_MASK) : (entry &= ~ENTRY_DELETED_MASK);
+  static const uint_t  INLINE_SIZE      = 48;
 
-    store_le_int64(entry, mNextEntry);
-  }
-
-  void MarkAsFirstEntry(const bool first)
+  StoreUnitHeader()
   {
-    uint64_t entry = load_le_int64(mNextEntry);
+    memset(this, 0, sizeof *this);
+  }
 
-    first ? (entry |= FIRST_RECORD_ENTRY) : (entry &= ~FIRST_RECORD_ENTRY);
+  uint8_t State() const { return mState; }
+  void State(const uint8_t state) { mState = state; }
 
-    store_le_int64(entry, mNextEntry);
-  }
+  uint8_t Layout() const { return mLayout; }
+  void Layout(const uint8_t layout) { mLayout = layout; }
 
-  bool IsDeleted() const { return (load_le_int64(mNextEntry) & ENTRY_DELETED_MASK) != 0; }
-  bool IsFirstEntry() const { return(load_le_int64(mNextEntry) & FIRST_RECORD_ENTRY) != 0; }
-  uint64_t PrevEntry() const { return load_le_int64(mPrevEntry); }
-  void PrevEntry(const uint64_t content) { store_le_int64(content, mPrevEntry); }
-  uint64_t NextEntry() const
-  {
-    return load_le_int64(mNextEntry) & ~(ENTRY_DELETED_MASK | FIRST_RECORD_ENTRY);
-  }
+  uint64_t RefCount() const { return load_le_int64(mRefCount); }
+  void RefCount(const uint64_t count) { store_le_int64(count, mRefCount); }
 
-  void NextEntry(const uint64_t content)
-  {
-    uint64_t entry = load_le_int64(mNextEntry);
+  uint64_t ExtentUnit() const { return load_le_int64(mData); }
+  void ExtentUnit(const uint64_t unit) { store_le_int64(unit, mData); }
 
-    entry &= (ENTRY_DELETED_MASK | FIRST_RECORD_ENTRY);
-    entry |= content;
+  uint64_t ExtentUnitsCount() const { return load_le_int64(mData + 8); }
+  void ExtentUnitsCount(const uint64_t count) { store_le_int64(count, mData + 8); }
 
-    store_le_int64(entry, mNextEntry);
-  }
+  uint64_t DirectoryExtentsCount() const { return load_le_int64(mData + 16); }
+  void DirectoryExtentsCount(const uint64_t count) { store_le_int64(count, mData + 16); }
 
-  uint_t Read(uint_t offset, uint_t count, uint8_t* buffer) const;
-  uint_t Write(uint_t offset, uint_t count, const uint8_t* buffer);
+  uint64_t NextFreeUnit() const { return load_le_int64(mData + 16); }
+  void NextFreeUnit(const uint64_t unit) { store_le_int64(unit, mData + 16); }
 
-  static uint8_t Size() { return ENTRY_SIZE; }
+  static uint_t InlineDataOffset() { return offsetof(StoreUnitHeader, mData); }
 
 private:
-  uint8_t  mPrevEntry[8];
-  uint8_t  mNextEntry[8];
-  uint8_t  mRawData[ENTRY_SIZE];
+  uint8_t  mState;
+  uint8_t  mLayout;
+  uint8_t  mReserved[6];
+  uint8_t  mRefCount[8];
+  uint8_t  mData[INLINE_SIZE];
 };
 
 
+/* Keeps the variable size values (texts and arrays) of a table. The storage
+   is split in units of UNIT_SIZE bytes, and the first one holds the store's
+   header. A record is identified by the unit of its header, so any offset of
+   it is found without walking its content. The free extents have a power of
+   two units count and are kept in lists by their size classes. The adjacent
+   free units are joined as they are freed, and a map of the free extents
+   kept in memory tells where each one is linked. */
 class VariableSizeStore : public IBlocksManager
 {
 public:
+  static const uint_t   UNIT_SIZE          = 64;
+  static const uint64_t LARGE_EXTENT_UNITS = 1024;
+  static const uint64_t LARGE_EXTENT_SIZE  = LARGE_EXTENT_UNITS * UNIT_SIZE;
+  static const uint_t   FREE_CLASSES_COUNT = 32;
+
   VariableSizeStore() = default;
   ~VariableSizeStore() = default;
 
   void Init(const char* tempDir, const uint32_t reservedMem);
-  void Init(const char* baseName, const uint64_t storeSize, const uint64_t maxFileSize);
+  void Init(const char*     baseName,
+            const uint64_t  storeSize,
+            const uint64_t  maxFileSize,
+            const bool      toCheck = false,
+            WriteAheadLog*  log = nullptr,
+            const uint32_t  logOwner = 0);
 
   void Flush();
   void MarkForRemoval();
 
   uint64_t AddRecord(const uint8_t* buffer, const uint64_t size);
   uint64_t AddRecord(VariableSizeStore& sourceStore,
-                     uint64_t sourceFirstEntry,
+                     uint64_t sourceRecord,
                      uint64_t sourceFrom,
                      uint64_t sourceSize);
   uint64_t AddRecord(IDataContainer& sourceContainer, uint64_t sourceFrom, uint64_t sourceSize);
 
-  void GetRecord(uint64_t recordFirstEntry, uint64_t offset, uint64_t size, uint8_t* buffer);
-  void UpdateRecord(uint64_t recordFirstEntry,
+  void GetRecord(uint64_t record, uint64_t offset, uint64_t size, uint8_t* buffer);
+  void UpdateRecord(uint64_t record,
                     uint64_t offset,
                     uint64_t size,
                     const uint8_t* source);
 
-  void UpdateRecord(uint64_t recordFirstEntry,
+  void UpdateRecord(uint64_t record,
                     uint64_t offset,
                     VariableSizeStore& sourceStore,
-                    uint64_t sourceFirstEntry,
+                    uint64_t sourceRecord,
                     uint64_t sourceOffset,
                     uint64_t sourceCount);
 
-  void UpdateRecord(uint64_t recordFirstEntry,
+  void UpdateRecord(uint64_t record,
                     uint64_t offset,
                     IDataContainer& sourceContainer,
                     uint64_t sourceOffset,
                     uint64_t sourceCount);
 
-  void IncrementRecordRef(const uint64_t recordFirstEntry);
-  void DecrementRecordRef(const uint64_t recordFirstEntry);
+  void IncrementRecordRef(const uint64_t record);
+  void DecrementRecordRef(const uint64_t record);
 
   uint64_t Size() const;
+  BlockCacheStats CacheStatistics() const;
+  void IOStatistics(uint64_t* const outRead, uint64_t* const outWritten) const;
 
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) override;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) override;
+  virtual void StoreBlocks(uint64_t               firstItem,
+                           const uint_t           itemsPerBlock,
+                           const uint8_t* const*  blocks,
+                           const uint_t           blocksCount) override;
 
   void PrepareToCheckStorage();
-  bool CheckArrayEntry(const uint64_t recordFirstEntry,
+  bool CheckArrayEntry(const uint64_t record,
                        const uint64_t recordSize,
                        const DBS_FIELD_TYPE itemSize);
-  bool CheckTextEntry(const uint64_t recordFirstEntry, const uint64_t recordSize);
+  bool CheckTextEntry(const uint64_t record, const uint64_t recordSize);
   void ConcludeStorageCheck();
 
 private:
-  void FinishInit(const bool nonPersitentData);
-
-  uint64_t AllocateEntry(const uint64_t prevEntryId);
-  uint64_t ExtentFreeList();
-  void RemoveRecord(uint64_t recordFirstEntry);
-  void ExtractFromFreeList(const uint64_t entryId);
-  void AddToFreeList(const uint64_t entryId);
-
-  std::unique_ptr<IDataContainer> mEntriesContainer;
-  BlockCache                      mEntriesCache;
-  uint64_t                        mFirstFreeEntry = { 0 };
-  uint64_t                        mEntriesCount = { 0 };
+  void InitCache(const bool nonPersitentData);
+  void FinishInit(const bool nonPersitentData, const bool toCheck);
+  void ConvertChainedStore(const char* baseName, const uint64_t maxFileSize);
+
+  StoreUnitHeader LoadUnitHeader(const uint64_t unit);
+  void SaveUnitHeader(const uint64_t unit, const StoreUnitHeader& header);
+  void StoreHeader();
+
+  void ReadUnits(uint64_t unit, uint64_t offset, uint64_t size, uint8_t* buffer);
+  void WriteUnits(uint64_t unit, uint64_t offset, uint64_t size, const uint8_t* buffer);
+
+  template<class OP>
+  void VisitRecord(const uint64_t          record,
+                   const StoreUnitHeader&  header,
+                   uint64_t                offset,
+                   uint64_t                size,
+                   OP                      op);
+
+  StoreUnitHeader LoadRecordHeader(const uint64_t record);
+  void ReadRecord(const uint64_t record, uint64_t offset, uint64_t size, uint8_t* buffer);
+  void WriteRecord(const uint64_t record, uint64_t offset, uint64_t size, const uint8_t* buffer);
+  void GrowRecord(const uint64_t record, const uint64_t capacity);
+  void MoveRecordContent(const uint64_t           record,
+                         const StoreUnitHeader&   header,
+                         const uint64_t           toUnit);
+  void ReleaseRecordExtents(const StoreUnitHeader& header);
+  uint64_t NewRecord();
+  void RemoveRecord(const uint64_t record);
+
+  uint64_t AllocateExtent(const uint_t sizeClass);
+  void FreeExtent(const uint64_t unit, const uint_t sizeClass);
+  void FreeUnits(uint64_t unit, const uint64_t unitsCount);
+  void LinkFreeExtent(const uint64_t unit, const uint_t sizeClass);
+  void UnlinkFreeExtent(const uint64_t unit);
+  void LoadFreeExtents();
+  uint64_t ExtendStore(const uint64_t unitsCount);
+  void StoreFreeHead(const uint_t sizeClass);
+  void RebuildFreeSpace();
+
+  bool CheckRecordSpace(const uint64_t record, const uint64_t recordSize, const bool markUnits);
+
+  //Where a free extent is found in its class list.
+  struct FreeExtentLinks
+  {
+    uint_t    mClass;
+    uint64_t  mPrev;
+    uint64_t  mNext;
+  };
+
+  std::unique_ptr<IDataContainer> mUnitsContainer;
+  BlockCache                      mUnitsCache;
+  uint64_t                        mUnitsCount = { 0 };
+  uint64_t                        mUnitsPerBlock = { 0 };
+  uint64_t                        mFreeMapUnit = { 0 };
+  uint64_t                        mFreeHeads[FREE_CLASSES_COUNT] = { 0, };
+  std::map<uint64_t, FreeExtentLinks> mFreeExtents;
   Lock                            mSync;
-  std::vector<bool>               mUsedEntries;
+  std::vector<bool>               mUsedUnits;
 };
 
 using VariableSizeStoreSPtr = std::shared_ptr<VariableSizeStore>;
@@ -0,0 +1,771 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+#include <vector>
+
+#include "dbs/dbs_exception.h"
+#include "utils/endianness.h"
+
+#include "ps_wal.h"
+
+
+using namespace std;
+
+
+namespace whais {
+namespace pastra {
+
+
+static const char PS_WAL_SIGNATURE[] = { 0x50, 0x41, 0x53, 0x54, 0x52, 0x41, 0x20, 0x4C };
+
+static const uint_t PS_WAL_SIGNATURE_OFF  = 0;
+static const uint_t PS_WAL_SIGNATURE_LEN  = 8;
+static const uint_t PS_WAL_VERSION_OFF    = 8;
+static const uint_t PS_WAL_GENERATION_OFF = 12;
+static const uint_t PS_WAL_HEADER_SIZE    = 32;
+
+static const uint32_t PS_WAL_VERSION = 1;
+
+/* Every record has a header followed by its content. The checksum covers
+   all of the record but itself. */
+static const uint_t PS_WAL_REC_CRC_OFF    = 0;
+static const uint_t PS_WAL_REC_TYPE_OFF   = 4;
+static const uint_t PS_WAL_REC_OWNER_OFF  = 8;
+static const uint_t PS_WAL_REC_FILE_OFF   = 12;
+static const uint_t PS_WAL_REC_OFFSET_OFF = 16;
+static const uint_t PS_WAL_REC_SIZE_OFF   = 24;
+static const uint_t PS_WAL_REC_GEN_OFF    = 28;
+static const uint_t PS_WAL_REC_HDR_SIZE   = 32;
+
+enum WAL_RECORD_TYPE
+{
+  WAL_REC_FILE = 1,     //Assigns an identifier to a file's path.
+  WAL_REC_WRITE,        //The content written to a file at an offset.
+  WAL_REC_COMMIT,       //All the writes of an owner up to here are consistent.
+  WAL_REC_DROP          //The file with this path was removed.
+};
+
+static const uint_t COPY_BUFFER_SIZE = 65536;
+
+
+struct CarriedWrite
+{
+  uint32_t          mOwner;
+  uint32_t          mFile;
+  uint64_t          mOffset;
+  vector<uint8_t>   mContent;
+};
+
+
+struct CrcTable
+{
+  CrcTable()
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t c = i;
+      for (uint_t bit = 0; bit < 8; ++bit)
+        c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+
+      mValues[i] = c;
+    }
+  }
+
+  uint32_t mValues[256];
+};
+
+
+static uint32_t
+update_crc(uint32_t crc, const uint8_t* data, uint64_t size)
+{
+  static const CrcTable table;
+
+  crc = ~crc;
+  while (size-- > 0)
+    crc = table.mValues[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+  return ~crc;
+}
+
+
+static uint32_t
+record_crc(const uint8_t* const header, const WIOVec* vecs, uint_t vecsCount)
+{
+  uint32_t crc = update_crc(0,
+                            header + PS_WAL_REC_TYPE_OFF,
+                            PS_WAL_REC_HDR_SIZE - PS_WAL_REC_TYPE_OFF);
+  while (vecsCount-- > 0)
+  {
+    crc = update_crc(crc, vecs->buffer, vecs->size);
+    ++vecs;
+  }
+
+  return crc;
+}
+
+
+
+WriteAheadLog::WriteAheadLog(const string&          directory,
+                             const string&          fileName,
+                             const WAL_SYNC_POLICY  syncPolicy,
+                             const uint64_t         checkpointSize)
+  : mDirectory(directory),
+    mFileName(fileName),
+    mSyncPolicy(syncPolicy),
+    mCheckpointSize(checkpointSize),
+    mFile(fileName.c_str(), WH_FILECREATE | WH_FILERDWR),
+    mTail(0),
+    mDurable(0),
+    mRecoveredWrites(0),
+    mGeneration(0),
+    mLastOwner(0),
+    mLastFile(0)
+{
+  assert(syncPolicy != WAL_DISABLED);
+
+  Recover();
+  Reset();
+}
+
+
+WriteAheadLog::~WriteAheadLog()
+{
+  Checkpoint(true);
+
+  //What is left in the log was never committed, so it would not be replayed.
+  mFile.Close();
+  whf_remove(mFileName.c_str());
+}
+
+
+uint32_t
+WriteAheadLog::RegisterOwner()
+{
+  LockGuard<RWLock> _l(mSync);
+
+  return ++mLastOwner;
+}
+
+
+uint32_t
+WriteAheadLog::RegisterFile(const string& path, const uint32_t owner, const uint64_t baseSize)
+{
+  LockGuard<RWLock> _l(mSync);
+
+  const uint32_t id = ++mLastFile;
+  LoggedFile& file = mFiles[id];
+
+  file.mPath = path;
+  file.mOwner = owner;
+  file.mBaseSize = baseSize;
+  file.mEnd = baseSize;
+
+  const string relative = RelativePath(path);
+  const WIOVec name = { _RC(const uint8_t*, relative.c_str()), _SC(uint_t, relative.length()) };
+
+  Append(WAL_REC_FILE, owner, id, 0, &name, 1);
+
+  return id;
+}
+
+
+void
+WriteAheadLog::ReleaseFile(const uint32_t file)
+{
+  LockGuard<Lock> _f(mFlushSync);
+  LockGuard<RWLock> _l(mSync);
+
+  LoggedFile& loggedFile = GetFile(file);
+
+  if ( ! loggedFile.mExtents.empty())
+  {
+    SyncLog();
+    ApplyExtents(loggedFile);
+  }
+
+  mFiles.erase(file);
+}
+
+
+void
+WriteAheadLog::DropFile(const uint32_t file)
+{
+  LockGuard<RWLock> _l(mSync);
+
+  const LoggedFile& loggedFile = GetFile(file);
+
+  Append(WAL_REC_DROP, loggedFile.mOwner, file, 0, nullptr, 0);
+  mFiles.erase(file);
+}
+
+
+void
+WriteAheadLog::Write(const uint32_t    owner,
+                     const uint32_t    file,
+                     const uint64_t    offset,
+                     const WIOVec*     vecs,
+                     const uint_t      vecsCount)
+{
+  uint64_t size = 0;
+  for (uint_t v = 0; v < vecsCount; ++v)
+    size += vecs[v].size;
+
+  if (size == 0)
+    return;
+
+  LockGuard<RWLock> _l(mSync);
+
+  LoggedFile& loggedFile = GetFile(file);
+
+  const uint64_t logOffset = Append(WAL_REC_WRITE, owner, file, offset, vecs, vecsCount);
+  const uint64_t end = offset + size;
+
+  mDirtyOwners.insert(owner);
+
+  //The new content overrides whatever was logged before for this interval.
+  auto& extents = loggedFile.mExtents;
+  auto it = extents.lower_bound(offset);
+
+  if (it != extents.begin())
+  {
+    auto prev = it;
+    --prev;
+
+    if (prev->second.mEnd > offset)
+    {
+      if (prev->second.mEnd > end)
+        extents[end] = { prev->second.mEnd, prev->second.mLogOffset + (end - prev->first) };
+
+      prev->second.mEnd = offset;
+    }
+  }
+
+  while ((it != extents.end()) && (it->first < end))
+  {
+    if (it->second.mEnd > end)
+    {
+      const Extent tail = { it->second.mEnd, it->second.mLogOffset + (end - it->first) };
+
+      extents.erase(it);
+      extents[end] = tail;
+      break;
+    }
+    it = extents.erase(it);
+  }
+
+  extents[offset] = { end, logOffset };
+  loggedFile.mEnd = MAX(loggedFile.mEnd, end);
+}
+
+
+void
+WriteAheadLog::Read(const uint32_t    file,
+                    const uint64_t    offset,
+                    const uint64_t    size,
+                    uint8_t* const    buffer,
+                    const File&       base)
+{
+  SharedLockGuard<RWLock> _l(mSync);
+
+  LoggedFile& loggedFile = GetFile(file);
+
+  const uint64_t end = offset + size;
+
+  if (offset < loggedFile.mBaseSize)
+    base.Read(offset, buffer, MIN(end, loggedFile.mBaseSize) - offset);
+
+  //What was never written reads as zeros, as a file's hole would.
+  if (end > loggedFile.mBaseSize)
+  {
+    const uint64_t from = MAX(offset, loggedFile.mBaseSize);
+    memset(buffer + (from - offset), 0, end - from);
+  }
+
+  const auto& extents = loggedFile.mExtents;
+  auto it = extents.upper_bound(offset);
+
+  if (it != extents.begin())
+    --it;
+
+  for (; (it != extents.end()) && (it->first < end); ++it)
+  {
+    const uint64_t from = MAX(it->first, offset);
+    const uint64_t to = MIN(it->second.mEnd, end);
+
+    if (from >= to)
+      continue;
+
+    mFile.Read(it->second.mLogOffset + (from - it->first), buffer + (from - offset), to - from);
+  }
+}
+
+
+uint64_t
+WriteAheadLog::FileSize(const uint32_t file)
+{
+  SharedLockGuard<RWLock> _l(mSync);
+
+  const LoggedFile& loggedFile = GetFile(file);
+
+  return MAX(loggedFile.mBaseSize, loggedFile.mEnd);
+}
+
+
+void
+WriteAheadLog::Commit(const uint32_t owner)
+{
+  uint64_t lsn, tail;
+  {
+    LockGuard<RWLock> _l(mSync);
+
+    if (mDirtyOwners.erase(owner) == 0)
+      return;
+
+    Append(WAL_REC_COMMIT, owner, 0, 0, nullptr, 0);
+    lsn = tail = mCommits[owner] = mTail;
+  }
+
+  if (mSyncPolicy == WAL_SYNC_COMMIT)
+  {
+    /* Only one committer syncs the log at a time. The others that were
+       waiting find their records already synced by it. */
+    LockGuard<Lock> _f(mFlushSync);
+
+    if (mDurable < lsn)
+    {
+      {
+        SharedLockGuard<RWLock> _l(mSync);
+        tail = mTail;
+      }
+
+      mFile.Sync();
+      mDurable = tail;
+    }
+  }
+
+  if (tail >= mCheckpointSize)
+    Checkpoint(false);
+}
+
+
+void
+WriteAheadLog::Sync()
+{
+  LockGuard<Lock> _f(mFlushSync);
+  LockGuard<RWLock> _l(mSync);
+
+  SyncLog();
+}
+
+
+bool
+WriteAheadLog::CheckpointDue()
+{
+  SharedLockGuard<RWLock> _l(mSync);
+
+  return mTail >= mCheckpointSize;
+}
+
+
+void
+WriteAheadLog::Checkpoint(const bool force)
+{
+  LockGuard<Lock> _f(mFlushSync);
+  LockGuard<RWLock> _l(mSync);
+
+  if ( ! force && (mTail < mCheckpointSize))
+    return;
+
+  //The files get only content that is already safe in the log.
+  SyncLog();
+
+  for (auto& file : mFiles)
+  {
+    if ( ! file.second.mExtents.empty()
+        && (mDirtyOwners.find(file.second.mOwner) == mDirtyOwners.end()))
+    {
+      ApplyExtents(file.second);
+    }
+  }
+
+  if ( ! mDirtyOwners.empty())
+    ApplyCommittedWrites();
+
+  Reset();
+}
+
+
+uint64_t
+WriteAheadLog::Append(const uint32_t    type,
+                      const uint32_t    owner,
+                      const uint32_t    file,
+                      const uint64_t    offset,
+                      const WIOVec*     vecs,
+                      const uint_t      vecsCount)
+{
+  vector<WIOVec> record(vecsCount + 1);
+  uint8_t header[PS_WAL_REC_HDR_SIZE];
+
+  uint64_t size = 0;
+  for (uint_t v = 0; v < vecsCount; ++v)
+  {
+    record[v + 1] = vecs[v];
+    size += vecs[v].size;
+  }
+
+  store_le_int32(type, header + PS_WAL_REC_TYPE_OFF);
+  store_le_int32(owner, header + PS_WAL_REC_OWNER_OFF);
+  store_le_int32(file, header + PS_WAL_REC_FILE_OFF);
+  store_le_int64(offset, header + PS_WAL_REC_OFFSET_OFF);
+  store_le_int32(size, header + PS_WAL_REC_SIZE_OFF);
+  store_le_int32(mGeneration, header + PS_WAL_REC_GEN_OFF);
+  store_le_int32(record_crc(header, vecs, vecsCount), header + PS_WAL_REC_CRC_OFF);
+
+  record[0].buffer = header;
+  record[0].size = sizeof header;
+
+  mFile.Write(mTail, record.data(), record.size());
+
+  const uint64_t contentOffset = mTail + sizeof header;
+  mTail = contentOffset + size;
+
+  return contentOffset;
+}
+
+
+/* Replay the writes that were committed by their owners. A record that was
+   not completely written ends the log, as does one left from the log's
+   previous generations. */
+void
+WriteAheadLog::Recover()
+{
+  const uint64_t logSize = mFile.Size();
+
+  uint8_t header[PS_WAL_HEADER_SIZE];
+  if (logSize < sizeof header)
+    return;
+
+  mFile.Read(0, header, sizeof header);
+  mGeneration = load_le_int32(header + PS_WAL_GENERATION_OFF);
+
+  if ((memcmp(header + PS_WAL_SIGNATURE_OFF, PS_WAL_SIGNATURE, PS_WAL_SIGNATURE_LEN) != 0)
+      || (load_le_int32(header + PS_WAL_VERSION_OFF) > PS_WAL_VERSION))
+  {
+    throw DBSException(_EXTRA(DBSException::INAVLID_DATABASE),
+                       "File '%s' is not a valid database log.",
+                       mFileName.c_str());
+  }
+
+  struct WriteRecord
+  {
+    uint64_t mLogOffset;
+    uint64_t mOffset;
+    uint32_t mOwner;
+    uint32_t mFile;
+    uint32_t mSize;
+  };
+
+  vector<WriteRecord> writes;
+  map<uint32_t, string> paths;
+  map<string, uint64_t> drops;
+  map<uint32_t, uint64_t> commits;
+  vector<uint8_t> content;
+
+  uint64_t position = PS_WAL_HEADER_SIZE;
+  while (position + PS_WAL_REC_HDR_SIZE <= logSize)
+  {
+    uint8_t record[PS_WAL_REC_HDR_SIZE];
+    mFile.Read(position, record, sizeof record);
+
+    const uint32_t type = load_le_int32(record + PS_WAL_REC_TYPE_OFF);
+    const uint32_t owner = load_le_int32(record + PS_WAL_REC_OWNER_OFF);
+    const uint32_t file = load_le_int32(record + PS_WAL_REC_FILE_OFF);
+    const uint32_t size = load_le_int32(record + PS_WAL_REC_SIZE_OFF);
+    const uint64_t contentOffset = position + sizeof record;
+
+    if ((load_le_int32(record + PS_WAL_REC_GEN_OFF) != mGeneration)
+        || (contentOffset + size > logSize))
+    {
+      break;
+    }
+
+    content.resize(size);
+    if (size > 0)
+      mFile.Read(contentOffset, content.data(), size);
+
+    const WIOVec vec = { content.data(), size };
+    if (load_le_int32(record + PS_WAL_REC_CRC_OFF) != record_crc(record, &vec, 1))
+      break;
+
+    switch (type)
+    {
+    case WAL_REC_FILE:
+      paths[file] = string(_RC(const char*, content.data()), size);
+      break;
+
+    case WAL_REC_WRITE:
+      writes.push_back({contentOffset,
+                        load_le_int64(record + PS_WAL_REC_OFFSET_OFF),
+                        owner,
+                        file,
+                        size});
+      break;
+
+    case WAL_REC_COMMIT:
+      commits[owner] = position;
+      break;
+
+    case WAL_REC_DROP:
+      drops[paths[file]] = position;
+      break;
+
+    default:
+      throw DBSException(_EXTRA(DBSException::INAVLID_DATABASE),
+                         "Database log '%s' has an unknown record at %lu.",
+                         mFileName.c_str(),
+                         _SC(long, position));
+    }
+
+    position = contentOffset + size;
+  }
+
+  map<uint32_t, unique_ptr<File>> files;
+  for (const auto& w : writes)
+  {
+    const auto commit = commits.find(w.mOwner);
+    if ((commit == commits.end()) || (commit->second < w.mLogOffset))
+      continue;
+
+    const string& path = paths[w.mFile];
+    if (path.empty())
+      continue;
+
+    const auto drop = drops.find(path);
+    if ((drop != drops.end()) && (w.mLogOffset < drop->second))
+      continue;
+
+    auto& target = files[w.mFile];
+    if ( ! target)
+    {
+      const string fullPath = whf_is_absolute(path.c_str()) ? path : mDirectory + path;
+      target.reset(new File(fullPath.c_str(), WH_FILECREATE | WH_FILERDWR));
+    }
+
+    content.resize(w.mSize);
+    mFile.Read(w.mLogOffset, content.data(), w.mSize);
+    target->Write(w.mOffset, content.data(), w.mSize);
+
+    ++mRecoveredWrites;
+  }
+
+  for (auto& f : files)
+    f.second->Sync();
+}
+
+
+/* Start a new generation of the log. All its committed content should be
+   already copied to the files by now, the rest is carried to the new one. */
+void
+WriteAheadLog::Reset()
+{
+  vector<CarriedWrite> carried;
+  for (auto& file : mFiles)
+  {
+    const auto commit = mCommits.find(file.second.mOwner);
+    const uint64_t committedEnd = (commit == mCommits.end()) ? 0 : commit->second;
+
+    for (const auto& extent : file.second.mExtents)
+    {
+      if (extent.second.mLogOffset < committedEnd)
+        continue;
+
+      carried.push_back({file.second.mOwner, file.first, extent.first, vector<uint8_t>()});
+
+      vector<uint8_t>& content = carried.back().mContent;
+      content.resize(extent.second.mEnd - extent.first);
+      mFile.Read(extent.second.mLogOffset, content.data(), content.size());
+    }
+
+    file.second.mExtents.clear();
+  }
+
+  mCommits.clear();
+
+  uint8_t header[PS_WAL_HEADER_SIZE];
+
+  memset(header, 0, sizeof header);
+  memcpy(header + PS_WAL_SIGNATURE_OFF, PS_WAL_SIGNATURE, PS_WAL_SIGNATURE_LEN);
+  store_le_int32(PS_WAL_VERSION, header + PS_WAL_VERSION_OFF);
+  store_le_int32(++mGeneration, header + PS_WAL_GENERATION_OFF);
+
+  mFile.Size(0);
+  mFile.Write(0, header, sizeof header);
+  mTail = sizeof header;
+
+  for (const auto& file : mFiles)
+  {
+    const string relative = RelativePath(file.second.mPath);
+    const WIOVec name = { _RC(const uint8_t*, relative.c_str()), _SC(uint_t, relative.length()) };
+
+    Append(WAL_REC_FILE, file.second.mOwner, file.first, 0, &name, 1);
+  }
+
+  for (const auto& write : carried)
+  {
+    const WIOVec content = { write.mContent.data(), _SC(uint_t, write.mContent.size()) };
+    const uint64_t logOffset = Append(WAL_REC_WRITE,
+                                      write.mOwner,
+                                      write.mFile,
+                                      write.mOffset,
+                                      &content,
+                                      1);
+
+    mFiles[write.mFile].mExtents[write.mOffset] = { write.mOffset + content.size, logOffset };
+  }
+
+  mFile.Sync();
+  mDurable = mTail;
+}
+
+
+void
+WriteAheadLog::SyncLog()
+{
+  if (mDurable >= mTail)
+    return;
+
+  mFile.Sync();
+  mDurable = mTail;
+}
+
+
+void
+WriteAheadLog::ApplyExtents(LoggedFile& file)
+{
+  if ( ! file.mBase)
+    file.mBase.reset(new File(file.mPath.c_str(), WH_FILECREATE | WH_FILERDWR));
+
+  vector<uint8_t> buffer(COPY_BUFFER_SIZE);
+  for (const auto& extent : file.mExtents)
+  {
+    for (uint64_t offset = extent.first; offset < extent.second.mEnd; )
+    {
+      const uint_t size = MIN(extent.second.mEnd - offset, COPY_BUFFER_SIZE);
+
+      mFile.Read(extent.second.mLogOffset + (offset - extent.first), buffer.data(), size);
+      file.mBase->Write(offset, buffer.data(), size);
+
+      offset += size;
+    }
+  }
+
+  file.mBase->Sync();
+  file.mExtents.clear();
+  file.mBaseSize = MAX(file.mBaseSize, file.mEnd);
+}
+
+
+/* Copy to their files what the owners with pending writes have committed.
+   The log is scanned for it, as their extents might already point to the
+   uncommitted writes that followed. */
+void
+WriteAheadLog::ApplyCommittedWrites()
+{
+  set<LoggedFile*> updated;
+  vector<uint8_t> content;
+
+  uint64_t position = PS_WAL_HEADER_SIZE;
+  while (position < mTail)
+  {
+    uint8_t record[PS_WAL_REC_HDR_SIZE];
+    mFile.Read(position, record, sizeof record);
+
+    const uint32_t type = load_le_int32(record + PS_WAL_REC_TYPE_OFF);
+    const uint32_t owner = load_le_int32(record + PS_WAL_REC_OWNER_OFF);
+    const uint32_t file = load_le_int32(record + PS_WAL_REC_FILE_OFF);
+    const uint64_t offset = load_le_int64(record + PS_WAL_REC_OFFSET_OFF);
+    const uint32_t size = load_le_int32(record + PS_WAL_REC_SIZE_OFF);
+    const uint64_t contentOffset = position + sizeof record;
+
+    position = contentOffset + size;
+
+    if ((type != WAL_REC_WRITE) || (mDirtyOwners.find(owner) == mDirtyOwners.end()))
+      continue;
+
+    const auto commit = mCommits.find(owner);
+    if ((commit == mCommits.end()) || (commit->second <= contentOffset))
+      continue;
+
+    //The writes of the released or dropped files are already handled.
+    const auto it = mFiles.find(file);
+    if (it == mFiles.end())
+      continue;
+
+    LoggedFile& loggedFile = it->second;
+    if ( ! loggedFile.mBase)
+      loggedFile.mBase.reset(new File(loggedFile.mPath.c_str(), WH_FILECREATE | WH_FILERDWR));
+
+    content.resize(size);
+    mFile.Read(contentOffset, content.data(), size);
+    loggedFile.mBase->Write(offset, content.data(), size);
+
+    loggedFile.mBaseSize = MAX(loggedFile.mBaseSize, offset + size);
+    updated.insert(&loggedFile);
+  }
+
+  for (auto file : updated)
+    file->mBase->Sync();
+}
+
+
+WriteAheadLog::LoggedFile&
+WriteAheadLog::GetFile(const uint32_t file)
+{
+  auto it = mFiles.find(file);
+  if (it == mFiles.end())
+  {
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR),
+                       "File %u is not registered with the database log '%s'.",
+                       file,
+                       mFileName.c_str());
+  }
+
+  return it->second;
+}
+
+
+string
+WriteAheadLog::RelativePath(const string& path) const
+{
+  if (path.compare(0, mDirectory.length(), mDirectory) == 0)
+    return path.substr(mDirectory.length());
+
+  return path;
+}
+
+
+} //namespace pastra
+} //namespace whais
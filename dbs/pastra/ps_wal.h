@@ -0,0 +1,150 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PS_WAL_H_
+#define PS_WAL_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "utils/wfile.h"
+#include "utils/wthread.h"
+#include "dbs/dbs_mgr.h"
+
+
+namespace whais {
+namespace pastra {
+
+
+/* A redo log shared by all persistent tables of a database. The writes to
+   the tables' files are appended to the log instead of being done in place,
+   and are read back from it until a checkpoint copies them to the files.
+   A table (the owner of its files) commits once its caches are flushed, so
+   the log always holds a consistent state of every table at its last
+   commit. The committers waiting for the log to reach the disk share the
+   same sync, and when a database is opened only the writes of the log that
+   were committed are replayed. A checkpoint starts a new generation of the
+   log, into which only the writes not yet committed are carried. */
+class WriteAheadLog
+{
+public:
+  WriteAheadLog(const std::string&     directory,
+                const std::string&     fileName,
+                const WAL_SYNC_POLICY  syncPolicy,
+                const uint64_t         checkpointSize);
+  ~WriteAheadLog();
+
+  uint32_t RegisterOwner();
+
+  /* Start logging the writes to a file. 'baseSize' is the size of the file
+     as it is found on the disk. */
+  uint32_t RegisterFile(const std::string& path, const uint32_t owner, const uint64_t baseSize);
+
+  /* Copy the file's logged content in place and stop logging its writes. */
+  void ReleaseFile(const uint32_t file);
+
+  /* The file is about to be removed, so its logged writes are discarded. */
+  void DropFile(const uint32_t file);
+
+  void Write(const uint32_t    owner,
+             const uint32_t    file,
+             const uint64_t    offset,
+             const WIOVec*     vecs,
+             const uint_t      vecsCount);
+
+  void Read(const uint32_t    file,
+            const uint64_t    offset,
+            const uint64_t    size,
+            uint8_t* const    buffer,
+            const File&       base);
+
+  uint64_t FileSize(const uint32_t file);
+
+  void Commit(const uint32_t owner);
+  void Sync();
+  void Checkpoint(const bool force);
+
+  /* The log has grown enough for a checkpoint to copy its content in place. */
+  bool CheckpointDue();
+
+  uint64_t RecoveredWrites() const { return mRecoveredWrites; }
+
+private:
+  struct Extent
+  {
+    uint64_t mEnd;
+    uint64_t mLogOffset;
+  };
+
+  struct LoggedFile
+  {
+    std::string                   mPath;
+    uint32_t                      mOwner;
+    uint64_t                      mBaseSize;
+    uint64_t                      mEnd;
+    std::map<uint64_t, Extent>    mExtents;
+    std::unique_ptr<File>         mBase;
+  };
+
+  uint64_t Append(const uint32_t    type,
+                  const uint32_t    owner,
+                  const uint32_t    file,
+                  const uint64_t    offset,
+                  const WIOVec*     vecs,
+                  const uint_t      vecsCount);
+
+  void Recover();
+  void Reset();
+  void SyncLog();
+  void ApplyExtents(LoggedFile& file);
+  void ApplyCommittedWrites();
+  LoggedFile& GetFile(const uint32_t file);
+
+  std::string RelativePath(const std::string& path) const;
+
+  const std::string                   mDirectory;
+  const std::string                   mFileName;
+  const WAL_SYNC_POLICY               mSyncPolicy;
+  const uint64_t                      mCheckpointSize;
+  File                                mFile;
+  RWLock                              mSync;
+  Lock                                mFlushSync;
+  std::map<uint32_t, LoggedFile>      mFiles;
+  std::set<uint32_t>                  mDirtyOwners;
+  std::map<uint32_t, uint64_t>        mCommits;     //Where the last commit of an owner ends.
+  uint64_t                            mTail;
+  uint64_t                            mDurable;
+  uint64_t                            mRecoveredWrites;
+  uint32_t                            mGeneration;
+  uint32_t                            mLastOwner;
+  uint32_t                            mLastFile;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+#endif /* PS_WAL_H_ */
@@ -0,0 +1,175 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+
+#include "ps_writeback.h"
+
+
+using namespace std;
+
+namespace whais {
+namespace pastra {
+
+
+WriteBackFlusher::WriteBackFlusher()
+  : mSync(),
+    mClients(),
+    mThread(),
+    mInterval(0),
+    mUrgent(0),
+    mStop(0),
+    mRunning(false),
+    mRounds(0),
+    mUrgentRounds(0),
+    mFailures(0)
+{
+}
+
+WriteBackFlusher::~WriteBackFlusher()
+{
+  Stop();
+}
+
+WriteBackFlusher&
+WriteBackFlusher::Instance()
+{
+  static WriteBackFlusher flusher;
+
+  return flusher;
+}
+
+void
+WriteBackFlusher::Start(const uint_t interval)
+{
+  assert(interval > 0);
+
+  if (mRunning)
+    return;
+
+  mInterval = interval;
+  mStop     = 0;
+  mUrgent   = 0;
+
+  mThread.IgnoreExceptions(true);
+  mRunning = mThread.Run(FlushRoutine, this);
+}
+
+void
+WriteBackFlusher::Stop()
+{
+  if ( ! mRunning)
+    return;
+
+  mStop = 1;
+  mThread.WaitToEnd(false);
+
+  mRunning = false;
+}
+
+void
+WriteBackFlusher::Register(IWriteBackClient& client)
+{
+  LockGuard<Lock> _l(mSync);
+
+  assert(mClients.find(&client) == mClients.end());
+
+  mClients.insert(&client);
+}
+
+void
+WriteBackFlusher::Unregister(IWriteBackClient& client)
+{
+  //Waits for a round in progress, so the client is not used after this.
+  LockGuard<Lock> _l(mSync);
+
+  mClients.erase(&client);
+}
+
+WriteBackStats
+WriteBackFlusher::Statistics()
+{
+  LockGuard<Lock> _l(mSync);
+
+  WriteBackStats result;
+
+  result.mRounds       = mRounds;
+  result.mUrgentRounds = mUrgentRounds;
+  result.mFailures     = mFailures;
+  result.mClientsCount = mClients.size();
+
+  return result;
+}
+
+void
+WriteBackFlusher::FlushRound(const bool urgent)
+{
+  LockGuard<Lock> _l(mSync);
+
+  ++mRounds;
+  if (urgent)
+    ++mUrgentRounds;
+
+  for (auto client : mClients)
+  {
+    /* A failed write leaves the blocks dirty, so the error is raised again
+       to the request thread that flushes or evicts them. */
+    try
+    {
+      client->WriteBack(urgent);
+    }
+    catch (Exception&)
+    {
+      ++mFailures;
+    }
+  }
+}
+
+void
+WriteBackFlusher::FlushRoutine(void* const args)
+{
+  WriteBackFlusher& flusher = *_RC(WriteBackFlusher*, args);
+
+  while (flusher.mStop == 0)
+  {
+    uint_t waited = 0;
+    while ((waited < flusher.mInterval) && (flusher.mUrgent == 0) && (flusher.mStop == 0))
+    {
+      wh_sleep(WAKE_CHECK_INTERVAL);
+      waited += WAKE_CHECK_INTERVAL;
+    }
+
+    if (flusher.mStop != 0)
+      break;
+
+    const bool urgent = (flusher.mUrgent != 0);
+    flusher.mUrgent = 0;
+
+    flusher.FlushRound(urgent);
+  }
+}
+
+
+} //namespace pastra
+} //namespace whais
@@ -0,0 +1,115 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PS_WRITEBACK_H_
+#define PS_WRITEBACK_H_
+
+#include <set>
+
+#include "whais.h"
+#include "utils/wthread.h"
+
+
+namespace whais {
+namespace pastra  {
+
+
+/* Implemented by the owners of the caches whose dirty blocks are written
+   back in the background. */
+class IWriteBackClient
+{
+public:
+  virtual ~IWriteBackClient() = default;
+
+  /* Write some of the dirty blocks to the storage. It's called from the
+     flusher's thread, so it should give up rather than wait on the locks
+     held by the request threads. 'urgent' is set when a cache had to evict
+     a dirty block since the last call. */
+  virtual void WriteBack(const bool urgent) = 0;
+};
+
+
+struct WriteBackStats
+{
+  uint64_t mRounds;
+  uint64_t mUrgentRounds;
+  uint64_t mFailures;
+  uint_t   mClientsCount;
+};
+
+
+/* Writes back the dirty blocks of the registered clients from a dedicated
+   thread, every 'interval' milliseconds or sooner when a request thread had
+   to evict a dirty block itself. This way the evictions done on the request
+   path find clean blocks almost every time, and the periodic flushes of the
+   tables have less to write. */
+class WriteBackFlusher
+{
+public:
+  static WriteBackFlusher& Instance();
+  ~WriteBackFlusher();
+
+  void Start(const uint_t interval);
+  void Stop();
+  bool IsRunning() const { return mRunning; }
+
+  void Register(IWriteBackClient& client);
+  void Unregister(IWriteBackClient& client);
+
+  /* Ask for a write back round as soon as possible. It does not block, so
+     it's safe to call it with any cache lock held. */
+  void Wake() { mUrgent = 1; }
+
+  WriteBackStats Statistics();
+
+  /* How often the thread checks if it was woken up or has to stop. */
+  static const uint_t WAKE_CHECK_INTERVAL = 10;
+
+private:
+  WriteBackFlusher();
+
+  WriteBackFlusher(const WriteBackFlusher&) = delete;
+  WriteBackFlusher& operator= (const WriteBackFlusher&) = delete;
+
+  static void FlushRoutine(void* const args);
+  void FlushRound(const bool urgent);
+
+  Lock                             mSync;
+  std::set<IWriteBackClient*>      mClients;
+  Thread                           mThread;
+  uint_t                           mInterval;
+  volatile int32_t                 mUrgent;
+  volatile int32_t                 mStop;
+  bool                             mRunning;
+  uint64_t                         mRounds;
+  uint64_t                         mUrgentRounds;
+  uint64_t                         mFailures;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_WRITEBACK_H_ */
@@ -0,0 +1,250 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+
+#include "utils/endianness.h"
+#include "ps_zonemap.h"
+
+
+using namespace std;
+
+namespace whais {
+namespace pastra {
+
+
+static const uint_t ZONES_HEADER_SIZE = 16;
+static const uint_t ZONE_RAW_SIZE     = 20;
+
+//A zone with no values has its range reversed.
+static const uint64_t EMPTY_MIN_KEY = ~_SC(uint64_t, 0);
+static const uint64_t EMPTY_MAX_KEY = 0;
+
+
+const uint_t ZoneMaps::NO_SLOT;
+
+
+ZoneMaps::ZoneMaps()
+  : mSlots(),
+    mZones(),
+    mDirtyBlocks(),
+    mSlotsCount(0),
+    mBlockRows(0),
+    mStoredRows(0)
+{
+}
+
+
+void
+ZoneMaps::Init(const vector<bool>& zoned, const uint_t blockRows)
+{
+  assert(blockRows > 0);
+
+  mSlots.assign(zoned.size(), NO_SLOT);
+  mZones.clear();
+  mDirtyBlocks.clear();
+  mSlotsCount = 0;
+  mBlockRows = blockRows;
+  mStoredRows = 0;
+
+  for (size_t field = 0; field < zoned.size(); ++field)
+  {
+    if (zoned[field])
+      mSlots[field] = mSlotsCount++;
+  }
+}
+
+
+void
+ZoneMaps::AddRow(const uint64_t row)
+{
+  const uint64_t block = row / mBlockRows;
+
+  if (block >= mDirtyBlocks.size())
+  {
+    const Zone empty = { EMPTY_MIN_KEY, EMPTY_MAX_KEY, 0 };
+
+    mZones.resize((block + 1) * mSlotsCount, empty);
+    mDirtyBlocks.resize(block + 1, 0);
+  }
+
+  for (uint_t slot = 0; slot < mSlotsCount; ++slot)
+    mZones[block * mSlotsCount + slot].mNullsCount++;
+
+  mDirtyBlocks[block] = 1;
+}
+
+
+void
+ZoneMaps::Update(const FIELD_INDEX   field,
+                 const uint64_t      row,
+                 const bool          wasNull,
+                 const bool          isNull,
+                 const uint64_t      key)
+{
+  assert(IsZoned(field));
+  assert(row / mBlockRows < mDirtyBlocks.size());
+
+  Zone& zone = GetZone(field, row);
+
+  if (wasNull && (zone.mNullsCount > 0))
+    zone.mNullsCount--;
+
+  if (isNull)
+    zone.mNullsCount++;
+
+  else
+  {
+    zone.mMinKey = MIN(zone.mMinKey, key);
+    zone.mMaxKey = MAX(zone.mMaxKey, key);
+  }
+
+  mDirtyBlocks[row / mBlockRows] = 1;
+}
+
+
+bool
+ZoneMaps::MayMatch(const FIELD_INDEX   field,
+                   const uint64_t      block,
+                   const bool          matchNulls,
+                   const bool          matchValues,
+                   const uint64_t      lowKey,
+                   const uint64_t      highKey) const
+{
+  if ( ! IsZoned(field) || (block >= mDirtyBlocks.size()))
+    return true;
+
+  const Zone& zone = mZones[block * mSlotsCount + mSlots[field]];
+
+  if (matchNulls && (zone.mNullsCount > 0))
+    return true;
+
+  return matchValues && (zone.mMinKey <= highKey) && (lowKey <= zone.mMaxKey);
+}
+
+
+bool
+ZoneMaps::Load(IDataContainer& container, const uint64_t rowsCount)
+{
+  const uint64_t blocksCount = (rowsCount + mBlockRows - 1) / mBlockRows;
+  const uint64_t zonesSize = blocksCount * mSlotsCount * ZONE_RAW_SIZE;
+
+  if (container.Size() < ZONES_HEADER_SIZE + zonesSize)
+    return false;
+
+  uint8_t header[ZONES_HEADER_SIZE];
+  container.Read(0, sizeof header, header);
+
+  if ((load_le_int32(header) != mBlockRows)
+      || (load_le_int32(header + 4) != mSlotsCount)
+      || (load_le_int64(header + 8) != rowsCount))
+  {
+    return false;
+  }
+
+  vector<uint8_t> content(zonesSize);
+  if (zonesSize > 0)
+    container.Read(ZONES_HEADER_SIZE, zonesSize, content.data());
+
+  mZones.resize(blocksCount * mSlotsCount);
+  for (size_t z = 0; z < mZones.size(); ++z)
+  {
+    const uint8_t* const raw = content.data() + z * ZONE_RAW_SIZE;
+
+    mZones[z].mMinKey = load_le_int64(raw);
+    mZones[z].mMaxKey = load_le_int64(raw + 8);
+    mZones[z].mNullsCount = load_le_int32(raw + 16);
+  }
+
+  mDirtyBlocks.assign(blocksCount, 0);
+  mStoredRows = rowsCount;
+
+  return true;
+}
+
+
+void
+ZoneMaps::Store(IDataContainer& container, const uint64_t rowsCount)
+{
+  if ((rowsCount == mStoredRows) && (container.Size() >= ZONES_HEADER_SIZE))
+  {
+    bool dirty = false;
+    for (size_t b = 0; (b < mDirtyBlocks.size()) && ! dirty; ++b)
+      dirty = (mDirtyBlocks[b] != 0);
+
+    if ( ! dirty)
+      return;
+  }
+
+  uint8_t header[ZONES_HEADER_SIZE];
+
+  store_le_int32(mBlockRows, header);
+  store_le_int32(mSlotsCount, header + 4);
+  store_le_int64(rowsCount, header + 8);
+
+  //Go first, as the container cannot be written past its end.
+  container.Write(0, sizeof header, header);
+
+  const uint_t blockSize = mSlotsCount * ZONE_RAW_SIZE;
+  vector<uint8_t> run;
+
+  //Write the runs of consecutive changed blocks with a single request.
+  for (size_t b = 0; b < mDirtyBlocks.size(); )
+  {
+    if (mDirtyBlocks[b] == 0)
+    {
+      ++b;
+      continue;
+    }
+
+    const size_t first = b;
+    run.clear();
+
+    for (; (b < mDirtyBlocks.size()) && (mDirtyBlocks[b] != 0); ++b)
+    {
+      for (uint_t slot = 0; slot < mSlotsCount; ++slot)
+      {
+        const Zone& zone = mZones[b * mSlotsCount + slot];
+        uint8_t raw[ZONE_RAW_SIZE];
+
+        store_le_int64(zone.mMinKey, raw);
+        store_le_int64(zone.mMaxKey, raw + 8);
+        store_le_int32(zone.mNullsCount, raw + 16);
+
+        run.insert(run.end(), raw, raw + sizeof raw);
+      }
+
+      mDirtyBlocks[b] = 0;
+    }
+
+    if ( ! run.empty())
+      container.Write(ZONES_HEADER_SIZE + first * blockSize, run.size(), run.data());
+  }
+
+  mStoredRows = rowsCount;
+}
+
+
+} //namespace pastra
+} //namespace whais
@@ -0,0 +1,110 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PS_ZONEMAP_H_
+#define PS_ZONEMAP_H_
+
+#include <vector>
+
+#include "whais.h"
+#include "dbs_types.h"
+#include "ps_container.h"
+
+
+namespace whais {
+namespace pastra  {
+
+
+/* Keeps for every block of rows and every field it covers the range of the
+   scan keys of the field's values, and how many of them are null. A scan
+   skips the blocks whose ranges cannot hold a value it looks for. A range
+   only grows when a value is changed, so it stays conservative without
+   having to look at the other rows of the block. The zones are stored with
+   the zone of every field of a block next to each other, so only the
+   blocks changed since the last store are written. */
+class ZoneMaps
+{
+public:
+  ZoneMaps();
+
+  /* 'zoned' tells which of the table's fields get zones. */
+  void Init(const std::vector<bool>& zoned, const uint_t blockRows);
+
+  bool IsZoned(const FIELD_INDEX field) const
+  {
+    return (field < mSlots.size()) && (mSlots[field] != NO_SLOT);
+  }
+
+  uint_t BlockRows() const { return mBlockRows; }
+
+  /* A new row starts with all its values null. */
+  void AddRow(const uint64_t row);
+
+  void Update(const FIELD_INDEX   field,
+              const uint64_t      row,
+              const bool          wasNull,
+              const bool          isNull,
+              const uint64_t      key);
+
+  bool MayMatch(const FIELD_INDEX   field,
+                const uint64_t      block,
+                const bool          matchNulls,
+                const bool          matchValues,
+                const uint64_t      lowKey,
+                const uint64_t      highKey) const;
+
+  /* Return false if the stored zones do not describe the table as it is,
+     so they have to be built again. */
+  bool Load(IDataContainer& container, const uint64_t rowsCount);
+  void Store(IDataContainer& container, const uint64_t rowsCount);
+
+private:
+  struct Zone
+  {
+    uint64_t mMinKey;
+    uint64_t mMaxKey;
+    uint32_t mNullsCount;
+  };
+
+  Zone& GetZone(const FIELD_INDEX field, const uint64_t row)
+  {
+    return mZones[(row / mBlockRows) * mSlotsCount + mSlots[field]];
+  }
+
+  static const uint_t NO_SLOT = ~0u;
+
+  std::vector<uint_t>     mSlots;
+  std::vector<Zone>       mZones;
+  std::vector<uint8_t>    mDirtyBlocks;
+  uint_t                  mSlotsCount;
+  uint_t                  mBlockRows;
+  uint64_t                mStoredRows;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_ZONEMAP_H_ */
@@ -2,6 +2,10 @@ UNIT_EXES+=test_wfilecontainer
 test_wfilecontainer_SRC=test/test_wfilecontainer.cpp
 test_wfilecontainer_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
 
+UNIT_EXES+=test_blockcache
+test_blockcache_SRC=test/test_blockcache.cpp
+test_blockcache_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
 UNIT_EXES+=test_dbsmgr
 test_dbsmgr_SRC=test/test_dbsmgr.cpp
 test_dbsmgr_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
@@ -122,3 +126,32 @@ test_autofix_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmema
 UNIT_EXES+=test_field_variable_values
 test_field_variable_values_SRC=test/test_field_variable_values.cpp
 test_field_variable_values_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_table_readers
+test_table_readers_SRC=test/test_table_readers.cpp
+test_table_readers_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_index_multithreading
+test_index_multithreading_SRC=test/test_index_multithreading.cpp
+test_index_multithreading_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_index_bulkload
+test_index_bulkload_SRC=test/test_index_bulkload.cpp
+test_index_bulkload_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_table_keysort
+test_table_keysort_SRC=test/test_table_keysort.cpp
+test_table_keysort_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_rowsset
+test_rowsset_SRC=test/test_rowsset.cpp
+test_rowsset_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_table_scan
+test_table_scan_SRC=test/test_table_scan.cpp
+test_table_scan_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_wal
+test_wal_SRC=test/test_wal.cpp
+test_wal_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
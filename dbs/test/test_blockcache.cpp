@@ -0,0 +1,564 @@
+/*
+ * test_blockcache.cpp
+ *
+ */
+
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+#include "dbs/dbs_mgr.h"
+
+#include "custom/include/test/test_fmw.h"
+#include "../pastra/ps_blockcache.h"
+#include "../pastra/ps_writeback.h"
+
+using namespace whais;
+using namespace pastra;
+
+
+static const uint_t ITEM_SIZE       = 16;
+static const uint_t BLOCK_SIZE      = 64;
+static const uint_t ITEMS_PER_BLOCK = BLOCK_SIZE / ITEM_SIZE;
+static const uint_t CACHED_BLOCKS   = 8;
+static const uint_t ITEMS_COUNT     = 1024;
+
+
+class TestBlocksManager : public IBlocksManager
+{
+public:
+  TestBlocksManager()
+    : mStorage(ITEMS_COUNT * ITEM_SIZE),
+      mReadsCount(0),
+      mWritesCount(0),
+      mBlocksWritesCount(0),
+      mBlocksReadsCount(0)
+  {
+    for (uint_t item = 0; item < ITEMS_COUNT; ++item)
+      memset(&mStorage[item * ITEM_SIZE], item & 0xFF, ITEM_SIZE);
+  }
+
+  virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from)
+  {
+    ++mWritesCount;
+    memcpy(&mStorage[firstItem * ITEM_SIZE], from, itemsCount * ITEM_SIZE);
+  }
+
+  virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to)
+  {
+    ++mReadsCount;
+    memcpy(to, &mStorage[firstItem * ITEM_SIZE], itemsCount * ITEM_SIZE);
+  }
+
+  virtual void StoreBlocks(uint64_t               firstItem,
+                           const uint_t           itemsPerBlock,
+                           const uint8_t* const*  blocks,
+                           const uint_t           blocksCount)
+  {
+    ++mBlocksWritesCount;
+    for (uint_t b = 0; b < blocksCount; ++b, firstItem += itemsPerBlock)
+      memcpy(&mStorage[firstItem * ITEM_SIZE], blocks[b], itemsPerBlock * ITEM_SIZE);
+  }
+
+  virtual uint_t RetrieveBlocks(uint64_t               firstItem,
+                                const uint_t           itemsPerBlock,
+                                uint8_t* const*        blocks,
+                                const uint_t           blocksCount)
+  {
+    ++mBlocksReadsCount;
+
+    uint_t count = 0;
+    for (; (count < blocksCount) && (firstItem < ITEMS_COUNT); ++count, firstItem += itemsPerBlock)
+      memcpy(blocks[count], &mStorage[firstItem * ITEM_SIZE], itemsPerBlock * ITEM_SIZE);
+
+    return count;
+  }
+
+  std::vector<uint8_t> mStorage;
+  uint_t               mReadsCount;
+  uint_t               mWritesCount;
+  uint_t               mBlocksWritesCount;
+  uint_t               mBlocksReadsCount;
+};
+
+
+static bool
+test_items_content()
+{
+  std::cout << "Testing cached items content ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    for (uint_t item = 0; (item < ITEMS_COUNT) && result; ++item)
+    {
+      StoredItem stored = cache.RetriveItem(item);
+      if (stored.GetDataForRead()[ITEM_SIZE - 1] != (item & 0xFF))
+        result = false;
+
+      stored.GetDataForUpdate()[0] = ~item & 0xFF;
+    }
+    cache.Flush();
+
+    const BlockCacheStats stats = cache.Statistics();
+    if ((stats.mCachedBlocks > CACHED_BLOCKS)
+        || (stats.mMisses + stats.mPrefetched != ITEMS_COUNT / ITEMS_PER_BLOCK)
+        || (stats.mHits != ITEMS_COUNT - stats.mMisses)
+        || (stats.mEvictions != stats.mMisses + stats.mPrefetched - stats.mCachedBlocks)
+        || (stats.mDirtyEvictions != stats.mEvictions))
+    {
+      result = false;
+    }
+  }
+
+  for (uint_t item = 0; (item < ITEMS_COUNT) && result; ++item)
+  {
+    if ((mgr.mStorage[item * ITEM_SIZE] != (~item & 0xFF))
+        || (mgr.mStorage[item * ITEM_SIZE + 1] != (item & 0xFF)))
+    {
+      result = false;
+    }
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_scan_resistance()
+{
+  std::cout << "Testing hot blocks survive a scan ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+  BlockCache cache;
+
+  cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, true);
+
+  //Make the first two blocks hot.
+  for (uint_t i = 0; i < 3; ++i)
+  {
+    cache.RetriveItem(0);
+    cache.RetriveItem(ITEMS_PER_BLOCK);
+  }
+
+  //Scan the rest of the items once.
+  for (uint_t item = 2 * ITEMS_PER_BLOCK; item < ITEMS_COUNT; ++item)
+    cache.RetriveItem(item);
+
+  const uint_t readsCount = mgr.mReadsCount;
+
+  cache.RetriveItem(1);
+  cache.RetriveItem(ITEMS_PER_BLOCK + 1);
+
+  if (readsCount != mgr.mReadsCount)
+    result = false;
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_used_blocks_eviction()
+{
+  std::cout << "Testing eviction with blocks in use ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+  BlockCache cache;
+
+  cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, true);
+
+  {
+    std::vector<StoredItem> pinned;
+    for (uint_t block = 0; block < CACHED_BLOCKS + 2; ++block)
+      pinned.push_back(cache.RetriveItem(block * ITEMS_PER_BLOCK));
+
+    //No block could be evicted, so the cache had to grow.
+    if (cache.Statistics().mCachedBlocks != CACHED_BLOCKS + 2)
+      result = false;
+
+    for (uint_t block = 0; block < CACHED_BLOCKS + 2; ++block)
+    {
+      if (pinned[block].GetDataForRead()[0] != ((block * ITEMS_PER_BLOCK) & 0xFF))
+        result = false;
+    }
+  }
+
+  cache.RetriveItem(ITEMS_COUNT - 1);
+  if (cache.Statistics().mCachedBlocks > CACHED_BLOCKS)
+    result = false;
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_flush_coalescing()
+{
+  std::cout << "Testing adjacent dirty blocks are flushed together ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    const uint_t dirtyBlocks[] = { 5, 1, 2, 0 };
+    for (auto block : dirtyBlocks)
+      cache.RetriveItem(block * ITEMS_PER_BLOCK + 1).GetDataForUpdate()[0] = 0xAA;
+
+    cache.RetriveItem(3 * ITEMS_PER_BLOCK);
+    cache.Flush();
+
+    //Blocks 0, 1 and 2 go in one request, block 5 in another.
+    if ((mgr.mBlocksWritesCount != 1) || (mgr.mWritesCount != 1))
+      result = false;
+
+    for (auto block : dirtyBlocks)
+    {
+      if (mgr.mStorage[(block * ITEMS_PER_BLOCK + 1) * ITEM_SIZE] != 0xAA)
+        result = false;
+    }
+
+    cache.Flush();
+    if ((mgr.mBlocksWritesCount != 1) || (mgr.mWritesCount != 1))
+      result = false;
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_read_ahead()
+{
+  std::cout << "Testing the blocks are read ahead during scans ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    //Keep a few blocks hot, the scan should not push them out.
+    const uint_t hotBlocks[] = { 100, 180 };
+    for (uint_t i = 0; i < 2; ++i)
+    {
+      for (auto block : hotBlocks)
+        cache.RetriveItem(block * ITEMS_PER_BLOCK);
+    }
+
+    for (uint_t item = 0; (item < ITEMS_COUNT) && result; ++item)
+    {
+      if (cache.RetriveItem(item).GetDataForRead()[0] != (item & 0xFF))
+        result = false;
+    }
+
+    const BlockCacheStats stats = cache.Statistics();
+    const uint_t blocksCount = ITEMS_COUNT / ITEMS_PER_BLOCK;
+
+    if ((stats.mPrefetched == 0)
+        || (stats.mPrefetchHits != stats.mPrefetched)
+        || (mgr.mReadsCount + mgr.mBlocksReadsCount >= blocksCount / 2))
+    {
+      result = false;
+    }
+
+    const uint_t readsCount = mgr.mReadsCount;
+    for (auto block : hotBlocks)
+      cache.RetriveItem(block * ITEMS_PER_BLOCK);
+
+    if (mgr.mReadsCount != readsCount)
+      result = false;
+
+    //Random accesses are not read ahead.
+    const uint_t prefetched = cache.Statistics().mPrefetched;
+    for (uint_t block = 0; block < blocksCount; block += 7)
+      cache.RetriveItem(((block * 13) % blocksCount) * ITEMS_PER_BLOCK);
+
+    if (cache.Statistics().mPrefetched != prefetched)
+      result = false;
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_write_back()
+{
+  std::cout << "Testing the write back of the dirty blocks ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    //Below the high watermark nothing is written, unless it's urgent.
+    cache.RetriveItem(ITEMS_PER_BLOCK + 1).GetDataForUpdate()[0] = 0xAA;
+    if ((cache.WriteBack(false) != 0) || (cache.WriteBack(true) != 1))
+      result = false;
+
+    const uint_t dirtyBlocks[] = { 4, 2, 3, 7 };
+    for (auto block : dirtyBlocks)
+      cache.RetriveItem(block * ITEMS_PER_BLOCK + 1).GetDataForUpdate()[0] = 0xBB;
+
+    //A block latched by someone else is left dirty.
+    StoredItem latched = cache.RetriveItem(7 * ITEMS_PER_BLOCK);
+    latched.Latch().lock();
+
+    const uint_t writesCount = mgr.mWritesCount;
+    if ((cache.WriteBack(false) != 3)
+        || (mgr.mBlocksWritesCount != 1)
+        || (mgr.mWritesCount != writesCount))
+    {
+      result = false;
+    }
+
+    if ((mgr.mStorage[(7 * ITEMS_PER_BLOCK + 1) * ITEM_SIZE] == 0xBB)
+        || (mgr.mStorage[(ITEMS_PER_BLOCK + 1) * ITEM_SIZE] != 0xAA))
+    {
+      result = false;
+    }
+
+    latched.Latch().unlock();
+
+    //The written blocks stay cached and are not written again.
+    const uint_t readsCount = mgr.mReadsCount;
+    for (auto block : dirtyBlocks)
+    {
+      if (cache.RetriveItem(block * ITEMS_PER_BLOCK + 1).GetDataForRead()[0] != 0xBB)
+        result = false;
+    }
+
+    cache.Flush();
+
+    if ((mgr.mReadsCount != readsCount)
+        || (mgr.mWritesCount != writesCount + 1)
+        || (cache.Statistics().mWrittenBack != 4))
+    {
+      result = false;
+    }
+
+    for (auto block : dirtyBlocks)
+    {
+      if (mgr.mStorage[(block * ITEMS_PER_BLOCK + 1) * ITEM_SIZE] != 0xBB)
+        result = false;
+    }
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_clean_victims()
+{
+  std::cout << "Testing clean blocks are evicted first ... ";
+
+  bool result = true;
+  TestBlocksManager mgr;
+
+  WriteBackFlusher::Instance().Start(DEFAULT_WRITE_BACK_INTERVAL);
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    //The least recently used blocks are the dirty ones. The blocks are not
+    //adjacent, so none is read ahead.
+    for (uint_t block = 0; block < CACHED_BLOCKS; ++block)
+    {
+      StoredItem item = cache.RetriveItem(2 * block * ITEMS_PER_BLOCK);
+      if (block < CACHED_BLOCKS / 2)
+        item.GetDataForUpdate()[0] = 0xCC;
+    }
+
+    for (uint_t block = CACHED_BLOCKS; block < CACHED_BLOCKS + CACHED_BLOCKS / 2; ++block)
+      cache.RetriveItem(2 * block * ITEMS_PER_BLOCK);
+
+    const BlockCacheStats stats = cache.Statistics();
+    if ((stats.mEvictions != CACHED_BLOCKS / 2) || (stats.mDirtyEvictions != 0))
+      result = false;
+
+    //With no clean block left, the dirty ones are evicted anyway.
+    for (uint_t block = 0; block < CACHED_BLOCKS; ++block)
+      cache.RetriveItem(2 * (2 * CACHED_BLOCKS + block) * ITEMS_PER_BLOCK).GetDataForUpdate()[0] = 0xCC;
+
+    if (cache.Statistics().mDirtyEvictions != CACHED_BLOCKS / 2)
+      result = false;
+
+    cache.Flush();
+  }
+
+  WriteBackFlusher::Instance().Stop();
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_shared_buffer_pool()
+{
+  std::cout << "Testing caches sharing the buffer pool ... ";
+
+  bool result = true;
+  TestBlocksManager idleMgr, hotMgr;
+  BufferPool& pool = BufferPool::Instance();
+
+  pool.Capacity(CACHED_BLOCKS * BLOCK_SIZE);
+
+  {
+    BlockCache idleCache, hotCache;
+
+    //Alone, a cache may use the whole pool.
+    idleCache.Init(idleMgr, ITEM_SIZE, BLOCK_SIZE, 2 * CACHED_BLOCKS, false);
+    for (uint_t block = 0; block < 2 * CACHED_BLOCKS; ++block)
+      idleCache.RetriveItem(block * ITEMS_PER_BLOCK);
+
+    if (idleCache.Statistics().mCachedBlocks != CACHED_BLOCKS)
+      result = false;
+
+    //The hot cache should take the memory held by the idle one, up to its share.
+    hotCache.Init(hotMgr, ITEM_SIZE, BLOCK_SIZE, 2 * CACHED_BLOCKS, false);
+    for (uint_t block = 0; block < CACHED_BLOCKS; ++block)
+      hotCache.RetriveItem(block * ITEMS_PER_BLOCK);
+
+    if ((hotCache.Statistics().mCachedBlocks != CACHED_BLOCKS / 2)
+        || (idleCache.Statistics().mCachedBlocks != CACHED_BLOCKS / 2)
+        || (pool.Statistics().mUsed > pool.Capacity())
+        || (pool.Statistics().mReclaimed != (CACHED_BLOCKS / 2) * BLOCK_SIZE))
+    {
+      result = false;
+    }
+
+    //The dirty watermarks follow the share, not the whole pool.
+    hotCache.RetriveItem(CACHED_BLOCKS * ITEMS_PER_BLOCK).GetDataForUpdate()[0] = 0xAA;
+    if (hotCache.WriteBack(false) != 1)
+      result = false;
+  }
+
+  if (pool.Statistics().mUsed != 0)
+    result = false;
+
+  pool.Capacity(0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+class TestMappedManager : public TestBlocksManager
+{
+public:
+  virtual uint8_t* MapItems(uint64_t firstItem, uint_t itemsCount)
+  {
+    //Leave the last block unmapped to exercise the mixed case.
+    if (firstItem + itemsCount >= ITEMS_COUNT)
+      return nullptr;
+
+    return &mStorage[firstItem * ITEM_SIZE];
+  }
+};
+
+
+static bool
+test_mapped_blocks()
+{
+  std::cout << "Testing mapped blocks are used in place ... ";
+
+  bool result = true;
+  TestMappedManager mgr;
+  BufferPool& pool = BufferPool::Instance();
+
+  pool.Capacity(CACHED_BLOCKS * BLOCK_SIZE);
+
+  {
+    BlockCache cache;
+    cache.Init(mgr, ITEM_SIZE, BLOCK_SIZE, CACHED_BLOCKS, false);
+
+    StoredItem first = cache.RetriveItem(1);
+    if (first.GetDataForRead() != &mgr.mStorage[ITEM_SIZE])
+      result = false;
+
+    first.GetDataForUpdate()[0] = 0xAA;
+    if (mgr.mStorage[ITEM_SIZE] != 0xAA)
+      result = false;
+
+    cache.RetriveItem(ITEMS_COUNT - 1);
+
+    //The update is already in the storage, the block is not left dirty.
+    cache.Flush();
+
+    const BlockCacheStats stats = cache.Statistics();
+    if ((mgr.mReadsCount != 1)
+        || (mgr.mWritesCount != 0)
+        || (mgr.mBlocksWritesCount != 0)
+        || (stats.mMappedBlocks != 1)
+        || (pool.Statistics().mUsed != BLOCK_SIZE))
+    {
+      result = false;
+    }
+  }
+
+  if (pool.Statistics().mUsed != 0)
+    result = false;
+
+  pool.Capacity(0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  DBSInit(DBSSettings());
+
+  success = success && test_items_content();
+  success = success && test_scan_resistance();
+  success = success && test_used_blocks_eviction();
+  success = success && test_flush_coalescing();
+  success = success && test_read_ahead();
+  success = success && test_write_back();
+  success = success && test_clean_victims();
+  success = success && test_shared_buffer_pool();
+  success = success && test_mapped_blocks();
+
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,80 @@
+/*
+ * test_dbs_common.cpp
+ *
+ * The database and the table setup shared by the table tests.
+ */
+
+#include <iostream>
+
+#include "test_dbs_common.h"
+
+
+using namespace std;
+using namespace whais;
+
+
+static const char db_name[] = "t_baza_date_1";
+static const char tb_name[] = "t_test_table";
+
+
+IDBSHandler&
+tdc_open_database()
+{
+  DBSInit(DBSSettings());
+  DBSCreateDatabase(db_name);
+
+  return DBSRetrieveDatabase(db_name);
+}
+
+
+void
+tdc_close_database(IDBSHandler& handler)
+{
+  DBSReleaseDatabase(handler);
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+}
+
+
+ITable&
+tdc_create_table(IDBSHandler&               handler,
+                 DBSFieldDescriptor* const  fields,
+                 const FIELD_INDEX          fieldsCount,
+                 const TABLE_LAYOUT         layout)
+{
+  handler.AddTable(tb_name, fieldsCount, fields, layout);
+
+  return handler.RetrievePersistentTable(tb_name);
+}
+
+
+ITable&
+tdc_reopen_table(IDBSHandler& handler, ITable& table)
+{
+  handler.ReleaseTable(table);
+
+  return handler.RetrievePersistentTable(tb_name);
+}
+
+
+void
+tdc_delete_table(IDBSHandler& handler, ITable& table)
+{
+  handler.ReleaseTable(table);
+  handler.DeleteTable(tb_name);
+}
+
+
+int
+tdc_test_result(const bool success)
+{
+  if (!success)
+    {
+      cout << "TEST RESULT: FAIL" << endl;
+      return 1;
+    }
+
+  cout << "TEST RESULT: PASS" << endl;
+
+  return 0;
+}
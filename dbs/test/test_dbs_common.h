@@ -0,0 +1,108 @@
+/*
+ * test_dbs_common.h
+ *
+ * The database and the table setup shared by the table tests.
+ */
+
+#ifndef TEST_DBS_COMMON_H_
+#define TEST_DBS_COMMON_H_
+
+#include <vector>
+
+#include "whais.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_values.h"
+
+
+/* Create the test database and get a handler for it. */
+whais::IDBSHandler&
+tdc_open_database();
+
+
+/* Release and remove the test database, then shut the DBS down. */
+void
+tdc_close_database(whais::IDBSHandler& handler);
+
+
+/* Add the test table with the given fields and open it. */
+whais::ITable&
+tdc_create_table(whais::IDBSHandler&               handler,
+                 DBSFieldDescriptor* const         fields,
+                 const FIELD_INDEX                 fieldsCount,
+                 const whais::TABLE_LAYOUT         layout = whais::TABLE_ROWS_LAYOUT);
+
+
+/* Close the test table and open it again, from what was stored. */
+whais::ITable&
+tdc_reopen_table(whais::IDBSHandler& handler, whais::ITable& table);
+
+
+/* Close the test table and remove it from the database. */
+void
+tdc_delete_table(whais::IDBSHandler& handler, whais::ITable& table);
+
+
+/* Print the test verdict and get the process exit code for it. */
+int
+tdc_test_result(const bool success);
+
+
+/* Add a row for every one of the values, in the same order. */
+template<class T> void
+tdc_add_rows(whais::ITable&         table,
+             const FIELD_INDEX      field,
+             const std::vector<T>&  values)
+{
+  for (const auto& value : values)
+    table.Set(table.AddRow(), field, value);
+}
+
+
+/* Check that the matched rows of a field are exactly the ones the
+   reference values tell. An index might not return them in order. */
+template<class T> bool
+tdc_check_matches(whais::ITable&         table,
+                  const FIELD_INDEX      field,
+                  const std::vector<T>&  refValues,
+                  const T&               min,
+                  const T&               max,
+                  const ROW_INDEX        fromRow,
+                  const ROW_INDEX        toRow)
+{
+  const whais::DArray rows = table.MatchRows(min, max, fromRow, toRow, field);
+
+  uint64_t expected = 0;
+  for (ROW_INDEX row = fromRow; (row <= toRow) && (row < refValues.size()); ++row)
+  {
+    if ( ! (refValues[row] < min) && ! (max < refValues[row]))
+      ++expected;
+  }
+
+  if (rows.Count() != expected)
+    return false;
+
+  std::vector<bool> matched(refValues.size(), false);
+  for (uint64_t i = 0; i < rows.Count(); ++i)
+  {
+    whais::DROW_INDEX row;
+    rows.Get(i, row);
+
+    if ((row.mValue < fromRow)
+        || (toRow < row.mValue)
+        || (refValues.size() <= row.mValue)
+        || matched[row.mValue]
+        || (refValues[row.mValue] < min)
+        || (max < refValues[row.mValue]))
+    {
+      return false;
+    }
+
+    matched[row.mValue] = true;
+  }
+
+  return true;
+}
+
+
+#endif /* TEST_DBS_COMMON_H_ */
@@ -0,0 +1,268 @@
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+
+#include "test_dbs_common.h"
+
+using namespace std;
+using namespace whais;
+
+
+//Enough rows to get the keys sorted in more than one run.
+static const ROW_INDEX ROWS_COUNT     = 300000;
+static const int32_t   VALUES_RANGE   = 50000;
+static const uint_t    UPDATES_COUNT  = 60000;
+static const uint_t    CHECKED_RANGES = 100;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_value", T_INT32, false},
+    {"f_other", T_UINT16, false}
+};
+
+static ITable*              refTable;
+static FIELD_INDEX          valueField;
+static FIELD_INDEX          otherField;
+static vector<DInt32>       refValues;
+static uint_t               callbackCalls;
+
+
+static DInt32
+random_value()
+{
+  if (wh_rnd() % 11 == 0)
+    return DInt32();
+
+  return DInt32(_SC(int32_t, wh_rnd() % VALUES_RANGE) - VALUES_RANGE / 2);
+}
+
+
+static const char*
+index_name(const INDEX_KIND kind)
+{
+  return (kind == INDEX_HASH) ? "hash" : "B-tree";
+}
+
+
+static void
+create_index_callback(CreateIndexCallbackContext* const)
+{
+  ++callbackCalls;
+}
+
+
+static bool
+check_range(const int32_t from, const int32_t to)
+{
+  return tdc_check_matches( *refTable,
+                           valueField,
+                           refValues,
+                           DInt32(from),
+                           DInt32(to),
+                           0,
+                           ROWS_COUNT - 1);
+}
+
+
+static bool
+check_value(const DInt32& value, const ROW_INDEX from, const ROW_INDEX to)
+{
+  //A hash index is used only when a single value is matched.
+  return tdc_check_matches( *refTable, valueField, refValues, value, value, from, to);
+}
+
+
+static bool
+check_index(const INDEX_KIND kind)
+{
+  bool result = (refTable->IndexKind(valueField) == kind)
+                && check_range(-VALUES_RANGE, VALUES_RANGE);
+
+  for (uint_t i = 0; (i < CHECKED_RANGES) && result; ++i)
+  {
+    const int32_t from = _SC(int32_t, wh_rnd() % VALUES_RANGE) - VALUES_RANGE / 2;
+    const int32_t to = from + wh_rnd() % 64;
+
+    result = check_range(from, to) && check_value(DInt32(from), 0, ROWS_COUNT - 1);
+    if (result && (i % 10 == 0))
+    {
+      const ROW_INDEX fromRow = wh_rnd() % ROWS_COUNT;
+      result = check_value(DInt32(to), fromRow, fromRow + wh_rnd() % (ROWS_COUNT / 4));
+    }
+  }
+
+  //The null values are not indexed and are still found with a scan.
+  result = result && check_value(DInt32(), 0, ROWS_COUNT - 1);
+
+  return result;
+}
+
+
+static bool
+test_create_index(const INDEX_KIND kind)
+{
+  cout << "Timing the " << index_name(kind) << " index creation ...\n";
+
+  callbackCalls = 0;
+
+  const uint64_t start = wh_msec_ticks();
+
+  refTable->CreateIndex(valueField, create_index_callback, nullptr, kind);
+
+  const uint64_t msecs = wh_msec_ticks() - start;
+
+  cout << '\t' << ROWS_COUNT << " keys indexed in " << msecs << " ms";
+  if (msecs > 0)
+    cout << " (" << (_SC(uint64_t, ROWS_COUNT) * 1000 / msecs) << " keys/s)";
+
+  cout << endl;
+
+  bool result = (callbackCalls == ROWS_COUNT);
+
+  //A field keeps only one index, of whatever kind.
+  try
+  {
+    refTable->CreateIndex(valueField,
+                          nullptr,
+                          nullptr,
+                          (kind == INDEX_HASH) ? INDEX_BTREE : INDEX_HASH);
+    result = false;
+  }
+  catch (DBSException&)
+  {
+  }
+
+  result = result && (refTable->IndexKind(otherField) == INDEX_NONE);
+
+  cout << "Checking the bulk loaded index ... ";
+
+  result = result && check_index(kind);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_index_updates(const INDEX_KIND kind)
+{
+  cout << "Checking the index after updates ... ";
+
+  for (uint_t i = 0; i < UPDATES_COUNT; ++i)
+  {
+    const ROW_INDEX row = wh_rnd() % ROWS_COUNT;
+
+    //Move many keys to the same spot to get the packed nodes split.
+    refValues[row] = (i % 3 == 0) ? DInt32(VALUES_RANGE / 4) : random_value();
+    refTable->Set(row, valueField, refValues[row]);
+  }
+
+  bool result = check_index(kind);
+
+  //The sort moves the rows around, so does their values' entries.
+  refTable->Sort(otherField, 0, ROWS_COUNT - 1, false);
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+    refTable->Get(row, valueField, refValues[row]);
+
+  result = result && check_index(kind);
+
+  //Then empty a part of the range to get the nodes joined.
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    if (refValues[row].IsNull() || (refValues[row] < DInt32(0)))
+      continue;
+
+    refValues[row] = DInt32();
+    refTable->Set(row, valueField, refValues[row]);
+  }
+
+  result = result && check_index(kind);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_index_reopen(IDBSHandler& handler, const INDEX_KIND kind)
+{
+  cout << "Checking the index after the table is opened again ... ";
+
+  refTable = &tdc_reopen_table(handler, *refTable);
+
+  bool result = check_index(kind);
+
+  refTable->RemoveIndex(valueField);
+
+  result = result && ! refTable->IsIndexed(valueField);
+  result = result && (refTable->IndexKind(valueField) == INDEX_NONE);
+
+  refTable = &tdc_reopen_table(handler, *refTable);
+
+  result = result && ! refTable->IsIndexed(valueField);
+  result = result && check_range(-VALUES_RANGE, VALUES_RANGE);
+  result = result && check_value(refValues[0], 0, ROWS_COUNT - 1);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_index_kind(IDBSHandler& handler, const INDEX_KIND kind)
+{
+  refTable = &tdc_create_table(handler,
+                               fieldsDescs,
+                               sizeof fieldsDescs / sizeof fieldsDescs[0]);
+  valueField = refTable->RetrieveField("f_value");
+  otherField = refTable->RetrieveField("f_other");
+
+  refValues.resize(ROWS_COUNT);
+  for (auto& value : refValues)
+    value = random_value();
+
+  tdc_add_rows( *refTable, valueField, refValues);
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+    refTable->Set(row, otherField, DUInt16(wh_rnd() & 0xFFFF));
+
+  bool result = test_create_index(kind);
+  result = result && test_index_updates(kind);
+  result = result && test_index_reopen(handler, kind);
+
+  tdc_delete_table(handler, *refTable);
+
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  {
+    IDBSHandler& handler = tdc_open_database();
+
+    success = success && test_index_kind(handler, INDEX_BTREE);
+    success = success && test_index_kind(handler, INDEX_HASH);
+
+    tdc_close_database(handler);
+  }
+
+  return tdc_test_result(success);
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
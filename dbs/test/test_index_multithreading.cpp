@@ -0,0 +1,295 @@
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+
+#include "test_dbs_common.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const ROW_INDEX ROWS_COUNT         = 20000;
+static const ROW_INDEX STABLE_ROWS        = 5000;
+static const uint_t    READERS_COUNT      = 4;
+static const uint_t    WRITERS_COUNT      = 2;
+static const uint_t    LOOKUPS_PER_THREAD = 20000;
+static const uint_t    WRITES_PER_THREAD  = 20000;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_key", T_INT64, false},
+    {"f_other", T_INT32, false}
+};
+
+static ITable*      refTable;
+static FIELD_INDEX  keyField;
+static bool         testResult;
+static volatile bool writersEnd;
+
+
+/* The first rows keep even keys the readers know about, while the writers
+   move the others around the whole keys range with odd keys. */
+static int64_t
+stable_key(const ROW_INDEX row)
+{
+  return _SC(int64_t, row) * 2;
+}
+
+
+static int64_t
+random_key()
+{
+  return _SC(int64_t, wh_rnd() % (ROWS_COUNT * 4)) * 2 + 1;
+}
+
+
+static bool
+lookup_stable_row(const ROW_INDEX row)
+{
+  const DArray rows = refTable->MatchRows(DInt64(stable_key(row)),
+                                          DInt64(stable_key(row)),
+                                          0,
+                                          ROWS_COUNT - 1,
+                                          keyField);
+  if (rows.Count() != 1)
+    return false;
+
+  DROW_INDEX found;
+  rows.Get(0, found);
+
+  return found == DROW_INDEX(row);
+}
+
+
+static void
+index_reader(void*)
+{
+  try
+  {
+    for (uint_t i = 0; (i < LOOKUPS_PER_THREAD) && testResult; ++i)
+    {
+      if ( ! lookup_stable_row(wh_rnd() % STABLE_ROWS))
+      {
+        cout << "Reader could not find a row by its key.\n";
+        testResult = false;
+      }
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static void
+index_writer(void*)
+{
+  try
+  {
+    for (uint_t i = 0; (i < WRITES_PER_THREAD) && testResult; ++i)
+    {
+      const ROW_INDEX row = STABLE_ROWS + wh_rnd() % (ROWS_COUNT - STABLE_ROWS);
+
+      if ((i % 16) == 0)
+        refTable->Set(row, keyField, DInt64());
+
+      else
+        refTable->Set(row, keyField, DInt64(random_key()));
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static void
+index_scanner(void*)
+{
+  try
+  {
+    while ( ! writersEnd && testResult)
+    {
+      const DArray rows = refTable->MatchRows(DInt64(0),
+                                              DInt64(stable_key(STABLE_ROWS - 1)),
+                                              0,
+                                              STABLE_ROWS - 1,
+                                              keyField);
+      if (rows.Count() != STABLE_ROWS)
+      {
+        cout << "Scanner got " << rows.Count() << " rows.\n";
+        testResult = false;
+      }
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static void
+run_readers(Thread* const readers)
+{
+  for (uint_t t = 0; t < READERS_COUNT; ++t)
+    readers[t].Run(index_reader, nullptr);
+}
+
+
+static void
+wait_readers(Thread* const readers)
+{
+  for (uint_t t = 0; t < READERS_COUNT; ++t)
+    readers[t].WaitToEnd(true);
+}
+
+
+static void
+print_rate(const uint64_t msecs)
+{
+  const uint64_t lookups = _SC(uint64_t, READERS_COUNT) * LOOKUPS_PER_THREAD;
+
+  cout << '\t' << lookups << " lookups in " << msecs << " ms";
+  if (msecs > 0)
+    cout << " (" << (lookups * 1000 / msecs) << " lookups/s)";
+
+  cout << endl;
+}
+
+
+static bool
+test_readers_alone()
+{
+  cout << "Timing index lookups alone ...\n";
+
+  Thread readers[READERS_COUNT];
+
+  const uint64_t start = wh_msec_ticks();
+
+  run_readers(readers);
+  wait_readers(readers);
+
+  print_rate(wh_msec_ticks() - start);
+
+  cout << (testResult ? "OK" : "FAIL") << endl;
+  return testResult;
+}
+
+
+static bool
+test_readers_with_writers()
+{
+  cout << "Timing index lookups along with index updates ...\n";
+
+  Thread readers[READERS_COUNT], writers[WRITERS_COUNT], scanner;
+
+  writersEnd = false;
+
+  const uint64_t start = wh_msec_ticks();
+
+  scanner.Run(index_scanner, nullptr);
+  for (auto& th : writers)
+    th.Run(index_writer, nullptr);
+
+  run_readers(readers);
+  wait_readers(readers);
+
+  print_rate(wh_msec_ticks() - start);
+
+  for (auto& th : writers)
+    th.WaitToEnd(true);
+
+  writersEnd = true;
+  scanner.WaitToEnd(true);
+
+  cout << (testResult ? "OK" : "FAIL") << endl;
+  return testResult;
+}
+
+
+static bool
+test_index_content()
+{
+  cout << "Checking the index content ... ";
+
+  const DArray allRows = refTable->MatchRows(DInt64(0),
+                                             DInt64(ROWS_COUNT * 8 + 1),
+                                             0,
+                                             ROWS_COUNT - 1,
+                                             keyField);
+  uint64_t keysCount = 0;
+
+  for (ROW_INDEX row = 0; (row < ROWS_COUNT) && testResult; ++row)
+  {
+    DInt64 key;
+    refTable->Get(row, keyField, key);
+
+    if (key.IsNull())
+      continue;
+
+    const DArray rows = refTable->MatchRows(key, key, row, row, keyField);
+    if (rows.Count() != 1)
+      testResult = false;
+
+    ++keysCount;
+  }
+
+  if (allRows.Count() != keysCount)
+    testResult = false;
+
+  cout << (testResult ? "OK" : "FAIL") << endl;
+  return testResult;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  testResult = true;
+
+  {
+    IDBSHandler& handler = tdc_open_database();
+
+    refTable = &tdc_create_table(handler,
+                                 fieldsDescs,
+                                 sizeof fieldsDescs / sizeof fieldsDescs[0]);
+    keyField = refTable->RetrieveField("f_key");
+
+    vector<DInt64> keys;
+    for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+      keys.push_back(DInt64((row < STABLE_ROWS) ? stable_key(row) : random_key()));
+
+    tdc_add_rows( *refTable, keyField, keys);
+    refTable->CreateIndex(keyField, nullptr, nullptr);
+
+    test_readers_alone();
+    test_readers_with_writers();
+    test_index_content();
+
+    tdc_delete_table(handler, *refTable);
+    tdc_close_database(handler);
+  }
+
+  return tdc_test_result(testResult);
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,247 @@
+#include <assert.h>
+#include <iostream>
+#include <set>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+#include "dbs/dbs_rowsset.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const char db_name[] = "t_baza_date_1";
+
+static const ROW_INDEX ROWS_COUNT  = 30000;
+static const ROW_INDEX LARGE_RANGE = 50000000;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_key", T_INT32, false}
+};
+
+
+/* Fill a set and its reference with rows sparse in some chunks and dense in
+   others, so both kinds of chunks get combined. */
+static void
+fill_random_set(RowsSet& rowsSet, set<ROW_INDEX>& reference, const uint_t seed)
+{
+  for (uint_t chunk = 0; chunk < 8; ++chunk)
+  {
+    const ROW_INDEX base = ((chunk * 3 + seed) % 11) << 16;
+    const uint_t count = (chunk + seed) % 3 == 0 ? 20000 : 300;
+
+    for (uint_t i = 0; i < count; ++i)
+    {
+      const ROW_INDEX row = base + wh_rnd() % 65536;
+
+      rowsSet.Add(row);
+      reference.insert(row);
+    }
+  }
+
+  const ROW_INDEX from = wh_rnd() % (11 << 16);
+  const ROW_INDEX to = from + wh_rnd() % 100000;
+
+  rowsSet.AddRange(from, to);
+  for (ROW_INDEX row = from; row <= to; ++row)
+    reference.insert(row);
+}
+
+
+static bool
+check_set(const RowsSet& rowsSet, const set<ROW_INDEX>& reference)
+{
+  if (rowsSet.Count() != reference.size())
+    return false;
+
+  auto it = reference.begin();
+  bool result = true;
+
+  rowsSet.ForEach([&it, &result](const ROW_INDEX row) {
+    if (*it++ != row)
+      result = false;
+  });
+
+  if ( ! result)
+    return false;
+
+  const DArray rows = rowsSet.ToArray();
+  if (rows.Count() != reference.size())
+    return false;
+
+  for (uint_t i = 0; i < 1000; ++i)
+  {
+    const ROW_INDEX row = wh_rnd() % (12 << 16);
+
+    if (rowsSet.Contains(row) != (reference.count(row) > 0))
+      return false;
+  }
+
+  return true;
+}
+
+
+static bool
+test_set_operations()
+{
+  cout << "Testing rows sets operations ... ";
+
+  bool result = true;
+
+  for (uint_t round = 0; (round < 4) && result; ++round)
+  {
+    RowsSet first, second;
+    set<ROW_INDEX> firstRef, secondRef;
+
+    fill_random_set(first, firstRef, round);
+    fill_random_set(second, secondRef, round + 1);
+
+    result &= check_set(first, firstRef) && check_set(second, secondRef);
+
+    set<ROW_INDEX> expected = firstRef;
+    expected.insert(secondRef.begin(), secondRef.end());
+    result &= check_set(RowsSet(first).Unite(second), expected);
+
+    expected.clear();
+    for (auto row : firstRef)
+    {
+      if (secondRef.count(row) > 0)
+        expected.insert(row);
+    }
+    result &= check_set(RowsSet(first).Intersect(second), expected);
+
+    expected.clear();
+    for (auto row : firstRef)
+    {
+      if (secondRef.count(row) == 0)
+        expected.insert(row);
+    }
+    result &= check_set(RowsSet(first).Subtract(second), expected);
+
+    result &= check_set(RowsSet(first.ToArray()), firstRef);
+    result &= RowsSet(first).Subtract(first).IsEmpty();
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_large_sets()
+{
+  cout << "Timing operations on large rows sets ... ";
+
+  const uint64_t start = wh_msec_ticks();
+
+  RowsSet all, odd, none;
+  all.AddRange(0, LARGE_RANGE - 1);
+
+  for (ROW_INDEX row = 1; row < LARGE_RANGE; row += 2 * 65536 + 1)
+    odd.Add(row);
+
+  bool result = (all.Count() == LARGE_RANGE);
+
+  result &= RowsSet(all).Intersect(none).IsEmpty();
+  result &= RowsSet(all).Intersect(odd).Count() == odd.Count();
+  result &= RowsSet(all).Subtract(odd).Count() == LARGE_RANGE - odd.Count();
+  result &= RowsSet(odd).Unite(all).Count() == LARGE_RANGE;
+
+  cout << (result ? "OK" : "FAIL") << " (" << (wh_msec_ticks() - start) << " ms)" << endl;
+  return result;
+}
+
+
+static bool
+test_match_rows(ITable& table)
+{
+  cout << "Testing rows sets of matched rows ... ";
+
+  const FIELD_INDEX field = table.RetrieveField("f_key");
+  bool result = true;
+
+  for (uint_t round = 0; (round < 2) && result; ++round)
+  {
+    //Check the same matches with the field indexed.
+    if (round > 0)
+      table.CreateIndex(field, nullptr, nullptr);
+
+    for (uint_t i = 0; (i < 50) && result; ++i)
+    {
+      const DInt32 min(wh_rnd() % 1000);
+      const DInt32 max(min.mValue + wh_rnd() % 100);
+      const ROW_INDEX from = wh_rnd() % ROWS_COUNT;
+      const ROW_INDEX to = from + wh_rnd() % ROWS_COUNT;
+
+      const RowsSet matched = table.MatchRowsSet(min, max, from, to, field);
+      const RowsSet expected(table.MatchRows(min, max, from, to, field));
+
+      result &= (matched.Count() == expected.Count())
+                && RowsSet(matched).Subtract(expected).IsEmpty();
+    }
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+
+    success &= test_set_operations();
+    success &= test_large_sets();
+
+    DBSCreateDatabase(db_name);
+    IDBSHandler& handler = DBSRetrieveDatabase(db_name);
+
+    handler.AddTable("t_test_table", sizeof fieldsDescs / sizeof fieldsDescs[0], fieldsDescs);
+    ITable& table = handler.RetrievePersistentTable("t_test_table");
+
+    const FIELD_INDEX field = table.RetrieveField("f_key");
+    for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+    {
+      table.Set(table.AddRow(),
+                field,
+                (row % 17 == 0) ? DInt32() : DInt32(wh_rnd() % 1000));
+    }
+
+    success &= test_match_rows(table);
+
+    handler.ReleaseTable(table);
+    handler.DeleteTable("t_test_table");
+    DBSReleaseDatabase(handler);
+  }
+
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,278 @@
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+
+#include "test_dbs_common.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const ROW_INDEX ROWS_COUNT = 50000;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_row", T_UINT32, false},
+    {"f_key", T_INT64, false},
+    {"f_indexed", T_INT32, false},
+    {"f_text", T_TEXT, false}
+};
+
+static FIELD_INDEX rowField;
+static FIELD_INDEX keyField;
+static FIELD_INDEX indexedField;
+static FIELD_INDEX textField;
+
+
+static DInt64
+row_key(const ROW_INDEX row)
+{
+  if (row % 11 == 0)
+    return DInt64();
+
+  return DInt64(_SC(int64_t, wh_rnd() % 2000) - 1000);
+}
+
+
+static DInt32
+row_indexed(const ROW_INDEX row)
+{
+  if (row % 7 == 0)
+    return DInt32();
+
+  return DInt32(_SC(int32_t, row));
+}
+
+
+static void
+fill_table(ITable& table)
+{
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    const ROW_INDEX added = table.AddRow();
+
+    //Leave some rows all null, for the table to reuse them.
+    if (row % 13 == 0)
+      continue;
+
+    table.Set(added, rowField, DUInt32(row));
+    table.Set(added, keyField, row_key(row));
+    table.Set(added, indexedField, row_indexed(row));
+
+    if (row % 3 != 0)
+    {
+      char text[16];
+      snprintf(text, sizeof text, "k%05u", _SC(uint_t, wh_rnd() % 1000));
+
+      table.Set(added, textField, DText(text));
+    }
+  }
+}
+
+
+template<class T> static bool
+check_sorted(ITable& table, const FIELD_INDEX field, const bool reverse)
+{
+  T last;
+
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    T value;
+    table.Get(reverse ? ROWS_COUNT - row - 1 : row, field, value);
+
+    if (value < last)
+      return false;
+
+    last = value;
+  }
+
+  return true;
+}
+
+
+static bool
+check_rows_kept(ITable& table)
+{
+  uint_t nullRows = 0;
+
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    DUInt32 origin;
+    DInt32 indexed;
+
+    table.Get(row, rowField, origin);
+    table.Get(row, indexedField, indexed);
+
+    if (origin.IsNull())
+    {
+      ++nullRows;
+      continue;
+    }
+
+    if (indexed != row_indexed(origin.mValue))
+      return false;
+
+    if (indexed.IsNull())
+      continue;
+
+    //The index should find the value where it has been moved.
+    const DArray found = table.MatchRows(indexed, indexed, 0, ROWS_COUNT - 1, indexedField);
+    if (found.Count() != 1)
+      return false;
+
+    DROW_INDEX foundRow;
+    found.Get(0, foundRow);
+    if (foundRow != DROW_INDEX(row))
+      return false;
+  }
+
+  return table.ReusableRowsCount() == nullRows;
+}
+
+
+static bool
+test_keys_sort(ITable& table)
+{
+  cout << "Sorting rows by a fixed size field ... ";
+
+  const uint64_t start = wh_msec_ticks();
+
+  table.Sort(keyField, 0, ROWS_COUNT - 1, false);
+
+  const uint64_t msecs = wh_msec_ticks() - start;
+
+  bool result = check_sorted<DInt64>(table, keyField, false) && check_rows_kept(table);
+
+  table.Sort(keyField, 0, ROWS_COUNT - 1, true);
+  result &= check_sorted<DInt64>(table, keyField, true) && check_rows_kept(table);
+
+  cout << (result ? "OK" : "FAIL") << " (" << msecs << " ms)" << endl;
+  return result;
+}
+
+
+static bool
+test_indexed_sort(ITable& table)
+{
+  cout << "Sorting rows by an indexed field ... ";
+
+  table.Sort(indexedField, 0, ROWS_COUNT - 1, true);
+
+  const bool result = check_sorted<DInt32>(table, indexedField, true) && check_rows_kept(table);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_text_sort(ITable& table)
+{
+  cout << "Sorting rows by a text field ... ";
+
+  const uint64_t start = wh_msec_ticks();
+
+  table.Sort(textField, 0, ROWS_COUNT - 1, false);
+
+  const uint64_t msecs = wh_msec_ticks() - start;
+
+  const bool result = check_sorted<DText>(table, textField, false) && check_rows_kept(table);
+
+  cout << (result ? "OK" : "FAIL") << " (" << msecs << " ms)" << endl;
+  return result;
+}
+
+
+static bool
+test_partial_sort(ITable& table)
+{
+  cout << "Sorting a range of rows ... ";
+
+  const ROW_INDEX from = ROWS_COUNT / 4, to = ROWS_COUNT / 2;
+
+  table.Sort(keyField, 0, ROWS_COUNT - 1, false);
+
+  DUInt32 before, after;
+  table.Get(from - 1, rowField, before);
+  table.Get(to + 1, rowField, after);
+
+  table.Sort(rowField, to, from, true);
+
+  bool result = check_rows_kept(table);
+
+  DUInt32 value, last;
+  table.Get(from - 1, rowField, value);
+  result &= (value == before);
+
+  table.Get(to + 1, rowField, value);
+  result &= (value == after);
+
+  for (ROW_INDEX row = to + 1; row-- > from; )
+  {
+    table.Get(row, rowField, value);
+    if (value < last)
+      result = false;
+
+    last = value;
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  {
+    IDBSHandler& handler = tdc_open_database();
+
+    const TABLE_LAYOUT layouts[] = { TABLE_ROWS_LAYOUT, TABLE_PAX_LAYOUT };
+
+    for (const auto layout : layouts)
+    {
+      if (layout == TABLE_PAX_LAYOUT)
+        cout << "Using a table with the PAX layout:" << endl;
+
+      ITable& table = tdc_create_table(handler,
+                                       fieldsDescs,
+                                       sizeof fieldsDescs / sizeof fieldsDescs[0],
+                                       layout);
+
+      rowField = table.RetrieveField("f_row");
+      keyField = table.RetrieveField("f_key");
+      indexedField = table.RetrieveField("f_indexed");
+      textField = table.RetrieveField("f_text");
+
+      fill_table(table);
+      table.CreateIndex(indexedField, nullptr, nullptr);
+
+      success &= test_keys_sort(table);
+      success &= test_indexed_sort(table);
+      success &= test_text_sort(table);
+      success &= test_partial_sort(table);
+
+      tdc_delete_table(handler, table);
+    }
+
+    tdc_close_database(handler);
+  }
+
+  return tdc_test_result(success);
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
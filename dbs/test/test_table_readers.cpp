@@ -0,0 +1,229 @@
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+
+#include "test_dbs_common.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const ROW_INDEX ROWS_COUNT         = 20000;
+static const uint_t    MAX_READERS        = 8;
+static const uint_t    READS_PER_THREAD   = 200000;
+static const uint_t    WRITES_PER_THREAD  = 20000;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_value", T_INT64, false},
+    {"f_other", T_INT32, false}
+};
+
+static ITable*      refTable;
+static FIELD_INDEX  valueField;
+static FIELD_INDEX  otherField;
+static bool         testResult;
+static volatile bool writersEnd;
+
+
+/* Every stored value keeps the row it belongs to in its remainder, so a
+   reader could tell if it sees a torn or misplaced value. */
+static int64_t
+row_value(const ROW_INDEX row, const uint64_t seed)
+{
+  return _SC(int64_t, row + (seed % 0x7FFFFF) * ROWS_COUNT);
+}
+
+
+static bool
+check_row(const ROW_INDEX row)
+{
+  DInt64 value;
+  refTable->Get(row, valueField, value);
+
+  return ( ! value.IsNull()) && (value.mValue % ROWS_COUNT == _SC(int64_t, row));
+}
+
+
+static void
+table_reader(void*)
+{
+  try
+  {
+    for (uint_t i = 0; (i < READS_PER_THREAD) && testResult; ++i)
+    {
+      if ( ! check_row(wh_rnd() % ROWS_COUNT))
+      {
+        cout << "Reader got an unexpected value.\n";
+        testResult = false;
+      }
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static void
+table_writer(void*)
+{
+  try
+  {
+    for (uint_t i = 0; (i < WRITES_PER_THREAD) && testResult; ++i)
+    {
+      const ROW_INDEX row = wh_rnd() % ROWS_COUNT;
+
+      refTable->Set(row, valueField, DInt64(row_value(row, wh_rnd())));
+      refTable->Set(row, otherField, ((i & 7) == 0) ? DInt32() : DInt32(i));
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static void
+table_scanner(void*)
+{
+  try
+  {
+    while ( ! writersEnd && testResult)
+    {
+      const DArray rows = refTable->MatchRows(DInt64(0),
+                                              DInt64(0x7FFFFFFFFFFFFFFFll),
+                                              0,
+                                              ROWS_COUNT - 1,
+                                              valueField);
+      if (rows.Count() != ROWS_COUNT)
+      {
+        cout << "Scanner got " << rows.Count() << " rows.\n";
+        testResult = false;
+      }
+    }
+  }
+  catch (...)
+  {
+    cout << "Got exception in " << __FUNCTION__ << endl;
+    testResult = false;
+  }
+}
+
+
+static bool
+test_concurrent_readers()
+{
+  cout << "Timing concurrent readers of one table ...\n";
+
+  for (uint_t readers = 1; (readers <= MAX_READERS) && testResult; readers *= 2)
+  {
+    Thread th[MAX_READERS];
+
+    const uint64_t start = wh_msec_ticks();
+
+    for (uint_t t = 0; t < readers; ++t)
+      th[t].Run(table_reader, nullptr);
+
+    for (uint_t t = 0; t < readers; ++t)
+      th[t].WaitToEnd(true);
+
+    const uint64_t msecs = wh_msec_ticks() - start;
+    const uint64_t reads = _SC(uint64_t, readers) * READS_PER_THREAD;
+
+    cout << '\t' << readers << " readers: " << reads << " reads in " << msecs << " ms";
+    if (msecs > 0)
+      cout << " (" << (reads * 1000 / msecs) << " reads/s)";
+
+    cout << endl;
+  }
+
+  cout << (testResult ? "OK" : "FAIL") << endl;
+  return testResult;
+}
+
+
+static bool
+test_readers_with_writers()
+{
+  cout << "Testing readers along with writers and a scanner ... ";
+
+  Thread readers[4], writers[2], scanner;
+
+  writersEnd = false;
+
+  scanner.Run(table_scanner, nullptr);
+  for (auto& th : writers)
+    th.Run(table_writer, nullptr);
+
+  for (auto& th : readers)
+    th.Run(table_reader, nullptr);
+
+  for (auto& th : readers)
+    th.WaitToEnd(true);
+
+  for (auto& th : writers)
+    th.WaitToEnd(true);
+
+  writersEnd = true;
+  scanner.WaitToEnd(true);
+
+  for (ROW_INDEX row = 0; (row < ROWS_COUNT) && testResult; ++row)
+  {
+    if ( ! check_row(row))
+      testResult = false;
+  }
+
+  cout << (testResult ? "OK" : "FAIL") << endl;
+  return testResult;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  testResult = true;
+
+  {
+    IDBSHandler& handler = tdc_open_database();
+
+    refTable = &tdc_create_table(handler,
+                                 fieldsDescs,
+                                 sizeof fieldsDescs / sizeof fieldsDescs[0]);
+    valueField = refTable->RetrieveField("f_value");
+    otherField = refTable->RetrieveField("f_other");
+
+    vector<DInt64> values;
+    for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+      values.push_back(DInt64(row_value(row, row)));
+
+    tdc_add_rows( *refTable, valueField, values);
+
+    test_concurrent_readers();
+    test_readers_with_writers();
+
+    tdc_delete_table(handler, *refTable);
+    tdc_close_database(handler);
+  }
+
+  return tdc_test_result(testResult);
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,435 @@
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+#include "dbs/dbs_values.h"
+
+#include "test_dbs_common.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const ROW_INDEX ROWS_COUNT = 30000;
+static const uint_t    RANGES_COUNT = 40;
+
+
+struct DBSFieldDescriptor fieldsDescs[] =
+{
+    {"f_bool", T_BOOL, false},
+    {"f_char", T_CHAR, false},
+    {"f_date", T_DATE, false},
+    {"f_datetime", T_DATETIME, false},
+    {"f_int8", T_INT8, false},
+    {"f_int32", T_INT32, false},
+    {"f_int64", T_INT64, false},
+    {"f_uint16", T_UINT16, false},
+    {"f_real", T_REAL, false},
+    {"f_richreal", T_RICHREAL, false}
+};
+
+
+static void random_value(DBool* v) { *v = DBool(wh_rnd() % 2 == 0); }
+static void random_value(DChar* v) { *v = DChar(32 + wh_rnd() % 1000); }
+static void random_value(DInt8* v) { *v = DInt8(_SC(int8_t, wh_rnd() % 256)); }
+static void random_value(DInt32* v) { *v = DInt32(_SC(int32_t, wh_rnd() % 2000) - 1000); }
+static void random_value(DInt64* v) { *v = DInt64(_SC(int64_t, wh_rnd())); }
+static void random_value(DUInt16* v) { *v = DUInt16(wh_rnd() % 65536); }
+
+static void
+random_value(DDate* v)
+{
+  *v = DDate(-1000 + wh_rnd() % 3000, 1 + wh_rnd() % 12, 1 + wh_rnd() % 28);
+}
+
+static void
+random_value(DDateTime* v)
+{
+  *v = DDateTime(-1000 + wh_rnd() % 3000,
+                 1 + wh_rnd() % 12,
+                 1 + wh_rnd() % 28,
+                 wh_rnd() % 24,
+                 wh_rnd() % 60,
+                 wh_rnd() % 60);
+}
+
+static void
+random_value(DReal* v)
+{
+  const int64_t value = _SC(int64_t, wh_rnd() % 2000000000) - 1000000000;
+  *v = DReal(DBS_REAL_T(_SC(double, value) / 1000000));
+}
+
+static void
+random_value(DRichReal* v)
+{
+  const int64_t value = _SC(int64_t, wh_rnd() % 2000000000) - 1000000000;
+  *v = DRichReal(DBS_RICHREAL_T(_SC(double, value) / 1000));
+}
+
+
+template<class T> static void
+fill_field(ITable& table, const char* const name)
+{
+  const FIELD_INDEX field = table.RetrieveField(name);
+
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    T value;
+
+    if (wh_rnd() % 9 != 0)
+      random_value(&value);
+
+    table.Set(row, field, value);
+  }
+}
+
+
+template<class T> static bool
+check_range(ITable&           table,
+            const FIELD_INDEX field,
+            const T&          min,
+            const T&          max,
+            const ROW_INDEX   from,
+            const ROW_INDEX   to)
+{
+  const DArray matched = table.MatchRows(min, max, from, to, field);
+  uint64_t count = 0;
+
+  for (ROW_INDEX row = from; row <= MIN(to, ROWS_COUNT - 1); ++row)
+  {
+    T value;
+    table.Get(row, field, value);
+
+    if ((value < min) || (max < value))
+      continue;
+
+    if (count >= matched.Count())
+      return false;
+
+    DROW_INDEX matchedRow;
+    matched.Get(count++, matchedRow);
+
+    if (matchedRow != DROW_INDEX(row))
+      return false;
+  }
+
+  return (count == matched.Count())
+         && (table.MatchRowsSet(min, max, from, to, field).Count() == count);
+}
+
+
+template<class T> static bool
+test_field_scan(ITable& table, const char* const name)
+{
+  cout << "Scanning field '" << name << "' ... ";
+
+  const FIELD_INDEX field = table.RetrieveField(name);
+  const uint64_t start = wh_msec_ticks();
+
+  bool result = true;
+  for (uint_t i = 0; (i < RANGES_COUNT) && result; ++i)
+  {
+    T min, max;
+
+    //Leave some of the bounds null, to match the null values too.
+    if (i % 5 != 0)
+      random_value(&min);
+
+    if (i % 7 != 0)
+      random_value(&max);
+
+    if ((i % 2 == 0) && (max < min))
+    {
+      const T temp = min;
+      min = max;
+      max = temp;
+    }
+
+    const ROW_INDEX from = (i % 3 == 0) ? 0 : wh_rnd() % ROWS_COUNT;
+    const ROW_INDEX to = (i % 4 == 0) ? ROWS_COUNT * 2 : from + wh_rnd() % ROWS_COUNT;
+
+    result &= check_range(table, field, min, max, from, to);
+    result &= check_range(table, field, min, min, from, to);
+  }
+
+  cout << (result ? "OK" : "FAIL") << " (" << (wh_msec_ticks() - start) << " ms)" << endl;
+  return result;
+}
+
+
+static bool
+test_real_limits(ITable& table)
+{
+  cout << "Scanning reals with bounds out of the stored range ... ";
+
+  const FIELD_INDEX field = table.RetrieveField("f_real");
+
+  const DReal huge(DBS_REAL_T(_SC(int64_t, 1) << 50));
+  const DReal tiny(DBS_REAL_T(-(_SC(int64_t, 1) << 50)));
+
+  const bool result = check_range(table, field, DReal::Min(), DReal::Max(), 0, ROWS_COUNT)
+                      && check_range(table, field, tiny, huge, 0, ROWS_COUNT)
+                      && check_range(table, field, DReal(), huge, 0, ROWS_COUNT)
+                      && check_range(table, field, huge, huge, 0, ROWS_COUNT)
+                      && check_range(table, field, tiny, DReal(1), 0, ROWS_COUNT);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+template<class T> static void
+copy_field(ITable& from, ITable& to, const char* const name)
+{
+  const FIELD_INDEX fromField = from.RetrieveField(name);
+  const FIELD_INDEX toField = to.RetrieveField(name);
+
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    T value;
+
+    from.Get(row, fromField, value);
+    to.Set(row, toField, value);
+  }
+}
+
+
+template<class T> static bool
+check_field_copy(ITable& from, ITable& to, const char* const name)
+{
+  const FIELD_INDEX fromField = from.RetrieveField(name);
+  const FIELD_INDEX toField = to.RetrieveField(name);
+
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+  {
+    T value, copy;
+
+    from.Get(row, fromField, value);
+    to.Get(row, toField, copy);
+
+    if ( ! (value == copy))
+      return false;
+  }
+
+  return true;
+}
+
+
+static bool
+test_table_scans(ITable& table)
+{
+  for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+    table.AddRow();
+
+  fill_field<DBool>(table, "f_bool");
+  fill_field<DChar>(table, "f_char");
+  fill_field<DDate>(table, "f_date");
+  fill_field<DDateTime>(table, "f_datetime");
+  fill_field<DInt8>(table, "f_int8");
+  fill_field<DInt32>(table, "f_int32");
+  fill_field<DInt64>(table, "f_int64");
+  fill_field<DUInt16>(table, "f_uint16");
+  fill_field<DReal>(table, "f_real");
+  fill_field<DRichReal>(table, "f_richreal");
+
+  bool result = test_field_scan<DBool>(table, "f_bool");
+  result &= test_field_scan<DChar>(table, "f_char");
+  result &= test_field_scan<DDate>(table, "f_date");
+  result &= test_field_scan<DDateTime>(table, "f_datetime");
+  result &= test_field_scan<DInt8>(table, "f_int8");
+  result &= test_field_scan<DInt32>(table, "f_int32");
+  result &= test_field_scan<DInt64>(table, "f_int64");
+  result &= test_field_scan<DUInt16>(table, "f_uint16");
+  result &= test_field_scan<DReal>(table, "f_real");
+  result &= test_field_scan<DRichReal>(table, "f_richreal");
+  result &= test_real_limits(table);
+
+  return result;
+}
+
+
+static bool
+test_pax_table(IDBSHandler& handler, ITable& table)
+{
+  handler.AddTable("t_pax_table",
+                   sizeof fieldsDescs / sizeof fieldsDescs[0],
+                   fieldsDescs,
+                   TABLE_PAX_LAYOUT);
+  {
+    ITable& paxTable = handler.RetrievePersistentTable("t_pax_table");
+
+    for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+      paxTable.AddRow();
+
+    copy_field<DBool>(table, paxTable, "f_bool");
+    copy_field<DChar>(table, paxTable, "f_char");
+    copy_field<DDate>(table, paxTable, "f_date");
+    copy_field<DDateTime>(table, paxTable, "f_datetime");
+    copy_field<DInt8>(table, paxTable, "f_int8");
+    copy_field<DInt32>(table, paxTable, "f_int32");
+    copy_field<DInt64>(table, paxTable, "f_int64");
+    copy_field<DUInt16>(table, paxTable, "f_uint16");
+    copy_field<DReal>(table, paxTable, "f_real");
+    copy_field<DRichReal>(table, paxTable, "f_richreal");
+
+    handler.ReleaseTable(paxTable);
+  }
+
+  ITable& paxTable = handler.RetrievePersistentTable("t_pax_table");
+
+  cout << "Checking the values of the reopened table ... ";
+
+  bool result = check_field_copy<DBool>(table, paxTable, "f_bool");
+  result &= check_field_copy<DChar>(table, paxTable, "f_char");
+  result &= check_field_copy<DDate>(table, paxTable, "f_date");
+  result &= check_field_copy<DDateTime>(table, paxTable, "f_datetime");
+  result &= check_field_copy<DInt8>(table, paxTable, "f_int8");
+  result &= check_field_copy<DInt32>(table, paxTable, "f_int32");
+  result &= check_field_copy<DInt64>(table, paxTable, "f_int64");
+  result &= check_field_copy<DUInt16>(table, paxTable, "f_uint16");
+  result &= check_field_copy<DReal>(table, paxTable, "f_real");
+  result &= check_field_copy<DRichReal>(table, paxTable, "f_richreal");
+
+  cout << (result ? "OK" : "FAIL") << endl;
+
+  result &= test_field_scan<DBool>(paxTable, "f_bool");
+  result &= test_field_scan<DChar>(paxTable, "f_char");
+  result &= test_field_scan<DDate>(paxTable, "f_date");
+  result &= test_field_scan<DDateTime>(paxTable, "f_datetime");
+  result &= test_field_scan<DInt8>(paxTable, "f_int8");
+  result &= test_field_scan<DInt32>(paxTable, "f_int32");
+  result &= test_field_scan<DInt64>(paxTable, "f_int64");
+  result &= test_field_scan<DUInt16>(paxTable, "f_uint16");
+  result &= test_field_scan<DReal>(paxTable, "f_real");
+  result &= test_field_scan<DRichReal>(paxTable, "f_richreal");
+  result &= test_real_limits(paxTable);
+
+  handler.ReleaseTable(paxTable);
+  handler.DeleteTable("t_pax_table");
+
+  return result;
+}
+
+
+static bool
+check_clustered_ranges(ITable& table)
+{
+  const FIELD_INDEX field = table.RetrieveField("f_clustered");
+
+  bool result = true;
+  for (uint_t i = 0; (i < RANGES_COUNT) && result; ++i)
+  {
+    const uint32_t low = wh_rnd() % (ROWS_COUNT * 2);
+    const DUInt32 min(low);
+    const DUInt32 max(low + wh_rnd() % 100);
+
+    result &= check_range(table, field, min, max, 0, ROWS_COUNT);
+    result &= check_range(table, field, min, min, wh_rnd() % ROWS_COUNT, ROWS_COUNT);
+  }
+
+  //The nulls matched alone, the value moved away and the values never stored.
+  result &= check_range(table, field, DUInt32(), DUInt32(), 0, ROWS_COUNT);
+  result &= check_range(table, field, DUInt32(7), DUInt32(7), 0, ROWS_COUNT);
+  result &= check_range(table, field, DUInt32(ROWS_COUNT * 3), DUInt32::Max(), 0, ROWS_COUNT);
+
+  return result;
+}
+
+
+static bool
+test_clustered_scans(IDBSHandler& handler)
+{
+  DBSFieldDescriptor clusteredDesc = {"f_clustered", T_UINT32, false};
+
+  handler.AddTable("t_clustered_table", 1, &clusteredDesc);
+  {
+    ITable& table = handler.RetrievePersistentTable("t_clustered_table");
+    const FIELD_INDEX field = table.RetrieveField("f_clustered");
+
+    //Every block of rows holds only a narrow range of values.
+    for (ROW_INDEX row = 0; row < ROWS_COUNT; ++row)
+    {
+      if (row % 97 == 0)
+        table.Set(row, field, DUInt32());
+
+      else
+        table.Set(row, field, DUInt32(row * 2));
+    }
+
+    //Values moved out of their block's range have to be found anyway.
+    table.Set(ROWS_COUNT - 1, field, DUInt32(7));
+    table.Set(ROWS_COUNT / 2, field, DUInt32(1));
+    table.Set(10, field, DUInt32());
+
+    cout << "Scanning a field with clustered values ... ";
+
+    const bool result = check_clustered_ranges(table);
+
+    cout << (result ? "OK" : "FAIL") << endl;
+
+    handler.ReleaseTable(table);
+
+    if ( ! result)
+      return false;
+  }
+
+  ITable& table = handler.RetrievePersistentTable("t_clustered_table");
+
+  cout << "Scanning the clustered values of the reopened table ... ";
+
+  const bool result = check_clustered_ranges(table);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+
+  handler.ReleaseTable(table);
+  handler.DeleteTable("t_clustered_table");
+
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  {
+    IDBSHandler& handler = tdc_open_database();
+    ITable& table = tdc_create_table(handler,
+                                     fieldsDescs,
+                                     sizeof fieldsDescs / sizeof fieldsDescs[0]);
+
+    success &= test_table_scans(table);
+
+    cout << "Using a table with the PAX layout:" << endl;
+
+    success &= test_pax_table(handler, table);
+
+    tdc_delete_table(handler, table);
+
+    success &= test_clustered_scans(handler);
+
+    cout << "Using a temporal table:" << endl;
+
+    ITable& tempTable = handler.CreateTempTable(sizeof fieldsDescs / sizeof fieldsDescs[0],
+                                                fieldsDescs);
+    success &= test_table_scans(tempTable);
+
+    handler.ReleaseTable(tempTable);
+    tdc_close_database(handler);
+  }
+
+  return tdc_test_result(success);
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -8,10 +8,12 @@
 #include <assert.h>
 #include <iostream>
 #include <string.h>
+#include <vector>
 
 #include "dbs/dbs_mgr.h"
 #include "dbs/dbs_exception.h"
 #include "dbs/dbs_values.h"
+#include "utils/wrandom.h"
 
 #include "../pastra/ps_varstorage.h"
 #include "../pastra/ps_textstrategy.h"
@@ -24,6 +26,7 @@ static uint8_t pattern2[503];
 static uint8_t pattern3[0x1001F7];
 
 static uint64_t firstEntries[3];
+static uint64_t storeSize;
 
 #define TEST_UNIT_MAX_SIZE              105000
 
@@ -100,6 +103,7 @@ bool test_record_create()
       }
 
     storage.Flush();
+    storeSize = storage.Size();
   }
 
   if (result)
@@ -107,12 +111,8 @@ bool test_record_create()
       std::string temp_file_base = DBSGetSeettings().mWorkDir;
       temp_file_base += "t_ps_varstore";
 
-      uint_t storageSize = sizeof pattern1 + sizeof pattern2 + sizeof pattern3;
-
-      storageSize = ((storageSize + 47 ) /48) * 64;
-
       VariableSizeStore storage;
-      storage.Init(temp_file_base.c_str(), storageSize, TEST_UNIT_MAX_SIZE);
+      storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
 
       if (test_record(&storage, pattern3, 61, firstEntries[2], sizeof pattern3) == false)
         result = false;
@@ -122,6 +122,7 @@ bool test_record_create()
         result = false;
 
       storage.Flush();
+      storeSize = storage.Size();
     }
 
   std::cout << ( result ? "OK" : "FALSE") << std::endl;
@@ -140,12 +141,8 @@ test_record_removal()
     std::string temp_file_base = DBSGetSeettings().mWorkDir;
     temp_file_base += "t_ps_varstore";
 
-    uint_t storageSize = sizeof pattern1 + sizeof pattern2 + sizeof pattern3;
-
-    storageSize = ((storageSize + 47 ) /48) * 64;
-
     VariableSizeStore storage;
-    storage.Init(temp_file_base.c_str(), storageSize, TEST_UNIT_MAX_SIZE);
+    storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
 
     if (result)
       {
@@ -166,6 +163,7 @@ test_record_removal()
       }
 
     storage.Flush();
+    storeSize = storage.Size();
   }
 
   if (result)
@@ -173,17 +171,14 @@ test_record_removal()
       std::string temp_file_base = DBSGetSeettings().mWorkDir;
       temp_file_base += "t_ps_varstore";
 
-      uint_t storageSize = sizeof pattern1 + sizeof pattern2 + sizeof pattern3;
-
-      storageSize = ((storageSize + 47 ) /48) * 64;
-
       VariableSizeStore storage;
-      storage.Init(temp_file_base.c_str(), storageSize, TEST_UNIT_MAX_SIZE);
+      storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
 
       if (test_record(&storage, pattern3, 61, firstEntries[2], sizeof pattern3) == false)
         result = false;
 
       storage.Flush();
+      storeSize = storage.Size();
     }
 
   std::cout << ( result ? "OK" : "FALSE") << std::endl;
@@ -200,12 +195,8 @@ bool test_record_update()
     std::string temp_file_base = DBSGetSeettings().mWorkDir;
     temp_file_base += "t_ps_varstore";
 
-    uint_t storageSize = sizeof pattern1 + sizeof pattern2 + sizeof pattern3;
-
-    storageSize = ((storageSize + 47 ) /48) * 64;
-
     VariableSizeStore storage;
-    storage.Init(temp_file_base.c_str(), storageSize, TEST_UNIT_MAX_SIZE);
+    storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
 
     if (result)
       {
@@ -232,6 +223,7 @@ bool test_record_update()
       }
 
     storage.Flush();
+    storeSize = storage.Size();
   }
 
   if (result)
@@ -239,12 +231,8 @@ bool test_record_update()
       std::string temp_file_base = DBSGetSeettings().mWorkDir;
       temp_file_base += "t_ps_varstore";
 
-      uint_t storageSize = sizeof pattern1 + sizeof pattern2 + sizeof pattern3;
-
-      storageSize = ((storageSize + 47 ) /48) * 64;
-
       VariableSizeStore storage;
-      storage.Init(temp_file_base.c_str(), storageSize, TEST_UNIT_MAX_SIZE);
+      storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
       storage.MarkForRemoval();
 
       init_pattern(pattern3, sizeof pattern3, 21);
@@ -397,6 +385,223 @@ test_record_record_update()
 
 
 
+static void
+store_chained_entry(FileContainer&   container,
+                    const uint64_t   entry,
+                    const uint64_t   prevOrRefs,
+                    const uint64_t   next,
+                    const uint8_t    seed)
+{
+  uint8_t raw[64];
+
+  store_le_int64(prevOrRefs, raw);
+  store_le_int64(next, raw + 8);
+  init_pattern(raw + 16, 48, seed);
+
+  container.Write(entry * sizeof raw, sizeof raw, raw);
+}
+
+
+bool
+test_chained_store_conversion()
+{
+  bool result = true;
+  std::cout << "Testing conversion of a chained entries store ... ";
+
+  const uint64_t DELETED = 0x8000000000000000ull;
+  const uint64_t FIRST   = 0x4000000000000000ull;
+  const uint64_t LAST    = 0x0FFFFFFFFFFFFFFFull;
+
+  std::string temp_file_base = DBSGetSeettings().mWorkDir;
+  temp_file_base += "t_ps_varstore_old";
+
+  uint64_t oldSize = 0;
+  {
+    FileContainer container(temp_file_base.c_str(), TEST_UNIT_MAX_SIZE, 0, true);
+
+    store_chained_entry(container, 0, 0, DELETED | 5, 0);
+    store_chained_entry(container, 1, 2, FIRST | 3, 10);
+    store_chained_entry(container, 2, 0, DELETED | LAST, 0);
+    store_chained_entry(container, 3, 1, LAST, 58);
+    store_chained_entry(container, 4, 1, FIRST | LAST, 70);
+    store_chained_entry(container, 5, 0, DELETED | LAST, 0);
+
+    container.Flush();
+    oldSize = container.Size();
+  }
+
+  //Leftovers of an interrupted conversion, these should be discarded.
+  const std::string leftover_file = temp_file_base + "_cv1";
+  {
+    FileContainer leftover((temp_file_base + "_cv").c_str(), TEST_UNIT_MAX_SIZE, 0, true);
+
+    const std::vector<uint8_t> raw(TEST_UNIT_MAX_SIZE + 64, 0);
+    leftover.Write(0, raw.size(), raw.data());
+    leftover.Flush();
+  }
+
+  do
+    {
+      VariableSizeStore storage;
+      storage.Init(temp_file_base.c_str(), oldSize, TEST_UNIT_MAX_SIZE);
+      storage.MarkForRemoval();
+
+      if (whf_file_exists(leftover_file.c_str()))
+        {
+          result = false;
+          break;
+        }
+
+      uint8_t temp[96];
+
+      storage.GetRecord(1, 0, sizeof temp, temp);
+      if ( ! test_pattern(temp, sizeof temp, 10))
+        {
+          result = false;
+          break;
+        }
+
+      storage.GetRecord(4, 0, 48, temp);
+      if ( ! test_pattern(temp, 48, 70))
+        {
+          result = false;
+          break;
+        }
+
+      //The reference counts are kept too.
+      storage.DecrementRecordRef(1);
+      storage.GetRecord(1, 0, sizeof temp, temp);
+      if ( ! test_pattern(temp, sizeof temp, 10))
+        {
+          result = false;
+          break;
+        }
+
+      init_pattern(pattern2, sizeof pattern2, 17);
+      const uint64_t record = storage.AddRecord(pattern2, sizeof pattern2);
+      if ( ! test_record(&storage, pattern2, 17, record, sizeof pattern2)
+          || ! test_record(&storage, pattern2, 10, 1, sizeof temp))
+        {
+          result = false;
+          break;
+        }
+
+      storage.Flush();
+    }
+  while (0);
+
+  std::cout << ( result ? "OK" : "FALSE") << std::endl;
+  return result;
+}
+
+
+bool
+test_mixed_sizes_reuse()
+{
+  const uint_t ROUNDS_COUNT = 8;
+  const uint_t ROUND_SIZE   = 256 * 1024;
+
+  bool result = true;
+  std::cout << "Testing the freed space is reused by records of other sizes ... ";
+
+  std::string temp_file_base = DBSGetSeettings().mWorkDir;
+  temp_file_base += "t_ps_varstore";
+
+  uint64_t firstRoundSize = 0;
+  {
+    VariableSizeStore storage;
+    storage.Init(temp_file_base.c_str(), 0, TEST_UNIT_MAX_SIZE);
+
+    //Every round holds as much content, in fewer and bigger records.
+    for (uint_t round = 0; (round < ROUNDS_COUNT) && result; ++round)
+      {
+        const uint_t recordSize = 512 << round;
+        std::vector<uint64_t> records;
+
+        init_pattern(pattern3, recordSize, round);
+        for (uint_t r = 0; r < ROUND_SIZE / recordSize; ++r)
+          records.push_back(storage.AddRecord(pattern3, recordSize));
+
+        for (auto record : records)
+          result &= test_record(&storage, pattern3, round, record, recordSize);
+
+        for (auto record : records)
+          storage.DecrementRecordRef(record);
+
+        if (round == 0)
+          firstRoundSize = storage.Size();
+      }
+
+    result &= (storage.Size() < 2 * firstRoundSize);
+
+    storage.Flush();
+    storeSize = storage.Size();
+  }
+
+  //The free space should be found again once the store is reopened.
+  {
+    VariableSizeStore storage;
+    storage.Init(temp_file_base.c_str(), storeSize, TEST_UNIT_MAX_SIZE);
+
+    init_pattern(pattern3, ROUND_SIZE / 2, 3);
+    const uint64_t record = storage.AddRecord(pattern3, ROUND_SIZE / 2);
+
+    result &= test_record(&storage, pattern3, 3, record, ROUND_SIZE / 2);
+    result &= (storage.Size() == storeSize);
+
+    storage.Flush();
+    storage.MarkForRemoval();
+  }
+
+  std::cout << ( result ? "OK" : "FALSE") << std::endl;
+  return result;
+}
+
+
+bool
+test_random_offsets()
+{
+  const uint_t READS_COUNT = 200000;
+
+  bool result = true;
+  std::cout << "Timing random offset reads of a large record ...\n";
+
+  std::string temp_file_base = DBSGetSeettings().mWorkDir;
+  temp_file_base += "t_ps_varstore";
+
+  VariableSizeStore storage;
+  storage.Init(temp_file_base.c_str(), 0, TEST_UNIT_MAX_SIZE);
+  storage.MarkForRemoval();
+
+  init_pattern(pattern3, sizeof pattern3, 7);
+  const uint64_t record = storage.AddRecord(pattern3, sizeof pattern3);
+
+  const uint64_t start = wh_msec_ticks();
+  for (uint_t i = 0; (i < READS_COUNT) && result; ++i)
+    {
+      uint8_t temp[16];
+      const uint_t offset = wh_rnd() % (sizeof pattern3 - sizeof temp);
+
+      storage.GetRecord(record, offset, sizeof temp, temp);
+      if ( ! test_pattern(temp, sizeof temp, _SC(uint8_t, 7 + offset)))
+        result = false;
+    }
+
+  const uint64_t msecs = wh_msec_ticks() - start;
+
+  storage.Flush();
+
+  std::cout << '\t' << READS_COUNT << " reads in " << msecs << " ms";
+  if (msecs > 0)
+    std::cout << " (" << (READS_COUNT * 1000ull / msecs) << " reads/s)";
+  std::cout << std::endl;
+
+  std::cout << ( result ? "OK" : "FALSE") << std::endl;
+  return result;
+}
+
+
+
 int
 main()
 {
@@ -409,6 +614,9 @@ main()
   success = success && test_record_update();
   success = success && test_record_container_update();
   success = success && test_record_record_update();
+  success = success && test_chained_store_conversion();
+  success = success && test_mixed_sizes_reuse();
+  success = success && test_random_offsets();
 
   DBSShoutdown();
 
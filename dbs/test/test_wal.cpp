@@ -0,0 +1,347 @@
+#include <assert.h>
+#include <iostream>
+#include <memory>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "utils/wrandom.h"
+#include "utils/wfile.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+
+#include "../pastra/ps_wal.h"
+
+using namespace std;
+using namespace whais;
+using namespace pastra;
+
+
+static const char log_name[]     = "t_wal_test.wal";
+static const char log_copy[]     = "t_wal_test_copy.wal";
+static const char data_name[]    = "t_wal_data";
+static const char new_data_name[] = "t_wal_new_data";
+static const char data_copy[]     = "t_wal_data_copy";
+
+static const uint64_t BASE_SIZE       = 8192;
+static const uint64_t MAX_FILE_SIZE   = 65536;
+static const uint64_t CHECKPOINT_SIZE = 1024 * 1024;
+static const uint_t   WRITES_COUNT    = 500;
+
+
+static void
+copy_file(const char* const from, const char* const to)
+{
+  File src(from, WH_FILEOPEN_EXISTING | WH_FILEREAD);
+  File dst(to, WH_FILECREATE | WH_FILETRUNC | WH_FILEWRITE);
+
+  vector<uint8_t> content(src.Size());
+  src.Read(0, content.data(), content.size());
+  dst.Write(0, content.data(), content.size());
+}
+
+
+static void
+create_base_file(const char* const name, const vector<uint8_t>& content)
+{
+  File file(name, WH_FILECREATE | WH_FILETRUNC | WH_FILERDWR);
+
+  if ( ! content.empty())
+    file.Write(0, content.data(), content.size());
+
+  file.Sync();
+}
+
+
+static bool
+check_content(const char* const name, const vector<uint8_t>& expected)
+{
+  File file(name, WH_FILEOPEN_EXISTING | WH_FILEREAD);
+
+  if (file.Size() != expected.size())
+    return false;
+
+  vector<uint8_t> content(expected.size());
+  file.Read(0, content.data(), content.size());
+
+  return content == expected;
+}
+
+
+static void
+random_writes(WriteAheadLog&     log,
+              const uint32_t     owner,
+              const uint32_t     file,
+              vector<uint8_t>&   reference)
+{
+  for (uint_t i = 0; i < WRITES_COUNT; ++i)
+  {
+    const uint64_t offset = wh_rnd() % (MAX_FILE_SIZE - 1024);
+    uint8_t first[300], second[500];
+
+    const uint_t firstSize = 1 + wh_rnd() % sizeof first;
+    const uint_t secondSize = wh_rnd() % sizeof second;
+
+    for (uint_t b = 0; b < firstSize; ++b)
+      first[b] = wh_rnd() & 0xFF;
+
+    for (uint_t b = 0; b < secondSize; ++b)
+      second[b] = wh_rnd() & 0xFF;
+
+    const WIOVec vecs[] = { {first, firstSize}, {second, secondSize} };
+    log.Write(owner, file, offset, vecs, 2);
+
+    if (reference.size() < offset + firstSize + secondSize)
+      reference.resize(offset + firstSize + secondSize, 0);
+
+    memcpy(reference.data() + offset, first, firstSize);
+    memcpy(reference.data() + offset + firstSize, second, secondSize);
+  }
+}
+
+
+static bool
+check_logged_content(WriteAheadLog&          log,
+                     const uint32_t          file,
+                     const char* const       name,
+                     const vector<uint8_t>&  expected)
+{
+  if (log.FileSize(file) != expected.size())
+    return false;
+
+  File base(name, WH_FILEOPEN_EXISTING | WH_FILEREAD);
+
+  for (uint_t i = 0; i < 100; ++i)
+  {
+    const uint64_t offset = wh_rnd() % expected.size();
+    const uint64_t maxSize = 1 + wh_rnd() % 4096;
+    const uint64_t size = MIN(maxSize, expected.size() - offset);
+
+    vector<uint8_t> content(size);
+    log.Read(file, offset, size, content.data(), base);
+
+    if (memcmp(content.data(), expected.data() + offset, size) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+
+static bool
+test_logged_reads(vector<uint8_t>& committed, vector<uint8_t>& newCommitted)
+{
+  cout << "Testing reads of the logged writes ... ";
+
+  vector<uint8_t> reference(BASE_SIZE, 'a');
+  vector<uint8_t> newReference;
+
+  create_base_file(data_name, reference);
+  create_base_file(new_data_name, newReference);
+
+  bool result = true;
+  {
+    WriteAheadLog log("", log_name, WAL_SYNC_COMMIT, CHECKPOINT_SIZE);
+
+    const uint32_t owner = log.RegisterOwner();
+    const uint32_t newOwner = log.RegisterOwner();
+    const uint32_t file = log.RegisterFile(data_name, owner, BASE_SIZE);
+    const uint32_t newFile = log.RegisterFile(new_data_name, newOwner, 0);
+
+    random_writes(log, owner, file, reference);
+    log.Commit(owner);
+    committed = reference;
+
+    random_writes(log, newOwner, newFile, newReference);
+    log.Commit(newOwner);
+    newCommitted = newReference;
+
+    //These are never committed, so they should not survive a crash.
+    random_writes(log, owner, file, reference);
+
+    result &= check_logged_content(log, file, data_name, reference);
+    result &= check_logged_content(log, newFile, new_data_name, newReference);
+    result &= check_content(data_name, vector<uint8_t>(BASE_SIZE, 'a'));
+
+    //Keep the log as it would be found after a crash.
+    log.Sync();
+    copy_file(log_name, log_copy);
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_recovery(const vector<uint8_t>& committed, const vector<uint8_t>& newCommitted)
+{
+  cout << "Testing the recovery of the committed writes ... ";
+
+  //Bring the files back as they were before the log was opened first.
+  create_base_file(data_name, vector<uint8_t>(BASE_SIZE, 'a'));
+  whf_remove(new_data_name);
+
+  copy_file(log_copy, log_name);
+  whf_remove(log_copy);
+
+  bool result = true;
+  {
+    WriteAheadLog log("", log_name, WAL_SYNC_COMMIT, CHECKPOINT_SIZE);
+
+    result &= (log.RecoveredWrites() == 2 * WRITES_COUNT);
+    result &= check_content(data_name, committed);
+    result &= check_content(new_data_name, newCommitted);
+  }
+
+  result &= ! whf_file_exists(log_name);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_checkpoint()
+{
+  cout << "Testing the checkpoints of the log ... ";
+
+  vector<uint8_t> reference(BASE_SIZE, 'b');
+  create_base_file(data_name, reference);
+
+  bool result = true;
+  {
+    WriteAheadLog log("", log_name, WAL_SYNC_COMMIT, CHECKPOINT_SIZE);
+
+    const uint32_t owner = log.RegisterOwner();
+    const uint32_t file = log.RegisterFile(data_name, owner, BASE_SIZE);
+
+    for (uint_t round = 0; round < 20; ++round)
+    {
+      random_writes(log, owner, file, reference);
+      log.Commit(owner);
+
+      //A commit that makes the log too big checkpoints it.
+      result &= ! log.CheckpointDue();
+
+      File logFile(log_name, WH_FILEOPEN_EXISTING | WH_FILEREAD);
+      result &= logFile.Size() < 2 * CHECKPOINT_SIZE;
+    }
+
+    result &= check_logged_content(log, file, data_name, reference);
+
+    log.ReleaseFile(file);
+    result &= check_content(data_name, reference);
+  }
+
+  result &= ! whf_file_exists(log_name);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_pending_writes_checkpoint()
+{
+  cout << "Testing the checkpoints with pending writes ... ";
+
+  vector<uint8_t> reference(BASE_SIZE, 'c');
+  vector<uint8_t> pendingReference(BASE_SIZE, 'd');
+  vector<uint8_t> pendingCommitted;
+
+  create_base_file(data_name, reference);
+  create_base_file(new_data_name, pendingReference);
+
+  bool result = true;
+  {
+    WriteAheadLog log("", log_name, WAL_SYNC_COMMIT, CHECKPOINT_SIZE);
+
+    const uint32_t owner = log.RegisterOwner();
+    const uint32_t pendingOwner = log.RegisterOwner();
+    const uint32_t file = log.RegisterFile(data_name, owner, BASE_SIZE);
+    const uint32_t pendingFile = log.RegisterFile(new_data_name, pendingOwner, BASE_SIZE);
+
+    //This owner has always some writes not committed when a checkpoint happens.
+    for (uint_t round = 0; round < 20; ++round)
+    {
+      random_writes(log, pendingOwner, pendingFile, pendingReference);
+      log.Commit(pendingOwner);
+      pendingCommitted = pendingReference;
+
+      random_writes(log, pendingOwner, pendingFile, pendingReference);
+
+      random_writes(log, owner, file, reference);
+      log.Commit(owner);
+
+      File logFile(log_name, WH_FILEOPEN_EXISTING | WH_FILEREAD);
+      result &= logFile.Size() < 2 * CHECKPOINT_SIZE;
+    }
+
+    result &= check_logged_content(log, file, data_name, reference);
+    result &= check_logged_content(log, pendingFile, new_data_name, pendingReference);
+
+    //Keep the log and the files as these would be found after a crash.
+    log.Sync();
+    copy_file(log_name, log_copy);
+    copy_file(new_data_name, data_copy);
+  }
+
+  //Only what was committed is found in the files.
+  result &= ! whf_file_exists(log_name);
+  result &= check_content(data_name, reference);
+  result &= check_content(new_data_name, pendingCommitted);
+
+  copy_file(data_copy, new_data_name);
+  copy_file(log_copy, log_name);
+  whf_remove(data_copy);
+  whf_remove(log_copy);
+  {
+    WriteAheadLog log("", log_name, WAL_SYNC_COMMIT, CHECKPOINT_SIZE);
+  }
+
+  result &= check_content(new_data_name, pendingCommitted);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+
+    vector<uint8_t> committed, newCommitted;
+
+    success &= test_logged_reads(committed, newCommitted);
+    success &= test_recovery(committed, newCommitted);
+    success &= test_checkpoint();
+    success &= test_pending_writes_checkpoint();
+
+    whf_remove(data_name);
+    whf_remove(new_data_name);
+  }
+
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 1;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -43,6 +43,40 @@ create_container(uint_t max_file_size, const uint_t container_size)
   return container.Size() == container_size;
 }
 
+static bool
+create_container_vectored(uint_t max_file_size, const uint_t container_size)
+{
+  FileContainer container(fileName, max_file_size, 0, true);
+  static uint8_t buffers[4][sizeof buffer];
+  uint8_t marker = 0;
+  uint64_t current_pos = 0;
+  uint_t left_to_write = container_size;
+
+  while (left_to_write > 0)
+    {
+      WIOVec vecs[4];
+      uint_t vecs_count = 0;
+      uint_t write_size = 0;
+
+      while ((vecs_count < 4) && (write_size < left_to_write))
+        {
+          const uint_t size = MIN(sizeof(buffer), left_to_write - write_size);
+
+          memset(buffers[vecs_count], marker, size);
+          vecs[vecs_count].buffer = buffers[vecs_count];
+          vecs[vecs_count++].size = size;
+
+          marker = (marker + 1) & 0xFF;
+          write_size += size;
+        }
+
+      container.Write(current_pos, vecs, vecs_count);
+      left_to_write -= write_size;
+      current_pos += write_size;
+    }
+  return container.Size() == container_size;
+}
+
 static bool
 check_container(uint_t max_file_size,
                  const uint_t container_size,
@@ -97,6 +131,71 @@ colapse_container(uint_t max_file_size, const uint_t container_size)
   return new_container_size;
 }
 
+static bool
+check_mapped_container(uint_t max_file_size, const uint_t container_size)
+{
+  const uint_t window_size = MappedFileContainer::MAP_WINDOW_SIZE;
+  bool result = true;
+
+  {
+    MappedFileContainer container(fileName,
+                                  max_file_size,
+                                  (container_size / max_file_size) + 1);
+    if (container.Size() != container_size)
+      return false;
+
+    //The mapped content should match what was written through the files.
+    for (uint_t pos = 0; (pos < container_size) && result; )
+      {
+        const uint8_t marker = (pos / sizeof buffer) & 0xFF;
+        const uint_t end = MIN(pos + sizeof buffer, container_size);
+
+        //A mapping does not span over two units or windows, so split the chunk.
+        for (; (pos < end) && result; )
+          {
+            const uint_t unit_pos = pos % max_file_size;
+            const uint_t window_left = MIN(max_file_size - unit_pos,
+                                           window_size - unit_pos % window_size);
+            const uint_t size = MIN(end - pos, window_left);
+            uint8_t* const content = container.MappedAddress(pos, size);
+
+            if ((content == nullptr) || (content[size - 1] != marker))
+              result = false;
+
+            else
+              {
+                //Update in place, the write back should be a no op.
+                memset(content, 0xA5, size);
+                container.Write(pos, size, content);
+              }
+            pos += size;
+          }
+      }
+
+    if (container.MappedAddress(container_size - 1, 2) != nullptr)
+      result = false;
+
+    if ((max_file_size > window_size)
+        && (container_size > window_size)
+        && (container.MappedAddress(window_size - 1, 2) != nullptr))
+      {
+        result = false;
+      }
+
+    container.Flush();
+  }
+
+  if (result)
+    {
+      FileContainer container(fileName, max_file_size, (container_size / max_file_size) + 1, false);
+
+      container.Read(container_size - 1, 1, buffer);
+      result = (buffer[0] == 0xA5);
+    }
+
+  return result;
+}
+
 static bool
 check_temp_container(uint_t uTestContainerSize)
 {
@@ -174,6 +273,29 @@ main()
   if (!check_container(max_file_size, container_size, 0, 1))
     success = false;
 
+  if (!create_container_vectored(max_file_size, container_size))
+    success = false;
+
+  if (!check_container(max_file_size, container_size, 0, 1))
+    success = false;
+
+  if (!check_mapped_container(max_file_size, container_size))
+    success = false;
+
+  //Units larger than a window are mapped piece by piece.
+  {
+    const uint_t window_size = MappedFileContainer::MAP_WINDOW_SIZE;
+
+    if (!create_container(2 * window_size + 4096, window_size + 3 * sizeof buffer))
+      success = false;
+
+    if (!check_mapped_container(2 * window_size + 4096, window_size + 3 * sizeof buffer))
+      success = false;
+  }
+
+  if (!create_container(max_file_size, container_size))
+    success = false;
+
   uint64_t new_container_size = colapse_container(max_file_size,
                                 container_size);
   if ((new_container_size <= 0) || (new_container_size % sizeof buffer) != 0)
@@ -10,7 +10,9 @@ wpastra_SRC:=pastra/ps_values.cpp pastra/ps_container.cpp pastra/ps_table.cpp\
 		   	pastra/ps_dbsmgr.cpp pastra/ps_serializer.cpp pastra/ps_varstorage.cpp\
 		   	pastra/ps_blockcache.cpp pastra/ps_textstrategy.cpp pastra/ps_arraystrategy.cpp\
 		   	pastra/ps_btree_index.cpp pastra/ps_btree_fields.cpp pastra/ps_templatetable.cpp\
-		   	pastra/ps_exception.cpp pastra/ps_valtranslator.cpp
+		   	pastra/ps_exception.cpp pastra/ps_valtranslator.cpp pastra/ps_bufferpool.cpp\
+		   	pastra/ps_rowsset.cpp pastra/ps_wal.cpp pastra/ps_writeback.cpp\
+		   	pastra/ps_zonemap.cpp pastra/ps_hashindex.cpp
 
 wpastra_cmn_DEF:=WVER_MAJ=1 WVER_MIN=0
 wpastra_DEF:=USE_CUSTOM_SHL USE_DBS_SHL DBS_EXPORTING $(wpastra_cmn_DEF)
@@ -25,6 +27,7 @@ wslpastra_SRC:=$(wpastra_SRC)
 wslpastra_INC:=$(wpastra_INC)
 
 ifeq ($(BUILD_TESTS),yes)
+wslpastra_SRC+=test/test_dbs_common.cpp
 -include ./$(UNIT)/test/test.mk
 endif
 
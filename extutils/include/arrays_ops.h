@@ -10,6 +10,7 @@
 
 #include "whais.h"
 #include "dbs/dbs_values.h"
+#include "dbs/dbs_rowsset.h"
 
 
 whais::DArray
@@ -21,6 +22,15 @@ array_intersect(const whais::DArray& array1, const whais::DArray& array2);
 whais::DArray
 array_get_uniques(const whais::DArray& array);
 
+whais::RowsSet
+array_unite(const whais::RowsSet& set1, const whais::RowsSet& set2);
+
+whais::RowsSet
+array_intersect(const whais::RowsSet& set1, const whais::RowsSet& set2);
+
+whais::RowsSet
+array_subtract(const whais::RowsSet& set1, const whais::RowsSet& set2);
+
 
 template<typename T> int64_t
 find_in_sorted_array(const whais::DArray& array, const T& value)
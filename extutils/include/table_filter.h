@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "dbs/dbs_types.h"
 #include "dbs/dbs_table.h"
+#include "dbs/dbs_rowsset.h"
 
 
 namespace whais {
@@ -73,7 +74,7 @@ class TableFilterRunnerRule
 public:
   virtual ~TableFilterRunnerRule() = default;
 
-  virtual DArray MatchRows(const DArray& rowsSet) = 0;
+  virtual RowsSet MatchRows(const RowsSet& rowsSet) = 0;
   virtual bool   RowIsMatching(const ITable& table, ROW_INDEX row) = 0;
   virtual bool   IsSearchIndexed() const = 0;
 };
@@ -87,6 +88,7 @@ public:
   bool AddFilterRules(TableFieldValuesFilter& filter);
 
   DArray Run();
+  RowsSet MatchingRows();
 
   void ResetRowsFilter();
   void ResetFilterRules();
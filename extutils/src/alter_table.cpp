@@ -722,6 +722,9 @@ TableAlterRules::Commit()
   {
       CommitToTable(*table, allRows);
 
+      //The copy has to be safe before the original table is deleted.
+      table->Flush();
+
       mDbs.ReleaseTable(*mTable);
       mTable = nullptr;
       mDbs.SyncAllTablesContent();
@@ -294,3 +294,30 @@ array_get_uniques(const whais::DArray& array)
                      "Unexpected array type %d",
                      array.Type());
 }
+
+
+whais::RowsSet
+array_unite(const whais::RowsSet& set1, const whais::RowsSet& set2)
+{
+  RowsSet result = set1;
+
+  return result.Unite(set2);
+}
+
+
+whais::RowsSet
+array_intersect(const whais::RowsSet& set1, const whais::RowsSet& set2)
+{
+  RowsSet result = set1;
+
+  return result.Intersect(set2);
+}
+
+
+whais::RowsSet
+array_subtract(const whais::RowsSet& set1, const whais::RowsSet& set2)
+{
+  RowsSet result = set1;
+
+  return result.Subtract(set2);
+}
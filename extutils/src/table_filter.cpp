@@ -465,35 +465,31 @@ public:
 
   ~TableFilterRunnerFieldRule() = default;
 
-  DArray MatchRows(const DArray& rowsSet) override
+  RowsSet MatchRows(const RowsSet& rowsSet) override
   {
-    DArray result;
+    RowsSet result;
 
     BuildValuesIntervals();
     if ( ! IsSearchIndexed())
     {
-      ROW_INDEX rowsCount = rowsSet.Count();
-      for (ROW_INDEX i = 0; i < rowsCount; ++i)
-      {
-        DUInt32 row;
-        if (RowIsMatching(mTable, row.mValue))
+      rowsSet.ForEach([this, &result](const ROW_INDEX row) {
+        if (RowIsMatching(mTable, row))
           result.Add(row);
-      }
-      result.Sort();
+      });
+
       return result;
     }
 
     for (auto entry = mValues.begin(); entry != mValues.end(); ++entry)
     {
-      DArray entryMatches = mTable.MatchRows(get<0>(*entry),
-                                             get<1>(*entry),
-                                             0,
-                                             mTable.AllocatedRows(),
-                                             mField);
-      result = array_unite(result, entryMatches);
+      result.Unite(mTable.MatchRowsSet(get<0>(*entry),
+                                       get<1>(*entry),
+                                       0,
+                                       mTable.AllocatedRows(),
+                                       mField));
     }
 
-    return array_intersect(rowsSet, result);
+    return result.Intersect(rowsSet);
   }
 
   bool RowIsMatching(const ITable& table, ROW_INDEX row) override
@@ -911,9 +907,16 @@ TableFilterRunner::ResetFilterRules()
 
 DArray
 TableFilterRunner::Run()
+{
+  return MatchingRows().ToArray();
+}
+
+
+RowsSet
+TableFilterRunner::MatchingRows()
 {
   if (mTable.AllocatedRows() == 0)
-    return DArray();
+    return RowsSet();
 
   vector<tuple<ROW_INDEX, ROW_INDEX>> rowsIntervals;
   for (const auto& interval : mRowsIntervals)
@@ -925,15 +928,12 @@ TableFilterRunner::Run()
   for (const auto& interval : mExcludedRowsIntervals)
     exclude_interval(rowsIntervals, get<0>(interval), get<1>(interval));
 
-  DArray result;
+  RowsSet result;
   for (const auto& interval : rowsIntervals)
-  {
-    for (ROW_INDEX row = get<0>(interval); row <= get<1>(interval); ++row)
-      result.Add(DUInt32(row));
-  }
+    result.AddRange(get<0>(interval), get<1>(interval));
 
   bool allIndexed = true;
-  for (size_t rulesUsed = 0; rulesUsed < mFilterRules.size(); ++rulesUsed)
+  for (size_t rulesUsed = 0; (rulesUsed < mFilterRules.size()) && ! result.IsEmpty(); ++rulesUsed)
   {
     if (! mFilterRules[rulesUsed]->IsSearchIndexed())
     {
@@ -943,27 +943,22 @@ TableFilterRunner::Run()
     result = mFilterRules[rulesUsed]->MatchRows(result);
   }
 
-  if (allIndexed)
+  if (allIndexed || result.IsEmpty())
     return result;
 
-  DArray temp = result;
-  result = DArray();
-  for (uint64_t rowIdx = 0; rowIdx < temp.Count(); ++rowIdx)
-  {
-    bool matches = true;
-    DUInt32 row;
-    temp.Get(rowIdx, row);
-    for (size_t rulesUsed = 0; (rulesUsed < mFilterRules.size()) && matches; ++rulesUsed)
+  RowsSet matched;
+  result.ForEach([this, &matched](const ROW_INDEX row) {
+    for (auto rule : mFilterRules)
     {
-      if (mFilterRules[rulesUsed]->IsSearchIndexed())
+      if (rule->IsSearchIndexed())
         continue ;
-      matches &= mFilterRules[rulesUsed]->RowIsMatching(mTable, row.mValue);
+
+      if ( ! rule->RowIsMatching(mTable, row))
+        return;
     }
 
-    if (matches)
-      result.Add(row);
-  }
+    matched.Add(row);
+  });
 
-  return result;
+  return matched;
 }
-
@@ -35,8 +35,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 typedef int             WH_FILE;
 typedef pthread_mutex_t WH_LOCK;
+typedef pthread_rwlock_t WH_RWLOCK;
+typedef pthread_cond_t  WH_COND;
 typedef pthread_t       WH_THREAD;
 typedef int             WH_SOCKET;
+typedef int             WH_POLLER;
 typedef void*           WH_SHLIB;
 
 #ifndef uint8_t
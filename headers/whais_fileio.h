@@ -39,6 +39,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define WH_SEEK_CURR           0x00000002
 #define WH_SEEK_END            0x00000004
 
+typedef struct
+{
+  const uint8_t*  buffer;
+  uint_t          size;
+}WIOVec;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -53,6 +59,15 @@ whf_read(WH_FILE hnd, uint8_t* dstBuffer, uint_t size);
 CUSTOM_SHL bool_t 
 whf_write(WH_FILE hnd, const uint8_t* srcBuffer, uint_t size);
 
+CUSTOM_SHL bool_t 
+whf_pread(WH_FILE hnd, uint64_t offset, uint8_t* dstBuffer, uint_t size);
+
+CUSTOM_SHL bool_t 
+whf_pwrite(WH_FILE hnd, uint64_t offset, const uint8_t* srcBuffer, uint_t size);
+
+CUSTOM_SHL bool_t 
+whf_pwritev(WH_FILE hnd, uint64_t offset, const WIOVec* vecs, uint_t vecsCount);
+
 CUSTOM_SHL bool_t 
 whf_seek(WH_FILE hnd, int64_t where, int whence);
 
@@ -71,6 +86,15 @@ whf_set_size(WH_FILE, const uint64_t newSize);
 CUSTOM_SHL bool_t 
 whf_close(WH_FILE hnd);
 
+CUSTOM_SHL void* 
+whf_map(WH_FILE hnd, uint64_t offset, uint64_t size);
+
+CUSTOM_SHL bool_t 
+whf_sync_map(void* address, uint64_t size);
+
+CUSTOM_SHL bool_t 
+whf_unmap(void* address, uint64_t size);
+
 CUSTOM_SHL uint32_t 
 whf_last_error();
 
@@ -80,7 +104,7 @@ whf_err_to_str(uint64_t errorCode, char* str, uint_t strSize);
 CUSTOM_SHL bool_t 
 whf_remove(const char* const file);
 
-CUSTOM_SHL void 
+CUSTOM_SHL bool_t 
 whf_move_file(const char* existingFIle, const char* newFile );
 
 CUSTOM_SHL const char 
@@ -58,12 +58,58 @@ whs_read(const WH_SOCKET           sd,
           uint8_t*                  dstBuffer,
           uint_t* const             inoutCount);
 
+/* Same as 'whs_read()' but it returns only the data already received. If
+ * none is pending '*inoutCount' is set to 0, and a connection closed by the
+ * peer is reported as an error. */
+CUSTOM_SHL uint32_t
+whs_read_nowait(const WH_SOCKET    sd,
+                uint8_t*           dstBuffer,
+                uint_t* const      inoutCount);
+
+CUSTOM_SHL void 
+whs_shutdown(const WH_SOCKET socket);
+
 CUSTOM_SHL void 
 whs_close(const WH_SOCKET socket);
 
 CUSTOM_SHL void 
 whs_clean();
 
+
+/* Sockets pollers. Every socket added to a poller is watched for one event
+ * only. Once reported by 'whs_poller_wait()' the socket is disarmed until
+ * 'whs_poller_rearm()' is called, so several threads may wait on the same
+ * poller and each ready socket is handed to one of them only. */
+#define WH_POLL_READ      0x01
+#define WH_POLL_WRITE     0x02
+
+CUSTOM_SHL uint32_t 
+whs_poller_create(WH_POLLER* const outPoller);
+
+CUSTOM_SHL uint32_t 
+whs_poller_add(const WH_POLLER         poller,
+               const WH_SOCKET         sd,
+               const uint_t            events,
+               void* const             data);
+
+CUSTOM_SHL uint32_t 
+whs_poller_rearm(const WH_POLLER       poller,
+                 const WH_SOCKET       sd,
+                 const uint_t          events,
+                 void* const           data);
+
+CUSTOM_SHL uint32_t 
+whs_poller_remove(const WH_POLLER      poller,
+                  const WH_SOCKET      sd);
+
+CUSTOM_SHL uint32_t 
+whs_poller_wait(const WH_POLLER        poller,
+                const uint_t           timeoutMsec,
+                void** const           outData);
+
+CUSTOM_SHL void 
+whs_poller_close(const WH_POLLER poller);
+
 #ifdef __cplusplus
 }
 #endif
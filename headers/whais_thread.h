@@ -48,6 +48,38 @@ wh_lock_try_acquire(WH_LOCK* const lock,
 CUSTOM_SHL uint_t 
 wh_lock_release(WH_LOCK* const lock);
 
+CUSTOM_SHL uint_t 
+wh_rwlock_init(WH_RWLOCK* const lock);
+
+CUSTOM_SHL uint_t 
+wh_rwlock_destroy(WH_RWLOCK* const lock);
+
+CUSTOM_SHL uint_t 
+wh_rwlock_acquire(WH_RWLOCK* const lock, const bool_t shared);
+
+CUSTOM_SHL uint_t 
+wh_rwlock_try_acquire(WH_RWLOCK* const lock,
+                       const bool_t     shared,
+                       bool_t* const    outAcquired);
+
+CUSTOM_SHL uint_t 
+wh_rwlock_release(WH_RWLOCK* const lock, const bool_t shared);
+
+CUSTOM_SHL uint_t 
+wh_cond_init(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_destroy(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock);
+
+CUSTOM_SHL uint_t 
+wh_cond_signal(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_broadcast(WH_COND* const cond);
+
 CUSTOM_SHL uint_t 
 wh_thread_create(WH_THREAD*                    outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -62,6 +94,9 @@ wh_yield();
 CUSTOM_SHL void 
 wh_sleep(const uint_t millisecs);
 
+CUSTOM_SHL uint_t 
+wh_cpus_count();
+
 CUSTOM_SHL int16_t 
 wh_atomic_fetch_inc16(volatile int16_t* const value);
 
@@ -80,6 +115,9 @@ wh_atomic_fetch_inc64(volatile int64_t* const value);
 CUSTOM_SHL int64_t 
 wh_atomic_fetch_dec64(volatile int64_t* const value);
 
+CUSTOM_SHL int64_t 
+wh_atomic_fetch_add64(volatile int64_t* const value, const int64_t delta);
+
 
 #ifdef __cplusplus
 }
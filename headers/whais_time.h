@@ -50,6 +50,11 @@ wh_get_currtime();
 CUSTOM_SHL WTICKS 
 wh_msec_ticks();
 
+/* A monotonic clock with a microseconds resolution, meant to measure
+   short intervals. Its origin is not specified. */
+CUSTOM_SHL WTICKS 
+wh_usec_ticks();
+
 #ifdef __cplusplus
 }
 #endif
@@ -72,8 +72,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 typedef HANDLE              WH_FILE;
 typedef CRITICAL_SECTION    WH_LOCK;
+typedef SRWLOCK             WH_RWLOCK;
+typedef CONDITION_VARIABLE  WH_COND;
 typedef HANDLE              WH_THREAD;
 typedef SOCKET              WH_SOCKET;
+typedef struct WHPoller*     WH_POLLER;
 typedef HMODULE             WH_SHLIB;
 #endif
 
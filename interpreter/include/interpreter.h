@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define INTERPRETER_H_
 
 #include <string>
+#include <vector>
 
 #include "whais.h"
 
@@ -105,6 +106,52 @@ public:
 
 
 
+/* How a sync statement of a procedure was used since the procedure was
+   loaded. The times are measured in microseconds. */
+struct SyncStatementStats
+{
+  static const uint_t HOLD_BUCKETS = 20;
+
+  uint64_t mAcquiresCount;
+
+  //How many of the acquires had to wait for other thread to leave first.
+  uint64_t mContentionsCount;
+  uint64_t mWaitTime;
+  uint64_t mHoldTime;
+  uint64_t mMaxHoldTime;
+
+  //Bucket 'i' counts the holds that lasted less than 2^i microseconds but
+  //not less than 2^(i - 1). The last bucket counts all the longer ones too.
+  uint64_t mHoldHistogram[HOLD_BUCKETS];
+};
+
+
+
+/* Where the calls of a procedure have spent their time, while their
+   sessions had the profiling enabled. The times are measured in
+   microseconds. */
+struct ProcedureProfile
+{
+  uint64_t mCallsCount;
+  uint64_t mInclusiveTime;
+
+  //The time left after the one spent in the called procedures.
+  uint64_t mExclusiveTime;
+  //The part of the inclusive time spent in the called native procedures.
+  uint64_t mNativeTime;
+  //The part of the exclusive time spent to access the tables' fields.
+  uint64_t mTablesTime;
+
+  //Indexed by the code offsets of the instructions, how many times each
+  //one was executed and how long it took (the called procedures included).
+  //A fused sequence of instructions is accounted to its first one. These
+  //are empty for a native procedure.
+  std::vector<uint64_t> mInstructionHits;
+  std::vector<uint64_t> mInstructionTimes;
+};
+
+
+
 class INTERP_SHL ISession
 {
 public:
@@ -116,6 +163,11 @@ public:
 
   virtual void ExecuteProcedure(const char* const name, SessionStack& stack) = 0;
 
+  /* Look up a procedure once, so it could be called later by the returned
+     id without searching its name again. */
+  virtual uint32_t ResolveProcedure(const char* const name) = 0;
+  virtual void ExecuteProcedure(const uint32_t procId, SessionStack& stack) = 0;
+
   virtual uint_t GlobalValuesCount() const = 0;
   virtual uint_t ProceduresCount() const = 0;
 
@@ -155,6 +207,12 @@ public:
                                            const uint_t param,
                                            const uint_t field) = 0;
 
+  virtual uint_t ProcedureSyncsCount(const uint_t id) const = 0;
+  virtual void ProcedureSyncStats(const uint_t id,
+                                  const uint_t sync,
+                                  SyncStatementStats& outStats) const = 0;
+  virtual void ProcedureProfileStats(const uint_t id, ProcedureProfile& outProfile) const = 0;
+
   virtual bool NotifyEvent(const uint_t event, uint64_t* const extra) = 0;
   Logger& GetLogger() { return mLog; }
 
@@ -162,6 +220,7 @@ public:
   static const uint_t MAX_PROCS_TMO           = 2;
   static const uint_t MAX_STACK_COUNT         = 3;
   static const uint_t MAX_PROCS_CALL_DEPTH    = 4;
+  static const uint_t PROFILE_PROCEDURES      = 5;
 
 protected:
 
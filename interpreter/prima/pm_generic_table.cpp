@@ -100,7 +100,8 @@ GenericTable::MarkRowForReuse(const ROW_INDEX)
 void
 GenericTable::CreateIndex(const FIELD_INDEX,
                            CREATE_INDEX_CALLBACK_FUNC* const,
-                           CreateIndexCallbackContext* const)
+                           CreateIndexCallbackContext* const,
+                           const INDEX_KIND)
 {
   throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
 }
@@ -120,6 +121,13 @@ GenericTable::IsIndexed(const FIELD_INDEX) const
 }
 
 
+INDEX_KIND
+GenericTable::IndexKind(const FIELD_INDEX) const
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
 void
 GenericTable::Set(const ROW_INDEX, const FIELD_INDEX, const DChar&, const bool)
 {
@@ -536,6 +544,171 @@ GenericTable::MatchRows(const DRichReal&,
   throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
 }
 
+
+RowsSet
+GenericTable::MatchRowsSet(const DBool&,
+                           const DBool&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DChar&,
+                           const DChar&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DDate&,
+                           const DDate&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DDateTime&,
+                           const DDateTime&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DHiresTime&,
+                           const DHiresTime&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DUInt8&,
+                           const DUInt8&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DUInt16&,
+                           const DUInt16&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DUInt32&,
+                           const DUInt32&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DUInt64&,
+                           const DUInt64&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DInt8&,
+                           const DInt8&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DInt16&,
+                           const DInt16&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DInt32&,
+                           const DInt32&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DInt64&,
+                           const DInt64&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DReal&,
+                           const DReal&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+RowsSet
+GenericTable::MatchRowsSet(const DRichReal&,
+                           const DRichReal&,
+                           const ROW_INDEX,
+                           const ROW_INDEX,
+                           const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
 void
 GenericTable::Flush()
 {
@@ -51,9 +51,11 @@ public:
 
   virtual void CreateIndex(const FIELD_INDEX field,
                            CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
-                           CreateIndexCallbackContext* const cbCotext);
+                           CreateIndexCallbackContext* const cbCotext,
+                           const INDEX_KIND kind);
   virtual void RemoveIndex(const FIELD_INDEX field) override;
   virtual bool IsIndexed(const FIELD_INDEX field) const override;
+  virtual INDEX_KIND IndexKind(const FIELD_INDEX field) const override;
 
   virtual void Set(const ROW_INDEX   row,
                    const FIELD_INDEX field,
@@ -323,6 +325,96 @@ public:
                            const ROW_INDEX       fromRow,
                            const ROW_INDEX       toRow,
                            const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DBool&          min,
+                               const DBool&          max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DChar&          min,
+                               const DChar&          max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DDate&          min,
+                               const DDate&          max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DDateTime&      min,
+                               const DDateTime&      max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DHiresTime&     min,
+                               const DHiresTime&     max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DUInt8&         min,
+                               const DUInt8&         max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DUInt16&        min,
+                               const DUInt16&        max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DUInt32&        min,
+                               const DUInt32&        max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DUInt64&        min,
+                               const DUInt64&        max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DInt8&          min,
+                               const DInt8&          max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DInt16&         min,
+                               const DInt16&         max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DInt32&         min,
+                               const DInt32&         max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DInt64&         min,
+                               const DInt64&         max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DReal&          min,
+                               const DReal&          max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
+
+  virtual RowsSet MatchRowsSet(const DRichReal&      min,
+                               const DRichReal&      max,
+                               const ROW_INDEX       fromRow,
+                               const ROW_INDEX       toRow,
+                               const FIELD_INDEX     field);
   virtual void Flush() override;
   virtual void LockTable() override;
   virtual void UnlockTable() override;
@@ -55,6 +55,7 @@ GlobalsManager::AddGlobal(const uint8_t* const name,
   const GlobalEntry entry = {IdOffset, typeOffset};
 
   mGlobalsEntrys.push_back(entry);
+  mNamesIndex.Add(name, nameLength, result);
 
   return result;
 }
@@ -64,18 +65,17 @@ GlobalsManager::FindGlobal(const uint8_t* const name, const uint_t nameLength)
 {
   assert(mGlobalsEntrys.size() == mStorage.size());
 
-  uint32_t iterator = 0;
-  for (auto& entry : mGlobalsEntrys)
+  const auto candidates = mNamesIndex.Candidates(name, nameLength);
+
+  for (auto it = candidates.first; it != candidates.second; ++it)
   {
-    const auto entryName = _RC(const char*, &mIdentifiers[entry.mIdOffet]);
+    const auto entryName = _RC(const char*, &mIdentifiers[mGlobalsEntrys[it->second].mIdOffet]);
 
     if (strlen(entryName) == nameLength
         && memcmp(entryName, name, nameLength) == 0)
     {
-      return iterator;
+      return it->second;
     }
-
-    ++iterator;
   }
 
   return INVALID_ENTRY;
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "whais.h"
 
 #include "pm_operand.h"
+#include "pm_symbols.h"
 
 
 namespace whais {
@@ -79,6 +80,7 @@ private:
   std::vector<uint8_t>     mIdentifiers;
   std::vector<GlobalValue> mStorage;
   std::vector<GlobalEntry> mGlobalsEntrys;
+  SymbolsIndex             mNamesIndex;
 };
 
 
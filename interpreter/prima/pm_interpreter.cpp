@@ -191,7 +191,8 @@ Session::Session(Logger&           log,
     mGlobalNames(globalNames),
     mPrivateNames(privateNames),
     mMaxStackCount(~0),
-    mServerStopped(false)
+    mServerStopped(false),
+    mProfiling(false)
 {
   DefineTablesGlobalValues();
 }
@@ -411,6 +412,42 @@ Session::ExecuteProcedure(const char* const procedure, SessionStack& stack)
 }
 
 
+uint32_t
+Session::ResolveProcedure(const char* const procedure)
+{
+  const uint32_t procId = FindProcedure(_RC(const uint8_t*, procedure), strlen(procedure));
+
+  if ( !ProcedureManager::IsValid(procId))
+  {
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ),
+                         "Cannot find procedure '%s' to resolve.",
+                         procedure);
+  }
+
+  return procId;
+}
+
+
+void
+Session::ExecuteProcedure(const uint32_t procId, SessionStack& stack)
+{
+  //The id comes from outside, so check it before it's used.
+  const ProcedureManager& procMgr = ProcedureManager::IsGlobalEntry(procId)
+                                    ? mGlobalNames->GetProcedureManager()
+                                    : mPrivateNames->GetProcedureManager();
+
+  if ( !ProcedureManager::IsValid(procId)
+      || (ProcedureManager::EntryIndex(procId) >= procMgr.Count()))
+  {
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ),
+                         "Cannot find procedure with id %u to execute.",
+                         procId);
+  }
+
+  ProcedureCall( *this, stack, GetProcedure(procId));
+}
+
+
 uint_t
 Session::GlobalValuesCount() const
 {
@@ -435,6 +472,13 @@ Session::GlobalValueName(const uint_t index) const
 const char*
 Session::ProcedureName(const uint_t index) const
 {
+  //Let the ids of the resolved global procedures be named too.
+  if (ProcedureManager::IsGlobalEntry(index))
+  {
+    const ProcedureManager& procMgr = mGlobalNames->GetProcedureManager();
+    return _RC(const char*, procMgr.Name(ProcedureManager::EntryIndex(index)));
+  }
+
   return _RC(const char*, mPrivateNames->GetProcedureManager().Name(index));
 }
 
@@ -657,6 +701,38 @@ Session::ProcedurePameterFieldType(const char* const name,
   return ProcedurePameterFieldType(procId, param, field);
 }
 
+uint_t
+Session::ProcedureSyncsCount(const uint_t id) const
+{
+  const ProcedureManager& procMgr = ProcedureManager::IsGlobalEntry(id)
+                                    ? mGlobalNames->GetProcedureManager()
+                                    : mPrivateNames->GetProcedureManager();
+
+  return procMgr.SyncsCount(id);
+}
+
+void
+Session::ProcedureSyncStats(const uint_t id,
+                            const uint_t sync,
+                            SyncStatementStats& outStats) const
+{
+  const ProcedureManager& procMgr = ProcedureManager::IsGlobalEntry(id)
+                                    ? mGlobalNames->GetProcedureManager()
+                                    : mPrivateNames->GetProcedureManager();
+
+  procMgr.SyncStats(id, sync, outStats);
+}
+
+void
+Session::ProcedureProfileStats(const uint_t id, ProcedureProfile& outProfile) const
+{
+  const ProcedureManager& procMgr = ProcedureManager::IsGlobalEntry(id)
+                                    ? mGlobalNames->GetProcedureManager()
+                                    : mPrivateNames->GetProcedureManager();
+
+  procMgr.ProfileStats(id, outProfile);
+}
+
 bool
 Session::NotifyEvent(const uint_t event, uint64_t* const extra)
 {
@@ -681,6 +757,18 @@ Session::NotifyEvent(const uint_t event, uint64_t* const extra)
     log.Log(LT_INFO, s.str());
     mMaxStackCount = *extra;
   }
+  else if (event == ISession::PROFILE_PROCEDURES)
+  {
+    if (extra == nullptr)
+    {
+      log.Log(LT_ERROR, "Could not set the procedures profiling because the value is missing.");
+      return false;
+    }
+
+    mProfiling = (*extra != 0);
+    log.Log(LT_INFO,
+            mProfiling ? "The procedures are profiled." : "The procedures are not profiled.");
+  }
   else
     return false;
 
@@ -71,6 +71,11 @@ public:
   virtual void ExecuteProcedure(const char* const   procedure,
                                  SessionStack&       stack);
 
+  virtual uint32_t ResolveProcedure(const char* const procedure) override;
+
+  virtual void ExecuteProcedure(const uint32_t    procId,
+                                SessionStack&     stack) override;
+
   virtual uint_t GlobalValuesCount() const override;
 
   virtual uint_t ProceduresCount() const override;
@@ -112,6 +117,13 @@ public:
                                            const uint_t param,
                                            const uint_t field);
 
+  virtual uint_t ProcedureSyncsCount(const uint_t id) const override;
+  virtual void ProcedureSyncStats(const uint_t id,
+                                  const uint_t sync,
+                                  SyncStatementStats& outStats) const override;
+  virtual void ProcedureProfileStats(const uint_t id,
+                                     ProcedureProfile& outProfile) const override;
+
   virtual bool NotifyEvent(const uint_t event, uint64_t* const extra) override;
 
   uint32_t FindGlobal(const uint8_t* name, const uint_t nameLength);
@@ -132,6 +144,7 @@ public:
 
   bool IsServerShoutdowing() const { return mServerStopped; }
   uint_t MaxStackCount() const { return mMaxStackCount; }
+  bool IsProfiling() const { return mProfiling; }
 
   void LogMessage(const std::string& msg) {/* TODO: It needs to be implemented */ }
 
@@ -161,6 +174,7 @@ private:
   std::vector<WH_SHLIB>      mNativeLibs;
   volatile uint_t            mMaxStackCount;
   volatile bool              mServerStopped;
+  volatile bool              mProfiling;
 };
 
 
@@ -37,6 +37,25 @@ namespace whais {
 namespace prima {
 
 
+class ProcedureCall;
+
+//Accounts the time taken by a table field access to the profiled
+//procedure call that runs on this thread, when there is one.
+class TableAccessProfile
+{
+public:
+  TableAccessProfile();
+  ~TableAccessProfile();
+
+  TableAccessProfile(const TableAccessProfile&) = delete;
+  TableAccessProfile& operator= (const TableAccessProfile&) = delete;
+
+private:
+  ProcedureCall* const    mCall;
+  const WTICKS            mStart;
+};
+
+
 template <typename T_DEST, typename T_SRC> T_DEST
 internal_add(const T_DEST& firstOp, const T_SRC& secondOp)
 {
@@ -1799,6 +1818,7 @@ protected:
 
   template<typename DBS_T> void Get(DBS_T& out) const
   {
+    TableAccessProfile profile;
     ITable& table = mTableRef->GetTable();
 
     if (table.AllocatedRows() <= mRow)
@@ -1812,6 +1832,7 @@ protected:
 
   template <typename DBS_T> void Set(const DBS_T& value)
   {
+    TableAccessProfile profile;
     ITable& table = mTableRef->GetTable();
 
     table.Set(mRow, mField, value);
@@ -2530,6 +2551,7 @@ protected:
 
   template <typename DBS_T> void Get(DBS_T& outValue) const
   {
+    TableAccessProfile profile;
     ITable& table = mTableRef->GetTable();
 
     if (table.AllocatedRows() <= mRow)
@@ -2553,6 +2575,7 @@ protected:
 
   template <typename DBS_T> void Set(const DBS_T& value)
   {
+    TableAccessProfile profile;
     ITable& table = mTableRef->GetTable();
 
     DArray array;
@@ -36,6 +36,7 @@ namespace prima {
 bool
 CharTextFieldElOperand::IsNull() const
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   DText text;
@@ -48,6 +49,7 @@ CharTextFieldElOperand::IsNull() const
 void
 CharTextFieldElOperand::GetValue(DChar& outValue) const
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   if (table.AllocatedRows() <= mRow)
@@ -84,6 +86,7 @@ CharTextFieldElOperand::GetValue(DText& outValue) const
 void
 CharTextFieldElOperand::SetValue(const DChar& value)
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   DText text;
@@ -117,6 +120,7 @@ CharTextFieldElOperand::Clone() const
 bool
 CharTextFieldElOperand::Iterate(const bool reverse)
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   assert(mRow < table.AllocatedRows());
@@ -160,6 +164,7 @@ BaseArrayFieldElOperand::~BaseArrayFieldElOperand()
 bool
 BaseArrayFieldElOperand::IsNull() const
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   if (table.AllocatedRows() <= mRow)
@@ -175,6 +180,7 @@ BaseArrayFieldElOperand::IsNull() const
 bool
 BaseArrayFieldElOperand::Iterate(const bool reverse)
 {
+  TableAccessProfile profile;
   ITable& table = mTableRef->GetTable();
 
   assert(mRow < table.AllocatedRows());
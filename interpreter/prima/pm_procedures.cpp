@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "pm_procedures.h"
 #include "pm_interpreter.h"
 #include "pm_typemanager.h"
+#include "pm_processor.h"
 
 
 using namespace std;
@@ -71,7 +72,8 @@ ProcedureManager::AddProcedure(const uint8_t* const name,
 
   const uint32_t result = mProcsEntrys.size();
 
-  mSyncStmts.insert(mSyncStmts.end(), syncCount, false);
+  for (uint_t i = 0; i < syncCount; ++i)
+    mSyncStmts.push_back(unique_ptr<SyncStatement>(new SyncStatement()));
 
   for (uint_t i = 0; i < localsCount; ++i)
     mLocalsValues.push_back(StackValue(localValues[i]));
@@ -79,9 +81,22 @@ ProcedureManager::AddProcedure(const uint8_t* const name,
   mIdentifiers.insert(mIdentifiers.end(), name, name + nameLength);
   mIdentifiers.push_back(0);
   mDefinitions.insert(mDefinitions.end(), code, code + codeSize);
+  mDecodedDefinitions.resize(mDefinitions.size());
+  mStaleDecodes.push_back(false);
   mLocalsTypes.insert(mLocalsTypes.end(), typesOffset, typesOffset + localsCount);
 
+  if (unit != nullptr)
+  {
+    DecodeProcedureCode(&mDefinitions[entry.mCodeIndex],
+                        codeSize,
+                        &mDecodedDefinitions[entry.mCodeIndex]);
+  }
+
+  mProfilers.push_back(unique_ptr<ProcedureProfiler>(
+                          new ProcedureProfiler((unit != nullptr) ? codeSize : 0)));
+
   mProcsEntrys.push_back(entry);
+  mNamesIndex.Add(name, nameLength, result);
 
   return result;
 }
@@ -89,8 +104,11 @@ ProcedureManager::AddProcedure(const uint8_t* const name,
 uint32_t
 ProcedureManager::GetProcedure(const uint8_t* const name, const uint_t nameLength) const
 {
-  for (uint32_t index = 0; index < mProcsEntrys.size(); ++index)
+  const auto candidates = mNamesIndex.Candidates(name, nameLength);
+
+  for (auto it = candidates.first; it != candidates.second; ++it)
   {
+    const uint32_t index = it->second;
     const char* const entryName = _RC(const char*, &mIdentifiers[mProcsEntrys[index].mIdIndex]);
 
     if (strlen(entryName) == nameLength
@@ -182,9 +200,34 @@ ProcedureManager::Code(const Procedure& proc, uint_t* const outCodeSize) const
   if (outCodeSize != nullptr)
     *outCodeSize = proc.mCodeSize;
 
+  //The caller may patch the code through the returned pointer (e.g. the
+  //tests do), so have it decoded again before its next execution.
+  mStaleDecodes[proc.mId] = true;
+
   return &mDefinitions[proc.mCodeIndex];
 }
 
+const DecodedOp*
+ProcedureManager::DecodedCode(const Procedure& proc, const uint8_t** const outCode)
+{
+  assert(proc.mProcMgr == this);
+  assert(proc.mNativeCode == nullptr);
+
+  if (mStaleDecodes[proc.mId])
+  {
+    LockGuard<Lock> holder(mSync);
+
+    DecodeProcedureCode(&mDefinitions[proc.mCodeIndex],
+                        proc.mCodeSize,
+                        &mDecodedDefinitions[proc.mCodeIndex]);
+    mStaleDecodes[proc.mId] = false;
+  }
+
+  *outCode = &mDefinitions[proc.mCodeIndex];
+
+  return &mDecodedDefinitions[proc.mCodeIndex];
+}
+
 void
 ProcedureManager::AquireSync(const Procedure& proc, const uint32_t sync)
 {
@@ -194,22 +237,7 @@ ProcedureManager::AquireSync(const Procedure& proc, const uint32_t sync)
   if (sync >= proc.mSyncCount)
     throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
 
-  do
-  {
-    LockGuard<Lock> holder(mSync);
-    const bool aquired = mSyncStmts[proc.mSyncIndex + sync];
-    if (aquired)
-    {
-      //Some one has taken this before us! Prepare to try again!
-      holder.unlock();
-      wh_yield();
-    }
-    else
-    {
-      mSyncStmts[proc.mSyncIndex + sync] = true;
-      break;
-    }
-  } while (true);
+  mSyncStmts[proc.mSyncIndex + sync]->Acquire();
 }
 
 void
@@ -221,9 +249,188 @@ ProcedureManager::ReleaseSync(const Procedure& proc, const uint32_t sync)
   if (sync >= proc.mSyncCount)
     throw InterException( _EXTRA(InterException::INVALID_SYNC_REQ));
 
-  assert(mSyncStmts[proc.mSyncIndex + sync] == true);
+  mSyncStmts[proc.mSyncIndex + sync]->Release();
+}
+
+uint32_t
+ProcedureManager::SyncsCount(const uint_t procId) const
+{
+  const uint32_t procedure = procId & ~GLOBAL_ID;
+
+  if (procedure >= mProcsEntrys.size())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  return mProcsEntrys[procedure].mSyncCount;
+}
+
+void
+ProcedureManager::SyncStats(const uint_t procId,
+                            const uint32_t sync,
+                            SyncStatementStats& outStats) const
+{
+  const uint32_t procedure = procId & ~GLOBAL_ID;
+
+  if (procedure >= mProcsEntrys.size())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  const Procedure& entry = mProcsEntrys[procedure];
+
+  if (sync >= entry.mSyncCount)
+    throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
+
+  mSyncStmts[entry.mSyncIndex + sync]->Stats(outStats);
+}
+
+void
+ProcedureManager::ProfileStats(const uint_t procId, ProcedureProfile& outProfile) const
+{
+  const uint32_t procedure = procId & ~GLOBAL_ID;
+
+  if (procedure >= mProcsEntrys.size())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  mProfilers[procedure]->Stats(outProfile);
+}
+
+
+SyncStatement::SyncStatement()
+  : mAcquireTime(0),
+    mHeld(false)
+{
+  memset(&mStats, 0, sizeof mStats);
+}
+
+void
+SyncStatement::Acquire()
+{
+  LockGuard<Lock> holder(mLock);
+
+  if (mHeld)
+  {
+    //Queue up behind the others. The holder that leaves hands the
+    //statement directly to the first waiter, so no one could jump ahead.
+    Waiter self;
+    self.mGranted = false;
+
+    mWaiters.push_back(&self);
+
+    const WTICKS waitStart = wh_usec_ticks();
+    do
+      self.mWakeUp.wait(mLock);
+    while ( ! self.mGranted);
+
+    ++mStats.mContentionsCount;
+    mStats.mWaitTime += wh_usec_ticks() - waitStart;
+  }
+  else
+    mHeld = true;
+
+  ++mStats.mAcquiresCount;
+  mAcquireTime = wh_usec_ticks();
+}
+
+void
+SyncStatement::Release()
+{
+  LockGuard<Lock> holder(mLock);
+
+  assert(mHeld);
+
+  const WTICKS holdTime = wh_usec_ticks() - mAcquireTime;
+
+  uint_t bucket = 0;
+  while ((bucket < SyncStatementStats::HOLD_BUCKETS - 1) && ((holdTime >> bucket) != 0))
+    ++bucket;
+
+  ++mStats.mHoldHistogram[bucket];
+  mStats.mHoldTime += holdTime;
+  mStats.mMaxHoldTime = MAX(mStats.mMaxHoldTime, holdTime);
+
+  if (mWaiters.empty())
+  {
+    mHeld = false;
+    return;
+  }
+
+  //Signal while the lock is still held, the waiter may leave (and its
+  //wake up condition with it) as soon as it sees itself granted.
+  Waiter* const next = mWaiters.front();
+  mWaiters.pop_front();
+
+  next->mGranted = true;
+  next->mWakeUp.notify_one();
+}
+
+void
+SyncStatement::Stats(SyncStatementStats& outStats)
+{
+  LockGuard<Lock> holder(mLock);
+
+  outStats = mStats;
+}
+
+
+
+ProcedureProfiler::ProcedureProfiler(const uint32_t codeSize)
+  : mCodeSize(codeSize),
+    mCallsCount(0),
+    mInclusiveTime(0),
+    mExclusiveTime(0),
+    mNativeTime(0),
+    mTablesTime(0)
+{
+}
+
+void
+ProcedureProfiler::Prepare()
+{
+  LockGuard<Lock> holder(mLock);
+
+  if ((mHits.get() != nullptr) || (mCodeSize == 0))
+    return;
+
+  mTimes.reset(new volatile int64_t[mCodeSize]);
+  mHits.reset(new volatile int64_t[mCodeSize]);
+
+  for (uint32_t i = 0; i < mCodeSize; ++i)
+  {
+    mHits[i] = 0;
+    mTimes[i] = 0;
+  }
+}
+
+void
+ProcedureProfiler::RecordCall(const uint64_t inclusiveTime,
+                              const uint64_t exclusiveTime,
+                              const uint64_t nativeTime,
+                              const uint64_t tablesTime)
+{
+  wh_atomic_fetch_inc64(&mCallsCount);
+  wh_atomic_fetch_add64(&mInclusiveTime, inclusiveTime);
+  wh_atomic_fetch_add64(&mExclusiveTime, exclusiveTime);
+  wh_atomic_fetch_add64(&mNativeTime, nativeTime);
+  wh_atomic_fetch_add64(&mTablesTime, tablesTime);
+}
+
+void
+ProcedureProfiler::Stats(ProcedureProfile& outProfile)
+{
+  LockGuard<Lock> holder(mLock);
+
+  outProfile.mCallsCount    = mCallsCount;
+  outProfile.mInclusiveTime = mInclusiveTime;
+  outProfile.mExclusiveTime = mExclusiveTime;
+  outProfile.mNativeTime    = mNativeTime;
+  outProfile.mTablesTime    = mTablesTime;
+
+  outProfile.mInstructionHits.clear();
+  outProfile.mInstructionTimes.clear();
+
+  if (mHits.get() == nullptr)
+    return;
 
-  mSyncStmts[proc.mSyncIndex + sync] = false;
+  outProfile.mInstructionHits.assign(mHits.get(), mHits.get() + mCodeSize);
+  outProfile.mInstructionTimes.assign(mTimes.get(), mTimes.get() + mCodeSize);
 }
 
 
@@ -25,11 +25,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PM_PROCEDURES_H_
 #define PM_PROCEDURES_H_
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "whais.h"
 #include "stdlib/interface.h"
 #include "pm_operand.h"
+#include "pm_symbols.h"
 
 
 namespace whais {
@@ -39,6 +42,25 @@ namespace prima {
 class  NameSpace;
 struct Unit;
 class  ProcedureManager;
+class  ProcedureCall;
+
+
+typedef void(*OP_FUNC) (ProcedureCall& call, int64_t& ioOffset);
+
+//An instruction as is prepared to be executed. Every code position has
+//one, so the result of a jump could be dispatched without a lookup.
+//A short sequence of instructions working on local values may be fused
+//in one handler, that finds its operands already decoded here.
+struct DecodedOp
+{
+  OP_FUNC           mHandler;
+  uint8_t           mOpcodeSize;
+  uint8_t           mFusedSize;
+  uint32_t          mFirstLocal;
+  uint32_t          mSecondLocal;
+  int32_t           mJumpOffset;
+  uint64_t          mImmediate;
+};
 
 struct Procedure
 {
@@ -57,6 +79,73 @@ struct Procedure
   ProcedureManager* mProcMgr;
 };
 
+//Guards the execution of a procedure's sync block. The threads that find
+//it taken sleep until they are let in, in the order they have arrived.
+class SyncStatement
+{
+public:
+  SyncStatement();
+  SyncStatement(const SyncStatement&) = delete;
+  SyncStatement& operator= (const SyncStatement&) = delete;
+
+  void Acquire();
+  void Release();
+
+  void Stats(SyncStatementStats& outStats);
+
+private:
+  struct Waiter
+  {
+    Condition   mWakeUp;
+    bool        mGranted;
+  };
+
+  Lock                  mLock;
+  std::deque<Waiter*>   mWaiters;
+  WTICKS                mAcquireTime;
+  bool                  mHeld;
+  SyncStatementStats    mStats;
+};
+
+//Gathers what the profiled calls of a procedure have cost. The calls
+//record concurrently, so the counters are updated atomically and the
+//instructions' ones are allocated only when the first call is profiled.
+class ProcedureProfiler
+{
+public:
+  ProcedureProfiler(const uint32_t codeSize);
+  ProcedureProfiler(const ProcedureProfiler&) = delete;
+  ProcedureProfiler& operator= (const ProcedureProfiler&) = delete;
+
+  void Prepare();
+
+  void RecordCall(const uint64_t inclusiveTime,
+                  const uint64_t exclusiveTime,
+                  const uint64_t nativeTime,
+                  const uint64_t tablesTime);
+
+  void RecordInstruction(const uint32_t offset, const uint64_t usecs)
+  {
+    assert(offset < mCodeSize);
+
+    wh_atomic_fetch_inc64(&mHits[offset]);
+    wh_atomic_fetch_add64(&mTimes[offset], usecs);
+  }
+
+  void Stats(ProcedureProfile& outProfile);
+
+private:
+  Lock                                    mLock;
+  const uint32_t                          mCodeSize;
+  volatile int64_t                        mCallsCount;
+  volatile int64_t                        mInclusiveTime;
+  volatile int64_t                        mExclusiveTime;
+  volatile int64_t                        mNativeTime;
+  volatile int64_t                        mTablesTime;
+  std::unique_ptr<volatile int64_t[]>     mHits;
+  std::unique_ptr<volatile int64_t[]>     mTimes;
+};
+
 class ProcedureManager
 {
 public:
@@ -88,16 +177,26 @@ public:
   const StackValue& LocalValue(const uint_t procId, const uint32_t local) const;
   const uint8_t* LocalTypeDescription(const uint_t procId, const uint32_t local) const;
   const uint8_t* Code(const Procedure& proc, uint_t* const outCodeSize) const;
+  const DecodedOp* DecodedCode(const Procedure& proc, const uint8_t** const outCode);
 
   void AquireSync(const Procedure& proc, const uint32_t sync);
   void ReleaseSync(const Procedure& proc, const uint32_t sync);
 
+  uint32_t SyncsCount(const uint_t procId) const;
+  void SyncStats(const uint_t procId,
+                 const uint32_t sync,
+                 SyncStatementStats& outStats) const;
+
+  ProcedureProfiler& Profiler(const Procedure& proc) { return *mProfilers[proc.mId]; }
+  void ProfileStats(const uint_t procId, ProcedureProfile& outProfile) const;
+
   static bool IsValid(const uint32_t entry) { return entry != INVALID_ENTRY; }
   static bool IsGlobalEntry(const uint32_t entry)
   {
     return IsValid(entry) && ((entry & GLOBAL_ID) != 0);
   }
   static void MarkAsGlobalEntry(uint32_t& entry) { entry |= GLOBAL_ID; }
+  static uint32_t EntryIndex(const uint32_t entry) { return entry & ~GLOBAL_ID; }
 
 
 private:
@@ -107,10 +206,14 @@ private:
   NameSpace&                  mNameSpace;
   std::vector<Procedure>      mProcsEntrys;
   std::vector<uint8_t>        mIdentifiers;
+  SymbolsIndex                mNamesIndex;
   std::vector<StackValue>     mLocalsValues;
   std::vector<uint32_t>       mLocalsTypes;
   std::vector<uint8_t>        mDefinitions;
-  std::vector<bool>           mSyncStmts;
+  std::vector<DecodedOp>      mDecodedDefinitions;
+  mutable std::vector<bool>   mStaleDecodes;
+  std::vector<std::unique_ptr<SyncStatement>> mSyncStmts;
+  std::vector<std::unique_ptr<ProcedureProfiler>> mProfilers;
   Lock                        mSync;
 };
 
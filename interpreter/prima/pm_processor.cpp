@@ -1861,7 +1861,13 @@ op_do_array_op(ProcedureCall& call, int64_t& offset)
 }
 
 
-typedef void(*OP_FUNC) (ProcedureCall& call, int64_t& ioOffset);
+static void
+op_func_invalid(ProcedureCall& call, int64_t& offset)
+{
+  throw InterException(_EXTRA(InterException::INVALID_OP_REQ),
+                       "Encountered an invalid instruction at position %u.",
+                       call.CurrentOffset());
+}
 
 
 static OP_FUNC operations[] = {
@@ -2050,19 +2056,554 @@ static OP_FUNC operations[] = {
                                 op_do_array_op<OP_FILTER_IN>
 };
 
+static const uint8_t operandsSizes[] = {
+                                0,
+                                1, 4, 1, 2, 4, 8, 4, 7, 11, 16, 4, 0, 0,   //ldnull ... ldbf
+                                1, 2, 4, 1, 2, 4,                         //ldlo8 ... ldgb32
+                                1,                                        //cts
+
+                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0,             //stb ... str
+                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0,             //strr ... stud
+
+                                0, 0,                                     //inull, nnull
+                                4, 0,                                     //call, ret
+
+                                0, 0, 0,                                  //add ... addt
+                                0, 0,                                     //and, andb
+                                0, 0, 0,                                  //div ... divrr
+                                0, 0, 0, 0, 0, 0, 0, 0,                   //eq ... eqt
+                                0, 0, 0, 0, 0, 0, 0,                      //ge ... gerr
+                                0, 0, 0, 0, 0, 0, 0,                      //gt ... gtrr
+                                0, 0, 0, 0, 0, 0, 0,                      //le ... lerr
+                                0, 0, 0, 0, 0, 0, 0,                      //lt ... ltrr
+                                0, 0,                                     //mod, modu
+                                0, 0, 0,                                  //mul ... mulrr
+                                0, 0, 0, 0, 0, 0, 0, 0,                   //ne ... net
+                                0, 0,                                     //not, notb
+                                0, 0,                                     //or, orb
+                                0, 0,                                     //sub, subrr
+                                0, 0,                                     //xor, xorb
+
+                                4, 4, 4, 4, 4,                            //jf ... jmp
+
+                                0, 0, 0, 4, 4,                            //indt ... self
+                                1, 1,                                     //bsync, esync
+
+                                0, 0, 0, 0,                               //sadd ... saddt
+                                0, 0,                                     //ssub, ssubrr
+                                0, 0, 0,                                  //smul ... smulrr
+                                0, 0, 0,                                  //sdiv ... sdivrr
+                                0, 0,                                     //smod, smodu
+                                0, 0,                                     //sand, sandb
+                                0, 0,                                     //sxor, sxorb
+                                0, 0,                                     //sor, sorb
+
+                                0, 0, 0, 0, 0, 0,                         //itf ... fid
+                                3,                                        //carr
+                                1, 1, 1                                   //ajoin, afout, afin
+};
+
+
+template <class DBS_T, bool IMMEDIATE> static inline void
+fused_second_operand(ProcedureCall& call, const DecodedOp& op, DBS_T& outValue)
+{
+  if (IMMEDIATE)
+    outValue = DBS_T(_SC(decltype(outValue.mValue), op.mImmediate));
+
+  else
+    call.GetStack()[call.StackBegin() + op.mSecondLocal].Operand().GetValue(outValue);
+}
+
+
+//Same as 'ldlo a; ldlo b|ldi b; sXX; cts 1', but done straight on the local.
+template <class DBS_T, void (IOperand::*SELF_OP)(const DBS_T&), bool IMMEDIATE> static void
+op_fused_self(ProcedureCall& call, int64_t& offset)
+{
+  const DecodedOp& op = call.CurrentOp();
+  SessionStack& stack = call.GetStack();
+
+  assert(op.mFirstLocal < call.LocalsCount());
+
+  DBS_T delta;
+  fused_second_operand<DBS_T, IMMEDIATE>(call, op, delta);
+
+  (stack[call.StackBegin() + op.mFirstLocal].Operand().*SELF_OP)(delta);
+
+  offset = op.mFusedSize;
+}
+
+
+struct FusedAdd
+{
+  template <class DBS_T> static DBS_T
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    return DBS_T(first.mValue + second.mValue);
+  }
+};
+
+struct FusedSub
+{
+  template <class DBS_T> static DBS_T
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    return DBS_T(first.mValue - second.mValue);
+  }
+};
+
+struct FusedMul
+{
+  template <class DBS_T> static DBS_T
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    return DBS_T(first.mValue * second.mValue);
+  }
+};
+
+
+//Same as 'ldlo a; ldlo b|ldi b; add|sub|mul'.
+template <class DBS_T, class OP_T, bool IMMEDIATE> static void
+op_fused_arithmetic(ProcedureCall& call, int64_t& offset)
+{
+  const DecodedOp& op = call.CurrentOp();
+  SessionStack& stack = call.GetStack();
+
+  assert(op.mFirstLocal < call.LocalsCount());
+
+  DBS_T firstOp, secondOp;
+
+  stack[call.StackBegin() + op.mFirstLocal].Operand().GetValue(firstOp);
+  fused_second_operand<DBS_T, IMMEDIATE>(call, op, secondOp);
+
+  if (firstOp.IsNull() || secondOp.IsNull())
+    stack.Push(DBS_T());
+
+  else
+    stack.Push(OP_T::Eval(firstOp, secondOp));
+
+  offset = op.mFusedSize;
+}
+
+
+struct FusedEq
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    return DBool(first == second);
+  }
+};
+
+struct FusedNe
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    return DBool((first == second) == false);
+  }
+};
+
+struct FusedLt
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    if (first.IsNull() || second.IsNull())
+      return DBool();
+
+    return DBool(first < second);
+  }
+};
+
+struct FusedLe
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    if (first.IsNull() || second.IsNull())
+      return DBool();
+
+    return DBool((first < second) || (first == second));
+  }
+};
+
+struct FusedGt
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    if (first.IsNull() || second.IsNull())
+      return DBool();
+
+    return DBool(((first < second) || (first == second)) == false);
+  }
+};
+
+struct FusedGe
+{
+  template <class DBS_T> static DBool
+  Eval(const DBS_T& first, const DBS_T& second)
+  {
+    if (first.IsNull() || second.IsNull())
+      return DBool();
+
+    return DBool((first < second) == false);
+  }
+};
+
+
+//Same as 'ldlo a; ldlo b|ldi b; <compare>; jfc|jtc offset'.
+template <class DBS_T, class OP_T, bool IMMEDIATE, bool JUMP_ON> static void
+op_fused_compare(ProcedureCall& call, int64_t& offset)
+{
+  const DecodedOp& op = call.CurrentOp();
+
+  assert(op.mFirstLocal < call.LocalsCount());
+
+  DBS_T firstOp, secondOp;
+
+  call.GetStack()[call.StackBegin() + op.mFirstLocal].Operand().GetValue(firstOp);
+  fused_second_operand<DBS_T, IMMEDIATE>(call, op, secondOp);
+
+  const DBool result = OP_T::Eval(firstOp, secondOp);
+
+  if ((result.IsNull() == false) && (result.mValue == JUMP_ON))
+    offset = op.mJumpOffset;
+
+  else
+    offset = op.mFusedSize;
+}
+
+
+#define FUSED_SELF(type, self)                                         \
+  {op_fused_self<type, &IOperand::self, false>,                        \
+   op_fused_self<type, &IOperand::self, false>},                       \
+  {op_fused_self<type, &IOperand::self, true>,                         \
+   op_fused_self<type, &IOperand::self, true>}
+
+#define FUSED_ARITHMETIC(type, operation)                              \
+  {op_fused_arithmetic<type, operation, false>,                        \
+   op_fused_arithmetic<type, operation, false>},                       \
+  {op_fused_arithmetic<type, operation, true>,                         \
+   op_fused_arithmetic<type, operation, true>}
+
+#define FUSED_COMPARE(type, operation)                                 \
+  {op_fused_compare<type, operation, false, false>,                    \
+   op_fused_compare<type, operation, false, true>},                    \
+  {op_fused_compare<type, operation, true, false>,                     \
+   op_fused_compare<type, operation, true, true>}
+
+
+enum FUSED_KIND
+{
+  FUSED_SELF,
+  FUSED_ARITHMETIC,
+  FUSED_COMPARE
+};
+
+struct FusedOpcode
+{
+  W_OPCODE      mOpcode;
+  FUSED_KIND    mKind;
+  bool          mUnsigned;
+
+  //Indexed by the second operand being an immediate value, then by the
+  //condition a compare has to jump on.
+  OP_FUNC       mHandlers[2][2];
+};
+
+
+static const FusedOpcode fusedOpcodes[] = {
+    {W_SADD,  FUSED_SELF, false, {FUSED_SELF(DInt64, SelfAdd)}},
+    {W_SSUB,  FUSED_SELF, false, {FUSED_SELF(DInt64, SelfSub)}},
+    {W_SMUL,  FUSED_SELF, false, {FUSED_SELF(DInt64, SelfMul)}},
+    {W_SMULU, FUSED_SELF, true,  {FUSED_SELF(DUInt64, SelfMul)}},
+    {W_SDIV,  FUSED_SELF, false, {FUSED_SELF(DInt64, SelfDiv)}},
+    {W_SDIVU, FUSED_SELF, true,  {FUSED_SELF(DUInt64, SelfDiv)}},
+    {W_SMOD,  FUSED_SELF, false, {FUSED_SELF(DInt64, SelfMod)}},
+    {W_SMODU, FUSED_SELF, true,  {FUSED_SELF(DUInt64, SelfMod)}},
+
+    {W_ADD,   FUSED_ARITHMETIC, false, {FUSED_ARITHMETIC(DInt64, FusedAdd)}},
+    {W_SUB,   FUSED_ARITHMETIC, false, {FUSED_ARITHMETIC(DInt64, FusedSub)}},
+    {W_MUL,   FUSED_ARITHMETIC, false, {FUSED_ARITHMETIC(DInt64, FusedMul)}},
+    {W_MULU,  FUSED_ARITHMETIC, true,  {FUSED_ARITHMETIC(DUInt64, FusedMul)}},
+
+    {W_EQ,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedEq)}},
+    {W_NE,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedNe)}},
+    {W_LT,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedLt)}},
+    {W_LTU,   FUSED_COMPARE, true,  {FUSED_COMPARE(DUInt64, FusedLt)}},
+    {W_LE,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedLe)}},
+    {W_LEU,   FUSED_COMPARE, true,  {FUSED_COMPARE(DUInt64, FusedLe)}},
+    {W_GT,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedGt)}},
+    {W_GTU,   FUSED_COMPARE, true,  {FUSED_COMPARE(DUInt64, FusedGt)}},
+    {W_GE,    FUSED_COMPARE, false, {FUSED_COMPARE(DInt64, FusedGe)}},
+    {W_GEU,   FUSED_COMPARE, true,  {FUSED_COMPARE(DUInt64, FusedGe)}},
+};
+
+
+static bool
+decode_local_load(const uint8_t* const code,
+                  const uint32_t       codeSize,
+                  const uint32_t       pos,
+                  uint32_t&            outLocal,
+                  uint32_t&            outSize)
+{
+  W_OPCODE opcode;
+  const uint_t opcodeSize = wh_compiler_decode_op(code + pos, &opcode);
+
+  if ((opcode != W_LDLO8) && (opcode != W_LDLO16) && (opcode != W_LDLO32))
+    return false;
+
+  outSize = opcodeSize + operandsSizes[opcode];
+  if (pos + outSize > codeSize)
+    return false;
+
+  const uint8_t* const data = code + pos + opcodeSize;
+
+  if (opcode == W_LDLO8)
+    outLocal = *data;
+
+  else if (opcode == W_LDLO16)
+    outLocal = load_le_int16(data);
+
+  else
+    outLocal = load_le_int32(data);
+
+  return true;
+}
+
+
+//Get the value an immediate load would push, as it would be read by the
+//signed and by the unsigned integer operations.
+static bool
+decode_immediate_load(const uint8_t* const code,
+                      const uint32_t       codeSize,
+                      const uint32_t       pos,
+                      DInt64&              outSigned,
+                      DUInt64&             outUnsigned,
+                      uint32_t&            outSize)
+{
+  W_OPCODE opcode;
+  const uint_t opcodeSize = wh_compiler_decode_op(code + pos, &opcode);
+
+  if ((opcode != W_LDI8)
+      && (opcode != W_LDI16)
+      && (opcode != W_LDI32)
+      && (opcode != W_LDI64))
+  {
+    return false;
+  }
+
+  outSize = opcodeSize + operandsSizes[opcode];
+  if (pos + outSize > codeSize)
+    return false;
+
+  const uint8_t* const data = code + pos + opcodeSize;
+
+  if (opcode == W_LDI8)
+  {
+    UInt8Operand(DUInt8(*data)).GetValue(outSigned);
+    UInt8Operand(DUInt8(*data)).GetValue(outUnsigned);
+  }
+  else if (opcode == W_LDI16)
+  {
+    UInt16Operand(DUInt16(load_le_int16(data))).GetValue(outSigned);
+    UInt16Operand(DUInt16(load_le_int16(data))).GetValue(outUnsigned);
+  }
+  else if (opcode == W_LDI32)
+  {
+    UInt32Operand(DUInt32(load_le_int32(data))).GetValue(outSigned);
+    UInt32Operand(DUInt32(load_le_int32(data))).GetValue(outUnsigned);
+  }
+  else
+  {
+    UInt64Operand(DUInt64(load_le_int64(data))).GetValue(outSigned);
+    UInt64Operand(DUInt64(load_le_int64(data))).GetValue(outUnsigned);
+  }
+
+  return true;
+}
+
+
+static bool
+decode_consumer(const uint8_t* const code,
+                const uint32_t       codeSize,
+                const uint32_t       pos,
+                W_OPCODE&            outOpcode,
+                uint32_t&            outSize)
+{
+  if (pos >= codeSize)
+    return false;
+
+  const uint_t opcodeSize = wh_compiler_decode_op(code + pos, &outOpcode);
+
+  if ((outOpcode == W_NA) || (outOpcode >= W_OP_END_MARK))
+    return false;
+
+  outSize = opcodeSize + operandsSizes[outOpcode];
+
+  return pos + outSize <= codeSize;
+}
+
+
+static void
+fuse_local_operation(const uint8_t* const code,
+                     const uint32_t       codeSize,
+                     const uint32_t       pos,
+                     DecodedOp&           outOp)
+{
+  uint32_t firstLocal, secondLocal = 0, firstSize, secondSize;
+  DInt64 signedValue;
+  DUInt64 unsignedValue;
+
+  if ( ! decode_local_load(code, codeSize, pos, firstLocal, firstSize))
+    return;
+
+  const uint32_t secondPos = pos + firstSize;
+  if (secondPos >= codeSize)
+    return;
+
+  const bool immediate = decode_immediate_load(code,
+                                               codeSize,
+                                               secondPos,
+                                               signedValue,
+                                               unsignedValue,
+                                               secondSize);
+  if ( ! immediate
+      && ! decode_local_load(code, codeSize, secondPos, secondLocal, secondSize))
+  {
+    return;
+  }
+
+  const uint32_t opPos = secondPos + secondSize;
+
+  W_OPCODE opcode;
+  uint32_t opSize;
+  if ( ! decode_consumer(code, codeSize, opPos, opcode, opSize))
+    return;
+
+  for (const FusedOpcode& fused : fusedOpcodes)
+  {
+    if (fused.mOpcode != opcode)
+      continue;
+
+    uint32_t fusedSize = opPos + opSize - pos;
+    bool jumpOn = false;
+    int32_t jumpOffset = 0;
+
+    W_OPCODE nextOpcode;
+    uint32_t nextSize;
+
+    if (fused.mKind == FUSED_SELF)
+    {
+      //The value left on the stack by the self operation has to be discarded.
+      if ( ! decode_consumer(code, codeSize, pos + fusedSize, nextOpcode, nextSize)
+          || (nextOpcode != W_CTS)
+          || (code[pos + fusedSize + nextSize - 1] != 1))
+      {
+        return;
+      }
+      fusedSize += nextSize;
+    }
+    else if (fused.mKind == FUSED_COMPARE)
+    {
+      //Only a conditional jump that consumes the result could follow.
+      const uint32_t jumpPos = pos + fusedSize;
+
+      if ( ! decode_consumer(code, codeSize, jumpPos, nextOpcode, nextSize)
+          || ((nextOpcode != W_JFC) && (nextOpcode != W_JTC)))
+      {
+        return;
+      }
+
+      jumpOn = (nextOpcode == W_JTC);
+      jumpOffset = _SC(int32_t, load_le_int32(code + jumpPos + nextSize - sizeof(uint32_t)));
+      jumpOffset += jumpPos - pos;
+      fusedSize += nextSize;
+    }
+
+    if (immediate)
+    {
+      if (fused.mUnsigned ? unsignedValue.IsNull() : signedValue.IsNull())
+        return;
+
+      outOp.mImmediate = fused.mUnsigned
+                         ? unsignedValue.mValue
+                         : _SC(uint64_t, signedValue.mValue);
+    }
+    else
+      outOp.mImmediate = 0;
+
+    outOp.mHandler     = fused.mHandlers[immediate ? 1 : 0][jumpOn ? 1 : 0];
+    outOp.mFusedSize   = fusedSize;
+    outOp.mFirstLocal  = firstLocal;
+    outOp.mSecondLocal = secondLocal;
+    outOp.mJumpOffset  = jumpOffset;
+
+    return;
+  }
+}
+
+
+//The profiled procedure call running on this thread, so the calls it makes
+//and the table accesses of its instructions could be accounted to it.
+static thread_local ProcedureCall* stProfiledCall = nullptr;
+
+
+void
+DecodeProcedureCode(const uint8_t* const code, const uint32_t codeSize, DecodedOp* const outOps)
+{
+  static_assert(sizeof operations / sizeof operations[0] == W_OP_END_MARK,
+                "The operations table does not cover all opcodes.");
+  static_assert(sizeof operandsSizes == W_OP_END_MARK,
+                "The operands sizes table does not cover all opcodes.");
+
+  //Decode starting from every position, not only from the instructions
+  //boundaries, so a jump lands on a decoded instruction wherever it goes.
+  for (uint32_t pos = 0; pos < codeSize; ++pos)
+  {
+    W_OPCODE opcode;
+    const uint_t opcodeSize = wh_compiler_decode_op(code + pos, &opcode);
+
+    DecodedOp& op = outOps[pos];
+
+    op.mOpcodeSize = opcodeSize;
+    op.mFusedSize  = 0;
+    if ((opcode == W_NA)
+        || (opcode >= W_OP_END_MARK)
+        || (pos + opcodeSize + operandsSizes[opcode] > codeSize))
+    {
+      op.mHandler = op_func_invalid;
+    }
+    else
+    {
+      op.mHandler = operations[opcode];
+      fuse_local_operation(code, codeSize, pos, op);
+    }
+  }
+}
+
+
 
 
 ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Procedure& procedure)
   : mProcedure(procedure),
     mSession(session),
     mStack(stack),
-    mCode(mProcedure.mNativeCode
-           ? nullptr
-           : procedure.mProcMgr->Code(procedure, nullptr)),
+    mCode(nullptr),
+    mDecodedCode(nullptr),
     mStackBegin(stack.Size() - procedure.mArgsCount),
     mCodePos(0),
-    mAquiredSync(NO_INDEX)
+    mAquiredSync(NO_INDEX),
+    mProfiler(session.IsProfiling() ? &procedure.mProcMgr->Profiler(procedure) : nullptr),
+    mCaller(nullptr),
+    mProfileStart(0),
+    mCalleesTime(0),
+    mNativeTime(0),
+    mTablesTime(0)
 {
+  ProfileScope profile(*this);
+
   if (mProcedure.mNativeCode != nullptr)
   {
     const WLIB_STATUS status = procedure.mNativeCode(stack, session);
@@ -2088,6 +2629,8 @@ ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Proced
   }
   else
   {
+    mDecodedCode = mProcedure.mProcMgr->DecodedCode(mProcedure, &mCode);
+
     if (stack.Size() + LocalsCount() > session.MaxStackCount())
     {
       throw InterException(_EXTRA(InterException::STACK_TOO_BIG),
@@ -2124,7 +2667,11 @@ ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Proced
 
     try
     {
-      Run();
+      if (mProfiler != nullptr)
+        Run<true>();
+
+      else
+        Run<false>();
     }
     catch (Exception& e)
     {
@@ -2150,29 +2697,43 @@ ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Proced
   assert(mAquiredSync == NO_INDEX);
 }
 
-void
+template<bool PROFILED> void
 ProcedureCall::Run()
 {
-  W_OPCODE opcode;
+  const uint32_t codeSize = CodeSize();
+  WTICKS lastTicks = PROFILED ? wh_usec_ticks() : 0;
+
+  //A running procedure checks for the server shutdown only when it starts and
+  //when it jumps back, as nothing else could keep it running for long.
+  if (mSession.IsServerShoutdowing())
+    throw InterException(_EXTRA(InterException::SERVER_STOPPED));
 
   try
   {
-    while (mCodePos < CodeSize())
+    while (mCodePos < codeSize)
     {
-      if (mSession.IsServerShoutdowing())
-        throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+      const DecodedOp& op = mDecodedCode[mCodePos];
+
+      int64_t offset = op.mOpcodeSize;
 
-      int64_t offset = wh_compiler_decode_op(mCode + mCodePos, &opcode);
+      op.mHandler(*this, offset);
 
-      assert(opcode < _SC(int, (sizeof operations / sizeof operations[0])));
-      assert(opcode != 0);
-      assert((offset > 0) && (offset < 3));
+      //Read the clock once per instruction, the time passed since the
+      //previous one ended being what this one took.
+      if (PROFILED)
+      {
+        const WTICKS ticks = wh_usec_ticks();
+
+        mProfiler->RecordInstruction(mCodePos, ticks - lastTicks);
+        lastTicks = ticks;
+      }
 
-      operations[opcode]( *this, offset);
+      if ((offset <= 0) && mSession.IsServerShoutdowing())
+        throw InterException(_EXTRA(InterException::SERVER_STOPPED));
 
       mCodePos += offset;
 
-      assert((mCodePos <= CodeSize()) || (_SC(uint64_t, offset) == CodeSize()));
+      assert((mCodePos <= codeSize) || (_SC(uint64_t, offset) == codeSize));
     }
 
     if (mAquiredSync != NO_INDEX)
@@ -2212,5 +2773,65 @@ ProcedureCall::ReleaseSync(const uint8_t sync)
   mAquiredSync = NO_INDEX;
 }
 
+
+ProcedureCall*
+ProcedureCall::ProfiledCall()
+{
+  return stProfiledCall;
+}
+
+
+ProcedureCall::ProfileScope::ProfileScope(ProcedureCall& call)
+  : mCall(call)
+{
+  if (mCall.mProfiler == nullptr)
+    return;
+
+  mCall.mProfiler->Prepare();
+
+  mCall.mCaller = stProfiledCall;
+  stProfiledCall = &mCall;
+
+  mCall.mProfileStart = wh_usec_ticks();
+}
+
+
+ProcedureCall::ProfileScope::~ProfileScope()
+{
+  if (mCall.mProfiler == nullptr)
+    return;
+
+  const uint64_t inclusiveTime = wh_usec_ticks() - mCall.mProfileStart;
+
+  stProfiledCall = mCall.mCaller;
+
+  if (mCall.mCaller != nullptr)
+  {
+    mCall.mCaller->mCalleesTime += inclusiveTime;
+
+    if (mCall.mProcedure.mNativeCode != nullptr)
+      mCall.mCaller->mNativeTime += inclusiveTime;
+  }
+
+  mCall.mProfiler->RecordCall(inclusiveTime,
+                              inclusiveTime - MIN(inclusiveTime, mCall.mCalleesTime),
+                              mCall.mNativeTime,
+                              mCall.mTablesTime);
+}
+
+
+TableAccessProfile::TableAccessProfile()
+  : mCall(ProcedureCall::ProfiledCall()),
+    mStart((mCall != nullptr) ? wh_usec_ticks() : 0)
+{
+}
+
+
+TableAccessProfile::~TableAccessProfile()
+{
+  if (mCall != nullptr)
+    mCall->RecordTablesAccess(wh_usec_ticks() - mStart);
+}
+
 } //namespace prima
 } //namespace whais
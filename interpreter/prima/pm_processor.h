@@ -33,6 +33,10 @@ namespace whais {
 namespace prima {
 
 
+void
+DecodeProcedureCode(const uint8_t* const code, const uint32_t codeSize, DecodedOp* const outOps);
+
+
 class ProcedureCall
 {
 public:
@@ -54,6 +58,7 @@ public:
   const uint8_t* Code() const { return mCode; }
   uint32_t CodeSize() const { return mProcedure.mCodeSize; }
   uint32_t CurrentOffset() const { return mCodePos; }
+  const DecodedOp& CurrentOp() const { return mDecodedCode[mCodePos]; }
   size_t LocalsCount() const { return mProcedure.mLocalsCount; }
 
   const StackValue& GetLocalDefault(const uint_t local) const
@@ -62,8 +67,23 @@ public:
   }
   uint32_t StackBegin() const { return mStackBegin; }
 
+  //The call that is profiled on the current thread, if there is one.
+  static ProcedureCall* ProfiledCall();
+  void RecordTablesAccess(const uint64_t usecs) { mTablesTime += usecs; }
+
 private:
-  void Run();
+  //Accounts the call to its procedure's profile while it is in scope.
+  class ProfileScope
+  {
+  public:
+    ProfileScope(ProcedureCall& call);
+    ~ProfileScope();
+
+  private:
+    ProcedureCall& mCall;
+  };
+
+  template<bool PROFILED> void Run();
 
   static const uint16_t NO_INDEX = 0xFFFF;
 
@@ -71,9 +91,16 @@ private:
   Session&                mSession;
   SessionStack&           mStack;
   const uint8_t*          mCode;
+  const DecodedOp*        mDecodedCode;
   uint32_t                mStackBegin;
   uint32_t                mCodePos;
   uint16_t                mAquiredSync;
+  ProcedureProfiler*      mProfiler;
+  ProcedureCall*          mCaller;
+  WTICKS                  mProfileStart;
+  uint64_t                mCalleesTime;
+  uint64_t                mNativeTime;
+  uint64_t                mTablesTime;
 };
 
 
@@ -0,0 +1,66 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PM_SYMBOLS_H_
+#define PM_SYMBOLS_H_
+
+#include <unordered_map>
+#include <utility>
+
+#include "whais.h"
+#include "utils/whash.h"
+
+
+namespace whais {
+namespace prima {
+
+
+/* Maps the names of a name space's symbols (or the descriptions of its
+   types) to their ids by their hashes. The managers keep the names
+   themselves, so they have to check the few candidates of a lookup. */
+class SymbolsIndex
+{
+public:
+  typedef std::unordered_multimap<uint64_t, uint32_t>::const_iterator Iterator;
+
+  void Add(const uint8_t* const name, const uint_t nameLength, const uint32_t id)
+  {
+    mEntries.emplace(wh_hash(name, nameLength), id);
+  }
+
+  std::pair<Iterator, Iterator> Candidates(const uint8_t* const name,
+                                           const uint_t nameLength) const
+  {
+    return mEntries.equal_range(wh_hash(name, nameLength));
+  }
+
+private:
+  std::unordered_multimap<uint64_t, uint32_t>   mEntries;
+};
+
+
+} //namespace prima
+} //namespace whais
+
+#endif /* PM_SYMBOLS_H_ */
@@ -100,6 +100,8 @@ TypeManager::AddType(const uint8_t* const typeDesc)
   const TypeSpec spec(typeDesc);
 
   mTypesDescriptions.insert(mTypesDescriptions.end(), typeDesc, typeDesc + spec.RawSize());
+  mTypesIndex.Add(typeDesc, spec.RawSize(), result);
+
   return result;
 }
 
@@ -110,21 +112,14 @@ TypeManager::FindType(const uint8_t* const typeDesc)
   assert(IsTypeValid(typeDesc));
 
   const TypeSpec spec(typeDesc);
+  const auto candidates = mTypesIndex.Candidates(typeDesc, spec.RawSize());
 
-  uint32_t result = 0;
-
-  while (result < mTypesDescriptions.size())
+  for (auto it = candidates.first; it != candidates.second; ++it)
   {
-    assert(IsTypeValid( &mTypesDescriptions[result]));
-
-    const TypeSpec specIt( &mTypesDescriptions[result]);
-
-    if (spec == specIt)
-      return result;
-
-    result += specIt.RawSize();
+    assert(IsTypeValid( &mTypesDescriptions[it->second]));
 
-    assert(result <= mTypesDescriptions.size());
+    if (spec == TypeSpec( &mTypesDescriptions[it->second]))
+      return it->second;
   }
 
   return INVALID_OFFSET;
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "whais.h"
 
 #include "pm_operand.h"
+#include "pm_symbols.h"
 
 namespace whais {
 namespace prima {
@@ -63,6 +64,7 @@ public:
 private:
   NameSpace&           mNameSpace;
   std::vector<uint8_t> mTypesDescriptions;
+  SymbolsIndex         mTypesIndex;
 };
 
 
@@ -119,3 +119,11 @@ UNIT_EXES+=test_stackvalue_size
 test_stackvalue_size_SRC=test/test_stackvalue_size.cpp
 test_stackvalue_size_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
 
+
+UNIT_EXES+=test_ops_dispatch
+test_ops_dispatch_SRC=test/test_ops_dispatch.cpp
+test_ops_dispatch_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_ops_fused
+test_ops_fused_SRC=test/test_ops_fused.cpp
+test_ops_fused_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
@@ -0,0 +1,231 @@
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+#include "compiler//wopcodes.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+static const int32_t LOOP_ITERATIONS = 1000000;
+static const int32_t CALL_ITERATIONS = 200000;
+static const int32_t ARRAY_ELEMENTS  = 1000;
+static const int32_t ARRAY_PARSES    = 200;
+
+const uint8_t dispatchTestProgram[] = ""
+    "PROCEDURE int_loop(n INT32) RETURN INT64\n"
+    "DO\n"
+    " VAR i INT32;\n"
+    " VAR sum INT64;\n"
+    "\n"
+    " i = 0;\n"
+    " sum = 0;\n"
+    " WHILE (i < n)\n"
+    " DO\n"
+    "   sum += i * 2;\n"
+    "   i += 1;\n"
+    " END\n"
+    "\n"
+    " RETURN sum;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE twice(n INT32) RETURN INT32\n"
+    "DO\n"
+    " RETURN n * 2;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE call_loop(n INT32) RETURN INT64\n"
+    "DO\n"
+    " VAR i INT32;\n"
+    " VAR sum INT64;\n"
+    "\n"
+    " i = 0;\n"
+    " sum = 0;\n"
+    " WHILE (i < n)\n"
+    " DO\n"
+    "   sum += twice(i);\n"
+    "   i += 1;\n"
+    " END\n"
+    "\n"
+    " RETURN sum;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE array_loop(ai INT32 ARRAY, n UINT32) RETURN INT64\n"
+    "DO\n"
+    " VAR sum INT64;\n"
+    "\n"
+    " sum = 0;\n"
+    " WHILE (n > 0)\n"
+    " DO\n"
+    "   FOR(v : ai)\n"
+    "     sum += v;\n"
+    "   n -= 1;\n"
+    " END\n"
+    "\n"
+    " RETURN sum;\n"
+    "ENDPROC\n";
+
+
+static void
+my_postman(WH_MESSENGER_CTXT data,
+           uint_t            buff_pos,
+           uint_t            msg_id,
+           uint_t            msgType,
+           const char*       pMsgFormat,
+           va_list           args)
+{
+  fprintf(stderr, "%d : ", msg_id);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+}
+
+
+static void
+print_rate(const char* what, const uint64_t count, const uint64_t msecs)
+{
+  std::cout << "\t" << count << ' ' << what << " in " << msecs << " ms";
+  if (msecs > 0)
+    std::cout << " (" << (count * 1000 / msecs) << ' ' << what << "/s)";
+
+  std::cout << std::endl;
+}
+
+
+static bool
+run_procedure(Session& session, const char* const procName, SessionStack& stack, int64_t expected)
+{
+  session.ExecuteProcedure(procName, stack);
+
+  if (stack.Size() != 1)
+    return false;
+
+  DInt64 result;
+  stack[0].Operand().GetValue(result);
+  stack.Pop(1);
+
+  return result == DInt64(expected);
+}
+
+
+static bool
+test_int_loop(Session& session)
+{
+  std::cout << "Timing an arithmetic loop ...\n";
+
+  SessionStack stack;
+  stack.Push(DInt32(LOOP_ITERATIONS));
+
+  const uint64_t start = wh_msec_ticks();
+  const bool result = run_procedure(session,
+                                    "int_loop",
+                                    stack,
+                                    _SC(int64_t, LOOP_ITERATIONS) * (LOOP_ITERATIONS - 1));
+
+  print_rate("iterations", LOOP_ITERATIONS, wh_msec_ticks() - start);
+
+  return result;
+}
+
+
+static bool
+test_call_loop(Session& session)
+{
+  std::cout << "Timing a loop of procedure calls ...\n";
+
+  SessionStack stack;
+  stack.Push(DInt32(CALL_ITERATIONS));
+
+  const uint64_t start = wh_msec_ticks();
+  const bool result = run_procedure(session,
+                                    "call_loop",
+                                    stack,
+                                    _SC(int64_t, CALL_ITERATIONS) * (CALL_ITERATIONS - 1));
+
+  print_rate("calls", CALL_ITERATIONS, wh_msec_ticks() - start);
+
+  return result;
+}
+
+
+static bool
+test_array_loop(Session& session)
+{
+  std::cout << "Timing an array iteration loop ...\n";
+
+  DArray array;
+  for (int32_t i = 0; i < ARRAY_ELEMENTS; ++i)
+    array.Add(DInt32(i));
+
+  SessionStack stack;
+  stack.Push(array);
+  stack.Push(DUInt32(ARRAY_PARSES));
+
+  const uint64_t start = wh_msec_ticks();
+  const bool result = run_procedure(session,
+                                    "array_loop",
+                                    stack,
+                                    _SC(int64_t, ARRAY_PARSES)
+                                      * (ARRAY_ELEMENTS * (ARRAY_ELEMENTS - 1) / 2));
+
+  print_rate("elements", _SC(uint64_t, ARRAY_PARSES) * ARRAY_ELEMENTS, wh_msec_ticks() - start);
+
+  return result;
+}
+
+
+int
+main()
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& commonSession = GetInstance(nullptr);
+
+    CompiledBufferUnit dispatchBuf(dispatchTestProgram,
+                                   sizeof dispatchTestProgram,
+                                   my_postman,
+                                   dispatchTestProgram);
+
+    commonSession.LoadCompiledUnit(dispatchBuf);
+
+    success = success && test_int_loop(_SC(Session&, commonSession));
+    success = success && test_call_loop(_SC(Session&, commonSession));
+    success = success && test_array_loop(_SC(Session&, commonSession));
+
+    ReleaseInstance(commonSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
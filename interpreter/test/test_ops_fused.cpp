@@ -0,0 +1,278 @@
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t fusedTestProgram[] = ""
+    "PROCEDURE self_ops(a INT32, b INT32) RETURN INT64\n"
+    "DO\n"
+    " VAR r INT64;\n"
+    "\n"
+    " r = a;\n"
+    " r += b;\n"
+    " r -= 3;\n"
+    " r *= b;\n"
+    " r /= 2;\n"
+    " r %= 7;\n"
+    " RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE compares(a INT32, b INT32) RETURN INT32\n"
+    "DO\n"
+    " VAR r INT32;\n"
+    "\n"
+    " r = 0;\n"
+    " IF (a < b) r += 1;\n"
+    " IF (a <= b) r += 2;\n"
+    " IF (a > b) r += 4;\n"
+    " IF (a >= b) r += 8;\n"
+    " IF (a == b) r += 16;\n"
+    " IF (a != b) r += 32;\n"
+    " RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE unsigned_ops(a UINT32, b UINT32) RETURN UINT64\n"
+    "DO\n"
+    " VAR r UINT64;\n"
+    "\n"
+    " r = a * b;\n"
+    " r *= 3;\n"
+    " IF (a < b) r += 1;\n"
+    " IF (a >= 5) r += 100;\n"
+    " IF (a < 10) r += 1000;\n"
+    " RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE arithmetic(a INT32, b INT32) RETURN INT64\n"
+    "DO\n"
+    " VAR r INT64;\n"
+    "\n"
+    " r = a + b;\n"
+    " r = r * (a - 7);\n"
+    " RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE until_loop(n INT32) RETURN INT32\n"
+    "DO\n"
+    " VAR i INT32;\n"
+    "\n"
+    " i = 0;\n"
+    " DO\n"
+    "   i += 1;\n"
+    " UNTIL (i < n);\n"
+    " RETURN i;\n"
+    "ENDPROC\n";
+
+
+static void
+my_postman(WH_MESSENGER_CTXT data,
+           uint_t            buff_pos,
+           uint_t            msg_id,
+           uint_t            msgType,
+           const char*       pMsgFormat,
+           va_list           args)
+{
+  fprintf(stderr, "%d : ", msg_id);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+}
+
+
+template <class RESULT_T, class ARG_T> static bool
+check_procedure(Session&        session,
+                const char*     procName,
+                const ARG_T&    first,
+                const ARG_T&    second,
+                const RESULT_T& expected)
+{
+  SessionStack stack;
+
+  stack.Push(first);
+  if (strcmp(procName, "until_loop") != 0)
+    stack.Push(second);
+
+  session.ExecuteProcedure(procName, stack);
+
+  if (stack.Size() != 1)
+    return false;
+
+  RESULT_T result;
+  stack[0].Operand().GetValue(result);
+
+  if (result != expected)
+  {
+    std::cout << "Procedure '" << procName << "' returned an unexpected value.\n";
+    return false;
+  }
+
+  return true;
+}
+
+
+static bool
+test_fused_code(Session& session)
+{
+  std::cout << "Testing local operations are fused ... ";
+
+  static const char* const procedures[] = {
+                                            "self_ops",
+                                            "compares",
+                                            "unsigned_ops",
+                                            "arithmetic",
+                                            "until_loop"
+                                          };
+  bool result = true;
+
+  for (auto name : procedures)
+  {
+    const uint32_t procId = session.FindProcedure(_RC(const uint8_t*, name), strlen(name));
+    const Procedure& proc = session.GetProcedure(procId);
+
+    const uint8_t* code = nullptr;
+    const DecodedOp* const decoded = proc.mProcMgr->DecodedCode(proc, &code);
+
+    uint_t fusedCount = 0;
+    for (uint32_t pos = 0; pos < proc.mCodeSize; ++pos)
+    {
+      if (decoded[pos].mFusedSize > 0)
+        ++fusedCount;
+    }
+
+    if (fusedCount == 0)
+    {
+      std::cout << "no fused operations in '" << name << "' ";
+      result = false;
+    }
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_self_operations(Session& session)
+{
+  std::cout << "Testing fused self operations ... ";
+
+  bool result = true;
+
+  result &= check_procedure(session, "self_ops", DInt32(100), DInt32(4), DInt64(6));
+  result &= check_procedure(session, "self_ops", DInt32(-100), DInt32(4), DInt64(6));
+  result &= check_procedure(session, "self_ops", DInt32(100), DInt32(), DInt64(6));
+  result &= check_procedure(session, "self_ops", DInt32(), DInt32(4), DInt64());
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_compares(Session& session)
+{
+  std::cout << "Testing fused compares and jumps ... ";
+
+  bool result = true;
+
+  result &= check_procedure(session, "compares", DInt32(1), DInt32(2), DInt32(1 + 2 + 32));
+  result &= check_procedure(session, "compares", DInt32(2), DInt32(2), DInt32(2 + 8 + 16));
+  result &= check_procedure(session, "compares", DInt32(3), DInt32(2), DInt32(4 + 8 + 32));
+  result &= check_procedure(session, "compares", DInt32(20), DInt32(2), DInt32(4 + 8 + 32));
+
+  //An ordering against a null is null, that doesn't take a 'false' jump.
+  result &= check_procedure(session,
+                            "compares",
+                            DInt32(),
+                            DInt32(2),
+                            DInt32(1 + 2 + 4 + 8 + 32));
+  result &= check_procedure(session, "compares", DInt32(2), DInt32(), DInt32(1 + 2 + 4 + 8 + 32));
+
+  result &= check_procedure(session, "until_loop", DInt32(10), DInt32(), DInt32(10));
+  result &= check_procedure(session, "until_loop", DInt32(-5), DInt32(), DInt32(1));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_arithmetic(Session& session)
+{
+  std::cout << "Testing fused arithmetic ... ";
+
+  bool result = true;
+
+  result &= check_procedure(session, "arithmetic", DInt32(10), DInt32(5), DInt64(45));
+  result &= check_procedure(session, "arithmetic", DInt32(-3), DInt32(1), DInt64(20));
+  result &= check_procedure(session, "arithmetic", DInt32(), DInt32(1), DInt64());
+  result &= check_procedure(session, "arithmetic", DInt32(1), DInt32(), DInt64());
+
+  result &= check_procedure(session, "unsigned_ops", DUInt32(3), DUInt32(4), DUInt64(1037));
+  result &= check_procedure(session, "unsigned_ops", DUInt32(6), DUInt32(4), DUInt64(1172));
+  result &= check_procedure(session, "unsigned_ops", DUInt32(), DUInt32(4), DUInt64());
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main()
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& commonSession = GetInstance(nullptr);
+
+    CompiledBufferUnit fusedBuf(fusedTestProgram,
+                                sizeof fusedTestProgram,
+                                my_postman,
+                                fusedTestProgram);
+
+    commonSession.LoadCompiledUnit(fusedBuf);
+
+    success &= test_fused_code(_SC(Session&, commonSession));
+    success &= test_self_operations(_SC(Session&, commonSession));
+    success &= test_compares(_SC(Session&, commonSession));
+    success &= test_arithmetic(_SC(Session&, commonSession));
+
+    ReleaseInstance(commonSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -6,6 +6,7 @@
 #include "dbs/dbs_mgr.h"
 #include "interpreter.h"
 #include "custom/include/test/test_fmw.h"
+#include "utils/wthread.h"
 
 #include "interpreter/prima/pm_interpreter.h"
 #include "interpreter/prima/pm_processor.h"
@@ -20,6 +21,9 @@ static const char inull_proc[] = "inull_test";
 static const char nnull_proc[] = "nnull_test";
 static const char field_proc[] = "field_index";
 
+static const uint_t SYNC_THREADS = 4;
+static const uint_t SYNC_CALLS   = 500;
+
 const uint8_t callTestProgram[] = ""
     "PROCEDURE cts_test(n INT8) RETURN INT8\n"
     "DO\n"
@@ -131,6 +135,16 @@ const uint8_t callTestProgram[] = ""
     " VAR f DATE FIELD;\n"
     "\n"
     " RETURN @f;\n"
+    "ENDPROC\n"
+    "PROCEDURE sync_twice(n INT32) RETURN INT32\n"
+    "DO\n"
+    " SYNC\n"
+    "   n = n + 1;\n"
+    " ENDSYNC\n"
+    " SYNC\n"
+    "   n = n * 2;\n"
+    " ENDSYNC\n"
+    " RETURN n;\n"
     "ENDPROC\n";
 
 
@@ -315,6 +329,23 @@ test_op_call(Session& session)
   if (result != DUInt8(24) )
     return false;
 
+  //The same call, by the procedure's id this time.
+  stack.Pop(1);
+  stack.Push(DUInt8(10));
+  stack.Push(DUInt16(2));
+
+  session.ExecuteProcedure(session.ResolveProcedure("p2"), stack);
+
+  if (stack.Size() != 1)
+    return false;
+
+  stack[0].Operand().GetValue(result);
+
+  if (result != DUInt8(24) )
+    return false;
+
+  stack.Pop(1);
+
   return true;
 }
 
@@ -848,6 +879,168 @@ test_field_id_parse(Session& session)
 }
 
 
+static void
+sync_calls_thread(void* args)
+{
+  bool& result = *_RC(bool*, args);
+  ISession& session = GetInstance(nullptr);
+
+  for (uint_t i = 0; (i < SYNC_CALLS) && result; ++i)
+  {
+    SessionStack stack;
+
+    stack.Push(DInt32(i));
+    session.ExecuteProcedure("sync_twice", stack);
+
+    DInt32 value;
+    stack[0].Operand().GetValue(value);
+
+    result = (stack.Size() == 1) && (value == DInt32((i + 1) * 2));
+  }
+
+  ReleaseInstance(session);
+}
+
+static bool
+test_sync_stats(Session& session)
+{
+  std::cout << "Testing the sync statements under contention ...\n";
+
+  Thread threads[SYNC_THREADS];
+  bool results[SYNC_THREADS];
+
+  for (uint_t t = 0; t < SYNC_THREADS; ++t)
+  {
+    results[t] = true;
+    threads[t].Run(sync_calls_thread, &results[t]);
+  }
+
+  bool result = true;
+  for (uint_t t = 0; t < SYNC_THREADS; ++t)
+  {
+    threads[t].WaitToEnd();
+    result = result && results[t];
+  }
+
+  const uint32_t procId = session.ResolveProcedure("sync_twice");
+  result = result && (session.ProcedureSyncsCount(procId) == 2);
+
+  for (uint_t sync = 0; (sync < 2) && result; ++sync)
+  {
+    SyncStatementStats stats;
+    session.ProcedureSyncStats(procId, sync, stats);
+
+    uint64_t holds = 0;
+    for (uint_t b = 0; b < SyncStatementStats::HOLD_BUCKETS; ++b)
+      holds += stats.mHoldHistogram[b];
+
+    std::cout << "Sync " << sync << ": " << stats.mAcquiresCount << " acquires, "
+              << stats.mContentionsCount << " contended, "
+              << stats.mWaitTime << "us waited, "
+              << stats.mHoldTime << "us held.\n";
+
+    result = (stats.mAcquiresCount == SYNC_THREADS * SYNC_CALLS)
+             && (holds == stats.mAcquiresCount)
+             && (stats.mContentionsCount <= stats.mAcquiresCount)
+             && (stats.mMaxHoldTime <= stats.mHoldTime);
+  }
+
+  try
+  {
+    SyncStatementStats stats;
+    session.ProcedureSyncStats(procId, 2, stats);
+
+    result = false;
+  }
+  catch (InterException&)
+  {
+  }
+
+  return result;
+}
+
+
+static bool
+check_profile(const ProcedureProfile& profile, const uint64_t calls)
+{
+  if ((profile.mCallsCount != calls)
+      || (profile.mExclusiveTime > profile.mInclusiveTime)
+      || (profile.mTablesTime > profile.mExclusiveTime)
+      || profile.mInstructionHits.empty()
+      || (profile.mInstructionHits.size() != profile.mInstructionTimes.size()))
+  {
+    return false;
+  }
+
+  //Every call runs the same instructions, so each is run once per call.
+  uint64_t executed = 0;
+  for (auto hits : profile.mInstructionHits)
+  {
+    if ((hits != 0) && (hits != calls))
+      return false;
+
+    executed += hits;
+  }
+
+  return executed > 0;
+}
+
+static bool
+test_procedures_profile(Session& session)
+{
+  std::cout << "Testing the procedures profiling ...\n";
+
+  static const uint_t CALLS_COUNT = 50;
+
+  const uint32_t callerId = session.ResolveProcedure("p2");
+  const uint32_t calleeId = session.ResolveProcedure("p1");
+
+  ProcedureProfile caller, callee;
+  session.ProcedureProfileStats(callerId, caller);
+
+  bool result = (caller.mCallsCount == 0) && caller.mInstructionHits.empty();
+  result = result && ! session.NotifyEvent(ISession::PROFILE_PROCEDURES, nullptr);
+
+  uint64_t enable = 1;
+  result = result && session.NotifyEvent(ISession::PROFILE_PROCEDURES, &enable);
+
+  for (uint_t i = 0; (i < 2 * CALLS_COUNT) && result; ++i)
+  {
+    //Only the first half of the calls are profiled.
+    if (i == CALLS_COUNT)
+    {
+      enable = 0;
+      result = session.NotifyEvent(ISession::PROFILE_PROCEDURES, &enable);
+    }
+
+    SessionStack stack;
+
+    stack.Push(DUInt8(i % 10));
+    stack.Push(DUInt16(2));
+
+    session.ExecuteProcedure(callerId, stack);
+
+    DUInt8 value;
+    stack[0].Operand().GetValue(value);
+
+    result = result && (stack.Size() == 1) && (value == DUInt8((i % 10 + 2) * 2));
+  }
+
+  session.ProcedureProfileStats(callerId, caller);
+  session.ProcedureProfileStats(calleeId, callee);
+
+  std::cout << "Caller: " << caller.mCallsCount << " calls, "
+            << caller.mInclusiveTime << "us inclusive, "
+            << caller.mExclusiveTime << "us exclusive.\n";
+
+  result = result && check_profile(caller, CALLS_COUNT);
+  result = result && check_profile(callee, CALLS_COUNT);
+  result = result && (callee.mInclusiveTime == callee.mExclusiveTime);
+
+  return result;
+}
+
+
 int
 main()
 {
@@ -886,6 +1079,8 @@ main()
     success = success && test_op_array_parse(_SC(Session&, commonSession), false);
     success = success && test_op_array_parse(_SC(Session&, commonSession), true);
     success = success && test_field_id_parse(_SC(Session&, commonSession));
+    success = success && test_sync_stats(_SC(Session&, commonSession));
+    success = success && test_procedures_profile(_SC(Session&, commonSession));
 
     ReleaseInstance(commonSession);
   }
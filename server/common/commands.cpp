@@ -392,9 +392,23 @@ cmd_execute_procedure(ClientConnection& conn)
   SessionStack& stack    = conn.Stack();
   uint32_t      result   = WCS_GENERAL_ERR;
 
+  //An empty name is followed by the id of an already resolved procedure.
+  const bool byId = (conn.DataSize() > 0) && (procName[0] == 0);
+  if (byId && (conn.DataSize() != 1 + sizeof(uint32_t)))
+    throw ConnectionException(_EXTRA(0), "Execute procedure command has invalid format.");
+
   try
   {
-    session.ExecuteProcedure(procName, stack);
+    //Resolve the name first, so the call is accounted under its procedure.
+    const uint32_t procId = byId
+                            ? _SC(uint32_t, load_le_int32(conn.Data() + 1))
+                            : session.ResolveProcedure(procName);
+
+    const uint64_t startTicks = wh_usec_ticks();
+
+    session.ExecuteProcedure(procId, stack);
+
+    conn.Stats().RecordProcedure(conn.Dbs(), procId, wh_usec_ticks() - startTicks);
     result = WCS_OK;
   }
   catch (InterException& e)
@@ -407,7 +421,12 @@ cmd_execute_procedure(ClientConnection& conn)
 
       std::ostringstream logEntry;
 
-      logEntry << "Failed to find procedure '" << procName << "'.";
+      if (byId)
+        logEntry << "Failed to find procedure with id " << load_le_int32(conn.Data() + 1) << '.';
+
+      else
+        logEntry << "Failed to find procedure '" << procName << "'.";
+
       session.GetLogger().Log(LT_ERROR, logEntry.str());
     }
       break;
@@ -434,6 +453,35 @@ cmd_execute_procedure(ClientConnection& conn)
   conn.SendCmdResponse(CMD_EXEC_PROC_RSP);
 }
 
+static void
+cmd_resolve_procedure(ClientConnection& conn)
+{
+  const char* const procName = _RC(const char*, conn.Data());
+  ISession&         session  = *conn.Dbs().mSession;
+
+  if ((conn.DataSize() == 0) || (procName[conn.DataSize() - 1] != 0))
+    throw ConnectionException(_EXTRA(0), "Resolve procedure command has invalid format.");
+
+  try
+  {
+    const uint32_t procId = session.ResolveProcedure(procName);
+
+    store_le_int32(WCS_OK, conn.Data());
+    store_le_int32(procId, conn.Data() + sizeof(uint32_t));
+    conn.DataSize(2 * sizeof(uint32_t));
+  }
+  catch (InterException& e)
+  {
+    if (e.Code() != InterException::INVALID_PROC_REQ)
+      throw;
+
+    store_le_int32(WCS_PROC_NOTFOUND, conn.Data());
+    conn.DataSize(sizeof(uint32_t));
+  }
+
+  conn.SendCmdResponse(CMD_RESOLVE_PROC_RSP);
+}
+
 static void
 cmd_ping_sever(ClientConnection& conn)
 {
@@ -809,13 +857,100 @@ cmd_procedure_param_desc_err:
   return;
 }
 
+static void
+send_report_part(ClientConnection&     conn,
+                 const std::string&    report,
+                 const uint32_t        fromOffset,
+                 const uint16_t        respType)
+{
+  if (fromOffset > report.size())
+  {
+    store_le_int32(WCS_INVALID_ARGS, conn.Data());
+    conn.DataSize(sizeof(uint32_t));
+
+    conn.SendCmdResponse(respType);
+    return;
+  }
+
+  const uint_t chunkSize = MIN(report.size() - fromOffset,
+                               conn.MaxSize() - 3 * sizeof(uint32_t) - 1);
+
+  store_le_int32(WCS_OK, conn.Data());
+  store_le_int32(report.size(), conn.Data() + sizeof(uint32_t));
+  store_le_int32(fromOffset, conn.Data() + 2 * sizeof(uint32_t));
+
+  memcpy(conn.Data() + 3 * sizeof(uint32_t), report.c_str() + fromOffset, chunkSize);
+  conn.Data()[3 * sizeof(uint32_t) + chunkSize] = 0;
+
+  conn.DataSize(3 * sizeof(uint32_t) + chunkSize + 1);
+  conn.SendCmdResponse(respType);
+}
+
+
+static void
+cmd_server_stats(ClientConnection& conn)
+{
+  if (conn.DataSize() != sizeof(uint32_t))
+    throw ConnectionException(_EXTRA(0), "Server statistics command has invalid format.");
+
+  const uint32_t fromOffset = load_le_int32(conn.Data());
+  std::string& report = conn.Report();
+
+  //Only the administrator of the global context sees all the databases.
+  if (fromOffset == 0)
+  {
+    const DBSDescriptors& dbs = conn.Dbs();
+    conn.Stats().Owner().Report((dbs.mDbsName == GlobalContextDatabase()) ? nullptr : &dbs,
+                                report);
+  }
+
+  send_report_part(conn, report, fromOffset, CMD_SERVER_STATS_RSP);
+}
+
+
+static void
+cmd_procedure_profile(ClientConnection& conn)
+{
+  if ((conn.DataSize() <= sizeof(uint32_t))
+      || (conn.Data()[conn.DataSize() - 1] != 0))
+  {
+    throw ConnectionException(_EXTRA(0), "Procedure profile command has invalid format.");
+  }
+
+  const uint32_t fromOffset = load_le_int32(conn.Data());
+  const char* const procName = _RC(const char*, conn.Data() + sizeof(uint32_t));
+  std::string& report = conn.Report();
+
+  if (fromOffset == 0)
+  {
+    ISession& session = *conn.Dbs().mSession;
+
+    try
+    {
+      ProceduresProfileReport(session, (procName[0] != 0) ? procName : nullptr, report);
+    }
+    catch (InterException&)
+    {
+      store_le_int32(WCS_PROC_NOTFOUND, conn.Data());
+      conn.DataSize(sizeof(uint32_t));
+
+      conn.SendCmdResponse(CMD_PROC_PROFILE_RSP);
+      return;
+    }
+  }
+
+  send_report_part(conn, report, fromOffset, CMD_PROC_PROFILE_RSP);
+}
+
 
 static COMMAND_HANDLER saAdminCmds[] =
     {
         cmd_invalid,                     // CMD_INVALID
         cmd_list_globals,                // CMD_LIST_GLOBALS
         cmd_list_procedures,             // CMD_LIST_PROC
-        cmd_procedure_param_desc         // CMD_DESC_PROC_PARAM
+        cmd_procedure_param_desc,        // CMD_DESC_PROC_PARAM
+        cmd_server_stats,                // CMD_SERVER_STATS
+        cmd_procedure_profile            // CMD_PROC_PROFILE
     };
 
 static COMMAND_HANDLER saUserCmds[] =
@@ -826,7 +961,8 @@ static COMMAND_HANDLER saUserCmds[] =
         cmd_update_stack,                // CMD_UPDATE_STACK
         cmd_execute_procedure,           // CMD_EXEC_PROC
         cmd_ping_sever,                  // CMD_PING_SERVER
-        cmd_hello_server                 // CMD_HELLO_SERVER
+        cmd_hello_server,                // CMD_HELLO_SERVER
+        cmd_resolve_procedure            // CMD_RESOLVE_PROC
     };
 
 /* The commands registers external definitions. */
@@ -51,6 +51,9 @@ static const uint_t MIN_TABLE_CACHE_BLOCK_COUNT = 128;
 static const uint_t MIN_VL_BLOCK_SIZE = 1024;
 static const uint_t MIN_VL_BLOCK_COUNT = 128;
 static const uint_t MIN_TEMP_CACHE = 128;
+static const uint64_t MIN_BUFFER_POOL_SIZE = 1024 * 1024;
+static const uint_t MIN_INDEX_FILL_FACTOR = 30;
+static const uint_t MAX_INDEX_FILL_FACTOR = 100;
 
 static const uint_t DEFAULT_MAX_CONNS = 64;
 static const uint_t DEFAULT_TABLE_CACHE_BLOCK_SIZE = 4098;
@@ -65,6 +68,7 @@ static const uint_t DEFAULT_AUTH_TMO_MS = 1000;
 
 static const string gEntPort("listen");
 static const string gEntMaxConnections("max_connections");
+static const string gEntWorkerThreads("worker_threads");
 static const string gEntMaxFrameSize("max_frame_size");
 static const string gEntEncryption("cipher");
 static const string gEntTableBlkSize("table_block_cache_size");
@@ -72,6 +76,11 @@ static const string gEntTableBlkCount("table_block_cache_count");
 static const string gEntVlBlkSize("vl_values_block_size");
 static const string gEntVlBlkCount("vl_values_block_count");
 static const string gEntTempCache("temporals_cache");
+static const string gEntBufferPool("buffer_pool_size");
+static const string gEntIndexFillFactor("index_fill_factor");
+static const string gEntWalSync("wal_sync");
+static const string gEntWalCheckpoint("wal_checkpoint_size");
+static const string gEntWriteBack("write_back_interval_ms");
 static const string gEntAuthTMO("auth_tmo_ms");
 static const string gEntRequestTMO("request_tmo_ms");
 static const string gEntSyncInterval("sync_interval_ms");
@@ -81,11 +90,15 @@ static const string gEntDBSName("name");
 static const string gEntWorkDir("directory");
 static const string gEntTempDir("temp_directory");
 static const string gEntShowDbg("show_debug");
+static const string gEntLogRateLimit("log_rate_limit");
+static const string gEntLogSyncLevel("log_sync_level");
 static const string gEntObjectLib("load_object");
 static const string gEntNativeLib("load_native");
 static const string gEntRootPasswrd("admin_password");
 static const string gEntUserPasswrd("user_password");
 static const string gEntStackCount("max_stack_count");
+static const string gEntMapTables("map_tables_rows");
+static const string gEntProfileProcs("profile_procedures");
 
 static ServerSettings gMainSettings;
 
@@ -219,6 +232,17 @@ bool ParseConfigurationSection(ifstream& config, uint_t& inoutConfigLine, ostrea
       token = NextToken(line, pos, delimiters);
       gMainSettings.mMaxConnections = atoi(token.c_str());
     }
+    else if (token == gEntWorkerThreads)
+    {
+      token = NextToken(line, pos, delimiters);
+      gMainSettings.mWorkerThreads = atoi(token.c_str());
+
+      if (gMainSettings.mWorkerThreads == 0)
+      {
+        errOut << "Configuration error at line " << inoutConfigLine << ".\n";
+        return false;
+      }
+    }
     else if (token == gEntMaxFrameSize)
     {
       token = NextToken(line, pos, delimiters);
@@ -305,6 +329,77 @@ bool ParseConfigurationSection(ifstream& config, uint_t& inoutConfigLine, ostrea
         return false;
       }
     }
+    else if (token == gEntBufferPool)
+    {
+      token = NextToken(line, pos, delimiters);
+      gMainSettings.mBufferPoolSize = atoll(token.c_str());
+
+      if (gMainSettings.mBufferPoolSize == 0)
+      {
+        errOut << "Configuration error at line " << inoutConfigLine << ".\n";
+        return false;
+      }
+    }
+    else if (token == gEntIndexFillFactor)
+    {
+      token = NextToken(line, pos, delimiters);
+      gMainSettings.mIndexFillFactor = atoi(token.c_str());
+
+      if (gMainSettings.mIndexFillFactor == 0)
+      {
+        errOut << "Configuration error at line " << inoutConfigLine << ".\n";
+        return false;
+      }
+    }
+    else if (token == gEntWalSync)
+    {
+      token = NextToken(line, pos, delimiters);
+
+      if (token == "commit")
+        gMainSettings.mWalSyncPolicy = WAL_SYNC_COMMIT;
+
+      else if (token == "periodic")
+        gMainSettings.mWalSyncPolicy = WAL_SYNC_PERIODIC;
+
+      else if (token == "disabled")
+        gMainSettings.mWalSyncPolicy = WAL_DISABLED;
+
+      else
+      {
+        errOut << "Cannot assign '" << token << "' to '" << gEntWalSync << "' at line "
+               << inoutConfigLine << ". Valid values are 'commit', 'periodic' or 'disabled'.\n";
+        return false;
+      }
+    }
+    else if (token == gEntWalCheckpoint)
+    {
+      token = NextToken(line, pos, delimiters);
+      gMainSettings.mWalCheckpointSize = atoll(token.c_str());
+
+      if (gMainSettings.mWalCheckpointSize == 0)
+      {
+        errOut << "Configuration error at line " << inoutConfigLine << ".\n";
+        return false;
+      }
+    }
+    else if (token == gEntWriteBack)
+    {
+      token = NextToken(line, pos, delimiters);
+      if ((token.length() == 0) || (token.at(0) == COMMENT_CHAR))
+      {
+        errOut << "Configuration error at line " << inoutConfigLine << ".\n";
+        return false;
+      }
+
+      gMainSettings.mWriteBackInterval = atoi(token.c_str());
+      if (gMainSettings.mWriteBackInterval < -1)
+      {
+        errOut << "At line " << inoutConfigLine << " the write back interval parameter"
+            " should be a positive integer value or -1 (was set to "
+            << gMainSettings.mWriteBackInterval << " ).\n";
+        return false;
+      }
+    }
     else if (token == gEntAuthTMO)
     {
       token = NextToken(line, pos, delimiters);
@@ -463,6 +558,41 @@ bool ParseConfigurationSection(ifstream& config, uint_t& inoutConfigLine, ostrea
         return false;
       }
     }
+    else if (token == gEntLogRateLimit)
+    {
+      token = NextToken(line, pos, delimiters);
+      gMainSettings.mLogSettings.mRateLimit = atoi(token.c_str());
+    }
+    else if (token == gEntLogSyncLevel)
+    {
+      token = NextToken(line, pos, delimiters);
+
+      if (token == "none")
+        gMainSettings.mLogSettings.mSyncLevel = LT_UNKNOW;
+
+      else if (token == "critical")
+        gMainSettings.mLogSettings.mSyncLevel = LT_CRITICAL;
+
+      else if (token == "error")
+        gMainSettings.mLogSettings.mSyncLevel = LT_ERROR;
+
+      else if (token == "warning")
+        gMainSettings.mLogSettings.mSyncLevel = LT_WARNING;
+
+      else if (token == "info")
+        gMainSettings.mLogSettings.mSyncLevel = LT_INFO;
+
+      else if (token == "debug")
+        gMainSettings.mLogSettings.mSyncLevel = LT_DEBUG;
+
+      else
+      {
+        errOut << "Cannot assign '" << token << "' to '" << gEntLogSyncLevel << "' at line "
+               << inoutConfigLine << ". Valid values are 'none', 'critical', 'error', "
+                  "'warning', 'info' or 'debug'.\n";
+        return false;
+      }
+    }
     else if (token == gEntShowDbg)
     {
       token = NextToken(line, pos, delimiters);
@@ -840,6 +970,44 @@ bool ParseContextSection(Logger& log,
         return false;
       }
     }
+    else if (token == gEntMapTables)
+    {
+      token = NextToken(line, pos, delimiters);
+
+      if (token == "false")
+        output.mMapTablesRows = false;
+
+      else if (token == "true")
+        output.mMapTablesRows = true;
+
+      else
+      {
+        logEntry << "Cannot assign '" << token << "' to '" << gEntMapTables << "' at line "
+            << inoutConfigLine << ". Valid value are only 'true' or 'false'.";
+        log.Log(LT_CRITICAL, logEntry.str());
+
+        return false;
+      }
+    }
+    else if (token == gEntProfileProcs)
+    {
+      token = NextToken(line, pos, delimiters);
+
+      if (token == "false")
+        output.mProfileProcedures = false;
+
+      else if (token == "true")
+        output.mProfileProcedures = true;
+
+      else
+      {
+        logEntry << "Cannot assign '" << token << "' to '" << gEntProfileProcs << "' at line "
+            << inoutConfigLine << ". Valid value are only 'true' or 'false'.";
+        log.Log(LT_CRITICAL, logEntry.str());
+
+        return false;
+      }
+    }
     else
     {
       logEntry << "At line " << inoutConfigLine << ": Don't know what to do " << "with '" << token
@@ -879,6 +1047,18 @@ bool PrepareConfigurationSection(Logger& log)
   log.Log(LT_INFO, logStream.str());
   logStream.str(CLEAR_LOG_STREAM);
 
+  if (gMainSettings.mWorkerThreads == UNSET_VALUE)
+  {
+    if (gMainSettings.mShowDebugLog)
+      log.Log(LT_DEBUG, "The number of worker threads is set by default.");
+    gMainSettings.mWorkerThreads = wh_cpus_count();
+  }
+
+  logStream << "Client requests are served by " << gMainSettings.mWorkerThreads
+      << " worker threads.";
+  log.Log(LT_INFO, logStream.str());
+  logStream.str(CLEAR_LOG_STREAM);
+
   if (gMainSettings.mCipher == UNSET_VALUE)
   {
     if (gMainSettings.mShowDebugLog)
@@ -1018,6 +1198,91 @@ bool PrepareConfigurationSection(Logger& log)
   log.Log(LT_INFO, logStream.str());
   logStream.str(CLEAR_LOG_STREAM);
 
+  //Buffer pool
+  if (gMainSettings.mBufferPoolSize == UNSET_VALUE)
+  {
+    if (gMainSettings.mShowDebugLog)
+      log.Log(LT_DEBUG, "The buffer pool size is not set. Each table cache uses its own limit.");
+  }
+  else
+  {
+    const uint64_t minPoolSize = max<uint64_t>(MIN_BUFFER_POOL_SIZE,
+                                               max(gMainSettings.mTableCacheBlockSize,
+                                                   gMainSettings.mVLBlockSize));
+    if (gMainSettings.mBufferPoolSize < minPoolSize)
+    {
+      gMainSettings.mBufferPoolSize = minPoolSize;
+      log.Log(LT_INFO, "The buffer pool size was set to less than minimum.");
+    }
+
+    logStream << "The buffer pool size set at " << gMainSettings.mBufferPoolSize << " bytes.";
+    log.Log(LT_INFO, logStream.str());
+    logStream.str(CLEAR_LOG_STREAM);
+  }
+
+  //Index fill factor
+  if (gMainSettings.mIndexFillFactor == UNSET_VALUE)
+  {
+    gMainSettings.mIndexFillFactor = DEFAULT_INDEX_FILL_FACTOR;
+    if (gMainSettings.mShowDebugLog)
+      log.Log(LT_DEBUG, "The index fill factor is not set. Using the default value.");
+  }
+  else if (gMainSettings.mIndexFillFactor < MIN_INDEX_FILL_FACTOR)
+  {
+    gMainSettings.mIndexFillFactor = MIN_INDEX_FILL_FACTOR;
+    log.Log(LT_INFO, "The index fill factor was set to less than minimum.");
+  }
+  else if (gMainSettings.mIndexFillFactor > MAX_INDEX_FILL_FACTOR)
+  {
+    gMainSettings.mIndexFillFactor = MAX_INDEX_FILL_FACTOR;
+    log.Log(LT_INFO, "The index fill factor was set to more than maximum.");
+  }
+
+  logStream << "The new indexes are filled at " << gMainSettings.mIndexFillFactor << "%.";
+  log.Log(LT_INFO, logStream.str());
+  logStream.str(CLEAR_LOG_STREAM);
+
+  //Write-ahead log
+  if (gMainSettings.mWalSyncPolicy == WAL_DISABLED)
+    log.Log(LT_INFO, "The tables' changes are not logged. Unclosed databases need repairing.");
+
+  else
+  {
+    if (gMainSettings.mWalCheckpointSize == UNSET_VALUE)
+    {
+      gMainSettings.mWalCheckpointSize = DEFAULT_WAL_CHECKPOINT_SIZE;
+      if (gMainSettings.mShowDebugLog)
+        log.Log(LT_DEBUG, "The log checkpoint size is not set. Using the default value.");
+    }
+
+    logStream << "The tables' changes are logged and synced "
+              << ((gMainSettings.mWalSyncPolicy == WAL_SYNC_COMMIT)
+                   ? "at every commit"
+                   : "with the tables")
+              << ". The log is checkpointed at " << gMainSettings.mWalCheckpointSize << " bytes.";
+    log.Log(LT_INFO, logStream.str());
+    logStream.str(CLEAR_LOG_STREAM);
+  }
+
+  //Background write back of the dirty rows blocks
+  if (gMainSettings.mWriteBackInterval == UNSET_VALUE)
+  {
+    gMainSettings.mWriteBackInterval = DEFAULT_WRITE_BACK_INTERVAL;
+    if (gMainSettings.mShowDebugLog)
+      log.Log(LT_DEBUG, "The write back interval is not set. Using the default value.");
+  }
+
+  if (gMainSettings.mWriteBackInterval < 0)
+    log.Log(LT_INFO, "The dirty rows blocks are written only by the request threads.");
+
+  else
+  {
+    logStream << "The dirty rows blocks are written in background every "
+              << gMainSettings.mWriteBackInterval << " milliseconds.";
+    log.Log(LT_INFO, logStream.str());
+    logStream.str(CLEAR_LOG_STREAM);
+  }
+
   //Authentication timeout
   if (gMainSettings.mAuthTMO == UNSET_VALUE)
   {
@@ -49,12 +49,18 @@ struct ServerSettings
 {
   ServerSettings()
     : mMaxConnections(UNSET_VALUE),
+      mWorkerThreads(UNSET_VALUE),
       mMaxFrameSize(UNSET_VALUE),
       mTableCacheBlockSize(UNSET_VALUE),
       mTableCacheBlockCount(UNSET_VALUE),
       mVLBlockSize(UNSET_VALUE),
       mVLBlockCount(UNSET_VALUE),
       mTempValuesCache(UNSET_VALUE),
+      mBufferPoolSize(UNSET_VALUE),
+      mIndexFillFactor(UNSET_VALUE),
+      mWalCheckpointSize(UNSET_VALUE),
+      mWalSyncPolicy(whais::WAL_SYNC_COMMIT),
+      mWriteBackInterval(UNSET_VALUE),
       mAuthTMO(UNSET_VALUE),
       mSyncWakeup(UNSET_VALUE),
       mSyncInterval(UNSET_VALUE),
@@ -64,12 +70,18 @@ struct ServerSettings
   {}
 
   uint_t                   mMaxConnections;
+  uint_t                   mWorkerThreads;
   uint_t                   mMaxFrameSize;
   uint_t                   mTableCacheBlockSize;
   uint_t                   mTableCacheBlockCount;
   uint_t                   mVLBlockSize;
   uint_t                   mVLBlockCount;
   uint_t                   mTempValuesCache;
+  uint64_t                 mBufferPoolSize;
+  uint_t                   mIndexFillFactor;
+  uint64_t                 mWalCheckpointSize;
+  whais::WAL_SYNC_POLICY   mWalSyncPolicy;
+  int                      mWriteBackInterval;
   int                      mAuthTMO;
   int                      mSyncWakeup;
   int                      mSyncInterval;
@@ -77,6 +89,7 @@ struct ServerSettings
   std::string              mWorkDirectory;
   std::string              mTempDirectory;
   std::string              mLogFile;
+  whais::FileLoggerSettings mLogSettings;
   std::vector<ListenEntry> mListens;
   uint8_t                  mCipher;
   bool                     mShowDebugLog;
@@ -93,6 +106,8 @@ struct DBSDescriptors
       mSyncInterval(UNSET_VALUE),
       mWaitReqTmo(UNSET_VALUE),
       mStackCount(DEFAULT_MAX_STACK_CNT),
+      mMapTablesRows(false),
+      mProfileProcedures(false),
       mDbs(nullptr),
       mSession(nullptr),
       mLogger(nullptr),
@@ -103,6 +118,8 @@ struct DBSDescriptors
   int                              mSyncInterval;
   int                              mWaitReqTmo;
   uint_t                           mStackCount;
+  bool                             mMapTablesRows;
+  bool                             mProfileProcedures;
   std::string                      mDbsName;
   std::string                      mDbsDirectory;
   std::string                      mDbsLogFile;
@@ -76,15 +76,18 @@ ConnectionException::Description() const
 }
 
 
-ClientConnection::ClientConnection(UserHandler& client, vector<DBSDescriptors>& databases)
+ClientConnection::ClientConnection(UserHandler& client)
   : mUserHandler(client),
+    mStats(nullptr),
     mDataSize(GetAdminSettings().mMaxFrameSize),
     mData(mDataSize, 0),
     mWaitingFrameId(0),
+    mChallenge(0),
     mClientCookie(0),
     mServerCookie(0),
     mLastReceivedCmd(CMD_INVALID),
     mFrameSize(0),
+    mFrameRead(0),
     mVersion(1),
     mCipher(FRAME_ENCTYPE_PLAIN)
 {
@@ -94,9 +97,8 @@ ClientConnection::ClientConnection(UserHandler& client, vector<DBSDescriptors>&
     mDataSize -= mDataSize % sizeof(uint64_t);
 
   mUserHandler.mDesc = nullptr;
-  const uint16_t authFrameLen = FRAME_HDR_SIZE + FRAME_AUTH_SIZE;
 
-  assert(authFrameLen <= MIN_FRAME_SIZE);
+  assert(FRAME_HDR_SIZE + FRAME_AUTH_SIZE <= MIN_FRAME_SIZE);
 
   store_le_int16(MIN_FRAME_SIZE, &mData[FRAME_SIZE_OFF]);
   mData[FRAME_TYPE_OFF]    = FRAME_TYPE_AUTH_CLNT;
@@ -107,10 +109,18 @@ ClientConnection::ClientConnection(UserHandler& client, vector<DBSDescriptors>&
   store_le_int16(mDataSize, &mData[FRAME_HDR_SIZE + FRAME_AUTH_SIZE_OFF]);
   mData[FRAME_HDR_SIZE + FRAME_AUTH_ENC_OFF] = GetAdminSettings().mCipher;
 
-  const uint64_t challenge = wh_rnd();
-  store_le_int64(challenge, &mData[FRAME_HDR_SIZE + FRAME_AUTH_CHALLENGE_OFF]);
+  mChallenge = wh_rnd();
+  store_le_int64(mChallenge, &mData[FRAME_HDR_SIZE + FRAME_AUTH_CHALLENGE_OFF]);
 
   mUserHandler.mSocket.Write(&mData.front(), MIN_FRAME_SIZE);
+}
+
+
+void
+ClientConnection::Authenticate(vector<DBSDescriptors>& databases)
+{
+  const uint16_t authFrameLen = FRAME_HDR_SIZE + FRAME_AUTH_SIZE;
+
   ReciveRawClientFrame();
 
   mCipher = GetAdminSettings().mCipher;
@@ -181,11 +191,11 @@ ClientConnection::ClientConnection(UserHandler& client, vector<DBSDescriptors>&
                         mKey._DES);
   }
 
-  uint8_t challengeRsp[sizeof challenge];
+  uint8_t challengeRsp[sizeof mChallenge];
   memcpy(challengeRsp, &mData[FRAME_HDR_SIZE + FRAME_AUTH_RSP_CHALLENGE_OFF], sizeof challengeRsp);
   wh_buff_des_decode(_RC(const uint8_t*, password.c_str()), challengeRsp, sizeof challengeRsp);
 
-  if (load_le_int64(challengeRsp) != challenge)
+  if (load_le_int64(challengeRsp) != mChallenge)
   {
     throw ConnectionException(_EXTRA(0),
                               mUserHandler.mRoot
@@ -271,56 +281,65 @@ ClientConnection::RawCmdData()
 }
 
 
-void
-ClientConnection::ReciveRawClientFrame()
+bool
+ClientConnection::ReceiveFrame()
 {
-  uint16_t frameRead = 0;
-
-  while (frameRead < FRAME_HDR_SIZE)
+  while (mFrameRead < FRAME_HDR_SIZE)
   {
-    const uint16_t chunkSize = mUserHandler.mSocket.Read(&mData[frameRead],
-                                                         FRAME_HDR_SIZE - frameRead);
+    const uint_t chunkSize = mUserHandler.mSocket.ReadPending(&mData[mFrameRead],
+                                                              FRAME_HDR_SIZE - mFrameRead);
     if (chunkSize == 0)
-      throw ConnectionException(_EXTRA(0), "Connection reset by peer.");
+      return false;
 
-    frameRead += chunkSize;
+    mFrameRead += chunkSize;
+    if (mFrameRead < FRAME_HDR_SIZE)
+      continue;
+
+    switch (mData[FRAME_TYPE_OFF])
+    {
+    case FRAME_TYPE_NORMAL:
+    case FRAME_TYPE_AUTH_CLNT_RSP:
+      mFrameSize = load_le_int16( &mData.front() + FRAME_SIZE_OFF);
+      if ((mFrameSize < mFrameRead) || (mFrameSize > mDataSize))
+        throw ConnectionException(_EXTRA(0), "Invalid frame received.");
+      break;
+
+    case FRAME_TYPE_TIMEOUT:
+      throw ConnectionException(_EXTRA(0), "Client peer has signaled a timeout condition.");
+      break;
+
+    default:
+      assert(false);
+      throw ConnectionException(_EXTRA(0), "Unexpected frame type received.");
+    }
   }
 
-  switch (mData[FRAME_TYPE_OFF])
+  while (mFrameRead < mFrameSize)
   {
-  case FRAME_TYPE_NORMAL:
-  case FRAME_TYPE_AUTH_CLNT_RSP:
-    mFrameSize = load_le_int16( &mData.front() + FRAME_SIZE_OFF);
-    if ((mFrameSize < frameRead) || (mFrameSize > mDataSize))
-      throw ConnectionException(_EXTRA(0), "Invalid frame received.");
+    const uint_t chunkSize = mUserHandler.mSocket.ReadPending(&mData[mFrameRead],
+                                                              mFrameSize - mFrameRead);
+    if (chunkSize == 0)
+      return false;
 
-    while (frameRead < mFrameSize)
-    {
-      const uint16_t chunkSize = mUserHandler.mSocket.Read(&mData[frameRead],
-                                                           mFrameSize - frameRead);
-      if (chunkSize == 0)
-        throw ConnectionException(_EXTRA(0), "Connection reset by peer.");
+    mFrameRead += chunkSize;
+  }
 
-      frameRead += chunkSize;
-    }
+  return true;
+}
 
-    assert(frameRead == mFrameSize);
 
-    if (load_le_int32( &mData.front() + FRAME_ID_OFF) != mWaitingFrameId)
-      throw ConnectionException(_EXTRA(0), "Connection with peer is out of sync");
+void
+ClientConnection::ReciveRawClientFrame()
+{
+  assert((mFrameRead >= FRAME_HDR_SIZE) && (mFrameRead == mFrameSize));
 
-    if (mCipher != mData[FRAME_ENCTYPE_OFF])
-      throw ConnectionException(_EXTRA(0), "Peer has used a wrong cipher.");
-    break;
+  mFrameRead = 0; //Next time start with a new frame.
 
-  case FRAME_TYPE_TIMEOUT:
-    throw ConnectionException(_EXTRA(0), "Client peer has signaled a timeout condition.");
-    break;
+  if (load_le_int32( &mData.front() + FRAME_ID_OFF) != mWaitingFrameId)
+    throw ConnectionException(_EXTRA(0), "Connection with peer is out of sync");
 
-  default:
-    assert(false);
-    throw ConnectionException(_EXTRA(0), "Unexpected frame type received.");
-  }
+  if (mCipher != mData[FRAME_ENCTYPE_OFF])
+    throw ConnectionException(_EXTRA(0), "Peer has used a wrong cipher.");
 
   if (mData[FRAME_TYPE_OFF] == FRAME_TYPE_AUTH_CLNT_RSP)
     return;
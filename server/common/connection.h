@@ -34,6 +34,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "server/server_protocol.h"
 
 #include "configuration.h"
+#include "stats.h"
 
 
 using namespace whais;
@@ -41,22 +42,18 @@ using namespace whais;
 
 struct UserHandler
 {
-  UserHandler()
+  UserHandler(Socket&& socket)
     : mDesc(nullptr),
       mLastReqTick(0),
-      mSocket(INVALID_SOCKET),
-      mRoot(false),
-      mEndConnection(true)
+      mSocket(std::move(socket)),
+      mRoot(false)
   {
-    mThread.IgnoreExceptions(true);
   }
 
   const DBSDescriptors* mDesc;
   uint64_t              mLastReqTick;
-  Thread                mThread;
   Socket                mSocket;
   bool                  mRoot;
-  bool                  mEndConnection;
 };
 
 
@@ -78,11 +75,18 @@ public:
 class ClientConnection
 {
 public:
-  ClientConnection(UserHandler& client, std::vector<DBSDescriptors>& databases);
+  //Sends the authentication challenge; the client's answer is checked by Authenticate().
+  ClientConnection(UserHandler& client);
 
   ClientConnection(const ClientConnection&) = delete;
   const ClientConnection& operator= (const ClientConnection&) = delete;
 
+  //Buffers what the client has sent so far without waiting for more.
+  //Returns true once a whole frame is received.
+  bool   ReceiveFrame();
+
+  void   Authenticate(std::vector<DBSDescriptors>& databases);
+
   uint_t MaxSize() const;
   uint_t DataSize() const;
   void   DataSize(const uint16_t size);
@@ -101,6 +105,17 @@ public:
   SessionStack& Stack() { return mStack; }
   bool IsAdmin() const { return mUserHandler.mRoot; }
 
+  //The statistics of the worker serving the current request.
+  WorkerStats& Stats()
+  {
+    assert(mStats != nullptr);
+    return *mStats;
+  }
+  void Stats(WorkerStats& stats) { mStats = &stats; }
+
+  //A report kept between the requests that fetch its parts.
+  std::string& Report() { return mReport; }
+
 private:
   uint8_t* RawCmdData();
   void ReciveRawClientFrame();
@@ -108,13 +123,17 @@ private:
 
   UserHandler&                  mUserHandler;
   SessionStack                  mStack;
+  WorkerStats*                  mStats;
+  std::string                   mReport;
   uint_t                        mDataSize;
   std::vector<uint8_t>          mData;
   uint32_t                      mWaitingFrameId;
+  uint64_t                      mChallenge;
   uint32_t                      mClientCookie;
   uint32_t                      mServerCookie;
   uint16_t                      mLastReceivedCmd;
   uint16_t                      mFrameSize;
+  uint16_t                      mFrameRead;
   uint8_t                       mVersion;
   uint8_t                       mCipher;
   union {
@@ -50,8 +50,12 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
   logEntry.str(CLEAR_LOG_STREAM);
 
   inoutDesc.mDbs = &DBSRetrieveDatabase(inoutDesc.mDbsName.c_str(),
-                                        inoutDesc.mDbsDirectory.c_str());
-  std::unique_ptr<Logger> dbsLogger = unique_make(FileLogger, inoutDesc.mDbsLogFile.c_str(), true);
+                                        inoutDesc.mDbsDirectory.c_str(),
+                                        inoutDesc.mMapTablesRows);
+  std::unique_ptr<Logger> dbsLogger = unique_make(FileLogger,
+                                                  inoutDesc.mDbsLogFile.c_str(),
+                                                  true,
+                                                  GetAdminSettings().mLogSettings);
 
   logEntry << "Sync interval is set at " << inoutDesc.mSyncInterval << " milliseconds";
   dbsLogger->Log(LT_INFO, logEntry.str());
@@ -63,6 +67,19 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
   log.Log(LT_INFO, logEntry.str());
   logEntry.str(CLEAR_LOG_STREAM);
 
+  if (inoutDesc.mMapTablesRows)
+  {
+    if (DBSGetSeettings().mWalSyncPolicy == WAL_DISABLED)
+      logEntry << "Tables' rows are accessed through memory mapped files.";
+
+    else
+      logEntry << "Tables' rows are not memory mapped while their changes are logged.";
+
+    dbsLogger->Log(LT_INFO, logEntry.str());
+    log.Log(LT_INFO, logEntry.str());
+    logEntry.str(CLEAR_LOG_STREAM);
+  }
+
   if (inoutDesc.mDbsName != GlobalContextDatabase())
     inoutDesc.mSession = &GetInstance(inoutDesc.mDbsName.c_str(), dbsLogger.get());
 
@@ -80,6 +97,16 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
     logEntry.str(CLEAR_LOG_STREAM);
   }
 
+  temp = inoutDesc.mProfileProcedures ? 1 : 0;
+  if ( ! inoutDesc.mSession->NotifyEvent(ISession::PROFILE_PROCEDURES, &temp))
+  {
+    logEntry << "Failed to set the procedures profiling for session '"
+             << inoutDesc.mDbsName << "'.";
+
+    log.Log(LT_ERROR, logEntry.str());
+    logEntry.str(CLEAR_LOG_STREAM);
+  }
+
   for (const auto& lib : inoutDesc.mNativeLibs)
   {
     logEntry << "... Loading dynamic native library '" << lib << "'.";
@@ -30,32 +30,55 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "server.h"
 #include "connection.h"
 #include "commands.h"
+#include "stats.h"
 
 
 using namespace std;
 using namespace whais;
 
 
-static const uint_t SOCKET_BACK_LOG       = 10;
+static const uint_t SOCKET_BACK_LOG       = 128;
 static const uint_t SLEEP_TICK_RESOLUTION = 10;
 static const uint_t REQ_TICK_RESOLUTION   = 100;
+static const uint_t WORKER_WAIT_TMO       = 100;
 
 static vector<DBSDescriptors>*     sDbsDescriptors;
 static FileLogger*                 sMainLog;
+static SocketPoller*               sPoller;
 static bool                        sAcceptUsersConnections;
 static bool                        sServerStopped;
 static Lock                        sClosingLock;
 static int32_t                     sListenersMaxFails;
 
 
+class Listener;
+
+/* A connected client. It does not own a thread; its socket waits in the
+ * poller between requests and the first available worker reads what has
+ * arrived. A request is served only once its whole frame is buffered. */
+struct UserSession
+{
+  UserSession(Listener& listener, Socket&& socket)
+    : mUser(std::move(socket)),
+      mListener(listener),
+      mIndex(0)
+  {
+  }
+
+  UserHandler                   mUser;
+  unique_ptr<ClientConnection>  mConnection;
+  Listener&                     mListener;
+  size_t                        mIndex;
+};
+
+
 class Listener
 {
 public:
   Listener()
     : mInterface(nullptr),
       mPort(nullptr),
-      mSocket(INVALID_SOCKET),
-      mUsersPool(GetAdminSettings().mMaxConnections)
+      mSocket(INVALID_SOCKET)
   {
     mListenThread.IgnoreExceptions(true);
   }
@@ -63,22 +86,48 @@ public:
   Listener(const Listener& ) = delete;
   Listener& operator= (const Listener&) = delete;
 
-  bool SearchFreeUser(void(*task)( void* args), Socket& socket)
+  UserSession* AddSession(Socket& socket)
   {
-    assert(mUsersPool.size() > 0);
+    LockGuard<Lock> _l(mSync);
 
-    for (auto& user : mUsersPool)
-    {
-      if ( !user.mEndConnection)
-        continue;
+    if (mSessions.size() >= GetAdminSettings().mMaxConnections)
+      return nullptr;
 
-      user.mSocket = std::move(socket);
-      user.mEndConnection = false;
-      user.mLastReqTick = 0;
-      if (user.mThread.Run(task, &user))
-        return true;
+    unique_ptr<UserSession> session(new UserSession(*this, std::move(socket)));
+
+    session->mIndex = mSessions.size();
+    session->mUser.mLastReqTick = wh_msec_ticks(); //Start authentication timer.
+    mSessions.push_back(std::move(session));
+
+    return mSessions.back().get();
+  }
+
+  void ReleaseSession(UserSession* const session)
+  {
+    unique_ptr<UserSession> released;
+
+    sPoller->Remove(session->mUser.mSocket);
+
+    LockGuard<Lock> _l(mSync);
+
+    const size_t index = session->mIndex;
+    const size_t last  = mSessions.size() - 1;
+
+    assert(mSessions[index].get() == session);
+
+    released = std::move(mSessions[index]);
+    if (index != last)
+    {
+      mSessions[index] = std::move(mSessions[last]);
+      mSessions[index]->mIndex = index;
     }
-    return false;
+    mSessions.pop_back();
+  }
+
+  void ReleaseAllSessions()
+  {
+    while ( !mSessions.empty())
+      ReleaseSession(mSessions.back().get());
   }
 
   void Close()
@@ -91,113 +140,132 @@ public:
     //Cancel any pending IO operations.
     mSocket.Close();
 
-    for (auto& user : mUsersPool)
-    {
-      user.mThread.IgnoreExceptions(true);
-      user.mThread.DiscardException();
+    LockGuard<Lock> _l(mSync);
 
-      user.mEndConnection = true;
-      user.mSocket.Close();
-      user.mThread.WaitToEnd(false);
-    }
+    for (auto& session : mSessions)
+      session->mUser.mSocket.Shutdown();
   }
 
   void ReqTmoCloseTick()
   {
     const WTICKS msecTicks = wh_msec_ticks();
 
-    for (auto& user : mUsersPool)
+    LockGuard<Lock> _l(mSync);
+
+    for (auto& session : mSessions)
     {
-      if ((user.mEndConnection) || (user.mLastReqTick == 0))
+      UserHandler& user = session->mUser;
+      const uint64_t lastReqTick = user.mLastReqTick;
+
+      if (lastReqTick == 0)
         continue;
 
       if (user.mDesc == nullptr)
       {
-        if ((msecTicks - user.mLastReqTick) < _SC(uint_t, GetAdminSettings().mAuthTMO))
+        if ((msecTicks - lastReqTick) < _SC(uint_t, GetAdminSettings().mAuthTMO))
           continue;
 
-        user.mSocket.Close();
+        //The worker serving it will notice and release the session.
+        user.mSocket.Shutdown();
+        user.mLastReqTick = 0;
         sMainLog->Log(LT_WARNING, "Authentication terminated as it took too long...");
         continue;
       }
-      else if ((msecTicks - user.mLastReqTick) < _SC(uint_t, user.mDesc->mWaitReqTmo))
+      else if ((msecTicks - lastReqTick) < _SC(uint_t, user.mDesc->mWaitReqTmo))
         continue;
 
-      user.mSocket.Close();
+      user.mSocket.Shutdown();
+      user.mLastReqTick = 0;
       user.mDesc->mLogger->Log(LT_WARNING,
                                "Connection dropped due to a long wait for a request...");
     }
   }
 
-  const char*         mInterface;
-  const char*         mPort;
-  Thread              mListenThread;
-  Socket              mSocket;
-  vector<UserHandler> mUsersPool;
+  const char*                     mInterface;
+  const char*                     mPort;
+  Thread                          mListenThread;
+  Socket                          mSocket;
 
 private:
-
-
-  static const uint_t MAX_AUTH_TMO_MS = 200;
+  Lock                            mSync;
+  vector<unique_ptr<UserSession>> mSessions;
 };
 
 
 static vector<Listener>* volatile sListeners;
 
 
-void
-client_handler_routine(void* args)
+//Serves the next request of a session. Returns false when it should be released.
+static bool
+serve_user_request(UserSession& session, WorkerStats& stats)
 {
-  UserHandler* const client = _RC(UserHandler*, args);
-
-  client->mLastReqTick   = 0;
-  client->mEndConnection = false;
+  UserHandler& client = session.mUser;
 
   assert(sDbsDescriptors != nullptr);
 
   try
   {
-    client->mLastReqTick = wh_msec_ticks(); //Start authentication timer.
-    ClientConnection connection( *client, *sDbsDescriptors);
+    if ( !session.mConnection)
+    {
+      session.mConnection.reset(new ClientConnection(client));
+      return true;
+    }
 
-    while (true)
+    ClientConnection& connection = *session.mConnection;
+    if ( !connection.ReceiveFrame())
+      return true;                          //Wait for the rest of the frame.
+
+    if (client.mDesc == nullptr)
     {
-      const COMMAND_HANDLER* cmds;
+      connection.Authenticate(*sDbsDescriptors);
+      client.mLastReqTick = 0;              //Stop authentication timer!
+      return true;
+    }
+    const COMMAND_HANDLER* cmds;
+    uint_t statsIndex;
 
-      client->mLastReqTick = wh_msec_ticks(); //Start request timer!
-      uint16_t cmdType = connection.ReadCommand();
-      client->mLastReqTick = 0;                //Stop request timer!
+    uint16_t cmdType = connection.ReadCommand();
+    client.mLastReqTick = 0;                //Stop request timer!
 
-      if (cmdType == CMD_CLOSE_CONN)
-        break;
+    if (cmdType == CMD_CLOSE_CONN)
+      return false;
 
-      if ((cmdType & 1) != 0)
-        throw ConnectionException(_EXTRA(cmdType), "Invalid command requested.");
+    if ((cmdType & 1) != 0)
+      throw ConnectionException(_EXTRA(cmdType), "Invalid command requested.");
 
-      if (cmdType >= USER_CMD_BASE)
-      {
-        cmdType -= USER_CMD_BASE, cmdType /= 2;
+    if (cmdType >= USER_CMD_BASE)
+    {
+      cmdType -= USER_CMD_BASE, cmdType /= 2;
 
-        if (cmdType >= USER_CMDS_COUNT)
-          throw ConnectionException(_EXTRA(cmdType), "Invalid user command received.");
+      if (cmdType >= USER_CMDS_COUNT)
+        throw ConnectionException(_EXTRA(cmdType), "Invalid user command received.");
 
-        cmds = gpUserCommands;
-      }
-      else
-      {
-        cmdType /= 2;
-        if (cmdType >= ADMIN_CMDS_COUNT)
-          throw ConnectionException(_EXTRA(cmdType), "Invalid administrator command received.");
+      cmds = gpUserCommands;
+      statsIndex = ADMIN_CMDS_COUNT + cmdType;
+    }
+    else
+    {
+      cmdType /= 2;
+      if (cmdType >= ADMIN_CMDS_COUNT)
+        throw ConnectionException(_EXTRA(cmdType), "Invalid administrator command received.");
 
-        else if ( !connection.IsAdmin())
-        {
-          throw ConnectionException(_EXTRA(cmdType),
-                                    "Regular user wants to execute an administrator command.");
-        }
-        cmds = gpAdminCommands;
+      else if ( !connection.IsAdmin())
+      {
+        throw ConnectionException(_EXTRA(cmdType),
+                                  "Regular user wants to execute an administrator command.");
       }
-      cmds[cmdType](connection);
+      cmds = gpAdminCommands;
+      statsIndex = cmdType;
     }
+
+    const uint64_t startTicks = wh_usec_ticks();
+
+    connection.Stats(stats);
+    cmds[cmdType](connection);
+
+    stats.RecordCommand(connection.Dbs(), statsIndex, wh_usec_ticks() - startTicks);
+
+    return true;
   }
   catch (SocketException& e)
   {
@@ -215,8 +283,8 @@ client_handler_routine(void* args)
   }
   catch(ConnectionException& e)
   {
-      if (client->mDesc != nullptr)
-        client->mDesc->mLogger->Log(LT_ERROR, e.Message());
+      if (client.mDesc != nullptr)
+        client.mDesc->mLogger->Log(LT_ERROR, e.Message());
 
       else
         sMainLog->Log(LT_ERROR, e.Message());
@@ -249,7 +317,11 @@ client_handler_routine(void* args)
         logEntry << "Message:\n" << e.Message() << endl;
 
       logEntry <<"Extra: " << e.Code() << " (" << e.File() << ':' << e.Line() << ").";
-      client->mDesc->mLogger->Log(LT_ERROR, logEntry.str());
+      if (client.mDesc != nullptr)
+        client.mDesc->mLogger->Log(LT_ERROR, logEntry.str());
+
+      else
+        sMainLog->Log(LT_ERROR, logEntry.str());
   }
   catch(std::bad_alloc&)
   {
@@ -272,9 +344,57 @@ client_handler_routine(void* args)
       StopServer();
   }
 
-  client->mSocket.Close();
-  client->mLastReqTick  = 0;
-  client->mEndConnection = true;
+  return false;
+}
+
+
+void
+worker_routine(void* args)
+{
+  WorkerStats& stats = *_RC(WorkerStats*, args);
+
+  assert(sPoller != nullptr);
+
+  while ( !sServerStopped)
+  {
+    try
+    {
+      const auto session = _RC(UserSession*, sPoller->Wait(WORKER_WAIT_TMO));
+      if (session == nullptr)
+        continue;
+
+      if (serve_user_request(*session, stats))
+      {
+        //Keep the timer running while a request's frame is still incomplete.
+        if ((session->mUser.mDesc != nullptr) && (session->mUser.mLastReqTick == 0))
+          session->mUser.mLastReqTick = wh_msec_ticks(); //Start request timer!
+
+        try
+        {
+          sPoller->Rearm(session->mUser.mSocket, WH_POLL_READ, session);
+          continue;
+        }
+        catch (SocketException& e)
+        {
+          sMainLog->Log(LT_ERROR, e.Message());
+        }
+      }
+      session->mListener.ReleaseSession(session);
+    }
+    catch (Exception& e)
+    {
+      ostringstream logEntry;
+
+      logEntry << "Worker failed to wait for client requests.\n";
+      if ( ! e.Message().empty())
+        logEntry << "Message:\n" << e.Message() << endl;
+
+      logEntry <<"Extra: " << e.Code() << " (" << e.File() << ':' << e.Line() << ").";
+      sMainLog->Log(LT_CRITICAL, logEntry.str());
+
+      StopServer();
+    }
+  }
 }
 
 
@@ -360,7 +480,6 @@ listener_routine(void* args)
 {
   const auto listener = _RC(Listener*, args);
 
-  assert(listener->mUsersPool.size() > 0);
   assert(listener->mListenThread.HasExceptionPending() == false);
   assert(listener->mPort != nullptr);
 
@@ -383,7 +502,8 @@ listener_routine(void* args)
       {
         Socket client = listener->mSocket.Accept();
 
-        if ( !listener->SearchFreeUser(client_handler_routine, client))
+        UserSession* const session = listener->AddSession(client);
+        if (session == nullptr)
         {
           static const uint8_t busyResp[] = { 0x04, 0x00, 0xFF, 0xFF };
 
@@ -391,6 +511,19 @@ listener_routine(void* args)
 
           sMainLog->Log(LT_INFO, "Connection refused because of unavailable slots.");
         }
+        else
+        {
+          //The server speaks first, so a worker picks it up as soon as it can write.
+          try
+          {
+            sPoller->Add(session->mUser.mSocket, WH_POLL_WRITE, session);
+          }
+          catch (SocketException& e)
+          {
+            sMainLog->Log(LT_ERROR, e.Message());
+            listener->ReleaseSession(session);
+          }
+        }
       }
       catch (SocketException& e)
       {
@@ -463,6 +596,9 @@ StartServer(FileLogger& log, vector<DBSDescriptors>& databases)
 
   const ServerSettings& server = GetAdminSettings();
 
+  SocketPoller poller;
+  sPoller = &poller;
+
   vector<Listener> listeners(server.mListens.size());
   sListenersMaxFails = listeners.size();
 
@@ -471,6 +607,16 @@ StartServer(FileLogger& log, vector<DBSDescriptors>& databases)
   sAcceptUsersConnections = true;
   sServerStopped          = false;
 
+  ServerStats stats(databases, server.mWorkerThreads);
+
+  vector<Thread> workers(server.mWorkerThreads);
+  for (uint_t w = 0; w < workers.size(); ++w)
+  {
+    workers[w].IgnoreExceptions(true);
+    if ( !workers[w].Run(worker_routine, &stats.Worker(w)))
+      log.Log(LT_ERROR, "Failed to start a worker thread.");
+  }
+
   for (uint_t i = 0; i < listeners.size(); ++i)
   {
     auto& l = listeners[i];
@@ -498,7 +644,14 @@ StartServer(FileLogger& log, vector<DBSDescriptors>& databases)
   for (uint_t index = 0; index < listeners.size(); ++index)
     listeners[index].mListenThread.WaitToEnd(false);
 
+  for (auto& w : workers)
+    w.WaitToEnd(false);
+
+  for (auto& l : listeners)
+    l.ReleaseAllSessions();
+
   listeners.clear();
+  sPoller = nullptr;
 
   log.Log(LT_INFO, "Server stopped!");
 }
@@ -198,7 +198,9 @@ main(int argc, char** argv)
       if (ParseConfigurationSection(*config, sectionLine, cerr) == false)
         return -1;
 
-      glbLog.reset(new FileLogger(GetAdminSettings().mLogFile.c_str()));
+      glbLog.reset(new FileLogger(GetAdminSettings().mLogFile.c_str(),
+                                  true,
+                                  GetAdminSettings().mLogSettings));
 
   }
   catch(ios_base::failure& e)
@@ -281,6 +283,11 @@ main(int argc, char** argv)
     dbsSettings.mVLStoreCacheBlkCount = confSettings.mVLBlockCount;
     dbsSettings.mVLStoreCacheBlkSize  = confSettings.mVLBlockSize;
     dbsSettings.mVLValueCacheSize     = confSettings.mTempValuesCache;
+    dbsSettings.mBufferPoolSize       = confSettings.mBufferPoolSize;
+    dbsSettings.mIndexFillFactor      = confSettings.mIndexFillFactor;
+    dbsSettings.mWalSyncPolicy        = confSettings.mWalSyncPolicy;
+    dbsSettings.mWalCheckpointSize    = confSettings.mWalCheckpointSize;
+    dbsSettings.mWriteBackInterval    = MAX(confSettings.mWriteBackInterval, 0);
 
     DBSInit(dbsSettings);
     sDbsInited = true;
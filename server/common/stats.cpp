@@ -0,0 +1,290 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+
+#include "dbs/dbs_exception.h"
+#include "interpreter/interpreter.h"
+
+#include "stats.h"
+
+
+using namespace std;
+using namespace whais;
+
+
+static const char* const saCommandsNames[] =
+{
+  "invalid",
+  "list_globals",
+  "list_procedures",
+  "desc_proc_param",
+  "server_stats",
+  "proc_profile",
+
+  "close_conn",
+  "global_desc",
+  "read_stack",
+  "update_stack",
+  "exec_proc",
+  "ping_server",
+  "hello_server",
+  "resolve_proc"
+};
+
+
+static void
+report_latency(ostream& out, const char* const name, const LatencyHistogram& latency)
+{
+  static const uint_t NAME_WIDTH = 24;
+
+  out << "    " << left << setw(NAME_WIDTH) << name << right;
+
+  //Keep the columns aligned when a long name gets its own line.
+  if (strlen(name) >= NAME_WIDTH)
+    out << endl << setw(NAME_WIDTH + 4) << "";
+
+  out << setw(10) << latency.Count()
+      << setw(10) << (latency.Sum() / latency.Count())
+      << setw(10) << latency.Percentile(50)
+      << setw(10) << latency.Percentile(90)
+      << setw(10) << latency.Percentile(99)
+      << setw(10) << latency.Max() << endl;
+}
+
+
+static void
+report_latency_header(ostream& out, const char* const title)
+{
+  out << "  " << left << setw(26) << title << right
+      << setw(10) << "count"
+      << setw(10) << "mean"
+      << setw(10) << "p50"
+      << setw(10) << "p90"
+      << setw(10) << "p99"
+      << setw(10) << "max" << endl;
+}
+
+
+static void
+report_syncs(ostream& out, const ISession& session, const uint32_t procId)
+{
+  const uint_t syncsCount = session.ProcedureSyncsCount(procId);
+
+  for (uint_t sync = 0; sync < syncsCount; ++sync)
+  {
+    SyncStatementStats stats;
+    session.ProcedureSyncStats(procId, sync, stats);
+
+    out << "      sync " << sync
+        << ": acquires " << stats.mAcquiresCount
+        << ", contentions " << stats.mContentionsCount
+        << ", wait " << stats.mWaitTime
+        << ", hold " << stats.mHoldTime
+        << ", max hold " << stats.mMaxHoldTime << endl;
+  }
+}
+
+
+static void
+report_tables(ostream& out, IDBSHandler& dbs)
+{
+  const TABLE_INDEX tablesCount = dbs.PersistentTablesCount();
+
+  out << "  Tables (cache hits/misses/evictions, index nodes retrieved/loaded,"
+         " bytes read/written, rows and indexes lock waits/time)" << endl;
+
+  try
+  {
+    for (TABLE_INDEX table = 0; table < tablesCount; ++table)
+    {
+      DBSTableStats stats;
+      if ( ! dbs.TableStatistics(table, stats))
+        continue;
+
+      out << "    " << dbs.TableName(table)
+          << ": " << stats.mCacheHits << '/' << stats.mCacheMisses << '/' << stats.mCacheEvictions
+          << ", " << stats.mNodesRetrieved << '/' << stats.mNodesLoaded
+          << ", " << stats.mBytesRead << '/' << stats.mBytesWritten
+          << ", " << stats.mRowsLockWaits << '/' << stats.mRowsLockWaitTime
+          << ", " << stats.mIndexesLockWaits << '/' << stats.mIndexesLockWaitTime << endl;
+    }
+  }
+  catch (DBSException& e)
+  {
+    //A table was removed meanwhile, so the rest are not where expected.
+    if (e.Code() != DBSException::TABLE_NOT_FUND)
+      throw;
+  }
+}
+
+
+WorkerStats::WorkerStats(ServerStats& owner, const uint_t dbsCount)
+  : mOwner(owner),
+    mSync(),
+    mDatabases(dbsCount)
+{
+}
+
+
+void
+WorkerStats::RecordCommand(const DBSDescriptors& dbs, const uint_t command, const uint64_t usecs)
+{
+  assert(command < STATS_COMMANDS_COUNT);
+
+  LockGuard<Lock> _l(mSync);
+
+  mDatabases[mOwner.DbsIndex(dbs)].mCommands[command].Record(usecs);
+}
+
+
+void
+WorkerStats::RecordProcedure(const DBSDescriptors& dbs, const uint32_t procId, const uint64_t usecs)
+{
+  LockGuard<Lock> _l(mSync);
+
+  mDatabases[mOwner.DbsIndex(dbs)].mProcedures[procId].Record(usecs);
+}
+
+
+ServerStats::ServerStats(const vector<DBSDescriptors>& databases, const uint_t workersCount)
+  : mDatabases(databases)
+{
+  static_assert(sizeof saCommandsNames / sizeof saCommandsNames[0] == STATS_COMMANDS_COUNT,
+                "Every command needs a name in the reports.");
+
+  for (uint_t w = 0; w < workersCount; ++w)
+    mWorkers.push_back(unique_ptr<WorkerStats>(new WorkerStats(*this, databases.size())));
+}
+
+
+uint_t
+ServerStats::DbsIndex(const DBSDescriptors& dbs) const
+{
+  assert((&mDatabases[0] <= &dbs) && (&dbs < &mDatabases[0] + mDatabases.size()));
+
+  return &dbs - &mDatabases[0];
+}
+
+
+void
+ServerStats::Report(const DBSDescriptors* const onlyDbs, string& outReport)
+{
+  ostringstream out;
+
+  out << "Latencies are measured in microseconds." << endl;
+  for (uint_t d = 0; d < mDatabases.size(); ++d)
+  {
+    const DBSDescriptors& dbs = mDatabases[d];
+    if ((onlyDbs != nullptr) && (onlyDbs != &dbs))
+      continue;
+
+    WorkerStats::DbsLatencies latencies;
+    for (auto& worker : mWorkers)
+    {
+      LockGuard<Lock> _l(worker->mSync);
+
+      const WorkerStats::DbsLatencies& source = worker->mDatabases[d];
+      for (uint_t c = 0; c < STATS_COMMANDS_COUNT; ++c)
+        latencies.mCommands[c].Merge(source.mCommands[c]);
+
+      for (auto& proc : source.mProcedures)
+        latencies.mProcedures[proc.first].Merge(proc.second);
+    }
+
+    out << endl << "Database '" << dbs.mDbsName << '\'' << endl;
+
+    report_latency_header(out, "Commands");
+    for (uint_t c = 0; c < STATS_COMMANDS_COUNT; ++c)
+    {
+      if (latencies.mCommands[c].Count() > 0)
+        report_latency(out, saCommandsNames[c], latencies.mCommands[c]);
+    }
+
+    report_latency_header(out, "Procedures");
+    for (auto& proc : latencies.mProcedures)
+    {
+      report_latency(out, dbs.mSession->ProcedureName(proc.first), proc.second);
+      report_syncs(out, *dbs.mSession, proc.first);
+    }
+
+    report_tables(out, *dbs.mDbs);
+  }
+
+  outReport = out.str();
+}
+
+
+static void
+report_profile(ostream& out, const char* const name, const ProcedureProfile& profile)
+{
+  out << "procedure " << name << endl
+      << "calls " << profile.mCallsCount
+      << " inclusive " << profile.mInclusiveTime
+      << " exclusive " << profile.mExclusiveTime
+      << " native " << profile.mNativeTime
+      << " tables " << profile.mTablesTime << endl;
+
+  for (size_t pc = 0; pc < profile.mInstructionHits.size(); ++pc)
+  {
+    if (profile.mInstructionHits[pc] == 0)
+      continue;
+
+    out << "pc " << pc
+        << ' ' << profile.mInstructionHits[pc]
+        << ' ' << profile.mInstructionTimes[pc] << endl;
+  }
+}
+
+
+void
+ProceduresProfileReport(ISession& session, const char* const procedure, string& outReport)
+{
+  ostringstream out;
+
+  ProcedureProfile profile;
+
+  if (procedure != nullptr)
+  {
+    const uint32_t procId = session.ResolveProcedure(procedure);
+
+    session.ProcedureProfileStats(procId, profile);
+    report_profile(out, procedure, profile);
+  }
+  else
+  {
+    const uint_t procsCount = session.ProceduresCount();
+    for (uint_t procId = 0; procId < procsCount; ++procId)
+    {
+      session.ProcedureProfileStats(procId, profile);
+
+      if (profile.mCallsCount > 0)
+        report_profile(out, session.ProcedureName(procId), profile);
+    }
+  }
+
+  outReport = out.str();
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "whais.h"
+#include "utils/wthread.h"
+#include "utils/wstats.h"
+
+#include "configuration.h"
+
+
+//The commands are counted with the administrator ones first.
+#define STATS_COMMANDS_COUNT    (ADMIN_CMDS_COUNT + USER_CMDS_COUNT)
+
+
+class ServerStats;
+
+/* The latencies of the requests served by one worker thread. Only its
+   worker records into it, so the lock is contended only while a report
+   is gathered. */
+class WorkerStats
+{
+public:
+  WorkerStats(ServerStats& owner, const uint_t dbsCount);
+
+  WorkerStats(const WorkerStats&) = delete;
+  WorkerStats& operator= (const WorkerStats&) = delete;
+
+  void RecordCommand(const DBSDescriptors& dbs, const uint_t command, const uint64_t usecs);
+  void RecordProcedure(const DBSDescriptors& dbs, const uint32_t procId, const uint64_t usecs);
+
+  ServerStats& Owner() { return mOwner; }
+
+private:
+  friend class ServerStats;
+
+  struct DbsLatencies
+  {
+    DbsLatencies()
+      : mCommands(STATS_COMMANDS_COUNT)
+    {
+    }
+
+    std::vector<whais::LatencyHistogram>           mCommands;
+    std::map<uint32_t, whais::LatencyHistogram>    mProcedures;
+  };
+
+  ServerStats&                mOwner;
+  whais::Lock                 mSync;
+  std::vector<DbsLatencies>   mDatabases;
+};
+
+
+class ServerStats
+{
+public:
+  ServerStats(const std::vector<DBSDescriptors>& databases, const uint_t workersCount);
+
+  ServerStats(const ServerStats&) = delete;
+  ServerStats& operator= (const ServerStats&) = delete;
+
+  WorkerStats& Worker(const uint_t index) { return *mWorkers[index]; }
+  uint_t DbsIndex(const DBSDescriptors& dbs) const;
+
+  /* Describe as text the latencies of the commands and procedures, with
+     the counters of the sync statements and tables. When 'onlyDbs' is set
+     the other databases are left out. */
+  void Report(const DBSDescriptors* const onlyDbs, std::string& outReport);
+
+private:
+  const std::vector<DBSDescriptors>&           mDatabases;
+  std::vector<std::unique_ptr<WorkerStats>>    mWorkers;
+};
+
+
+/* Describe as text where the profiled calls of a procedure have spent
+   their time, or of all the called ones when 'procedure' is not set. It
+   is meant to be read back by the objects dumper, so its format is kept:
+
+     procedure <name>
+     calls <count> inclusive <us> exclusive <us> native <us> tables <us>
+     pc <code offset> <hits> <us>
+     ...
+
+   The instructions that were not executed are left out. */
+void
+ProceduresProfileReport(whais::ISession&     session,
+                        const char* const    procedure,
+                        std::string&         outReport);
+
+
+#endif /* STATS_H_ */
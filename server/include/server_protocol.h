@@ -130,6 +130,47 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define CMD_DESC_PROC_PARAM            (CMD_LIST_PROCEDURE_RSP + 1)
 #define CMD_DESC_PROC_PARAM_RSP        (CMD_DESC_PROC_PARAM + 1)
 
+#define CMD_SERVER_STATS               (CMD_DESC_PROC_PARAM_RSP + 1)
+#define CMD_SERVER_STATS_RSP           (CMD_SERVER_STATS + 1)
+/*
+ * CmdServerStats
+ * {
+ *      fromOffset   : uint32
+ * }
+ *
+ * CmdServerStatsRsp
+ * {
+ *      status       : uint32
+ *      reportSize   : uint32
+ *      fromOffset   : uint32
+ *      report       : char[]
+ * }
+ *
+ * The report is a text too large for a frame, so it is sent in parts. It
+ * is gathered again when it is asked from its start.
+ */
+
+#define CMD_PROC_PROFILE               (CMD_SERVER_STATS_RSP + 1)
+#define CMD_PROC_PROFILE_RSP           (CMD_PROC_PROFILE + 1)
+/*
+ * CmdProcProfile
+ * {
+ *      fromOffset   : uint32
+ *      procName     : char[]
+ * }
+ *
+ * CmdProcProfileRsp
+ * {
+ *      status       : uint32
+ *      profileSize  : uint32
+ *      fromOffset   : uint32
+ *      profile      : char[]
+ * }
+ *
+ * Like the server statistics, the profile is sent in parts. An empty
+ * procedure name asks for the profiles of all the database's procedures.
+ */
+
 
 /* Connection close command */
 #define CMD_CLOSE_CONN                 USER_CMD_BASE
@@ -274,6 +315,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define CMD_EXEC_PROC           (CMD_UPDATE_STACK_RSP + 1)
 #define CMD_EXEC_PROC_RSP       (CMD_EXEC_PROC + 1)
+/*
+ * CmdExecProc
+ * {
+ *      procedure : char[]
+ *      procId    : uint32  (procedure is empty)
+ * }
+ *
+ * CmdExecProcRsp
+ * {
+ *      status: uint32
+ * }
+ *
+ * A procedure resolved before with CMD_RESOLVE_PROC is called by its id,
+ * sent after an empty name.
+ */
 
 /* Ping command */
 #define CMD_PING_SERVER         (CMD_EXEC_PROC_RSP + 1)
@@ -283,8 +339,24 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define CMD_HELLO_SERVER         (CMD_PING_SERVER_RSP + 1)
 #define CMD_HELLO_SERVER_RSP     (CMD_HELLO_SERVER + 1)
 
-#define ADMIN_CMDS_COUNT        ((CMD_DESC_PROC_PARAM / 2) + 1)
-#define USER_CMDS_COUNT         ((CMD_HELLO_SERVER - USER_CMD_BASE) / 2 + 1)
+/* Get the id of a procedure, for its later calls */
+#define CMD_RESOLVE_PROC         (CMD_HELLO_SERVER_RSP + 1)
+#define CMD_RESOLVE_PROC_RSP     (CMD_RESOLVE_PROC + 1)
+/*
+ * CmdResolveProc
+ * {
+ *      procedure : char[]
+ * }
+ *
+ * CmdResolveProcRsp
+ * {
+ *      status : uint32
+ *      procId : uint32  (status == WCS_OK)
+ * }
+ */
+
+#define ADMIN_CMDS_COUNT        ((CMD_PROC_PROFILE / 2) + 1)
+#define USER_CMDS_COUNT         ((CMD_RESOLVE_PROC - USER_CMD_BASE) / 2 + 1)
 
 #endif /* SERVER_PROTOCOL_H_ */
 
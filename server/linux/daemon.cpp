@@ -179,7 +179,9 @@ boot_server()
       return false;
     }
 
-    glbLog.reset(new FileLogger(GetAdminSettings().mLogFile.c_str()));
+    glbLog.reset(new FileLogger(GetAdminSettings().mLogFile.c_str(),
+                                true,
+                                GetAdminSettings().mLogSettings));
   }
   catch(ios_base::failure& e)
   {
@@ -271,6 +273,11 @@ boot_server()
     dbsSettings.mVLStoreCacheBlkCount = confSettings.mVLBlockCount;
     dbsSettings.mVLStoreCacheBlkSize  = confSettings.mVLBlockSize;
     dbsSettings.mVLValueCacheSize     = confSettings.mTempValuesCache;
+    dbsSettings.mBufferPoolSize       = confSettings.mBufferPoolSize;
+    dbsSettings.mIndexFillFactor      = confSettings.mIndexFillFactor;
+    dbsSettings.mWalSyncPolicy        = confSettings.mWalSyncPolicy;
+    dbsSettings.mWalCheckpointSize    = confSettings.mWalCheckpointSize;
+    dbsSettings.mWriteBackInterval    = MAX(confSettings.mWriteBackInterval, 0);
 
     DBSInit(dbsSettings);
     sDbsInited = true;
@@ -14,7 +14,8 @@ UNIT_EXES+=whaisd
 endif
 
 wslsrv_cmn_SRC:=common/configuration.cpp common/loader.cpp common/server.cpp\
-			common/connection.cpp common/commands.cpp common/stack_cmds.cpp
+			common/connection.cpp common/commands.cpp common/stack_cmds.cpp\
+			common/stats.cpp
 
 wslsrv_cmn_DEF:=WVER_MAJ=1 WVER_MIN=2
 
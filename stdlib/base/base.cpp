@@ -203,6 +203,7 @@ static const WLIB_PROC_DESCRIPTION* sgRegisteredProcs[] = {
                           /* Field procedures */
                                                     &gProcFieldTable,
                                                     &gProcIsFielsIndexed,
+                                                    &gProcFieldIndexKind,
                                                     &gProcFieldName,
                                                     &gProcFindValueRange,
                                                     &gProcFilterRows,
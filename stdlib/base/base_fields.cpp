@@ -34,6 +34,7 @@ using namespace whais;
 
 WLIB_PROC_DESCRIPTION         gProcFieldTable;
 WLIB_PROC_DESCRIPTION         gProcIsFielsIndexed;
+WLIB_PROC_DESCRIPTION         gProcFieldIndexKind;
 WLIB_PROC_DESCRIPTION         gProcFieldName;
 
 WLIB_PROC_DESCRIPTION         gProcFindValueRange;
@@ -76,6 +77,27 @@ proc_field_isindexed( SessionStack& stack, ISession&)
 }
 
 
+static WLIB_STATUS
+proc_field_index_kind( SessionStack& stack, ISession&)
+{
+  const auto stackTop = stack.Size() - 1;
+  IOperand& op = stack[stackTop].Operand();
+
+  if (op.IsNull())
+  {
+    stack[stackTop] = StackValue::Create(DUInt8());
+    return WOP_OK;
+  }
+
+  ITable&           table = op.GetTable();
+  const FIELD_INDEX field = op.GetField();
+
+  DUInt8 result(table.IndexKind(field));
+  stack[stackTop] = StackValue::Create(result);
+  return WOP_OK;
+}
+
+
 static WLIB_STATUS
 proc_field_name( SessionStack& stack, ISession&)
 {
@@ -804,6 +826,17 @@ base_fields_init()
   gProcIsFielsIndexed.code        = proc_field_isindexed;
 
 
+  static const uint8_t* fieldIndexKindLocals[] = {
+                                                    gUInt8Type,
+                                                    gGenericFieldType
+                                                 };
+
+  gProcFieldIndexKind.name        = "index_kind";
+  gProcFieldIndexKind.localsCount = 2;
+  gProcFieldIndexKind.localsTypes = fieldIndexKindLocals;
+  gProcFieldIndexKind.code        = proc_field_index_kind;
+
+
   static const uint8_t* fieldNameLocals[] = { gTextType, gGenericFieldType };
 
   gProcFieldName.name        = "get_name";
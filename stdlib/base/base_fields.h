@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 extern whais::WLIB_PROC_DESCRIPTION         gProcFieldTable;
 extern whais::WLIB_PROC_DESCRIPTION         gProcIsFielsIndexed;
+extern whais::WLIB_PROC_DESCRIPTION         gProcFieldIndexKind;
 extern whais::WLIB_PROC_DESCRIPTION         gProcFieldName;
 extern whais::WLIB_PROC_DESCRIPTION         gProcFindValueRange;
 extern whais::WLIB_PROC_DESCRIPTION         gProcFilterRows;
@@ -27,6 +27,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include <fstream>
+#include <memory>
+#include <string>
 
 #include "wthread.h"
 
@@ -55,26 +57,108 @@ public:
 };
 
 
+/* How a file logger gets the messages into its file. */
+struct FileLoggerSettings
+{
+  FileLoggerSettings()
+    : mQueueSize(DEFAULT_QUEUE_SIZE),
+      mBatchSize(DEFAULT_BATCH_SIZE),
+      mSyncLevel(LT_CRITICAL),
+      mRateLimit(0)
+  {
+  }
+
+  static const uint_t DEFAULT_QUEUE_SIZE = 4096;
+  static const uint_t DEFAULT_BATCH_SIZE = 64 * 1024;
+
+  //How many message slots could wait to be written. It is rounded up to a
+  //power of 2. A message takes a slot for every 236 characters of it.
+  uint_t    mQueueSize;
+
+  //How many bytes are gathered at most before they are written at once.
+  uint_t    mBatchSize;
+
+  //The callers of the messages at least this severe wait until these
+  //are written. LT_UNKNOW lets every caller go without waiting.
+  LOG_TYPE  mSyncLevel;
+
+  //How many messages are accepted in a second, 0 meaning no limit. The
+  //critical messages are always accepted.
+  uint_t    mRateLimit;
+};
+
+
+/* The messages are queued without taking a lock, then a thread of the
+   logger formats them and writes them to the file in batches. So a caller
+   does not wait for the file, unless the message is severe enough for the
+   settings to ask so. When the queue is full, or the rate limit is hit,
+   the messages are dropped and their count is logged later instead. */
 class FileLogger : public Logger
 {
 public:
-  FileLogger(const char* const file, const bool printStart = true);
+  FileLogger(const char* const          file,
+             const bool                 printStart = true,
+             const FileLoggerSettings&  settings = FileLoggerSettings());
+  virtual ~FileLogger() override;
 
   void Log(const LOG_TYPE type, const char* str);
   void Log(const LOG_TYPE type, const std::string& str);
 
+  //Wait until the messages logged so far are written to the file.
+  void Flush();
+
+  uint64_t DroppedCount() const { return mDroppedCount; }
+
 private:
   FileLogger(const Logger&);
   FileLogger& operator= (const Logger&);
 
-  uint_t PrintTimeMark(LOG_TYPE type);
+  static const uint_t SLOT_TEXT_SIZE = 236;
+
+  struct Slot
+  {
+    volatile int64_t  mSequence;
+    WTICKS            mTicks;
+    uint16_t          mSize;
+    uint8_t           mType;
+    uint8_t           mPartsCount;
+    char              mText[SLOT_TEXT_SIZE];
+  };
+
+  static void WriterRoutine(void* const logger);
+
+  void   WriteMessages();
+  bool   IsMessageReady(uint_t& outPartsCount);
+  void   FormatMessage(std::string& out, const uint_t partsCount, const WTime& time,
+                       const WTICKS ticks);
+  void   WriteBatch(std::string& batch);
+  void   WaitWritten(const int64_t sequence);
+  void   WakeUpWriter();
+  uint_t PrintTimeMark(std::string& out, LOG_TYPE type, const WTime& time);
+  void   PrintDayMark(std::string& out, const char* const greeting);
   void   SwitchFile();
 
-  WTICKS        mStartTick;
-  Lock          mSync;
-  std::ofstream mOutStream;
-  std::string   mLogFile;
-  WTime         mTodayTime;
+  const FileLoggerSettings    mSettings;
+  std::unique_ptr<Slot[]>     mSlots;
+  uint64_t                    mSlotsMask;
+  uint_t                      mMaxParts;
+  volatile int64_t            mTail;
+  volatile int64_t            mHead;
+  volatile int64_t            mDroppedCount;
+  volatile int64_t            mRateSecond;
+  volatile int64_t            mRateCount;
+  volatile int32_t            mWriterIdle;
+  volatile bool               mStop;
+  int64_t                     mWrittenSeq;
+  int64_t                     mReportedDrops;
+  Lock                        mSync;
+  Condition                   mWakeUp;
+  Condition                   mWritten;
+  Thread                      mWriter;
+  std::ofstream               mOutStream;
+  std::string                 mLogFile;
+  std::string                 mMessage;
+  WTime                       mTodayTime;
 };
 
 
@@ -60,6 +60,9 @@ public:
 
   void     Read(uint8_t* buffer, uint_t size);
   void     Write(const uint8_t* buffer, uint_t size);
+  void     Read(const uint64_t offset, uint8_t* buffer, uint_t size) const;
+  void     Write(const uint64_t offset, const uint8_t* buffer, uint_t size);
+  void     Write(const uint64_t offset, const WIOVec* vecs, uint_t vecsCount);
   void     Seek(const int64_t where, const int whence);
   uint64_t Tell();
   void     Sync();
@@ -67,6 +70,9 @@ public:
   void     Size(const uint64_t size);
   void     Close();
 
+  /* Map a region of the file in memory. Returns nullptr if not possible. */
+  uint8_t* Map(const uint64_t offset, const uint64_t size);
+
 private:
   static const uint64_t UNKNOWN_SIZE = 0xFFFFFFFFFFFFFFFFull;
 
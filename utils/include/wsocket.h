@@ -67,10 +67,14 @@ public:
 
   Socket  Accept();
   uint_t  Read(uint8_t* const buffer, const uint_t maxCount);
+  uint_t  ReadPending(uint8_t* const buffer, const uint_t maxCount); //Does not wait, may return 0.
   void    Write(const uint8_t* const buffer, const uint_t count);
+  void    Shutdown();
   void    Close();
 
 private:
+  friend class SocketPoller;
+
   WH_SOCKET   mSocket;
 
   struct CUSTOM_SHL  SocketInitialiser
@@ -94,6 +98,30 @@ private:
 };
 
 
+/* Waits for sockets to become ready. A socket is reported only once after
+ * it's added or rearmed, so the same poller may be shared by several threads
+ * without handing the same socket to two of them. */
+class CUSTOM_SHL SocketPoller
+{
+public:
+  SocketPoller();
+  ~SocketPoller();
+
+  void  Add(const Socket& socket, const uint_t events, void* const data);
+  void  Rearm(const Socket& socket, const uint_t events, void* const data);
+  void  Remove(const Socket& socket);
+
+  //Returns the data of a ready socket or nullptr if the timeout expired.
+  void* Wait(const uint_t timeoutMsec);
+
+private:
+  SocketPoller(const SocketPoller&);
+  SocketPoller& operator= (const SocketPoller&);
+
+  WH_POLLER   mPoller;
+};
+
+
 } //namespace whais
 
 
@@ -0,0 +1,78 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef WSTATS_H_
+#define WSTATS_H_
+
+
+#include "whais.h"
+
+
+namespace whais
+{
+
+
+/* Counts the recorded values in buckets of bounded relative width, the way
+   the HDR histograms do: the values are grouped by their most significant
+   bit and every group is split in SUB_BUCKETS equal buckets. This way the
+   reported percentiles are off by less than 1/SUB_BUCKETS, whatever the
+   magnitude of the values. It does no locking of its own. */
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  void Record(const uint64_t value);
+  void Merge(const LatencyHistogram& source);
+
+  uint64_t Count() const { return mCount; }
+  uint64_t Sum() const { return mSum; }
+  uint64_t Max() const { return mMax; }
+
+  /* The value that is bigger than or equal to the given percent of the
+     recorded values. */
+  uint64_t Percentile(const uint_t percent) const;
+
+  static const uint_t SUB_BUCKETS_BITS = 3;
+  static const uint_t SUB_BUCKETS      = 1 << SUB_BUCKETS_BITS;
+
+  //The bigger values are all counted in the last bucket.
+  static const uint_t VALUE_BITS       = 40;
+  static const uint_t BUCKETS_COUNT    = (VALUE_BITS - SUB_BUCKETS_BITS + 1) * SUB_BUCKETS;
+
+private:
+  static uint_t BucketIndex(const uint64_t value);
+  static uint64_t BucketTop(const uint_t index);
+
+  uint64_t mCount;
+  uint64_t mSum;
+  uint64_t mMax;
+  uint64_t mBuckets[BUCKETS_COUNT];
+};
+
+
+} //namespace whais
+
+
+#endif //WSTATS_H_
@@ -45,12 +45,92 @@ public:
   void unlock();
 
 private:
+  friend class Condition;
+
   Lock(const Lock&);
   Lock& operator= (const Lock&);
 
   WH_LOCK mLock;
 };
 
+/* A lock that could be held by many readers at once, or by one writer.
+   The exclusive side works with LockGuard, the shared one with
+   SharedLockGuard. */
+class CUSTOM_SHL RWLock
+{
+public:
+  RWLock();
+  ~RWLock();
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+private:
+  RWLock(const RWLock&);
+  RWLock& operator= (const RWLock&);
+
+  WH_RWLOCK mLock;
+};
+
+/* A lock that counts how many of its acquires had to wait for an other
+   holder, and for how long (in microseconds). The uncontended acquires
+   cost as much as those of a plain lock. */
+class CUSTOM_SHL MeteredLock : public Lock
+{
+public:
+  MeteredLock();
+
+  void lock();
+
+  uint64_t Waits() const { return mWaits; }
+  uint64_t WaitTime() const { return mWaitTime; }
+
+private:
+  volatile int64_t mWaits;
+  volatile int64_t mWaitTime;
+};
+
+class CUSTOM_SHL MeteredRWLock : public RWLock
+{
+public:
+  MeteredRWLock();
+
+  void lock();
+  void lock_shared();
+
+  uint64_t Waits() const { return mWaits; }
+  uint64_t WaitTime() const { return mWaitTime; }
+
+private:
+  volatile int64_t mWaits;
+  volatile int64_t mWaitTime;
+};
+
+/* Lets threads sleep until other thread signals them. The waiters must
+   hold the associated lock, which is released for the duration of the
+   wait. Spurious wake ups are possible, so recheck the condition. */
+class CUSTOM_SHL Condition
+{
+public:
+  Condition();
+  ~Condition();
+
+  void wait(Lock& lock);
+  void notify_one();
+  void notify_all();
+
+private:
+  Condition(const Condition&);
+  Condition& operator= (const Condition&);
+
+  WH_COND mCond;
+};
+
 class CUSTOM_SHL SpinLock
 {
 public:
@@ -115,6 +195,53 @@ private:
 };
 
 
+template<class T>
+class SharedLockGuard
+{
+public:
+  explicit SharedLockGuard( T &lock, const bool skipAcquire = false)
+    : mLock(lock),
+      mIsAcquireed(false)
+  {
+    if ( ! skipAcquire)
+      this->lock();
+  }
+
+  ~SharedLockGuard()
+  {
+    unlock();
+  }
+
+  void lock()
+  {
+    mLock.lock_shared();
+    mIsAcquireed = true;
+  }
+
+  bool try_lock()
+  {
+    mIsAcquireed = mLock.try_lock_shared();
+    return mIsAcquireed;
+  }
+
+  void unlock()
+  {
+    if (mIsAcquireed)
+      {
+        mLock.unlock_shared();
+        mIsAcquireed = false;
+      }
+  }
+
+private:
+  SharedLockGuard(const SharedLockGuard&);
+  SharedLockGuard& operator= (const SharedLockGuard& );
+
+  T&       mLock;
+  bool     mIsAcquireed;
+};
+
+
 template<typename T>
 class DoubleLockGuard
 {
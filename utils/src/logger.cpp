@@ -22,6 +22,9 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <string.h>
+#include <stdio.h>
+
 #include "logger.h"
 
 using namespace std;
@@ -32,111 +35,381 @@ namespace whais
 //A global variable to used every one when you need one
 NullLogger NULL_LOGGER;
 
+const uint_t FileLogger::SLOT_TEXT_SIZE;
+
+
+
+static const int64_t USECS_PER_DAY = 24ll * 60 * 60 * 1000000;
+
+
+static int64_t
+usecs_of_day(const WTime& time)
+{
+  return ((time.hour * 60ll + time.min) * 60 + time.sec) * 1000000 + time.usec;
+}
 
 
-FileLogger::FileLogger(const char* const file, const bool printStart)
-  : mStartTick(wh_msec_ticks()),
+static bool
+is_same_day(const WTime& time1, const WTime& time2)
+{
+  return (time1.day == time2.day)
+         && (time1.month == time2.month)
+         && (time1.year == time2.year);
+}
+
+
+FileLogger::FileLogger(const char* const          file,
+                       const bool                 printStart,
+                       const FileLoggerSettings&  settings)
+  : mSettings(settings),
+    mSlotsMask(0),
+    mMaxParts(0),
+    mTail(0),
+    mHead(0),
+    mDroppedCount(0),
+    mRateSecond(0),
+    mRateCount(0),
+    mWriterIdle(0),
+    mStop(false),
+    mWrittenSeq(0),
+    mReportedDrops(0),
     mLogFile(file),
     mTodayTime(wh_get_currtime())
 {
+  uint64_t slotsCount = 64;
+  while (slotsCount < mSettings.mQueueSize)
+    slotsCount <<= 1;
+
+  mSlotsMask = slotsCount - 1;
+  mMaxParts  = MIN(slotsCount / 4, 0xFFu);
+
+  mSlots.reset(new Slot[slotsCount]);
+  for (uint64_t i = 0; i < slotsCount; ++i)
+    mSlots[i].mSequence = i;
+
   mLogFile.append(".wlog");
   SwitchFile();
 
   if (printStart)
   {
-    const WTime dayStart = wh_get_currtime();
-
-    mOutStream << "\n* Server start on: " << (int)dayStart.year
-               << '-' << (int)dayStart.month
-               << "-" << (int)dayStart.day
-               << ' ' << (int)dayStart.hour
-               << ':' << (int)dayStart.min
-               << ':' << (int)dayStart.sec << "\n\n";
+    string mark;
+    PrintDayMark(mark, "Server start on");
+    WriteBatch(mark);
   }
 
   if (! mOutStream.good())
     throw ios_base::failure("The file associated with the output stream could not be opened.");
+
+  mWriter.Run(WriterRoutine, this);
+}
+
+
+FileLogger::~FileLogger()
+{
+  {
+    LockGuard<Lock> holder(mSync);
+
+    mStop = true;
+    mWakeUp.notify_one();
+  }
+
+  mWriter.WaitToEnd(false);
 }
 
+
 void
 FileLogger::Log(const LOG_TYPE type, const char* str)
 {
-  LockGuard<Lock> holder(mSync);
+  const bool critical = (type == LT_CRITICAL);
+  const WTICKS ticks = wh_usec_ticks();
+
+  if ((mSettings.mRateLimit > 0) && ! critical)
+  {
+    /* Who notices first the new second resets the count. The others that
+       raced it could get a few extra messages in, which is fine. */
+    const int64_t second = ticks / 1000000;
+    if (mRateSecond != second)
+    {
+      mRateSecond = second;
+      mRateCount  = 0;
+    }
+
+    if (wh_atomic_fetch_inc64(&mRateCount) >= mSettings.mRateLimit)
+    {
+      wh_atomic_fetch_inc64(&mDroppedCount);
+      return;
+    }
+  }
 
-  const int markSize = PrintTimeMark(type);
+  uint64_t length = strlen(str);
+  uint_t partsCount = MAX(1, (length + SLOT_TEXT_SIZE - 1) / SLOT_TEXT_SIZE);
+  if (partsCount > mMaxParts)
+  {
+    partsCount = mMaxParts;
+    length     = partsCount * SLOT_TEXT_SIZE;
+  }
+
+  /* The check is racy, so the queue could be a bit overcommitted. Those
+     that went through just wait for their slots to be written first. */
+  if (! critical
+      && (_SC(uint64_t, mTail - mHead) + partsCount > mSlotsMask + 1))
+  {
+    wh_atomic_fetch_inc64(&mDroppedCount);
+    return;
+  }
+
+  const int64_t ticket = wh_atomic_fetch_add64(&mTail, partsCount);
+  for (uint_t part = 0; part < partsCount; ++part)
+  {
+    Slot& slot = mSlots[(ticket + part) & mSlotsMask];
+
+    while (wh_atomic_fetch_add64(&slot.mSequence, 0) != ticket + part)
+      wh_yield();
+
+    slot.mTicks      = ticks;
+    slot.mType       = _SC(uint8_t, type);
+    slot.mPartsCount = _SC(uint8_t, partsCount);
+    slot.mSize       = _SC(uint16_t, MIN(length, SLOT_TEXT_SIZE));
+    memcpy(slot.mText, str, slot.mSize);
+
+    str    += slot.mSize;
+    length -= slot.mSize;
+
+    wh_atomic_fetch_inc64(&slot.mSequence);
+  }
+
+  if (mWriterIdle > 0)
+    WakeUpWriter();
+
+  if ((type != LT_UNKNOW) && (type <= mSettings.mSyncLevel))
+    WaitWritten(ticket + partsCount);
+}
+
+
+void
+FileLogger::Log(const LOG_TYPE type, const string& str)
+{
+  Log(type, str.c_str());
+}
+
+
+void
+FileLogger::Flush()
+{
+  const int64_t tail = wh_atomic_fetch_add64(&mTail, 0);
+
+  WakeUpWriter();
+  WaitWritten(tail);
+}
+
+
+void
+FileLogger::WriterRoutine(void* const logger)
+{
+  _RC(FileLogger*, logger)->WriteMessages();
+}
+
+
+void
+FileLogger::WriteMessages()
+{
+  string batch;
+  uint_t partsCount;
+
+  while (true)
+  {
+    const WTime  time  = wh_get_currtime();
+    const WTICKS ticks = wh_usec_ticks();
+
+    if ( ! is_same_day(time, mTodayTime))
+    {
+      SwitchFile();
+      mTodayTime = time;
+      PrintDayMark(batch, "Hello on");
+    }
+
+    const int64_t drops = mDroppedCount;
+    if (drops != mReportedDrops)
+    {
+      char text[64];
+      snprintf(text,
+               sizeof text,
+               "%lld log messages were dropped.\n",
+               _SC(long long, drops - mReportedDrops));
+
+      PrintTimeMark(batch, LT_WARNING, time);
+      batch.append(text);
+
+      mReportedDrops = drops;
+    }
+
+    while ((batch.size() < mSettings.mBatchSize) && IsMessageReady(partsCount))
+    {
+      FormatMessage(batch, partsCount, time, ticks);
+
+      //Let the producers have the slots back before the text hits the file.
+      for (uint_t part = 0; part < partsCount; ++part)
+        wh_atomic_fetch_add64(&mSlots[(mHead + part) & mSlotsMask].mSequence, mSlotsMask);
+
+      wh_atomic_fetch_add64(&mHead, partsCount);
+    }
+
+    if ( ! batch.empty())
+    {
+      WriteBatch(batch);
+
+      LockGuard<Lock> holder(mSync);
+
+      mWrittenSeq = mHead;
+      mWritten.notify_all();
+      continue;
+    }
+
+    LockGuard<Lock> holder(mSync);
+
+    wh_atomic_fetch_inc32(&mWriterIdle);
+    while ( ! mStop && ! IsMessageReady(partsCount))
+      mWakeUp.wait(mSync);
+    wh_atomic_fetch_dec32(&mWriterIdle);
+
+    if (mStop && ! IsMessageReady(partsCount) && (mDroppedCount == mReportedDrops))
+      break;
+  }
+}
+
+
+bool
+FileLogger::IsMessageReady(uint_t& outPartsCount)
+{
+  Slot& first = mSlots[mHead & mSlotsMask];
+  if (wh_atomic_fetch_add64(&first.mSequence, 0) != mHead + 1)
+    return false;
+
+  outPartsCount = first.mPartsCount;
+
+  const int64_t last = mHead + outPartsCount - 1;
+  Slot& lastSlot = mSlots[last & mSlotsMask];
+
+  return wh_atomic_fetch_add64(&lastSlot.mSequence, 0) == last + 1;
+}
+
+
+void
+FileLogger::FormatMessage(string&       out,
+                          const uint_t  partsCount,
+                          const WTime&  time,
+                          const WTICKS  ticks)
+{
+  const Slot& first = mSlots[mHead & mSlotsMask];
+
+  mMessage.clear();
+  for (uint_t part = 0; part < partsCount; ++part)
+  {
+    const Slot& slot = mSlots[(mHead + part) & mSlotsMask];
+    mMessage.append(slot.mText, slot.mSize);
+  }
+
+  /* The message was stamped with the monotonic ticks, as these are cheap
+     to get. Go back from the wall time of this round by the message's age. */
+  int64_t usecs = usecs_of_day(time) - (_SC(int64_t, ticks) - _SC(int64_t, first.mTicks));
+  usecs = MAX(0, MIN(usecs, USECS_PER_DAY - 1));
+
+  WTime msgTime = time;
+  msgTime.usec = _SC(uint_t, usecs % 1000000);
+  msgTime.sec  = _SC(uint8_t, usecs / 1000000 % 60);
+  msgTime.min  = _SC(uint8_t, usecs / 60000000 % 60);
+  msgTime.hour = _SC(uint8_t, usecs / 3600000000ll);
+
+  const uint_t markSize = PrintTimeMark(out, _SC(LOG_TYPE, first.mType), msgTime);
 
   /* Print white spaces where the time mark should have been for
      for string messages that have more than one line, to keep
      a mice indentation. */
+  const char* str = mMessage.c_str();
   while (*str != 0)
   {
     if ((*str == '\n') && (*(str + 1) != '\n'))
       {
-        mOutStream << endl;
-        for (int i = 0; i < markSize; ++i)
-          mOutStream << ' ';
+        out.push_back('\n');
+        out.append(markSize, ' ');
       }
     else
-      mOutStream << *str;
+      out.push_back(*str);
 
     ++str;
   }
 
-  mOutStream << endl;
+  out.push_back('\n');
+}
+
+
+void
+FileLogger::WriteBatch(string& batch)
+{
+  mOutStream.write(batch.data(), batch.size());
   mOutStream.flush();
+
+  batch.clear();
 }
 
 
 void
-FileLogger::Log(const LOG_TYPE type, const string& str)
+FileLogger::WaitWritten(const int64_t sequence)
 {
-  Log(type, str.c_str());
+  LockGuard<Lock> holder(mSync);
+
+  while (mWrittenSeq < sequence)
+    mWritten.wait(mSync);
+}
+
+
+void
+FileLogger::WakeUpWriter()
+{
+  LockGuard<Lock> holder(mSync);
+
+  mWakeUp.notify_one();
 }
 
 
 uint_t
-FileLogger::PrintTimeMark(LOG_TYPE type)
+FileLogger::PrintTimeMark(string& out, LOG_TYPE type, const WTime& time)
 {
   static char logIds[] = { '!', 'C', 'E', 'W', 'I', 'D' };
 
   if (type > LT_DEBUG)
     type = LT_UNKNOW;
 
-  const WTime ctime = wh_get_currtime();
-
-  if ((ctime.day != mTodayTime.day)
-      || (ctime.month != mTodayTime.month)
-      || (ctime.year != mTodayTime.year))
-  {
-    SwitchFile();
-    mTodayTime = ctime;
-
-    mOutStream << "\n* Hello on: " << (int)mTodayTime.year
-               << '-' << (int)mTodayTime.month
-               << "-" << (int)mTodayTime.day
-               << ' ' << (int)mTodayTime.hour
-               << ':' << (int)mTodayTime.min
-               << ':' << (int)mTodayTime.sec << "\n\n";
-  }
-
-  const char       fill  = mOutStream.fill();
-  const streamsize width = mOutStream.width();
+  char mark[32];
+  const int markSize = snprintf(mark,
+                                sizeof mark,
+                                "(%c)%02u:%02u:%02u.%06u: ",
+                                logIds[type],
+                                _SC(uint_t, time.hour),
+                                _SC(uint_t, time.min),
+                                _SC(uint_t, time.sec),
+                                _SC(uint_t, time.usec));
+  out.append(mark, markSize);
 
-  mOutStream << '(' << logIds [type] << ')';
-  mOutStream.fill('0');
-  mOutStream.width(2);
-  mOutStream << (uint_t) ctime.hour << ':';
-  mOutStream.width(2);
-  mOutStream << (uint_t) ctime.min << ':';
-  mOutStream.width(2);
-  mOutStream << (uint_t) ctime.sec << '.';
-  mOutStream.width(6);
-  mOutStream << (uint_t) ctime.usec << ": ";
+  return 3 + 2 + 1 + 2 + 1 + 2 + 1 + 6 + 2;
+}
 
-  mOutStream.fill(fill);
-  mOutStream.width(width);
 
-  return 3 + 2 + 1 + 2 + 1 + 2 + 1 + 6 + 2;
+void
+FileLogger::PrintDayMark(string& out, const char* const greeting)
+{
+  char mark[64];
+  const int markSize = snprintf(mark,
+                                sizeof mark,
+                                "\n* %s: %d-%d-%d %d:%d:%d\n\n",
+                                greeting,
+                                _SC(int, mTodayTime.year),
+                                _SC(int, mTodayTime.month),
+                                _SC(int, mTodayTime.day),
+                                _SC(int, mTodayTime.hour),
+                                _SC(int, mTodayTime.min),
+                                _SC(int, mTodayTime.sec));
+  out.append(mark, markSize);
 }
 
 
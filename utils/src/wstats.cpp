@@ -0,0 +1,122 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "wstats.h"
+
+
+namespace whais
+{
+
+
+LatencyHistogram::LatencyHistogram()
+  : mCount(0),
+    mSum(0),
+    mMax(0)
+{
+  memset(mBuckets, 0, sizeof mBuckets);
+}
+
+
+void
+LatencyHistogram::Record(const uint64_t value)
+{
+  ++mBuckets[BucketIndex(value)];
+
+  ++mCount;
+  mSum += value;
+  mMax = MAX(mMax, value);
+}
+
+
+void
+LatencyHistogram::Merge(const LatencyHistogram& source)
+{
+  for (uint_t i = 0; i < BUCKETS_COUNT; ++i)
+    mBuckets[i] += source.mBuckets[i];
+
+  mCount += source.mCount;
+  mSum += source.mSum;
+  mMax = MAX(mMax, source.mMax);
+}
+
+
+uint64_t
+LatencyHistogram::Percentile(const uint_t percent) const
+{
+  assert(percent <= 100);
+
+  if (mCount == 0)
+    return 0;
+
+  const uint64_t rank = (mCount * percent + 99) / 100;
+
+  uint64_t counted = 0;
+  for (uint_t i = 0; i < BUCKETS_COUNT; ++i)
+  {
+    counted += mBuckets[i];
+    if ((counted > 0) && (counted >= rank))
+      return MIN(BucketTop(i), mMax);
+  }
+
+  return mMax;
+}
+
+
+uint_t
+LatencyHistogram::BucketIndex(const uint64_t value)
+{
+  if (value < SUB_BUCKETS)
+    return value;
+
+  uint_t msb = SUB_BUCKETS_BITS;
+  while ((msb < 63) && ((value >> (msb + 1)) != 0))
+    ++msb;
+
+  if (msb >= VALUE_BITS)
+    return BUCKETS_COUNT - 1;
+
+  const uint_t shift = msb - SUB_BUCKETS_BITS;
+  const uint_t sub = (value >> shift) - SUB_BUCKETS;
+
+  return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+
+uint64_t
+LatencyHistogram::BucketTop(const uint_t index)
+{
+  if (index < SUB_BUCKETS)
+    return index;
+
+  const uint_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+  const uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+  return ((SUB_BUCKETS + sub) << shift) + (_SC(uint64_t, 1) << shift) - 1;
+}
+
+
+} //namespace whais
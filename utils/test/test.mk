@@ -0,0 +1,3 @@
+UNIT_EXES+=test_logger
+test_logger_SRC=test/test_logger.cpp
+test_logger_LIB=utils/wslutils custom/wslcustom custom/wslcppmemalloc
@@ -0,0 +1,285 @@
+#include <assert.h>
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "utils/logger.h"
+#include "utils/wfile.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+using namespace std;
+using namespace whais;
+
+
+static const char log_name[]      = "t_logger_test";
+static const char log_file[]      = "t_logger_test.wlog";
+
+static const uint_t THREADS_COUNT = 4;
+static const uint_t MESSAGES_COUNT = 5000;
+static const uint_t MARK_SIZE = 20;
+
+
+struct ProducerContext
+{
+  FileLogger*  mLogger;
+  uint_t       mThreadId;
+};
+
+
+static string
+message_text(const uint_t threadId, const uint_t message)
+{
+  char text[32];
+  snprintf(text, sizeof text, "thread %u message %u ", threadId, message);
+
+  //Every tenth message is long enough to be split in a few slots.
+  string result(text);
+  result.append((message % 10 == 0) ? 600 : message % 40, 'a' + message % 26);
+  result.append(";");
+
+  return result;
+}
+
+
+static void
+producer_routine(void* const args)
+{
+  ProducerContext* const context = _RC(ProducerContext*, args);
+
+  for (uint_t i = 0; i < MESSAGES_COUNT; ++i)
+    context->mLogger->Log(LT_CRITICAL, message_text(context->mThreadId, i));
+}
+
+
+static vector<string>
+read_log_lines()
+{
+  vector<string> result;
+  ifstream       file(log_file);
+  string         line;
+
+  while (getline(file, line))
+  {
+    if ( ! line.empty() && (line[0] != '*'))
+      result.push_back(line);
+  }
+
+  return result;
+}
+
+
+static bool
+check_time_mark(const string& line, const char type)
+{
+  return (line.length() >= MARK_SIZE)
+         && (line[0] == '(')
+         && (line[1] == type)
+         && (line[2] == ')')
+         && (line[5] == ':')
+         && (line[8] == ':')
+         && (line[11] == '.')
+         && (line[18] == ':')
+         && (line[19] == ' ');
+}
+
+
+static bool
+test_concurrent_producers()
+{
+  cout << "Testing messages logged from concurrent threads ... ";
+
+  FileLoggerSettings settings;
+  settings.mQueueSize = 64;
+  settings.mBatchSize = 4096;
+  settings.mSyncLevel = LT_UNKNOW;
+
+  whf_remove(log_file);
+
+  bool result = true;
+  {
+    FileLogger logger(log_name, false, settings);
+
+    Thread          threads[THREADS_COUNT];
+    ProducerContext contexts[THREADS_COUNT];
+
+    for (uint_t t = 0; t < THREADS_COUNT; ++t)
+    {
+      contexts[t].mLogger   = &logger;
+      contexts[t].mThreadId = t;
+      threads[t].Run(producer_routine, &contexts[t]);
+    }
+
+    for (uint_t t = 0; t < THREADS_COUNT; ++t)
+      threads[t].WaitToEnd();
+
+    logger.Flush();
+    result &= (logger.DroppedCount() == 0);
+  }
+
+  const vector<string> lines = read_log_lines();
+  result &= (lines.size() == THREADS_COUNT * MESSAGES_COUNT);
+
+  //Each thread's messages should be found intact and in their order.
+  uint_t nextMessage[THREADS_COUNT] = {0, };
+  for (size_t i = 0; (i < lines.size()) && result; ++i)
+  {
+    uint_t threadId, message;
+
+    result &= check_time_mark(lines[i], 'C');
+    result &= (sscanf(lines[i].c_str() + MARK_SIZE, "thread %u message %u", &threadId, &message) == 2);
+    result &= (threadId < THREADS_COUNT) && (message == nextMessage[threadId]);
+    result &= (lines[i].substr(MARK_SIZE) == message_text(threadId, message));
+
+    ++nextMessage[threadId % THREADS_COUNT];
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_multiline_messages()
+{
+  cout << "Testing the indentation of the multi-line messages ... ";
+
+  whf_remove(log_file);
+  {
+    FileLogger logger(log_name, false);
+
+    logger.Log(LT_INFO, "first line\nsecond line\n\nfourth line");
+    logger.Log(LT_WARNING, string(1000, 'x'));
+  }
+
+  const vector<string> lines = read_log_lines();
+  const string indent(MARK_SIZE, ' ');
+
+  bool result = (lines.size() == 4);
+
+  result = result && check_time_mark(lines[0], 'I');
+  result = result && (lines[0].substr(MARK_SIZE) == "first line");
+  result = result && (lines[1] == indent + "second line");
+  result = result && (lines[2] == indent + "fourth line");
+  result = result && check_time_mark(lines[3], 'W');
+  result = result && (lines[3].substr(MARK_SIZE) == string(1000, 'x'));
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_sync_level()
+{
+  cout << "Testing the messages that are waited to be written ... ";
+
+  FileLoggerSettings settings;
+  settings.mSyncLevel = LT_ERROR;
+
+  whf_remove(log_file);
+
+  bool result = true;
+  {
+    FileLogger logger(log_name, false, settings);
+
+    logger.Log(LT_ERROR, "an error message");
+
+    vector<string> lines = read_log_lines();
+    result &= (lines.size() == 1) && (lines[0].substr(MARK_SIZE) == "an error message");
+
+    logger.Log(LT_DEBUG, "a debug message");
+    logger.Flush();
+
+    lines = read_log_lines();
+    result &= (lines.size() == 2) && (lines[1].substr(MARK_SIZE) == "a debug message");
+  }
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+static bool
+test_rate_limit()
+{
+  cout << "Testing the rate limit of the messages ... ";
+
+  FileLoggerSettings settings;
+  settings.mRateLimit = 10;
+
+  whf_remove(log_file);
+
+  uint64_t dropped = 0;
+  bool result = true;
+  {
+    FileLogger logger(log_name, false, settings);
+
+    for (uint_t i = 0; i < 100; ++i)
+      logger.Log(LT_INFO, "a limited message");
+
+    logger.Log(LT_CRITICAL, "a critical message");
+
+    dropped = logger.DroppedCount();
+    result &= (dropped >= 100 - 2 * settings.mRateLimit);
+  }
+
+  const vector<string> lines = read_log_lines();
+
+  uint64_t logged = 0, reported = 0;
+  bool criticalFound = false;
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    unsigned long long count;
+
+    if (lines[i].substr(MARK_SIZE) == "a limited message")
+      ++logged;
+
+    else if (lines[i].substr(MARK_SIZE) == "a critical message")
+      criticalFound = true;
+
+    else if (sscanf(lines[i].c_str() + MARK_SIZE, "%llu log messages were dropped.", &count) == 1)
+      reported += count;
+
+    else
+      result = false;
+  }
+
+  result &= criticalFound;
+  result &= (logged + dropped == 100);
+  result &= (reported == dropped);
+
+  cout << (result ? "OK" : "FAIL") << endl;
+  return result;
+}
+
+
+int
+main(int argc, char** argv)
+{
+  bool success = true;
+
+  success &= test_concurrent_producers();
+  success &= test_multiline_messages();
+  success &= test_sync_level();
+  success &= test_rate_limit();
+
+  whf_remove(log_file);
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -8,7 +8,13 @@ UNIT_SHLS:=
 wslutils_SRC=src/warray.c src/msglog.c src/woutstream.c src/wrandom.c\
 		  src/logger.cpp src/tokenizer.cpp src/wutf.c src/enc_3k.c\
 		  src/wtypes.c src/wunicode.c src/whash.c src/enc_des.c\
-		  src/license.cpp
+		  src/license.cpp src/wstats.cpp
 
+
+ifeq ($(BUILD_TESTS),yes)
+-include ./$(UNIT)/test/test.mk
+endif
+
+$(foreach exe, $(UNIT_EXES), $(eval $(call add_output_executable,$(exe),$(UNIT))))
 $(foreach lib, $(UNIT_LIBS), $(eval $(call add_output_library,$(lib),$(UNIT))))
 